@@ -13,6 +13,7 @@
 
 #include "fem.hpp"
 #include "../general/device.hpp"
+#include "../general/tic_toc.hpp"
 #include <cmath>
 
 namespace mfem
@@ -74,6 +75,7 @@ BilinearForm::BilinearForm(FiniteElementSpace * f)
    static_cond = NULL;
    hybridization = NULL;
    precompute_sparsity = 0;
+   elem_costs = NULL;
    diag_policy = DIAG_KEEP;
 
    assembly = AssemblyLevel::LEGACYFULL;
@@ -92,6 +94,7 @@ BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
    static_cond = NULL;
    hybridization = NULL;
    precompute_sparsity = ps;
+   elem_costs = NULL;
    diag_policy = DIAG_KEEP;
 
    assembly = AssemblyLevel::LEGACYFULL;
@@ -399,6 +402,13 @@ void BilinearForm::Assemble(int skip_zeros)
    }
 #endif
 
+   StopWatch elem_timer;
+   if (elem_costs)
+   {
+      elem_costs->SetSize(fes->GetNE());
+      *elem_costs = 0.0;
+   }
+
    if (dbfi.Size())
    {
       for (int i = 0; i < fes -> GetNE(); i++)
@@ -410,6 +420,7 @@ void BilinearForm::Assemble(int skip_zeros)
          }
          else
          {
+            if (elem_costs) { elem_timer.Clear(); elem_timer.Start(); }
             const FiniteElement &fe = *fes->GetFE(i);
             eltrans = fes->GetElementTransformation(i);
             dbfi[0]->AssembleElementMatrix(fe, *eltrans, elmat);
@@ -419,6 +430,11 @@ void BilinearForm::Assemble(int skip_zeros)
                elmat += elemmat;
             }
             elmat_p = &elmat;
+            if (elem_costs)
+            {
+               elem_timer.Stop();
+               (*elem_costs)(i) = elem_timer.RealTime();
+            }
          }
          if (static_cond)
          {
@@ -111,6 +111,10 @@ protected:
    DiagonalPolicy diag_policy;
 
    int precompute_sparsity;
+
+   /// Per-element assembly times, see SetElementCosts(). Not owned.
+   Vector *elem_costs;
+
    // Allocate appropriate SparseMatrix and assign it to mat
    void AllocMat();
 
@@ -123,6 +127,7 @@ protected:
       mat = mat_e = NULL; extern_bfs = 0; element_matrices = NULL;
       static_cond = NULL; hybridization = NULL;
       precompute_sparsity = 0;
+      elem_costs = NULL;
       diag_policy = DIAG_KEEP;
       assembly = AssemblyLevel::LEGACYFULL;
       batch = 1;
@@ -198,6 +203,16 @@ public:
        present in the bilinear form. */
    void UsePrecomputedSparsity(int ps = 1) { precompute_sparsity = ps; }
 
+   /** @brief Record the time (in seconds) spent computing the element matrix
+       of each element in @a costs during the next calls to Assemble().
+
+       This is only supported with AssemblyLevel::LEGACYFULL, where element
+       matrices are computed one element at a time. The vector is resized to
+       the number of elements and can be used as weights for
+       Mesh::GeneratePartitioning() or ParMesh::Rebalance(). Pass NULL to stop
+       recording. The vector is not owned. */
+   void SetElementCosts(Vector *costs) { elem_costs = costs; }
+
    /** @brief Use the given CSR sparsity pattern to allocate the internal
        SparseMatrix.
 
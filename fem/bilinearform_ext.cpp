@@ -251,7 +251,12 @@ PABilinearFormExtension::PABilinearFormExtension(BilinearForm *form)
 
 void PABilinearFormExtension::SetupRestrictionOperators(const L2FaceValues m)
 {
-   ElementDofOrdering ordering = UsesTensorBasis(*a->FESpace())?
+   // On meshes with more than one geometry, the E-vector is split in batches
+   // of elements with the same geometry, see ElementRestriction, and the
+   // batches of tensor product elements need the lexicographic ordering.
+   const Mesh &mesh = *a->FESpace()->GetMesh();
+   const bool mixed = mesh.GetNumGeometries(mesh.Dimension()) > 1;
+   ElementDofOrdering ordering = (UsesTensorBasis(*a->FESpace()) || mixed)?
                                  ElementDofOrdering::LEXICOGRAPHIC:
                                  ElementDofOrdering::NATIVE;
    elem_restrict = trialFes->GetElementRestriction(ordering);
@@ -717,12 +717,15 @@ void DiffusionIntegrator::AssembleElementMatrix
    elmat.SetSize(nd);
 
    const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el);
+   const ShapeTable *table = el.GetShapeTable(*ir);
+   Trans.SetIntRule(ir);
 
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      el.CalcDShape(ip, dshape);
+      if (table) { table->CalcDShape(i, dshape); }
+      else { el.CalcDShape(ip, dshape); }
 
       Trans.SetIntPoint(&ip);
       w = Trans.Weight();
@@ -781,13 +784,18 @@ void DiffusionIntegrator::AssembleElementMatrix2(
    elmat.SetSize(te_nd, tr_nd);
 
    const IntegrationRule *ir = IntRule ? IntRule : &GetRule(trial_fe, test_fe);
+   const ShapeTable *tr_table = trial_fe.GetShapeTable(*ir);
+   const ShapeTable *te_table = test_fe.GetShapeTable(*ir);
+   Trans.SetIntRule(ir);
 
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      trial_fe.CalcDShape(ip, dshape);
-      test_fe.CalcDShape(ip, te_dshape);
+      if (tr_table) { tr_table->CalcDShape(i, dshape); }
+      else { trial_fe.CalcDShape(ip, dshape); }
+      if (te_table) { te_table->CalcDShape(i, te_dshape); }
+      else { test_fe.CalcDShape(ip, te_dshape); }
 
       Trans.SetIntPoint(&ip);
       CalcAdjugate(Trans.Jacobian(), invdfdx);
@@ -1055,12 +1063,15 @@ void MassIntegrator::AssembleElementMatrix
    shape.SetSize(nd);
 
    const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el, Trans);
+   const ShapeTable *table = el.GetShapeTable(*ir);
+   Trans.SetIntRule(ir);
 
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      el.CalcShape(ip, shape);
+      if (table) { table->CalcShape(i, shape); }
+      else { el.CalcShape(ip, shape); }
 
       Trans.SetIntPoint (&ip);
       w = Trans.Weight() * ip.weight;
@@ -1090,13 +1101,18 @@ void MassIntegrator::AssembleElementMatrix2(
 
    const IntegrationRule *ir = IntRule ? IntRule :
                                &GetRule(trial_fe, test_fe, Trans);
+   const ShapeTable *tr_table = trial_fe.GetShapeTable(*ir);
+   const ShapeTable *te_table = test_fe.GetShapeTable(*ir);
+   Trans.SetIntRule(ir);
 
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      trial_fe.CalcShape(ip, shape);
-      test_fe.CalcShape(ip, te_shape);
+      if (tr_table) { tr_table->CalcShape(i, shape); }
+      else { trial_fe.CalcShape(ip, shape); }
+      if (te_table) { te_table->CalcShape(i, te_shape); }
+      else { test_fe.CalcShape(ip, te_shape); }
 
       Trans.SetIntPoint (&ip);
       w = Trans.Weight() * ip.weight;
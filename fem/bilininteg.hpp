@@ -27,6 +27,199 @@ constexpr int HCURL_MAX_Q1D = 6;
 constexpr int HDIV_MAX_D1D = 5;
 constexpr int HDIV_MAX_Q1D = 6;
 
+constexpr int SIMPLEX_MAX_D1D = 9;
+constexpr int SIMPLEX_MAX_Q1D = 12;
+
+/** @brief Data for the sum-factorized partial assembly kernels on triangles,
+    tetrahedra and prisms. */
+/** The kernels use the Duffy (collapsed coordinate) map from the cube
+    [0,1]^dim to the simplex, x = a(1-b)(1-c), y = b(1-c), z = c, with a tensor
+    product Gauss-Legendre rule in (a,b,c), see GetCollapsedRule(). In these
+    coordinates, the Bernstein polynomials of degree p factor as
+
+        B_{jkl}(x,y,z) = B^{p-l-k}_j(a) B^{p-l}_k(b) B^p_l(c),
+
+    where B^m_j is the 1D Bernstein polynomial of degree m, so their values
+    and gradients at the points of the rule can be computed with sum
+    factorization in O(p^{dim+1}) operations per element. On prisms, the map
+    is x = a(1-b), y = b, z = c and the Bernstein basis is the product of the
+    triangle basis and the 1D basis, B^{p-k}_j(a) B^p_k(b) B^p_l(c).
+
+    The element degrees of freedom are converted to Bernstein coefficients
+    with the matrix #T, which is a permutation for the Bernstein basis
+    (BasisType::Positive) and a dense matrix for other bases. */
+class SimplexPAMaps
+{
+public:
+   /// The element geometry.
+   Geometry::Type geom;
+
+   /// Reference space dimension (2 or 3), polynomial order and number of dofs.
+   int dim, order, ndof;
+
+   /// Number of 1D points of the collapsed rule.
+   int quad1D;
+
+   /// The collapsed rule, see GetCollapsedRule(). Not owned.
+   const IntegrationRule *IntRule;
+
+   /// The 1D Gauss-Legendre points in [0,1] of the collapsed rule.
+   Vector pts1D;
+
+   /** @brief 1D Bernstein polynomials of all degrees m = 0,...,order and their
+       derivatives at the 1D points of #IntRule. */
+   /** The layout is (quad1D x (order+1) x (order+1)), the entry (q,j,m) being
+       B^m_j at the point q; the entries with j > m are zero. */
+   Vector B, G;
+
+   /** @brief If #perm is empty, the dense matrix mapping the element dofs to
+       the Bernstein coefficients, ordered with the index j running fastest,
+       then k, then l. */
+   DenseMatrix T;
+
+   /// The element dof of each Bernstein coefficient, if #T is a permutation.
+   Array<int> perm;
+
+   /** @brief Setup the data for the scalar FiniteElement @a fe, with a
+       collapsed rule that is exact for polynomials of degree @a ir_order in
+       the element. */
+   SimplexPAMaps(const FiniteElement &fe, int ir_order);
+
+   /** @brief Return the tensor product rule with @a q1d Gauss-Legendre points
+       per direction of the collapsed coordinates, mapped to the reference
+       triangle, tetrahedron or prism @a geom. */
+   /** The points are ordered with the index in a running fastest, then b, then
+       c. The weights include the Jacobian of the Duffy map. The returned
+       reference remains valid until the end of the program. */
+   static const IntegrationRule &GetCollapsedRule(Geometry::Type geom,
+                                                  int q1d);
+
+   /** @brief Compute the mass quadrature data, W detJ C, from the Jacobians
+       @a J of GeometricFactors at the points of #IntRule and the coefficient
+       values @a C (of size 1 if constant). */
+   void MassSetup(const int NE, const Vector &J, const Vector &C,
+                  Vector &D) const;
+
+   /** @brief Compute the diffusion quadrature data, W C adj(J) adj(J)^T /
+       detJ, stored as the (dim*(dim+1))/2 entries of the upper triangle. */
+   void DiffusionSetup(const int NE, const Vector &J, const Vector &C,
+                       Vector &D) const;
+
+   /// Add the action of the mass operator with quadrature data @a D.
+   void MassApply(const int NE, const Vector &D, const Vector &x,
+                  Vector &y) const;
+
+   /// Add the action of the diffusion operator with quadrature data @a D.
+   void DiffusionApply(const int NE, const Vector &D, const Vector &x,
+                       Vector &y) const;
+
+   /// Add the diagonal of the mass operator with quadrature data @a D.
+   void MassDiagonal(const FiniteElement &fe, const int NE, const Vector &D,
+                     Vector &diag) const;
+
+   /// Add the diagonal of the diffusion operator with quadrature data @a D.
+   void DiffusionDiagonal(const FiniteElement &fe, const int NE,
+                          const Vector &D, Vector &diag) const;
+};
+
+/// Return true if @a geom is supported by SimplexPAMaps: Geometry::TRIANGLE,
+/// Geometry::TETRAHEDRON or Geometry::PRISM.
+inline bool IsSimplexPAGeometry(Geometry::Type geom)
+{
+   return geom == Geometry::TRIANGLE || geom == Geometry::TETRAHEDRON ||
+          geom == Geometry::PRISM;
+}
+
+/** @brief Partial assembly data of an integrator for one batch of elements
+    with the same geometry, see ElementRestriction::GetBatchElements(). */
+/** Used by the PA integrators on meshes with more than one geometry, where
+    each batch runs its own kernels on its part of the E-vector. */
+class PAElementBatch
+{
+public:
+   Geometry::Type geom;
+   Array<int> elements;          ///< The mesh elements of the batch
+   int ne;                       ///< Number of elements of the batch
+   int offset;                   ///< Offset of the batch in the E-vector
+   int size;                     ///< Size of the batch in the E-vector
+   const FiniteElement *fe;      ///< The element of the batch, not owned
+   const IntegrationRule *ir;    ///< Not owned
+   int dofs1D, quad1D;           ///< Tensor sizes on quads and hexes
+   const DofToQuad *maps;        ///< Tensor maps on quads and hexes, not owned
+   SimplexPAMaps *simplex_maps;  ///< Data on simplices and prisms, owned
+   Vector pa_data;
+
+   PAElementBatch() : ir(NULL), maps(NULL), simplex_maps(NULL) { }
+   ~PAElementBatch() { delete simplex_maps; }
+
+   /** @brief Replace @a batches by the batches of the ElementRestriction of
+       @a fes with LEXICOGRAPHIC ordering. */
+   /** The integration rule and the PA data of the new batches are not set. */
+   static void MakeBatches(const FiniteElementSpace &fes,
+                           Array<PAElementBatch*> &batches);
+
+   /// Delete the entries of @a batches and set its size to zero.
+   static void DeleteBatches(Array<PAElementBatch*> &batches);
+
+   /** @brief Set the rule of the batch, exact for polynomials of degree @a
+       order, and the maps of #fe at its points. */
+   /** The rule is SimplexPAMaps::GetCollapsedRule() on simplices and prisms,
+       and IntRules.Get(geom, order) on quads and hexes. */
+   void SetIntRule(int order);
+
+   /// Compute the Jacobians at the points of #ir, (NQ x DIM x DIM x NE).
+   void GetJacobians(Mesh &mesh, Vector &J) const;
+
+   /** @brief Evaluate the coefficient @a Q at the points of #ir, (NQ x NE), or
+       return a single value if @a Q is NULL or constant. */
+   void GetCoefficient(Coefficient *Q, Mesh &mesh, Vector &C) const;
+};
+
+/** @brief Host partial assembly kernels on tensor product elements, vectorized
+    across elements with the AutoSIMD type of AutoSIMDTraits. */
+/** The elements are processed in groups of Width() elements, which are copied
+    to and from an interleaved layout where each AutoSIMD entry holds the same
+    dof or quadrature point of all the elements of the group. The sum
+    factorization contracts one dimension at a time, so D1D and Q1D are runtime
+    values. The data layouts are those of the MFEM_FORALL kernels of the
+    corresponding integrators. */
+class SimdPA
+{
+   static bool enabled;
+
+public:
+   /// Number of elements processed together, i.e. the AutoSIMD width.
+   static int Width();
+
+   /** @brief Enable or disable the SIMD kernels in the integrators. They are
+       enabled by default if Width() > 1, i.e. with MFEM_USE_SIMD. */
+   static void Enable(bool enable) { enabled = enable; }
+
+   /** @brief Return true if the integrators use the SIMD kernels: they are
+       enabled and the Device has only the CPU backend. */
+   static bool Enabled();
+
+   /** @brief Y += M X for the mass operator with PA data @a D, (NQ x NE),
+       applied to the @a vdim components of X, (ND x vdim x NE). */
+   static void MassApply(const int dim, const int D1D, const int Q1D,
+                         const int NE, const int vdim,
+                         const Array<double> &B, const Vector &D,
+                         const Vector &X, Vector &Y);
+
+   /** @brief Y += K X for the diffusion operator with PA data @a D, (NQ x
+       dim*(dim+1)/2 x NE) if @a symm, and (NQ x dim*dim x NE) otherwise. */
+   static void DiffusionApply(const int dim, const int D1D, const int Q1D,
+                              const int NE, const bool symm,
+                              const Array<double> &B, const Array<double> &G,
+                              const Vector &D, const Vector &X, Vector &Y);
+
+   /// Y += C X for the convection operator with PA data @a D, (NQ x dim x NE).
+   static void ConvectionApply(const int dim, const int D1D, const int Q1D,
+                               const int NE,
+                               const Array<double> &B, const Array<double> &G,
+                               const Vector &D, const Vector &X, Vector &Y);
+};
+
 /// Abstract base class BilinearFormIntegrator
 class BilinearFormIntegrator : public NonlinearFormIntegrator
 {
@@ -1968,9 +2161,19 @@ private:
    int dim, ne, dofs1D, quad1D;
    Vector pa_data;
    bool symmetric = true; ///< False if using a nonsymmetric matrix coefficient
+   SimplexPAMaps *simplex_maps = NULL; ///< PA data on simplices and prisms
+   Array<PAElementBatch*> pa_batches; ///< PA data on mixed meshes, owned
    // CEED extension
    CeedData* ceedDataPtr;
 
+   /// Partial assembly on triangles, tetrahedra and prisms, see SimplexPAMaps.
+   void AssemblePASimplex(const FiniteElementSpace &fes,
+                          const IntegrationRule &ir);
+
+   /** @brief Partial assembly on meshes with more than one geometry, with one
+       PAElementBatch per geometry. */
+   void AssemblePABatches(const FiniteElementSpace &fes);
+
 public:
    /// Construct a diffusion integrator with coefficient Q = 1
    DiffusionIntegrator()
@@ -1999,6 +2202,8 @@ public:
 
    virtual ~DiffusionIntegrator()
    {
+      PAElementBatch::DeleteBatches(pa_batches);
+      delete simplex_maps;
       delete ceedDataPtr;
    }
 
@@ -2065,10 +2270,20 @@ protected:
    const DofToQuad *maps;         ///< Not owned
    const GeometricFactors *geom;  ///< Not owned
    int dim, ne, nq, dofs1D, quad1D;
+   SimplexPAMaps *simplex_maps = NULL; ///< PA data on simplices and prisms
+   Array<PAElementBatch*> pa_batches; ///< PA data on mixed meshes, owned
 
    // CEED extension
    CeedData* ceedDataPtr;
 
+   /// Partial assembly on triangles, tetrahedra and prisms, see SimplexPAMaps.
+   void AssemblePASimplex(const FiniteElementSpace &fes,
+                          const IntegrationRule &ir);
+
+   /** @brief Partial assembly on meshes with more than one geometry, with one
+       PAElementBatch per geometry. */
+   void AssemblePABatches(const FiniteElementSpace &fes);
+
 public:
    MassIntegrator(const IntegrationRule *ir = NULL)
       : BilinearFormIntegrator(ir), Q(NULL), maps(NULL), geom(NULL),
@@ -2081,6 +2296,8 @@ public:
 
    virtual ~MassIntegrator()
    {
+      PAElementBatch::DeleteBatches(pa_batches);
+      delete simplex_maps;
       delete ceedDataPtr;
    }
    /** Given a particular Finite Element computes the element mass matrix
@@ -10,6 +10,7 @@
 // CONTRIBUTING.md for details.
 
 #include "../general/forall.hpp"
+#include "../general/kernel_registry.hpp"
 #include "bilininteg.hpp"
 #include "gridfunc.hpp"
 
@@ -824,6 +825,53 @@ void ConvectionIntegrator::AssemblePA(const FiniteElementSpace &fes)
                      vel, alpha, pa_data);
 }
 
+typedef void (*ConvectionApplyKernel)(const int, const Array<double>&,
+                                      const Array<double>&,
+                                      const Array<double>&,
+                                      const Array<double>&,
+                                      const Vector&, const Vector&, Vector&,
+                                      const int, const int);
+
+// The (D1D,Q1D,NBZ) and (D1D,Q1D) specializations of the PA convection apply
+// kernels in 2D and 3D, see MFEM_PA_DIFFUSION_DIAGONAL_2D_KERNELS.
+#ifndef MFEM_PA_CONVECTION_APPLY_2D_KERNELS
+#define MFEM_PA_CONVECTION_APPLY_2D_KERNELS(X) \
+   X(2,2,8) X(3,3,3) X(4,4,2) X(5,5,2) X(6,6,1) X(7,7,1) X(8,8,1) X(9,9,1)
+#endif
+#ifndef MFEM_PA_CONVECTION_APPLY_3D_KERNELS
+#define MFEM_PA_CONVECTION_APPLY_3D_KERNELS(X) \
+   X(2,3) X(3,4) X(4,5) X(5,6) X(6,7) X(7,8) X(8,9)
+#endif
+
+// The SimdPA convection kernel with the signature of the registry.
+template <int DIM>
+static void SimdPAConvectionApply(const int NE, const Array<double> &B,
+                                  const Array<double> &G,
+                                  const Array<double> &,
+                                  const Array<double> &,
+                                  const Vector &op, const Vector &x, Vector &y,
+                                  const int D1D, const int Q1D)
+{
+   SimdPA::ConvectionApply(DIM, D1D, Q1D, NE, B, G, op, x, y);
+}
+
+struct ConvectionApplyKernels : KernelRegistry<ConvectionApplyKernel>
+{
+   ConvectionApplyKernels() : KernelRegistry("PAConvectionApply")
+   {
+#define MFEM_ADD_KERNEL_2D(D,Q,NBZ) Add(2,D,Q,SmemPAConvectionApply2D<D,Q,NBZ>);
+#define MFEM_ADD_KERNEL_3D(D,Q) Add(3,D,Q,SmemPAConvectionApply3D<D,Q>);
+      MFEM_PA_CONVECTION_APPLY_2D_KERNELS(MFEM_ADD_KERNEL_2D)
+      MFEM_PA_CONVECTION_APPLY_3D_KERNELS(MFEM_ADD_KERNEL_3D)
+#undef MFEM_ADD_KERNEL_2D
+#undef MFEM_ADD_KERNEL_3D
+      AddFallback(2, PAConvectionApply2D<>);
+      AddFallback(3, PAConvectionApply3D<>);
+      AddVectorized(2, SimdPAConvectionApply<2>);
+      AddVectorized(3, SimdPAConvectionApply<3>);
+   }
+};
+
 static void PAConvectionApply(const int dim,
                               const int D1D,
                               const int Q1D,
@@ -836,36 +884,9 @@ static void PAConvectionApply(const int dim,
                               const Vector &x,
                               Vector &y)
 {
-   if (dim == 2)
-   {
-      switch ((D1D << 4 ) | Q1D)
-      {
-         case 0x22: return SmemPAConvectionApply2D<2,2,8>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x33: return SmemPAConvectionApply2D<3,3,3>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x44: return SmemPAConvectionApply2D<4,4,2>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x55: return SmemPAConvectionApply2D<5,5,2>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x66: return SmemPAConvectionApply2D<6,6,1>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x77: return SmemPAConvectionApply2D<7,7,1>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x88: return SmemPAConvectionApply2D<8,8,1>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x99: return SmemPAConvectionApply2D<9,9,1>(NE,B,G,Bt,Gt,op,x,y);
-         default:   return PAConvectionApply2D(NE,B,G,Bt,Gt,op,x,y,D1D,Q1D);
-      }
-   }
-   else if (dim == 3)
-   {
-      switch ((D1D << 4 ) | Q1D)
-      {
-         case 0x23: return SmemPAConvectionApply3D<2,3>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x34: return SmemPAConvectionApply3D<3,4>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x45: return SmemPAConvectionApply3D<4,5>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x56: return SmemPAConvectionApply3D<5,6>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x67: return SmemPAConvectionApply3D<6,7>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x78: return SmemPAConvectionApply3D<7,8>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x89: return SmemPAConvectionApply3D<8,9>(NE,B,G,Bt,Gt,op,x,y);
-         default:   return PAConvectionApply3D(NE,B,G,Bt,Gt,op,x,y,D1D,Q1D);
-      }
-   }
-   MFEM_ABORT("Unknown kernel.");
+   static const ConvectionApplyKernels kernels;
+   kernels.Get(dim, D1D, Q1D, SimdPA::Enabled())(NE, B, G, Bt, Gt, op, x, y,
+                                                 D1D, Q1D);
 }
 
 // PA Convection Apply kernel
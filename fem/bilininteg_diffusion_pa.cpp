@@ -10,6 +10,7 @@
 // CONTRIBUTING.md for details.
 
 #include "../general/forall.hpp"
+#include "../general/kernel_registry.hpp"
 #include "bilininteg.hpp"
 #include "gridfunc.hpp"
 #include "libceed/diffusion.hpp"
@@ -355,8 +356,19 @@ void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
    fespace = &fes;
    Mesh *mesh = fes.GetMesh();
    if (mesh->GetNE() == 0) { return; }
+   if (mesh->GetNumGeometries(mesh->Dimension()) > 1)
+   {
+      return AssemblePABatches(fes);
+   }
+   PAElementBatch::DeleteBatches(pa_batches);
    const FiniteElement &el = *fes.GetFE(0);
    const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el);
+   if (IsSimplexPAGeometry(el.GetGeomType()))
+   {
+      return AssemblePASimplex(fes, *ir);
+   }
+   delete simplex_maps;
+   simplex_maps = NULL;
    if (DeviceCanUseCeed())
    {
       delete ceedDataPtr;
@@ -384,25 +396,11 @@ void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
 
       coeffDim = MQfullDim;
 
-      coeff.SetSize(MQfullDim * nq * ne);
-
-      DenseMatrix M;
-      M.SetSize(dim);
-
-      auto C = Reshape(coeff.HostWrite(), MQfullDim, nq, ne);
-      for (int e=0; e<ne; ++e)
-      {
-         ElementTransformation *tr = mesh->GetElementTransformation(e);
-         for (int p=0; p<nq; ++p)
-         {
-            MQ->Eval(M, *tr, ir->IntPoint(p));
-            for (int i=0; i<dim; ++i)
-               for (int j=0; j<dim; ++j)
-               {
-                  C(j+(i*dim), p, e) = M(i,j);
-               }
-         }
-      }
+      // The setup kernels expect the matrix in row-major order.
+      QuadratureSpace qs(mesh, *ir);
+      QuadratureFunction qf(&qs, MQfullDim);
+      MQ->Project(qf, true);
+      coeff.Swap(qf);
    }
    else if (SMQ)
    {
@@ -434,21 +432,10 @@ void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
    {
       MFEM_VERIFY(VQ->GetVDim() == dim, "");
       coeffDim = VQ->GetVDim();
-      coeff.SetSize(coeffDim * nq * ne);
-      auto C = Reshape(coeff.HostWrite(), coeffDim, nq, ne);
-      Vector D(coeffDim);
-      for (int e=0; e<ne; ++e)
-      {
-         ElementTransformation *tr = mesh->GetElementTransformation(e);
-         for (int p=0; p<nq; ++p)
-         {
-            VQ->Eval(D, *tr, ir->IntPoint(p));
-            for (int i=0; i<coeffDim; ++i)
-            {
-               C(i, p, e) = D[i];
-            }
-         }
-      }
+      QuadratureSpace qs(mesh, *ir);
+      QuadratureFunction qf(&qs, coeffDim);
+      VQ->Project(qf);
+      coeff.Swap(qf);
    }
    else if (Q == nullptr)
    {
@@ -475,16 +462,10 @@ void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
    }
    else
    {
-      coeff.SetSize(nq * ne);
-      auto C = Reshape(coeff.HostWrite(), nq, ne);
-      for (int e = 0; e < ne; ++e)
-      {
-         ElementTransformation& T = *fes.GetElementTransformation(e);
-         for (int q = 0; q < nq; ++q)
-         {
-            C(q,e) = Q->Eval(T, ir->IntPoint(q));
-         }
-      }
+      QuadratureSpace qs(mesh, *ir);
+      QuadratureFunction qf(&qs);
+      Q->Project(qf);
+      coeff.Swap(qf);
    }
    pa_data.SetSize((symmetric ? symmDims : MQfullDim) * nq * ne,
                    Device::GetDeviceMemoryType());
@@ -492,6 +473,48 @@ void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
                     geom->J, coeff, pa_data);
 }
 
+void DiffusionIntegrator::AssemblePABatches(const FiniteElementSpace &fes)
+{
+   MFEM_VERIFY(!DeviceCanUseCeed(), "libCEED does not support meshes with"
+               " more than one geometry");
+   MFEM_VERIFY(!VQ && !MQ && !SMQ, "PA on meshes with more than one geometry"
+               " supports only scalar coefficients");
+   Mesh *mesh = fes.GetMesh();
+   delete simplex_maps;
+   simplex_maps = NULL;
+   dim = mesh->Dimension();
+   ne = fes.GetNE();
+   symmetric = true;
+   geom = NULL;
+   maps = NULL;
+   const int symmDims = (dim * (dim + 1)) / 2;
+   PAElementBatch::MakeBatches(fes, pa_batches);
+   for (int b = 0; b < pa_batches.Size(); b++)
+   {
+      // A rule set with SetIntRule() is used for its order only, since it is
+      // defined on a single geometry.
+      PAElementBatch &batch = *pa_batches[b];
+      const FiniteElement &el = *batch.fe;
+      batch.SetIntRule(IntRule ? IntRule->GetOrder() :
+                       GetRule(el, el).GetOrder());
+      Vector J, coeff;
+      batch.GetJacobians(*mesh, J);
+      batch.GetCoefficient(Q, *mesh, coeff);
+      if (batch.simplex_maps)
+      {
+         batch.simplex_maps->DiffusionSetup(batch.ne, J, coeff, batch.pa_data);
+      }
+      else
+      {
+         const int nq = batch.ir->GetNPoints();
+         batch.pa_data.SetSize(symmDims * nq * batch.ne,
+                               Device::GetDeviceMemoryType());
+         PADiffusionSetup(dim, dim, batch.dofs1D, batch.quad1D, 1, batch.ne,
+                          batch.ir->GetWeights(), J, coeff, batch.pa_data);
+      }
+   }
+}
+
 template<int T_D1D = 0, int T_Q1D = 0>
 static void PADiffusionDiagonal2D(const int NE,
                                   const bool symmetric,
@@ -871,6 +894,40 @@ static void SmemPADiffusionDiagonal3D(const int NE,
    });
 }
 
+typedef void (*DiffusionDiagonalKernel)(const int, const bool,
+                                        const Array<double>&,
+                                        const Array<double>&,
+                                        const Vector&, Vector&,
+                                        const int, const int);
+
+// The (D1D,Q1D,NBZ) and (D1D,Q1D) specializations of the PA diffusion diagonal
+// kernels in 2D and 3D, which can be redefined at build time, for instance
+// with -D'MFEM_PA_DIFFUSION_DIAGONAL_3D_KERNELS(X)=X(6,7) X(6,8)'.
+#ifndef MFEM_PA_DIFFUSION_DIAGONAL_2D_KERNELS
+#define MFEM_PA_DIFFUSION_DIAGONAL_2D_KERNELS(X) \
+   X(2,2,8) X(3,3,8) X(4,4,4) X(5,5,4) X(6,6,2) X(7,7,2) X(8,8,1) X(9,9,1)
+#endif
+#ifndef MFEM_PA_DIFFUSION_DIAGONAL_3D_KERNELS
+#define MFEM_PA_DIFFUSION_DIAGONAL_3D_KERNELS(X) \
+   X(2,3) X(3,4) X(4,5) X(5,6) X(6,7) X(7,8) X(8,9) X(9,10)
+#endif
+
+struct DiffusionDiagonalKernels : KernelRegistry<DiffusionDiagonalKernel>
+{
+   DiffusionDiagonalKernels() : KernelRegistry("PADiffusionDiagonal")
+   {
+#define MFEM_ADD_KERNEL_2D(D,Q,NBZ) \
+   Add(2,D,Q,SmemPADiffusionDiagonal2D<D,Q,NBZ>);
+#define MFEM_ADD_KERNEL_3D(D,Q) Add(3,D,Q,SmemPADiffusionDiagonal3D<D,Q>);
+      MFEM_PA_DIFFUSION_DIAGONAL_2D_KERNELS(MFEM_ADD_KERNEL_2D)
+      MFEM_PA_DIFFUSION_DIAGONAL_3D_KERNELS(MFEM_ADD_KERNEL_3D)
+#undef MFEM_ADD_KERNEL_2D
+#undef MFEM_ADD_KERNEL_3D
+      AddFallback(2, PADiffusionDiagonal2D<>);
+      AddFallback(3, PADiffusionDiagonal3D<>);
+   }
+};
+
 static void PADiffusionAssembleDiagonal(const int dim,
                                         const int D1D,
                                         const int Q1D,
@@ -881,42 +938,37 @@ static void PADiffusionAssembleDiagonal(const int dim,
                                         const Vector &D,
                                         Vector &Y)
 {
-   if (dim == 2)
+   static const DiffusionDiagonalKernels kernels;
+   kernels.Get(dim, D1D, Q1D)(NE, symm, B, G, D, Y, D1D, Q1D);
+}
+
+void DiffusionIntegrator::AssembleDiagonalPA(Vector &diag)
+{
+   if (pa_batches.Size() > 0)
    {
-      switch ((D1D << 4 ) | Q1D)
+      for (int b = 0; b < pa_batches.Size(); b++)
       {
-         case 0x22: return SmemPADiffusionDiagonal2D<2,2,8>(NE,symm,B,G,D,Y);
-         case 0x33: return SmemPADiffusionDiagonal2D<3,3,8>(NE,symm,B,G,D,Y);
-         case 0x44: return SmemPADiffusionDiagonal2D<4,4,4>(NE,symm,B,G,D,Y);
-         case 0x55: return SmemPADiffusionDiagonal2D<5,5,4>(NE,symm,B,G,D,Y);
-         case 0x66: return SmemPADiffusionDiagonal2D<6,6,2>(NE,symm,B,G,D,Y);
-         case 0x77: return SmemPADiffusionDiagonal2D<7,7,2>(NE,symm,B,G,D,Y);
-         case 0x88: return SmemPADiffusionDiagonal2D<8,8,1>(NE,symm,B,G,D,Y);
-         case 0x99: return SmemPADiffusionDiagonal2D<9,9,1>(NE,symm,B,G,D,Y);
-         default: return PADiffusionDiagonal2D(NE,symm,B,G,D,Y,D1D,Q1D);
+         PAElementBatch &batch = *pa_batches[b];
+         Vector diag_b;
+         diag_b.MakeRef(diag, batch.offset, batch.size);
+         if (batch.simplex_maps)
+         {
+            batch.simplex_maps->DiffusionDiagonal(*batch.fe, batch.ne,
+                                                  batch.pa_data, diag_b);
+         }
+         else
+         {
+            PADiffusionAssembleDiagonal(dim, batch.dofs1D, batch.quad1D,
+                                        batch.ne, true, batch.maps->B,
+                                        batch.maps->G, batch.pa_data, diag_b);
+         }
       }
    }
-   else if (dim == 3)
+   else if (simplex_maps)
    {
-      switch ((D1D << 4 ) | Q1D)
-      {
-         case 0x23: return SmemPADiffusionDiagonal3D<2,3>(NE,symm,B,G,D,Y);
-         case 0x34: return SmemPADiffusionDiagonal3D<3,4>(NE,symm,B,G,D,Y);
-         case 0x45: return SmemPADiffusionDiagonal3D<4,5>(NE,symm,B,G,D,Y);
-         case 0x56: return SmemPADiffusionDiagonal3D<5,6>(NE,symm,B,G,D,Y);
-         case 0x67: return SmemPADiffusionDiagonal3D<6,7>(NE,symm,B,G,D,Y);
-         case 0x78: return SmemPADiffusionDiagonal3D<7,8>(NE,symm,B,G,D,Y);
-         case 0x89: return SmemPADiffusionDiagonal3D<8,9>(NE,symm,B,G,D,Y);
-         case 0x9A: return SmemPADiffusionDiagonal3D<9,10>(NE,symm,B,G,D,Y);
-         default: return PADiffusionDiagonal3D(NE,symm,B,G,D,Y,D1D,Q1D);
-      }
+      simplex_maps->DiffusionDiagonal(*fespace->GetFE(0), ne, pa_data, diag);
    }
-   MFEM_ABORT("Unknown kernel.");
-}
-
-void DiffusionIntegrator::AssembleDiagonalPA(Vector &diag)
-{
-   if (DeviceCanUseCeed())
+   else if (DeviceCanUseCeed())
    {
       CeedAssembleDiagonal(ceedDataPtr, diag);
    }
@@ -1157,12 +1209,16 @@ static void SmemPADiffusionApply2D(const int NE,
                                    const bool symmetric,
                                    const Array<double> &b_,
                                    const Array<double> &g_,
+                                   const Array<double> &bt_,
+                                   const Array<double> &gt_,
                                    const Vector &d_,
                                    const Vector &x_,
                                    Vector &y_,
                                    const int d1d = 0,
                                    const int q1d = 0)
 {
+   MFEM_CONTRACT_VAR(bt_);
+   MFEM_CONTRACT_VAR(gt_);
    const int D1D = T_D1D ? T_D1D : d1d;
    const int Q1D = T_Q1D ? T_Q1D : q1d;
    constexpr int NBZ = T_NBZ ? T_NBZ : 1;
@@ -1534,12 +1590,16 @@ static void SmemPADiffusionApply3D(const int NE,
                                    const bool symmetric,
                                    const Array<double> &b_,
                                    const Array<double> &g_,
+                                   const Array<double> &bt_,
+                                   const Array<double> &gt_,
                                    const Vector &d_,
                                    const Vector &x_,
                                    Vector &y_,
                                    const int d1d = 0,
                                    const int q1d = 0)
 {
+   MFEM_CONTRACT_VAR(bt_);
+   MFEM_CONTRACT_VAR(gt_);
    const int D1D = T_D1D ? T_D1D : d1d;
    const int Q1D = T_Q1D ? T_Q1D : q1d;
    constexpr int M1Q = T_Q1D ? T_Q1D : MAX_Q1D;
@@ -1823,6 +1883,55 @@ static void SmemPADiffusionApply3D(const int NE,
    });
 }
 
+typedef void (*DiffusionApplyKernel)(const int, const bool,
+                                     const Array<double>&,
+                                     const Array<double>&,
+                                     const Array<double>&,
+                                     const Array<double>&,
+                                     const Vector&, const Vector&, Vector&,
+                                     const int, const int);
+
+// The (D1D,Q1D,NBZ) and (D1D,Q1D) specializations of the PA diffusion apply
+// kernels in 2D and 3D, see MFEM_PA_DIFFUSION_DIAGONAL_2D_KERNELS.
+#ifndef MFEM_PA_DIFFUSION_APPLY_2D_KERNELS
+#define MFEM_PA_DIFFUSION_APPLY_2D_KERNELS(X) \
+   X(2,2,16) X(3,3,16) X(4,4,8) X(5,5,8) X(6,6,4) X(7,7,4) X(8,8,2) X(9,9,2)
+#endif
+#ifndef MFEM_PA_DIFFUSION_APPLY_3D_KERNELS
+#define MFEM_PA_DIFFUSION_APPLY_3D_KERNELS(X) \
+   X(2,3) X(3,4) X(4,5) X(4,6) X(5,6) X(5,8) X(6,7) X(7,8) X(8,9)
+#endif
+
+// The SimdPA diffusion kernel with the signature of the registry.
+template <int DIM>
+static void SimdPADiffusionApply(const int NE, const bool symm,
+                                 const Array<double> &B,
+                                 const Array<double> &G,
+                                 const Array<double> &,
+                                 const Array<double> &,
+                                 const Vector &D, const Vector &X, Vector &Y,
+                                 const int D1D, const int Q1D)
+{
+   SimdPA::DiffusionApply(DIM, D1D, Q1D, NE, symm, B, G, D, X, Y);
+}
+
+struct DiffusionApplyKernels : KernelRegistry<DiffusionApplyKernel>
+{
+   DiffusionApplyKernels() : KernelRegistry("PADiffusionApply")
+   {
+#define MFEM_ADD_KERNEL_2D(D,Q,NBZ) Add(2,D,Q,SmemPADiffusionApply2D<D,Q,NBZ>);
+#define MFEM_ADD_KERNEL_3D(D,Q) Add(3,D,Q,SmemPADiffusionApply3D<D,Q>);
+      MFEM_PA_DIFFUSION_APPLY_2D_KERNELS(MFEM_ADD_KERNEL_2D)
+      MFEM_PA_DIFFUSION_APPLY_3D_KERNELS(MFEM_ADD_KERNEL_3D)
+#undef MFEM_ADD_KERNEL_2D
+#undef MFEM_ADD_KERNEL_3D
+      AddFallback(2, PADiffusionApply2D<>);
+      AddFallback(3, PADiffusionApply3D<>);
+      AddVectorized(2, SimdPADiffusionApply<2>);
+      AddVectorized(3, SimdPADiffusionApply<3>);
+   }
+};
+
 static void PADiffusionApply(const int dim,
                              const int D1D,
                              const int Q1D,
@@ -1852,47 +1961,41 @@ static void PADiffusionApply(const int dim,
       MFEM_ABORT("OCCA PADiffusionApply unknown kernel!");
    }
 #endif // MFEM_USE_OCCA
-   const int ID = (D1D << 4) | Q1D;
+   static const DiffusionApplyKernels kernels;
+   kernels.Get(dim, D1D, Q1D, SimdPA::Enabled())(NE, symm, B, G, Bt, Gt, D, X,
+                                                 Y, D1D, Q1D);
+}
 
-   if (dim == 2)
+// PA Diffusion Apply kernel
+void DiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (pa_batches.Size() > 0)
    {
-      switch (ID)
+      // Each batch runs its own kernel on its part of the E-vectors.
+      for (int b = 0; b < pa_batches.Size(); b++)
       {
-         case 0x22: return SmemPADiffusionApply2D<2,2,16>(NE,symm,B,G,D,X,Y);
-         case 0x33: return SmemPADiffusionApply2D<3,3,16>(NE,symm,B,G,D,X,Y);
-         case 0x44: return SmemPADiffusionApply2D<4,4,8>(NE,symm,B,G,D,X,Y);
-         case 0x55: return SmemPADiffusionApply2D<5,5,8>(NE,symm,B,G,D,X,Y);
-         case 0x66: return SmemPADiffusionApply2D<6,6,4>(NE,symm,B,G,D,X,Y);
-         case 0x77: return SmemPADiffusionApply2D<7,7,4>(NE,symm,B,G,D,X,Y);
-         case 0x88: return SmemPADiffusionApply2D<8,8,2>(NE,symm,B,G,D,X,Y);
-         case 0x99: return SmemPADiffusionApply2D<9,9,2>(NE,symm,B,G,D,X,Y);
-         default:   return PADiffusionApply2D(NE,symm,B,G,Bt,Gt,D,X,Y,D1D,Q1D);
+         const PAElementBatch &batch = *pa_batches[b];
+         Vector x_b, y_b;
+         x_b.MakeRef(const_cast<Vector&>(x), batch.offset, batch.size);
+         y_b.MakeRef(y, batch.offset, batch.size);
+         if (batch.simplex_maps)
+         {
+            batch.simplex_maps->DiffusionApply(batch.ne, batch.pa_data,
+                                               x_b, y_b);
+         }
+         else
+         {
+            const DofToQuad &m = *batch.maps;
+            PADiffusionApply(dim, batch.dofs1D, batch.quad1D, batch.ne, true,
+                             m.B, m.G, m.Bt, m.Gt, batch.pa_data, x_b, y_b);
+         }
       }
    }
-
-   if (dim == 3)
+   else if (simplex_maps)
    {
-      switch (ID)
-      {
-         case 0x23: return SmemPADiffusionApply3D<2,3>(NE,symm,B,G,D,X,Y);
-         case 0x34: return SmemPADiffusionApply3D<3,4>(NE,symm,B,G,D,X,Y);
-         case 0x45: return SmemPADiffusionApply3D<4,5>(NE,symm,B,G,D,X,Y);
-         case 0x46: return SmemPADiffusionApply3D<4,6>(NE,symm,B,G,D,X,Y);
-         case 0x56: return SmemPADiffusionApply3D<5,6>(NE,symm,B,G,D,X,Y);
-         case 0x58: return SmemPADiffusionApply3D<5,8>(NE,symm,B,G,D,X,Y);
-         case 0x67: return SmemPADiffusionApply3D<6,7>(NE,symm,B,G,D,X,Y);
-         case 0x78: return SmemPADiffusionApply3D<7,8>(NE,symm,B,G,D,X,Y);
-         case 0x89: return SmemPADiffusionApply3D<8,9>(NE,symm,B,G,D,X,Y);
-         default:   return PADiffusionApply3D(NE,symm,B,G,Bt,Gt,D,X,Y,D1D,Q1D);
-      }
+      simplex_maps->DiffusionApply(ne, pa_data, x, y);
    }
-   MFEM_ABORT("Unknown kernel.");
-}
-
-// PA Diffusion Apply kernel
-void DiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
-{
-   if (DeviceCanUseCeed())
+   else if (DeviceCanUseCeed())
    {
       CeedAddMult(ceedDataPtr, x, y);
    }
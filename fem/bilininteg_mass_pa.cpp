@@ -10,6 +10,7 @@
 // CONTRIBUTING.md for details.
 
 #include "../general/forall.hpp"
+#include "../general/kernel_registry.hpp"
 #include "bilininteg.hpp"
 #include "gridfunc.hpp"
 #include "libceed/mass.hpp"
@@ -23,79 +24,26 @@ namespace mfem
 
 // PA Mass Assemble kernel
 
-void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
+// Compute the PA data of the mass integrator, (Q1D^dim x NE), from the weights
+// w, the Jacobians j and the coefficient coeff at the points of a tensor rule.
+static void PAMassSetup(const int dim,
+                        const int Q1D,
+                        const int NE,
+                        const Array<double> &w,
+                        const Vector &j,
+                        const Vector &coeff,
+                        Vector &d)
 {
-   // Assuming the same element type
-   fespace = &fes;
-   Mesh *mesh = fes.GetMesh();
-   if (mesh->GetNE() == 0) { return; }
-   const FiniteElement &el = *fes.GetFE(0);
-   ElementTransformation *T = mesh->GetElementTransformation(0);
-   const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el, *T);
-   if (DeviceCanUseCeed())
-   {
-      delete ceedDataPtr;
-      ceedDataPtr = new CeedData;
-      InitCeedCoeff(Q, *mesh, *ir, ceedDataPtr);
-      return CeedPAMassAssemble(fes, *ir, *ceedDataPtr);
-   }
-   dim = mesh->Dimension();
-   ne = fes.GetMesh()->GetNE();
-   nq = ir->GetNPoints();
-   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::COORDINATES |
-                                    GeometricFactors::JACOBIANS);
-   maps = &el.GetDofToQuad(*ir, DofToQuad::TENSOR);
-   dofs1D = maps->ndof;
-   quad1D = maps->nqpt;
-   pa_data.SetSize(ne*nq, Device::GetDeviceMemoryType());
-   Vector coeff;
-   if (Q == nullptr)
-   {
-      coeff.SetSize(1);
-      coeff(0) = 1.0;
-   }
-   else if (ConstantCoefficient* cQ = dynamic_cast<ConstantCoefficient*>(Q))
-   {
-      coeff.SetSize(1);
-      coeff(0) = cQ->constant;
-   }
-   else if (QuadratureFunctionCoefficient* cQ =
-               dynamic_cast<QuadratureFunctionCoefficient*>(Q))
-   {
-      const QuadratureFunction &qFun = cQ->GetQuadFunction();
-      MFEM_VERIFY(qFun.Size() == nq * ne,
-                  "Incompatible QuadratureFunction dimension \n");
-
-      MFEM_VERIFY(ir == &qFun.GetSpace()->GetElementIntRule(0),
-                  "IntegrationRule used within integrator and in"
-                  " QuadratureFunction appear to be different");
-      qFun.Read();
-      coeff.MakeRef(const_cast<QuadratureFunction &>(qFun),0);
-   }
-   else
-   {
-      coeff.SetSize(nq * ne);
-      auto C = Reshape(coeff.HostWrite(), nq, ne);
-      for (int e = 0; e < ne; ++e)
-      {
-         ElementTransformation& T = *fes.GetElementTransformation(e);
-         for (int q = 0; q < nq; ++q)
-         {
-            C(q,e) = Q->Eval(T, ir->IntPoint(q));
-         }
-      }
-   }
+   d.SetSize(w.Size()*NE, Device::GetDeviceMemoryType());
    if (dim==1) { MFEM_ABORT("Not supported yet... stay tuned!"); }
    if (dim==2)
    {
-      const int NE = ne;
-      const int Q1D = quad1D;
       const bool const_c = coeff.Size() == 1;
-      const auto W = Reshape(ir->GetWeights().Read(), Q1D,Q1D);
-      const auto J = Reshape(geom->J.Read(), Q1D,Q1D,2,2,NE);
+      const auto W = Reshape(w.Read(), Q1D,Q1D);
+      const auto J = Reshape(j.Read(), Q1D,Q1D,2,2,NE);
       const auto C = const_c ? Reshape(coeff.Read(), 1,1,1) :
                      Reshape(coeff.Read(), Q1D,Q1D,NE);
-      auto v = Reshape(pa_data.Write(), Q1D,Q1D, NE);
+      auto v = Reshape(d.Write(), Q1D,Q1D, NE);
       MFEM_FORALL_2D(e, NE, Q1D,Q1D,1,
       {
          MFEM_FOREACH_THREAD(qx,x,Q1D)
@@ -115,14 +63,12 @@ void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
    }
    if (dim==3)
    {
-      const int NE = ne;
-      const int Q1D = quad1D;
       const bool const_c = coeff.Size() == 1;
-      const auto W = Reshape(ir->GetWeights().Read(), Q1D,Q1D,Q1D);
-      const auto J = Reshape(geom->J.Read(), Q1D,Q1D,Q1D,3,3,NE);
+      const auto W = Reshape(w.Read(), Q1D,Q1D,Q1D);
+      const auto J = Reshape(j.Read(), Q1D,Q1D,Q1D,3,3,NE);
       const auto C = const_c ? Reshape(coeff.Read(), 1,1,1,1) :
                      Reshape(coeff.Read(), Q1D,Q1D,Q1D,NE);
-      auto v = Reshape(pa_data.Write(), Q1D,Q1D,Q1D,NE);
+      auto v = Reshape(d.Write(), Q1D,Q1D,Q1D,NE);
       MFEM_FORALL_3D(e, NE, Q1D, Q1D, Q1D,
       {
          MFEM_FOREACH_THREAD(qx,x,Q1D)
@@ -152,6 +98,112 @@ void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
    }
 }
 
+void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   // Assuming the same element type
+   fespace = &fes;
+   Mesh *mesh = fes.GetMesh();
+   if (mesh->GetNE() == 0) { return; }
+   if (mesh->GetNumGeometries(mesh->Dimension()) > 1)
+   {
+      return AssemblePABatches(fes);
+   }
+   PAElementBatch::DeleteBatches(pa_batches);
+   const FiniteElement &el = *fes.GetFE(0);
+   ElementTransformation *T = mesh->GetElementTransformation(0);
+   const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el, *T);
+   if (IsSimplexPAGeometry(el.GetGeomType()))
+   {
+      return AssemblePASimplex(fes, *ir);
+   }
+   delete simplex_maps;
+   simplex_maps = NULL;
+   if (DeviceCanUseCeed())
+   {
+      delete ceedDataPtr;
+      ceedDataPtr = new CeedData;
+      InitCeedCoeff(Q, *mesh, *ir, ceedDataPtr);
+      return CeedPAMassAssemble(fes, *ir, *ceedDataPtr);
+   }
+   dim = mesh->Dimension();
+   ne = fes.GetMesh()->GetNE();
+   nq = ir->GetNPoints();
+   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::COORDINATES |
+                                    GeometricFactors::JACOBIANS);
+   maps = &el.GetDofToQuad(*ir, DofToQuad::TENSOR);
+   dofs1D = maps->ndof;
+   quad1D = maps->nqpt;
+   Vector coeff;
+   if (Q == nullptr)
+   {
+      coeff.SetSize(1);
+      coeff(0) = 1.0;
+   }
+   else if (ConstantCoefficient* cQ = dynamic_cast<ConstantCoefficient*>(Q))
+   {
+      coeff.SetSize(1);
+      coeff(0) = cQ->constant;
+   }
+   else if (QuadratureFunctionCoefficient* cQ =
+               dynamic_cast<QuadratureFunctionCoefficient*>(Q))
+   {
+      const QuadratureFunction &qFun = cQ->GetQuadFunction();
+      MFEM_VERIFY(qFun.Size() == nq * ne,
+                  "Incompatible QuadratureFunction dimension \n");
+
+      MFEM_VERIFY(ir == &qFun.GetSpace()->GetElementIntRule(0),
+                  "IntegrationRule used within integrator and in"
+                  " QuadratureFunction appear to be different");
+      qFun.Read();
+      coeff.MakeRef(const_cast<QuadratureFunction &>(qFun),0);
+   }
+   else
+   {
+      QuadratureSpace qs(mesh, *ir);
+      QuadratureFunction qf(&qs);
+      Q->Project(qf);
+      coeff.Swap(qf);
+   }
+   PAMassSetup(dim, quad1D, ne, ir->GetWeights(), geom->J, coeff, pa_data);
+}
+
+void MassIntegrator::AssemblePABatches(const FiniteElementSpace &fes)
+{
+   MFEM_VERIFY(!DeviceCanUseCeed(), "libCEED does not support meshes with"
+               " more than one geometry");
+   Mesh *mesh = fes.GetMesh();
+   delete simplex_maps;
+   simplex_maps = NULL;
+   dim = mesh->Dimension();
+   ne = fes.GetNE();
+   geom = NULL;
+   maps = NULL;
+   PAElementBatch::MakeBatches(fes, pa_batches);
+   for (int b = 0; b < pa_batches.Size(); b++)
+   {
+      // A rule set with SetIntRule() is used for its order only, since it is
+      // defined on a single geometry.
+      PAElementBatch &batch = *pa_batches[b];
+      const FiniteElement &el = *batch.fe;
+      ElementTransformation &T =
+         *mesh->GetElementTransformation(batch.elements[0]);
+      batch.SetIntRule(IntRule ? IntRule->GetOrder() :
+                       GetRule(el, el, T).GetOrder());
+      Vector J, coeff;
+      batch.GetJacobians(*mesh, J);
+      batch.GetCoefficient(Q, *mesh, coeff);
+      if (batch.simplex_maps)
+      {
+         batch.simplex_maps->MassSetup(batch.ne, J, coeff, batch.pa_data);
+      }
+      else
+      {
+         PAMassSetup(dim, batch.quad1D, batch.ne, batch.ir->GetWeights(), J,
+                     coeff, batch.pa_data);
+      }
+   }
+}
+
 template<int T_D1D = 0, int T_Q1D = 0>
 static void PAMassAssembleDiagonal2D(const int NE,
                                      const Array<double> &b,
@@ -419,47 +471,74 @@ static void SmemPAMassAssembleDiagonal3D(const int NE,
    });
 }
 
+typedef void (*MassDiagonalKernel)(const int, const Array<double>&,
+                                   const Vector&, Vector&,
+                                   const int, const int);
+
+// The (D1D,Q1D,NBZ) and (D1D,Q1D) specializations of the PA mass diagonal
+// kernels in 2D and 3D, which can be redefined at build time, for instance
+// with -D'MFEM_PA_MASS_DIAGONAL_3D_KERNELS(X)=X(6,7) X(6,8)'.
+#ifndef MFEM_PA_MASS_DIAGONAL_2D_KERNELS
+#define MFEM_PA_MASS_DIAGONAL_2D_KERNELS(X) \
+   X(2,2,16) X(3,3,16) X(4,4,8) X(5,5,8) X(6,6,4) X(7,7,4) X(8,8,2) X(9,9,2)
+#endif
+#ifndef MFEM_PA_MASS_DIAGONAL_3D_KERNELS
+#define MFEM_PA_MASS_DIAGONAL_3D_KERNELS(X) \
+   X(2,3) X(3,4) X(4,5) X(5,6) X(6,7) X(7,8) X(8,9)
+#endif
+
+struct MassDiagonalKernels : KernelRegistry<MassDiagonalKernel>
+{
+   MassDiagonalKernels() : KernelRegistry("PAMassDiagonal")
+   {
+#define MFEM_ADD_KERNEL_2D(D,Q,NBZ) \
+   Add(2,D,Q,SmemPAMassAssembleDiagonal2D<D,Q,NBZ>);
+#define MFEM_ADD_KERNEL_3D(D,Q) Add(3,D,Q,SmemPAMassAssembleDiagonal3D<D,Q>);
+      MFEM_PA_MASS_DIAGONAL_2D_KERNELS(MFEM_ADD_KERNEL_2D)
+      MFEM_PA_MASS_DIAGONAL_3D_KERNELS(MFEM_ADD_KERNEL_3D)
+#undef MFEM_ADD_KERNEL_2D
+#undef MFEM_ADD_KERNEL_3D
+      AddFallback(2, PAMassAssembleDiagonal2D<>);
+      AddFallback(3, PAMassAssembleDiagonal3D<>);
+   }
+};
+
 static void PAMassAssembleDiagonal(const int dim, const int D1D,
                                    const int Q1D, const int NE,
                                    const Array<double> &B,
                                    const Vector &D,
                                    Vector &Y)
 {
-   if (dim == 2)
+   static const MassDiagonalKernels kernels;
+   kernels.Get(dim, D1D, Q1D)(NE, B, D, Y, D1D, Q1D);
+}
+
+void MassIntegrator::AssembleDiagonalPA(Vector &diag)
+{
+   if (pa_batches.Size() > 0)
    {
-      switch ((D1D << 4 ) | Q1D)
+      for (int b = 0; b < pa_batches.Size(); b++)
       {
-         case 0x22: return SmemPAMassAssembleDiagonal2D<2,2,16>(NE,B,D,Y);
-         case 0x33: return SmemPAMassAssembleDiagonal2D<3,3,16>(NE,B,D,Y);
-         case 0x44: return SmemPAMassAssembleDiagonal2D<4,4,8>(NE,B,D,Y);
-         case 0x55: return SmemPAMassAssembleDiagonal2D<5,5,8>(NE,B,D,Y);
-         case 0x66: return SmemPAMassAssembleDiagonal2D<6,6,4>(NE,B,D,Y);
-         case 0x77: return SmemPAMassAssembleDiagonal2D<7,7,4>(NE,B,D,Y);
-         case 0x88: return SmemPAMassAssembleDiagonal2D<8,8,2>(NE,B,D,Y);
-         case 0x99: return SmemPAMassAssembleDiagonal2D<9,9,2>(NE,B,D,Y);
-         default:   return PAMassAssembleDiagonal2D(NE,B,D,Y,D1D,Q1D);
+         PAElementBatch &batch = *pa_batches[b];
+         Vector diag_b;
+         diag_b.MakeRef(diag, batch.offset, batch.size);
+         if (batch.simplex_maps)
+         {
+            batch.simplex_maps->MassDiagonal(*batch.fe, batch.ne,
+                                             batch.pa_data, diag_b);
+         }
+         else
+         {
+            PAMassAssembleDiagonal(dim, batch.dofs1D, batch.quad1D, batch.ne,
+                                   batch.maps->B, batch.pa_data, diag_b);
+         }
       }
    }
-   else if (dim == 3)
+   else if (simplex_maps)
    {
-      switch ((D1D << 4 ) | Q1D)
-      {
-         case 0x23: return SmemPAMassAssembleDiagonal3D<2,3>(NE,B,D,Y);
-         case 0x34: return SmemPAMassAssembleDiagonal3D<3,4>(NE,B,D,Y);
-         case 0x45: return SmemPAMassAssembleDiagonal3D<4,5>(NE,B,D,Y);
-         case 0x56: return SmemPAMassAssembleDiagonal3D<5,6>(NE,B,D,Y);
-         case 0x67: return SmemPAMassAssembleDiagonal3D<6,7>(NE,B,D,Y);
-         case 0x78: return SmemPAMassAssembleDiagonal3D<7,8>(NE,B,D,Y);
-         case 0x89: return SmemPAMassAssembleDiagonal3D<8,9>(NE,B,D,Y);
-         default:   return PAMassAssembleDiagonal3D(NE,B,D,Y,D1D,Q1D);
-      }
+      simplex_maps->MassDiagonal(*fespace->GetFE(0), ne, pa_data, diag);
    }
-   MFEM_ABORT("Unknown kernel.");
-}
-
-void MassIntegrator::AssembleDiagonalPA(Vector &diag)
-{
-   if (DeviceCanUseCeed())
+   else if (DeviceCanUseCeed())
    {
       CeedAssembleDiagonal(ceedDataPtr, diag);
    }
@@ -1145,6 +1224,51 @@ static void SmemPAMassApply3D(const int NE,
    });
 }
 
+typedef void (*MassApplyKernel)(const int, const Array<double>&,
+                                const Array<double>&, const Vector&,
+                                const Vector&, Vector&,
+                                const int, const int);
+
+// The (D1D,Q1D,NBZ) and (D1D,Q1D) specializations of the PA mass apply kernels
+// in 2D and 3D, see MFEM_PA_MASS_DIAGONAL_2D_KERNELS.
+#ifndef MFEM_PA_MASS_APPLY_2D_KERNELS
+#define MFEM_PA_MASS_APPLY_2D_KERNELS(X) \
+   X(2,2,16) X(2,4,16) X(3,3,16) X(3,4,16) X(3,6,16) X(4,4,8) X(4,8,4) \
+   X(5,5,8) X(5,8,2) X(6,6,4) X(7,7,4) X(8,8,2) X(9,9,2)
+#endif
+#ifndef MFEM_PA_MASS_APPLY_3D_KERNELS
+#define MFEM_PA_MASS_APPLY_3D_KERNELS(X) \
+   X(2,3) X(2,4) X(3,4) X(3,6) X(4,5) X(4,6) X(4,8) X(5,6) X(5,8) X(6,7) \
+   X(7,8) X(8,9) X(9,10)
+#endif
+
+// The SimdPA mass kernel with the signature of the registry.
+template <int DIM>
+static void SimdPAMassApply(const int NE, const Array<double> &B,
+                            const Array<double> &, const Vector &D,
+                            const Vector &X, Vector &Y,
+                            const int D1D, const int Q1D)
+{
+   SimdPA::MassApply(DIM, D1D, Q1D, NE, 1, B, D, X, Y);
+}
+
+struct MassApplyKernels : KernelRegistry<MassApplyKernel>
+{
+   MassApplyKernels() : KernelRegistry("PAMassApply")
+   {
+#define MFEM_ADD_KERNEL_2D(D,Q,NBZ) Add(2,D,Q,SmemPAMassApply2D<D,Q,NBZ>);
+#define MFEM_ADD_KERNEL_3D(D,Q) Add(3,D,Q,SmemPAMassApply3D<D,Q>);
+      MFEM_PA_MASS_APPLY_2D_KERNELS(MFEM_ADD_KERNEL_2D)
+      MFEM_PA_MASS_APPLY_3D_KERNELS(MFEM_ADD_KERNEL_3D)
+#undef MFEM_ADD_KERNEL_2D
+#undef MFEM_ADD_KERNEL_3D
+      AddFallback(2, PAMassApply2D<>);
+      AddFallback(3, PAMassApply3D<>);
+      AddVectorized(2, SimdPAMassApply<2>);
+      AddVectorized(3, SimdPAMassApply<3>);
+   }
+};
+
 static void PAMassApply(const int dim,
                         const int D1D,
                         const int Q1D,
@@ -1169,54 +1293,37 @@ static void PAMassApply(const int dim,
       MFEM_ABORT("OCCA PA Mass Apply unknown kernel!");
    }
 #endif // MFEM_USE_OCCA
-   const int id = (D1D << 4) | Q1D;
-   if (dim == 2)
+   static const MassApplyKernels kernels;
+   kernels.Get(dim, D1D, Q1D, SimdPA::Enabled())(NE, B, Bt, D, X, Y, D1D, Q1D);
+}
+
+void MassIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (pa_batches.Size() > 0)
    {
-      switch (id)
+      // Each batch runs its own kernel on its part of the E-vectors.
+      for (int b = 0; b < pa_batches.Size(); b++)
       {
-         case 0x22: return SmemPAMassApply2D<2,2,16>(NE,B,Bt,D,X,Y);
-         case 0x24: return SmemPAMassApply2D<2,4,16>(NE,B,Bt,D,X,Y);
-         case 0x33: return SmemPAMassApply2D<3,3,16>(NE,B,Bt,D,X,Y);
-         case 0x34: return SmemPAMassApply2D<3,4,16>(NE,B,Bt,D,X,Y);
-         case 0x36: return SmemPAMassApply2D<3,6,16>(NE,B,Bt,D,X,Y);
-         case 0x44: return SmemPAMassApply2D<4,4,8>(NE,B,Bt,D,X,Y);
-         case 0x48: return SmemPAMassApply2D<4,8,4>(NE,B,Bt,D,X,Y);
-         case 0x55: return SmemPAMassApply2D<5,5,8>(NE,B,Bt,D,X,Y);
-         case 0x58: return SmemPAMassApply2D<5,8,2>(NE,B,Bt,D,X,Y);
-         case 0x66: return SmemPAMassApply2D<6,6,4>(NE,B,Bt,D,X,Y);
-         case 0x77: return SmemPAMassApply2D<7,7,4>(NE,B,Bt,D,X,Y);
-         case 0x88: return SmemPAMassApply2D<8,8,2>(NE,B,Bt,D,X,Y);
-         case 0x99: return SmemPAMassApply2D<9,9,2>(NE,B,Bt,D,X,Y);
-         default:   return PAMassApply2D(NE,B,Bt,D,X,Y,D1D,Q1D);
+         const PAElementBatch &batch = *pa_batches[b];
+         Vector x_b, y_b;
+         x_b.MakeRef(const_cast<Vector&>(x), batch.offset, batch.size);
+         y_b.MakeRef(y, batch.offset, batch.size);
+         if (batch.simplex_maps)
+         {
+            batch.simplex_maps->MassApply(batch.ne, batch.pa_data, x_b, y_b);
+         }
+         else
+         {
+            PAMassApply(dim, batch.dofs1D, batch.quad1D, batch.ne,
+                        batch.maps->B, batch.maps->Bt, batch.pa_data, x_b, y_b);
+         }
       }
    }
-   else if (dim == 3)
+   else if (simplex_maps)
    {
-      switch (id)
-      {
-         case 0x23: return SmemPAMassApply3D<2,3>(NE,B,Bt,D,X,Y);
-         case 0x24: return SmemPAMassApply3D<2,4>(NE,B,Bt,D,X,Y);
-         case 0x34: return SmemPAMassApply3D<3,4>(NE,B,Bt,D,X,Y);
-         case 0x36: return SmemPAMassApply3D<3,6>(NE,B,Bt,D,X,Y);
-         case 0x45: return SmemPAMassApply3D<4,5>(NE,B,Bt,D,X,Y);
-         case 0x46: return SmemPAMassApply3D<4,6>(NE,B,Bt,D,X,Y);
-         case 0x48: return SmemPAMassApply3D<4,8>(NE,B,Bt,D,X,Y);
-         case 0x56: return SmemPAMassApply3D<5,6>(NE,B,Bt,D,X,Y);
-         case 0x58: return SmemPAMassApply3D<5,8>(NE,B,Bt,D,X,Y);
-         case 0x67: return SmemPAMassApply3D<6,7>(NE,B,Bt,D,X,Y);
-         case 0x78: return SmemPAMassApply3D<7,8>(NE,B,Bt,D,X,Y);
-         case 0x89: return SmemPAMassApply3D<8,9>(NE,B,Bt,D,X,Y);
-         case 0x9A: return SmemPAMassApply3D<9,10>(NE,B,Bt,D,X,Y);
-         default:   return PAMassApply3D(NE,B,Bt,D,X,Y,D1D,Q1D);
-      }
+      simplex_maps->MassApply(ne, pa_data, x, y);
    }
-   mfem::out << "Unknown kernel 0x" << std::hex << id << std::endl;
-   MFEM_ABORT("Unknown kernel.");
-}
-
-void MassIntegrator::AddMultPA(const Vector &x, Vector &y) const
-{
-   if (DeviceCanUseCeed())
+   else if (DeviceCanUseCeed())
    {
       CeedAddMult(ceedDataPtr, x, y);
    }
@@ -0,0 +1,297 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "../general/forall.hpp"
+#include "../linalg/simd.hpp"
+#include "bilininteg.hpp"
+
+#include <algorithm>
+
+namespace mfem
+{
+
+// Host PA kernels vectorized across elements
+
+typedef AutoSIMDTraits<double,double>::vreal_t vreal_t;
+static constexpr int SS = AutoSIMDTraits<double,double>::simd_size;
+
+bool SimdPA::enabled = (SS > 1);
+
+int SimdPA::Width() { return SS; }
+
+bool SimdPA::Enabled()
+{
+   const unsigned long non_cpu = ~static_cast<unsigned long>(Backend::CPU);
+   return enabled && !Device::Allows(non_cpu);
+}
+
+// Contraction along the fastest index: w(r,i) = sum_a M(i,a) u(a,r), where M
+// is (m x n), u is (n x R) and w is (R x m). With TRANS, M is (n x m) and
+// M(a,i) is used instead. With ADD, the result is added to w. Applying one
+// contraction per dimension brings the indices back in their original order,
+// e.g. u(dx,dy,dz) -> (dy,dz,qx) -> (dz,qx,qy) -> (qx,qy,qz).
+template <bool TRANS, bool ADD>
+static void Contract(const int m, const int n, const int R, const double *M,
+                     const vreal_t *u, vreal_t *w)
+{
+   for (int i = 0; i < m; i++)
+   {
+      vreal_t *wi = w + R*i;
+      for (int r = 0; r < R; r++)
+      {
+         const vreal_t *ur = u + n*r;
+         vreal_t s;
+         s = 0.0;
+         for (int a = 0; a < n; a++)
+         {
+            s.fma(ur[a], TRANS ? M[a + n*i] : M[i + m*a]);
+         }
+         if (ADD) { wi[r] += s; }
+         else { wi[r] = s; }
+      }
+   }
+}
+
+// Copy the entries x[i + stride*e], 0 <= i < n, of the ns <= SS elements
+// e0 <= e < e0 + ns to the lanes of u[i], padding the other lanes with zeros.
+static void Gather(const int n, const int stride, const int e0, const int ns,
+                   const double *x, vreal_t *u)
+{
+   for (int l = 0; l < SS; l++)
+   {
+      const double *xl = x + stride*(e0 + l);
+      for (int i = 0; i < n; i++) { u[i][l] = (l < ns) ? xl[i] : 0.0; }
+   }
+}
+
+// Add the lanes of u[i] to y[i + stride*e], the reverse of Gather().
+static void ScatterAdd(const int n, const int stride, const int e0,
+                       const int ns, const vreal_t *u, double *y)
+{
+   for (int l = 0; l < ns; l++)
+   {
+      double *yl = y + stride*(e0 + l);
+      for (int i = 0; i < n; i++) { yl[i] += u[i][l]; }
+   }
+}
+
+// Work space of the kernels: nbuf buffers of max(D1D,Q1D)^dim entries.
+class SimdPAWork
+{
+   Vector data;
+   int size;
+
+public:
+   SimdPAWork(const int dim, const int D1D, const int Q1D, const int nbuf)
+   {
+      const int M = std::max(D1D, Q1D);
+      size = (dim == 2) ? M*M : M*M*M;
+      data.SetSize(nbuf*size*SS, MemoryType::HOST_64);
+   }
+
+   vreal_t *operator[](int i)
+   { return reinterpret_cast<vreal_t*>(data.HostReadWrite()) + size*i; }
+};
+
+// u <- B u in dim dimensions, from D1D^dim to Q1D^dim values, using w as
+// work space, or u <- B^T u from Q1D^dim to D1D^dim values with TRANS.
+template <bool TRANS>
+static void Interp(const int dim, const int D1D, const int Q1D,
+                   const double *B, vreal_t *u, vreal_t *w)
+{
+   const int m = TRANS ? D1D : Q1D, n = TRANS ? Q1D : D1D;
+   // R = n^(dim-1-k) m^k values along the other dimensions at step k.
+   for (int k = 0, R = (dim == 2) ? n : n*n; k < dim; k++, R = R/n*m)
+   {
+      Contract<TRANS,false>(m, n, R, B, (k % 2) ? w : u, (k % 2) ? u : w);
+   }
+   if (dim % 2) { std::copy(w, w + m*m*m, u); }
+}
+
+// The gradient g[j] at the quadrature points of u, from the maps B and G, with
+// t[0..4] as work space.
+static void Grad(const int dim, const int D1D, const int Q1D,
+                 const double *B, const double *G, const vreal_t *u,
+                 vreal_t **t, vreal_t **g)
+{
+   const int D = D1D, Q = Q1D;
+   if (dim == 2)
+   {
+      Contract<false,false>(Q, D, D, B, u, t[0]);
+      Contract<false,false>(Q, D, D, G, u, t[1]);
+      Contract<false,false>(Q, D, Q, B, t[1], g[0]);
+      Contract<false,false>(Q, D, Q, G, t[0], g[1]);
+      return;
+   }
+   // t: B_x u, G_x u, B_y B_x u, G_y B_x u, B_y G_x u
+   Contract<false,false>(Q, D, D*D, B, u, t[0]);
+   Contract<false,false>(Q, D, D*D, G, u, t[1]);
+   Contract<false,false>(Q, D, D*Q, B, t[0], t[2]);
+   Contract<false,false>(Q, D, D*Q, G, t[0], t[3]);
+   Contract<false,false>(Q, D, D*Q, B, t[1], t[4]);
+   Contract<false,false>(Q, D, Q*Q, B, t[4], g[0]);
+   Contract<false,false>(Q, D, Q*Q, B, t[3], g[1]);
+   Contract<false,false>(Q, D, Q*Q, G, t[2], g[2]);
+}
+
+// y = sum_j G_j^T q[j], the transpose of Grad(), with t[0..4] as work space.
+static void GradT(const int dim, const int D1D, const int Q1D,
+                  const double *B, const double *G, vreal_t **q,
+                  vreal_t **t, vreal_t *y)
+{
+   const int D = D1D, Q = Q1D;
+   if (dim == 2)
+   {
+      Contract<true,false>(D, Q, Q, G, q[0], t[0]);
+      Contract<true,false>(D, Q, Q, B, q[1], t[1]);
+      Contract<true,false>(D, Q, D, B, t[0], y);
+      Contract<true,true>(D, Q, D, G, t[1], y);
+      return;
+   }
+   Contract<true,false>(D, Q, Q*Q, G, q[0], t[0]);
+   Contract<true,false>(D, Q, Q*Q, B, q[1], t[1]);
+   Contract<true,false>(D, Q, Q*Q, B, q[2], t[2]);
+   Contract<true,false>(D, Q, Q*D, B, t[0], t[3]);
+   Contract<true,true>(D, Q, Q*D, G, t[1], t[3]);
+   Contract<true,false>(D, Q, Q*D, B, t[2], t[4]);
+   Contract<true,false>(D, Q, D*D, B, t[3], y);
+   Contract<true,true>(D, Q, D*D, G, t[4], y);
+}
+
+void SimdPA::MassApply(const int dim, const int D1D, const int Q1D,
+                       const int NE, const int vdim,
+                       const Array<double> &B, const Vector &D,
+                       const Vector &X, Vector &Y)
+{
+   MFEM_VERIFY(dim == 2 || dim == 3, "dim = " << dim << " is not supported");
+   const int ND = (dim == 2) ? D1D*D1D : D1D*D1D*D1D;
+   const int NQ = (dim == 2) ? Q1D*Q1D : Q1D*Q1D*Q1D;
+   const double *b = B.HostRead();
+   const double *d = D.HostRead();
+   const double *x = X.HostRead();
+   double *y = Y.HostReadWrite();
+   SimdPAWork work(dim, D1D, Q1D, 3);
+   vreal_t *u = work[0], *w = work[1], *op = work[2];
+   for (int e0 = 0; e0 < NE; e0 += SS)
+   {
+      const int ns = std::min(SS, NE - e0);
+      Gather(NQ, NQ, e0, ns, d, op);
+      for (int c = 0; c < vdim; c++)
+      {
+         Gather(ND, ND*vdim, e0, ns, x + ND*c, u);
+         Interp<false>(dim, D1D, Q1D, b, u, w);
+         for (int q = 0; q < NQ; q++) { u[q] *= op[q]; }
+         Interp<true>(dim, D1D, Q1D, b, u, w);
+         ScatterAdd(ND, ND*vdim, e0, ns, u, y + ND*c);
+      }
+   }
+}
+
+void SimdPA::DiffusionApply(const int dim, const int D1D, const int Q1D,
+                            const int NE, const bool symm,
+                            const Array<double> &B, const Array<double> &G,
+                            const Vector &D, const Vector &X, Vector &Y)
+{
+   MFEM_VERIFY(dim == 2 || dim == 3, "dim = " << dim << " is not supported");
+   const int ND = (dim == 2) ? D1D*D1D : D1D*D1D*D1D;
+   const int NQ = (dim == 2) ? Q1D*Q1D : Q1D*Q1D*Q1D;
+   const int ncomp = symm ? dim*(dim+1)/2 : dim*dim;
+   // Index of the entry (j,k) of the matrix at each point in the PA data, see
+   // PADiffusionSetup(): symmetric matrices store the upper triangle by rows,
+   // other matrices are stored by columns in 2D and by rows in 3D.
+   int idx[3][3];
+   for (int j = 0, s = 0; j < dim; j++)
+   {
+      for (int k = 0; k < dim; k++)
+      {
+         if (symm) { idx[j][k] = (k < j) ? idx[k][j] : s++; }
+         else { idx[j][k] = (dim == 2) ? j + 2*k : 3*j + k; }
+      }
+   }
+   const double *b = B.HostRead();
+   const double *g = G.HostRead();
+   const double *d = D.HostRead();
+   const double *x = X.HostRead();
+   double *y = Y.HostReadWrite();
+   SimdPAWork work(dim, D1D, Q1D, 1 + 5 + 2*dim + ncomp);
+   vreal_t *u = work[0], *t[5], *gq[3], *qq[3], *op[9];
+   for (int i = 0; i < 5; i++) { t[i] = work[1 + i]; }
+   for (int j = 0; j < dim; j++)
+   {
+      gq[j] = work[6 + j];
+      qq[j] = work[6 + dim + j];
+   }
+   for (int k = 0; k < ncomp; k++) { op[k] = work[6 + 2*dim + k]; }
+   for (int e0 = 0; e0 < NE; e0 += SS)
+   {
+      const int ns = std::min(SS, NE - e0);
+      for (int k = 0; k < ncomp; k++)
+      {
+         Gather(NQ, NQ*ncomp, e0, ns, d + NQ*k, op[k]);
+      }
+      Gather(ND, ND, e0, ns, x, u);
+      Grad(dim, D1D, Q1D, b, g, u, t, gq);
+      for (int j = 0; j < dim; j++)
+      {
+         const vreal_t *O0 = op[idx[j][0]];
+         for (int q = 0; q < NQ; q++) { qq[j][q].mul(O0[q], gq[0][q]); }
+         for (int k = 1; k < dim; k++)
+         {
+            const vreal_t *Ok = op[idx[j][k]];
+            for (int q = 0; q < NQ; q++) { qq[j][q].fma(Ok[q], gq[k][q]); }
+         }
+      }
+      GradT(dim, D1D, Q1D, b, g, qq, t, u);
+      ScatterAdd(ND, ND, e0, ns, u, y);
+   }
+}
+
+void SimdPA::ConvectionApply(const int dim, const int D1D, const int Q1D,
+                             const int NE,
+                             const Array<double> &B, const Array<double> &G,
+                             const Vector &D, const Vector &X, Vector &Y)
+{
+   MFEM_VERIFY(dim == 2 || dim == 3, "dim = " << dim << " is not supported");
+   const int ND = (dim == 2) ? D1D*D1D : D1D*D1D*D1D;
+   const int NQ = (dim == 2) ? Q1D*Q1D : Q1D*Q1D*Q1D;
+   const double *b = B.HostRead();
+   const double *g = G.HostRead();
+   const double *d = D.HostRead();
+   const double *x = X.HostRead();
+   double *y = Y.HostReadWrite();
+   SimdPAWork work(dim, D1D, Q1D, 1 + 5 + 2*dim);
+   vreal_t *u = work[0], *t[5], *gq[3], *op[3];
+   for (int i = 0; i < 5; i++) { t[i] = work[1 + i]; }
+   for (int j = 0; j < dim; j++)
+   {
+      gq[j] = work[6 + j];
+      op[j] = work[6 + dim + j];
+   }
+   for (int e0 = 0; e0 < NE; e0 += SS)
+   {
+      const int ns = std::min(SS, NE - e0);
+      for (int j = 0; j < dim; j++)
+      {
+         Gather(NQ, NQ*dim, e0, ns, d + NQ*j, op[j]);
+      }
+      Gather(ND, ND, e0, ns, x, u);
+      Grad(dim, D1D, Q1D, b, g, u, t, gq);
+      for (int q = 0; q < NQ; q++)
+      {
+         u[q].mul(op[0][q], gq[0][q]);
+         for (int j = 1; j < dim; j++) { u[q].fma(op[j][q], gq[j][q]); }
+      }
+      Interp<true>(dim, D1D, Q1D, b, u, t[0]);
+      ScatterAdd(ND, ND, e0, ns, u, y);
+   }
+}
+
+} // namespace mfem
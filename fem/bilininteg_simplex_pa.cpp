@@ -0,0 +1,1006 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "../general/forall.hpp"
+#include "bilininteg.hpp"
+#include "gridfunc.hpp"
+
+using namespace std;
+
+namespace mfem
+{
+
+// PA Mass and Diffusion Integrators on triangles, tetrahedra and prisms
+
+// Maximal number of Bernstein coefficients of a tetrahedron or a prism
+constexpr int SIMPLEX_MAX_DOF =
+   (SIMPLEX_MAX_D1D*SIMPLEX_MAX_D1D*(SIMPLEX_MAX_D1D+1))/2;
+
+// Number of collapsed directions of the Duffy map of geom
+static int NumCollapsed(Geometry::Type geom)
+{
+   return geom == Geometry::TETRAHEDRON ? 2 : 1;
+}
+
+// Storage for the collapsed rules, deleted at the end of the program.
+class CollapsedRules
+{
+public:
+   Array<IntegrationRule*> rules[3]; // triangle, tetrahedron and prism
+
+   ~CollapsedRules()
+   {
+      for (int i = 0; i < 3; i++)
+      {
+         for (int j = 0; j < rules[i].Size(); j++) { delete rules[i][j]; }
+      }
+   }
+};
+
+static IntegrationRule *NewCollapsedRule(const Geometry::Type geom,
+                                         const int q1d)
+{
+   const IntegrationRule &ir1 = IntRules.Get(Geometry::SEGMENT, 2*q1d - 1);
+   MFEM_VERIFY(ir1.GetNPoints() == q1d, "invalid 1D rule");
+   const int dim = Geometry::Dimension[geom];
+   const bool prism = geom == Geometry::PRISM;
+   const int nq = dim == 2 ? q1d*q1d : q1d*q1d*q1d;
+   IntegrationRule *ir = new IntegrationRule(nq);
+   for (int qc = 0, q = 0; qc < (dim == 2 ? 1 : q1d); qc++)
+   {
+      const double z = dim == 2 ? 0.0 : ir1.IntPoint(qc).x;
+      const double c = prism ? 0.0 : z;
+      const double wc = dim == 2 ? 1.0 : ir1.IntPoint(qc).weight*(1.-c)*(1.-c);
+      for (int qb = 0; qb < q1d; qb++)
+      {
+         const double b = ir1.IntPoint(qb).x;
+         const double wb = ir1.IntPoint(qb).weight*(1.-b);
+         for (int qa = 0; qa < q1d; qa++, q++)
+         {
+            const double a = ir1.IntPoint(qa).x;
+            const double wa = ir1.IntPoint(qa).weight;
+            IntegrationPoint &ip = ir->IntPoint(q);
+            ip.x = a*(1.-b)*(1.-c);
+            ip.y = b*(1.-c);
+            ip.z = z;
+            ip.weight = wa*wb*wc;
+         }
+      }
+   }
+   ir->SetOrder(2*q1d - 1 - NumCollapsed(geom));
+   return ir;
+}
+
+const IntegrationRule &SimplexPAMaps::GetCollapsedRule(Geometry::Type geom,
+                                                       int q1d)
+{
+   MFEM_VERIFY(IsSimplexPAGeometry(geom), "invalid geometry");
+   MFEM_VERIFY(q1d > 0, "invalid number of points");
+   static CollapsedRules collapsed;
+   const int g = geom == Geometry::TRIANGLE ? 0 :
+                 geom == Geometry::TETRAHEDRON ? 1 : 2;
+   IntegrationRule *ir;
+#ifdef MFEM_USE_LEGACY_OPENMP
+   #pragma omp critical (CollapsedRules)
+#endif
+   {
+      Array<IntegrationRule*> &rules = collapsed.rules[g];
+      if (rules.Size() < q1d)
+      {
+         const int size = rules.Size();
+         rules.SetSize(q1d);
+         for (int i = size; i < q1d; i++) { rules[i] = NULL; }
+      }
+      if (rules[q1d-1] == NULL) { rules[q1d-1] = NewCollapsedRule(geom, q1d); }
+      ir = rules[q1d-1];
+   }
+   return *ir;
+}
+
+// Return the Bernstein polynomial with exponents (j,k,l), of degree p, at the
+// point (x,y,z) of the reference simplex.
+static double Bernstein(const int p, const int j, const int k, const int l,
+                        const double x, const double y, const double z)
+{
+   const int m = p - j - k - l;
+   double f = 1.0;
+   for (int i = 2; i <= p; i++) { f *= i; }
+   for (int i = 2; i <= j; i++) { f /= i; }
+   for (int i = 2; i <= k; i++) { f /= i; }
+   for (int i = 2; i <= l; i++) { f /= i; }
+   for (int i = 2; i <= m; i++) { f /= i; }
+   return f*pow(x, j)*pow(y, k)*pow(z, l)*pow(1.-x-y-z, m);
+}
+
+// Return the Bernstein polynomial with exponents (j,k,l), of degree p, at the
+// point (x,y,z) of the reference element geom.
+static double Bernstein(const Geometry::Type geom, const int p, const int j,
+                        const int k, const int l, const double x,
+                        const double y, const double z)
+{
+   if (geom != Geometry::PRISM) { return Bernstein(p, j, k, l, x, y, z); }
+   return Bernstein(p, j, k, 0, x, y, 0.0)*Bernstein(p, l, 0, 0, z, 0., 0.);
+}
+
+SimplexPAMaps::SimplexPAMaps(const FiniteElement &fe, int ir_order)
+{
+   geom = fe.GetGeomType();
+   MFEM_VERIFY(IsSimplexPAGeometry(geom), "invalid geometry");
+   MFEM_VERIFY(fe.GetRangeType() == FiniteElement::SCALAR &&
+               fe.GetMapType() == FiniteElement::VALUE,
+               "only scalar elements with a VALUE map are supported");
+   dim = fe.GetDim();
+   order = fe.GetOrder();
+   ndof = fe.GetDof();
+   quad1D = (max(ir_order, 0) + NumCollapsed(geom))/2 + 1;
+   MFEM_VERIFY(order + 1 <= SIMPLEX_MAX_D1D, "order " << order
+               << " is not supported on simplices, the maximum is "
+               << SIMPLEX_MAX_D1D - 1);
+   MFEM_VERIFY(quad1D <= SIMPLEX_MAX_Q1D, "the quadrature order " << ir_order
+               << " is too high");
+   IntRule = &GetCollapsedRule(geom, quad1D);
+
+   // 1D Bernstein polynomials and derivatives of all degrees
+   const int p = order, P1 = order + 1, Q1D = quad1D;
+   const IntegrationRule &ir1 = IntRules.Get(Geometry::SEGMENT, 2*Q1D - 1);
+   pts1D.SetSize(Q1D);
+   B.SetSize(Q1D*P1*P1);
+   G.SetSize(Q1D*P1*P1);
+   B = 0.0;
+   G = 0.0;
+   for (int q = 0; q < Q1D; q++)
+   {
+      const double t = pts1D(q) = ir1.IntPoint(q).x;
+      B[q] = 1.0;
+      for (int m = 1; m <= p; m++)
+      {
+         for (int j = 0; j <= m; j++)
+         {
+            const double b0 = j < m ? B[q + Q1D*(j + P1*(m-1))] : 0.0;
+            const double b1 = j > 0 ? B[q + Q1D*(j-1 + P1*(m-1))] : 0.0;
+            B[q + Q1D*(j + P1*m)] = (1.-t)*b0 + t*b1;
+            G[q + Q1D*(j + P1*m)] = m*(b1 - b0);
+         }
+      }
+   }
+
+   // Change of basis, T = Bm^{-1} Phi, from the values of the Bernstein and
+   // element bases at the points of an equispaced lattice.
+   const bool prism = geom == Geometry::PRISM;
+   const int tri_dof = (P1*(P1+1))/2;
+   MFEM_VERIFY(ndof == (dim == 2 ? tri_dof : prism ? tri_dof*P1 :
+                        (tri_dof*(P1+2))/3), "invalid number of dofs");
+   DenseMatrix Bm(ndof), Phi(ndof);
+   Vector shape(ndof);
+   IntegrationPoint ip;
+   const int L = dim == 2 ? 0 : p;
+   const double h = p > 0 ? 1.0/p : 0.0;
+   // the lattice point for p = 0 is the center of the element
+   const double cxy = (dim == 3 && !prism) ? 0.25 : 1./3.;
+   const double cz = prism ? 0.5 : 0.25;
+   for (int l = 0, i = 0; l <= L; l++)
+   {
+      for (int k = 0; k <= p - (prism ? 0 : l); k++)
+      {
+         for (int j = 0; j <= p - k - (prism ? 0 : l); j++, i++)
+         {
+            ip.x = p > 0 ? j*h : cxy;
+            ip.y = p > 0 ? k*h : cxy;
+            ip.z = dim == 2 ? 0.0 : (p > 0 ? l*h : cz);
+            fe.CalcShape(ip, shape);
+            Phi.SetRow(i, shape);
+            for (int l2 = 0, c = 0; l2 <= L; l2++)
+            {
+               for (int k2 = 0; k2 <= p - (prism ? 0 : l2); k2++)
+               {
+                  for (int j2 = 0; j2 <= p - k2 - (prism ? 0 : l2); j2++, c++)
+                  {
+                     Bm(i, c) = Bernstein(geom, p, j2, k2, l2,
+                                          ip.x, ip.y, ip.z);
+                  }
+               }
+            }
+         }
+      }
+   }
+   DenseMatrixInverse Bm_inv(Bm);
+   T.SetSize(ndof);
+   Bm_inv.Mult(Phi, T);
+
+   // Replace T by a permutation, if possible.
+   const double tol = 1e-10;
+   perm.SetSize(ndof);
+   for (int c = 0; c < ndof && perm.Size() > 0; c++)
+   {
+      perm[c] = -1;
+      for (int d = 0; d < ndof; d++)
+      {
+         if (fabs(T(c, d) - 1.0) < tol && perm[c] < 0) { perm[c] = d; }
+         else if (fabs(T(c, d)) >= tol) { perm.SetSize(0); break; }
+      }
+      if (perm.Size() > 0 && perm[c] < 0) { perm.SetSize(0); }
+   }
+   if (perm.Size() > 0) { T.Clear(); }
+}
+
+void SimplexPAMaps::MassSetup(const int NE, const Vector &j, const Vector &c,
+                              Vector &d) const
+{
+   const int DIM = dim;
+   const int NQ = IntRule->GetNPoints();
+   const bool const_c = c.Size() == 1;
+   d.SetSize(NQ*NE, Device::GetDeviceMemoryType());
+   const auto W = IntRule->GetWeights().Read();
+   const auto J = Reshape(j.Read(), NQ, DIM, DIM, NE);
+   const auto C = const_c ? Reshape(c.Read(), 1, 1) :
+                  Reshape(c.Read(), NQ, NE);
+   auto D = Reshape(d.Write(), NQ, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; q++)
+      {
+         double detJ;
+         if (DIM == 2)
+         {
+            detJ = J(q,0,0,e)*J(q,1,1,e) - J(q,0,1,e)*J(q,1,0,e);
+         }
+         else
+         {
+            detJ = J(q,0,0,e)*(J(q,1,1,e)*J(q,2,2,e) - J(q,1,2,e)*J(q,2,1,e))
+                   - J(q,0,1,e)*(J(q,1,0,e)*J(q,2,2,e) - J(q,1,2,e)*J(q,2,0,e))
+                   + J(q,0,2,e)*(J(q,1,0,e)*J(q,2,1,e) - J(q,1,1,e)*J(q,2,0,e));
+         }
+         const double coeff = const_c ? C(0,0) : C(q,e);
+         D(q,e) = W[q]*coeff*detJ;
+      }
+   });
+}
+
+void SimplexPAMaps::DiffusionSetup(const int NE, const Vector &j,
+                                   const Vector &c, Vector &d) const
+{
+   const int DIM = dim;
+   const int NQ = IntRule->GetNPoints();
+   const int S = (DIM*(DIM+1))/2;
+   const bool const_c = c.Size() == 1;
+   d.SetSize(NQ*S*NE, Device::GetDeviceMemoryType());
+   const auto W = IntRule->GetWeights().Read();
+   const auto J = Reshape(j.Read(), NQ, DIM, DIM, NE);
+   const auto C = const_c ? Reshape(c.Read(), 1, 1) :
+                  Reshape(c.Read(), NQ, NE);
+   auto D = Reshape(d.Write(), NQ, S, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; q++)
+      {
+         const double coeff = const_c ? C(0,0) : C(q,e);
+         if (DIM == 2)
+         {
+            const double J11 = J(q,0,0,e);
+            const double J21 = J(q,1,0,e);
+            const double J12 = J(q,0,1,e);
+            const double J22 = J(q,1,1,e);
+            const double w_detJ = W[q]*coeff/((J11*J22) - (J21*J12));
+            D(q,0,e) =  w_detJ * (J12*J12 + J22*J22); // 1,1
+            D(q,1,e) = -w_detJ * (J12*J11 + J22*J21); // 1,2
+            D(q,2,e) =  w_detJ * (J11*J11 + J21*J21); // 2,2
+         }
+         else
+         {
+            double A[3][3];
+            A[0][0] = J(q,1,1,e)*J(q,2,2,e) - J(q,1,2,e)*J(q,2,1,e);
+            A[0][1] = J(q,0,2,e)*J(q,2,1,e) - J(q,0,1,e)*J(q,2,2,e);
+            A[0][2] = J(q,0,1,e)*J(q,1,2,e) - J(q,0,2,e)*J(q,1,1,e);
+            A[1][0] = J(q,1,2,e)*J(q,2,0,e) - J(q,1,0,e)*J(q,2,2,e);
+            A[1][1] = J(q,0,0,e)*J(q,2,2,e) - J(q,0,2,e)*J(q,2,0,e);
+            A[1][2] = J(q,0,2,e)*J(q,1,0,e) - J(q,0,0,e)*J(q,1,2,e);
+            A[2][0] = J(q,1,0,e)*J(q,2,1,e) - J(q,1,1,e)*J(q,2,0,e);
+            A[2][1] = J(q,0,1,e)*J(q,2,0,e) - J(q,0,0,e)*J(q,2,1,e);
+            A[2][2] = J(q,0,0,e)*J(q,1,1,e) - J(q,0,1,e)*J(q,1,0,e);
+            const double detJ = J(q,0,0,e)*A[0][0] + J(q,0,1,e)*A[1][0] +
+                                J(q,0,2,e)*A[2][0];
+            const double w_detJ = W[q]*coeff/detJ;
+            for (int i = 0, s = 0; i < 3; i++)
+            {
+               for (int k = i; k < 3; k++, s++)
+               {
+                  D(q,s,e) = w_detJ*(A[i][0]*A[k][0] + A[i][1]*A[k][1] +
+                                     A[i][2]*A[k][2]);
+               }
+            }
+         }
+      }
+   });
+}
+
+// Convert the element dofs x to the Bernstein coefficients u, with the
+// permutation P or, if P is NULL, with the dense matrix T.
+static MFEM_HOST_DEVICE inline void ToBernstein(const int ND, const int *P,
+                                                const double *T,
+                                                const double *x, double *u)
+{
+   if (P)
+   {
+      for (int c = 0; c < ND; c++) { u[c] = x[P[c]]; }
+      return;
+   }
+   for (int c = 0; c < ND; c++) { u[c] = 0.0; }
+   for (int d = 0; d < ND; d++)
+   {
+      for (int c = 0; c < ND; c++) { u[c] += T[c + ND*d]*x[d]; }
+   }
+}
+
+// Add the transpose of ToBernstein applied to v to the element dofs y.
+static MFEM_HOST_DEVICE inline void FromBernstein(const int ND, const int *P,
+                                                  const double *T,
+                                                  const double *v, double *y)
+{
+   if (P)
+   {
+      for (int c = 0; c < ND; c++) { y[P[c]] += v[c]; }
+      return;
+   }
+   for (int d = 0; d < ND; d++)
+   {
+      double s = 0.0;
+      for (int c = 0; c < ND; c++) { s += T[c + ND*d]*v[c]; }
+      y[d] += s;
+   }
+}
+
+static void SimplexMassApply2D(const int NE, const int p, const int Q1D,
+                               const int ND, const int *P, const double *T,
+                               const Vector &b, const Vector &d,
+                               const Vector &x, Vector &y)
+{
+   constexpr int MD1 = SIMPLEX_MAX_D1D;
+   constexpr int MQ1 = SIMPLEX_MAX_Q1D;
+   constexpr int MDOF = SIMPLEX_MAX_DOF;
+   const auto B = Reshape(b.Read(), Q1D, p+1, p+1);
+   const auto D = Reshape(d.Read(), Q1D, Q1D, NE);
+   const double *X = x.Read();
+   double *Y = y.ReadWrite();
+   MFEM_FORALL(e, NE,
+   {
+      double u[MDOF];
+      double u1[MD1][MQ1], v1[MD1][MQ1];
+      ToBernstein(ND, P, T, X + ND*e, u);
+      for (int k = 0, c = 0; k <= p; c += p - k + 1, k++)
+      {
+         const int n = p - k;
+         for (int qa = 0; qa < Q1D; qa++)
+         {
+            double s = 0.0;
+            for (int j = 0; j <= n; j++) { s += u[c+j]*B(qa,j,n); }
+            u1[k][qa] = s;
+            v1[k][qa] = 0.0;
+         }
+      }
+      for (int qb = 0; qb < Q1D; qb++)
+      {
+         for (int qa = 0; qa < Q1D; qa++)
+         {
+            double s = 0.0;
+            for (int k = 0; k <= p; k++) { s += u1[k][qa]*B(qb,k,p); }
+            s *= D(qa,qb,e);
+            for (int k = 0; k <= p; k++) { v1[k][qa] += B(qb,k,p)*s; }
+         }
+      }
+      for (int k = 0, c = 0; k <= p; c += p - k + 1, k++)
+      {
+         const int n = p - k;
+         for (int j = 0; j <= n; j++)
+         {
+            double s = 0.0;
+            for (int qa = 0; qa < Q1D; qa++) { s += v1[k][qa]*B(qa,j,n); }
+            u[c+j] = s;
+         }
+      }
+      FromBernstein(ND, P, T, u, Y + ND*e);
+   });
+}
+
+static void SimplexMassApply3D(const int NE, const bool prism,
+                               const int p, const int Q1D,
+                               const int ND, const int *P, const double *T,
+                               const Vector &b, const Vector &d,
+                               const Vector &x, Vector &y)
+{
+   constexpr int MD1 = SIMPLEX_MAX_D1D;
+   constexpr int MQ1 = SIMPLEX_MAX_Q1D;
+   constexpr int MDOF = SIMPLEX_MAX_DOF;
+   const auto B = Reshape(b.Read(), Q1D, p+1, p+1);
+   const auto D = Reshape(d.Read(), Q1D, Q1D, Q1D, NE);
+   const double *X = x.Read();
+   double *Y = y.ReadWrite();
+   MFEM_FORALL(e, NE,
+   {
+      double u[MDOF];
+      double u1[MD1][MD1][MQ1];
+      double u2[MD1][MQ1][MQ1], v2[MD1][MQ1][MQ1];
+      ToBernstein(ND, P, T, X + ND*e, u);
+      // contract j -> qa
+      for (int l = 0, c = 0; l <= p; l++)
+      {
+         const int m = prism ? p : p - l;
+         for (int k = 0; k <= m; c += m - k + 1, k++)
+         {
+            const int n = m - k;
+            for (int qa = 0; qa < Q1D; qa++)
+            {
+               double s = 0.0;
+               for (int j = 0; j <= n; j++) { s += u[c+j]*B(qa,j,n); }
+               u1[l][k][qa] = s;
+            }
+         }
+      }
+      // contract k -> qb
+      for (int l = 0; l <= p; l++)
+      {
+         const int m = prism ? p : p - l;
+         for (int qb = 0; qb < Q1D; qb++)
+         {
+            for (int qa = 0; qa < Q1D; qa++)
+            {
+               double s = 0.0;
+               for (int k = 0; k <= m; k++) { s += u1[l][k][qa]*B(qb,k,m); }
+               u2[l][qb][qa] = s;
+               v2[l][qb][qa] = 0.0;
+            }
+         }
+      }
+      // contract l -> qc, apply D and contract back qc -> l
+      for (int qc = 0; qc < Q1D; qc++)
+      {
+         for (int qb = 0; qb < Q1D; qb++)
+         {
+            for (int qa = 0; qa < Q1D; qa++)
+            {
+               double s = 0.0;
+               for (int l = 0; l <= p; l++) { s += u2[l][qb][qa]*B(qc,l,p); }
+               s *= D(qa,qb,qc,e);
+               for (int l = 0; l <= p; l++) { v2[l][qb][qa] += B(qc,l,p)*s; }
+            }
+         }
+      }
+      // contract qb -> k
+      for (int l = 0; l <= p; l++)
+      {
+         const int m = prism ? p : p - l;
+         for (int k = 0; k <= m; k++)
+         {
+            for (int qa = 0; qa < Q1D; qa++)
+            {
+               double s = 0.0;
+               for (int qb = 0; qb < Q1D; qb++)
+               {
+                  s += v2[l][qb][qa]*B(qb,k,m);
+               }
+               u1[l][k][qa] = s;
+            }
+         }
+      }
+      // contract qa -> j
+      for (int l = 0, c = 0; l <= p; l++)
+      {
+         const int m = prism ? p : p - l;
+         for (int k = 0; k <= m; c += m - k + 1, k++)
+         {
+            const int n = m - k;
+            for (int j = 0; j <= n; j++)
+            {
+               double s = 0.0;
+               for (int qa = 0; qa < Q1D; qa++) { s += u1[l][k][qa]*B(qa,j,n); }
+               u[c+j] = s;
+            }
+         }
+      }
+      FromBernstein(ND, P, T, u, Y + ND*e);
+   });
+}
+
+static void SimplexDiffusionApply2D(const int NE, const int p, const int Q1D,
+                                    const int ND, const int *P,
+                                    const double *T, const Vector &pts,
+                                    const Vector &b, const Vector &g,
+                                    const Vector &d, const Vector &x,
+                                    Vector &y)
+{
+   constexpr int MD1 = SIMPLEX_MAX_D1D;
+   constexpr int MQ1 = SIMPLEX_MAX_Q1D;
+   constexpr int MDOF = SIMPLEX_MAX_DOF;
+   const double *X1 = pts.Read();
+   const auto B = Reshape(b.Read(), Q1D, p+1, p+1);
+   const auto G = Reshape(g.Read(), Q1D, p+1, p+1);
+   const auto D = Reshape(d.Read(), Q1D, Q1D, 3, NE);
+   const double *X = x.Read();
+   double *Y = y.ReadWrite();
+   MFEM_FORALL(e, NE,
+   {
+      double u[MDOF];
+      double u1v[MD1][MQ1], u1d[MD1][MQ1], v1v[MD1][MQ1], v1d[MD1][MQ1];
+      ToBernstein(ND, P, T, X + ND*e, u);
+      for (int k = 0, c = 0; k <= p; c += p - k + 1, k++)
+      {
+         const int n = p - k;
+         for (int qa = 0; qa < Q1D; qa++)
+         {
+            double sv = 0.0, sd = 0.0;
+            for (int j = 0; j <= n; j++)
+            {
+               sv += u[c+j]*B(qa,j,n);
+               sd += u[c+j]*G(qa,j,n);
+            }
+            u1v[k][qa] = sv;
+            u1d[k][qa] = sd;
+            v1v[k][qa] = 0.0;
+            v1d[k][qa] = 0.0;
+         }
+      }
+      for (int qb = 0; qb < Q1D; qb++)
+      {
+         const double bb = X1[qb];
+         const double A = 1.0/(1.0 - bb);
+         for (int qa = 0; qa < Q1D; qa++)
+         {
+            const double aa = X1[qa];
+            double ua = 0.0, ub = 0.0;
+            for (int k = 0; k <= p; k++)
+            {
+               ua += u1d[k][qa]*B(qb,k,p);
+               ub += u1v[k][qa]*G(qb,k,p);
+            }
+            // gradient in the reference triangle
+            const double gx = A*ua;
+            const double gy = A*aa*ua + ub;
+            const double fx = D(qa,qb,0,e)*gx + D(qa,qb,1,e)*gy;
+            const double fy = D(qa,qb,1,e)*gx + D(qa,qb,2,e)*gy;
+            // transpose of the chain rule
+            const double va = A*(fx + aa*fy);
+            const double vb = fy;
+            for (int k = 0; k <= p; k++)
+            {
+               v1d[k][qa] += B(qb,k,p)*va;
+               v1v[k][qa] += G(qb,k,p)*vb;
+            }
+         }
+      }
+      for (int k = 0, c = 0; k <= p; c += p - k + 1, k++)
+      {
+         const int n = p - k;
+         for (int j = 0; j <= n; j++)
+         {
+            double s = 0.0;
+            for (int qa = 0; qa < Q1D; qa++)
+            {
+               s += v1v[k][qa]*B(qa,j,n) + v1d[k][qa]*G(qa,j,n);
+            }
+            u[c+j] = s;
+         }
+      }
+      FromBernstein(ND, P, T, u, Y + ND*e);
+   });
+}
+
+static void SimplexDiffusionApply3D(const int NE, const bool prism,
+                                    const int p, const int Q1D,
+                                    const int ND, const int *P,
+                                    const double *T, const Vector &pts,
+                                    const Vector &b, const Vector &g,
+                                    const Vector &d, const Vector &x,
+                                    Vector &y)
+{
+   constexpr int MD1 = SIMPLEX_MAX_D1D;
+   constexpr int MQ1 = SIMPLEX_MAX_Q1D;
+   constexpr int MDOF = SIMPLEX_MAX_DOF;
+   const double *X1 = pts.Read();
+   const auto B = Reshape(b.Read(), Q1D, p+1, p+1);
+   const auto G = Reshape(g.Read(), Q1D, p+1, p+1);
+   const auto D = Reshape(d.Read(), Q1D, Q1D, Q1D, 6, NE);
+   const double *X = x.Read();
+   double *Y = y.ReadWrite();
+   MFEM_FORALL(e, NE,
+   {
+      double u[MDOF];
+      double u1v[MD1][MD1][MQ1], u1d[MD1][MD1][MQ1];
+      double u2vv[MD1][MQ1][MQ1], u2vd[MD1][MQ1][MQ1], u2dv[MD1][MQ1][MQ1];
+      double v2vv[MD1][MQ1][MQ1], v2vd[MD1][MQ1][MQ1], v2dv[MD1][MQ1][MQ1];
+      ToBernstein(ND, P, T, X + ND*e, u);
+      // contract j -> qa
+      for (int l = 0, c = 0; l <= p; l++)
+      {
+         const int m = prism ? p : p - l;
+         for (int k = 0; k <= m; c += m - k + 1, k++)
+         {
+            const int n = m - k;
+            for (int qa = 0; qa < Q1D; qa++)
+            {
+               double sv = 0.0, sd = 0.0;
+               for (int j = 0; j <= n; j++)
+               {
+                  sv += u[c+j]*B(qa,j,n);
+                  sd += u[c+j]*G(qa,j,n);
+               }
+               u1v[l][k][qa] = sv;
+               u1d[l][k][qa] = sd;
+            }
+         }
+      }
+      // contract k -> qb
+      for (int l = 0; l <= p; l++)
+      {
+         const int m = prism ? p : p - l;
+         for (int qb = 0; qb < Q1D; qb++)
+         {
+            for (int qa = 0; qa < Q1D; qa++)
+            {
+               double vv = 0.0, vd = 0.0, dv = 0.0;
+               for (int k = 0; k <= m; k++)
+               {
+                  vv += u1v[l][k][qa]*B(qb,k,m);
+                  vd += u1v[l][k][qa]*G(qb,k,m);
+                  dv += u1d[l][k][qa]*B(qb,k,m);
+               }
+               u2vv[l][qb][qa] = vv;
+               u2vd[l][qb][qa] = vd;
+               u2dv[l][qb][qa] = dv;
+               v2vv[l][qb][qa] = 0.0;
+               v2vd[l][qb][qa] = 0.0;
+               v2dv[l][qb][qa] = 0.0;
+            }
+         }
+      }
+      // contract l -> qc, apply D and contract back qc -> l
+      for (int qc = 0; qc < Q1D; qc++)
+      {
+         const double cc = X1[qc];
+         // the c direction is collapsed on tetrahedra only
+         const double C = prism ? 1.0 : 1.0/(1.0 - cc);
+         const double Z = prism ? 0.0 : 1.0;
+         for (int qb = 0; qb < Q1D; qb++)
+         {
+            const double bb = X1[qb];
+            const double A = C/(1.0 - bb);
+            for (int qa = 0; qa < Q1D; qa++)
+            {
+               const double aa = X1[qa];
+               double ua = 0.0, ub = 0.0, uc = 0.0;
+               for (int l = 0; l <= p; l++)
+               {
+                  ua += u2dv[l][qb][qa]*B(qc,l,p);
+                  ub += u2vd[l][qb][qa]*B(qc,l,p);
+                  uc += u2vv[l][qb][qa]*G(qc,l,p);
+               }
+               // gradient in the reference tetrahedron or prism
+               const double gx = A*ua;
+               const double gy = A*aa*ua + C*ub;
+               const double gz = Z*(A*aa*ua + C*bb*ub) + uc;
+               const double O11 = D(qa,qb,qc,0,e);
+               const double O12 = D(qa,qb,qc,1,e);
+               const double O13 = D(qa,qb,qc,2,e);
+               const double O22 = D(qa,qb,qc,3,e);
+               const double O23 = D(qa,qb,qc,4,e);
+               const double O33 = D(qa,qb,qc,5,e);
+               const double fx = O11*gx + O12*gy + O13*gz;
+               const double fy = O12*gx + O22*gy + O23*gz;
+               const double fz = O13*gx + O23*gy + O33*gz;
+               // transpose of the chain rule
+               const double va = A*(fx + aa*(fy + Z*fz));
+               const double vb = C*(fy + Z*bb*fz);
+               const double vc = fz;
+               for (int l = 0; l <= p; l++)
+               {
+                  v2dv[l][qb][qa] += B(qc,l,p)*va;
+                  v2vd[l][qb][qa] += B(qc,l,p)*vb;
+                  v2vv[l][qb][qa] += G(qc,l,p)*vc;
+               }
+            }
+         }
+      }
+      // contract qb -> k
+      for (int l = 0; l <= p; l++)
+      {
+         const int m = prism ? p : p - l;
+         for (int k = 0; k <= m; k++)
+         {
+            for (int qa = 0; qa < Q1D; qa++)
+            {
+               double sv = 0.0, sd = 0.0;
+               for (int qb = 0; qb < Q1D; qb++)
+               {
+                  sv += v2vv[l][qb][qa]*B(qb,k,m) + v2vd[l][qb][qa]*G(qb,k,m);
+                  sd += v2dv[l][qb][qa]*B(qb,k,m);
+               }
+               u1v[l][k][qa] = sv;
+               u1d[l][k][qa] = sd;
+            }
+         }
+      }
+      // contract qa -> j
+      for (int l = 0, c = 0; l <= p; l++)
+      {
+         const int m = prism ? p : p - l;
+         for (int k = 0; k <= m; c += m - k + 1, k++)
+         {
+            const int n = m - k;
+            for (int j = 0; j <= n; j++)
+            {
+               double s = 0.0;
+               for (int qa = 0; qa < Q1D; qa++)
+               {
+                  s += u1v[l][k][qa]*B(qa,j,n) + u1d[l][k][qa]*G(qa,j,n);
+               }
+               u[c+j] = s;
+            }
+         }
+      }
+      FromBernstein(ND, P, T, u, Y + ND*e);
+   });
+}
+
+void SimplexPAMaps::MassApply(const int NE, const Vector &D, const Vector &x,
+                              Vector &y) const
+{
+   const bool use_perm = perm.Size() > 0;
+   const int *P = use_perm ? perm.Read() : NULL;
+   const double *Tm = use_perm ? NULL : T.Read();
+   if (dim == 2)
+   {
+      return SimplexMassApply2D(NE, order, quad1D, ndof, P, Tm, B, D, x, y);
+   }
+   const bool prism = geom == Geometry::PRISM;
+   return SimplexMassApply3D(NE, prism, order, quad1D, ndof, P, Tm, B, D, x, y);
+}
+
+void SimplexPAMaps::DiffusionApply(const int NE, const Vector &D,
+                                   const Vector &x, Vector &y) const
+{
+   const bool use_perm = perm.Size() > 0;
+   const int *P = use_perm ? perm.Read() : NULL;
+   const double *Tm = use_perm ? NULL : T.Read();
+   if (dim == 2)
+   {
+      return SimplexDiffusionApply2D(NE, order, quad1D, ndof, P, Tm, pts1D,
+                                     B, G, D, x, y);
+   }
+   const bool prism = geom == Geometry::PRISM;
+   return SimplexDiffusionApply3D(NE, prism, order, quad1D, ndof, P, Tm, pts1D,
+                                  B, G, D, x, y);
+}
+
+void SimplexPAMaps::MassDiagonal(const FiniteElement &fe, const int NE,
+                                 const Vector &d, Vector &diag) const
+{
+   // The collapsed rule is never deleted, so its maps can be cached in fe.
+   const DofToQuad &maps = fe.GetDofToQuad(*IntRule, DofToQuad::FULL);
+   const int NQ = maps.nqpt, ND = maps.ndof;
+   const auto B = Reshape(maps.B.Read(), NQ, ND);
+   const auto D = Reshape(d.Read(), NQ, NE);
+   auto Y = Reshape(diag.ReadWrite(), ND, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int i = 0; i < ND; i++)
+      {
+         double s = 0.0;
+         for (int q = 0; q < NQ; q++) { s += B(q,i)*B(q,i)*D(q,e); }
+         Y(i,e) += s;
+      }
+   });
+}
+
+void SimplexPAMaps::DiffusionDiagonal(const FiniteElement &fe, const int NE,
+                                      const Vector &d, Vector &diag) const
+{
+   const DofToQuad &maps = fe.GetDofToQuad(*IntRule, DofToQuad::FULL);
+   const int DIM = dim, NQ = maps.nqpt, ND = maps.ndof;
+   const int S = (DIM*(DIM+1))/2;
+   const auto G = Reshape(maps.G.Read(), NQ, DIM, ND);
+   const auto D = Reshape(d.Read(), NQ, S, NE);
+   auto Y = Reshape(diag.ReadWrite(), ND, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int i = 0; i < ND; i++)
+      {
+         double s = 0.0;
+         for (int q = 0; q < NQ; q++)
+         {
+            for (int a = 0, k = 0; a < DIM; a++)
+            {
+               s += G(q,a,i)*G(q,a,i)*D(q,k++,e);
+               for (int b = a + 1; b < DIM; b++)
+               {
+                  s += 2.0*G(q,a,i)*G(q,b,i)*D(q,k++,e);
+               }
+            }
+         }
+         Y(i,e) += s;
+      }
+   });
+}
+
+void PAElementBatch::MakeBatches(const FiniteElementSpace &fes,
+                                 Array<PAElementBatch*> &batches)
+{
+   DeleteBatches(batches);
+   const ElementRestriction *R = dynamic_cast<const ElementRestriction*>(
+                                    fes.GetElementRestriction(
+                                       ElementDofOrdering::LEXICOGRAPHIC));
+   MFEM_VERIFY(R, "the space must use an ElementRestriction");
+   const Array<int> &b_off = R->GetBatchOffsets();
+   batches.SetSize(R->GetNumBatches());
+   for (int b = 0; b < batches.Size(); b++)
+   {
+      PAElementBatch *batch = batches[b] = new PAElementBatch;
+      batch->geom = R->GetBatchGeometry(b);
+      batch->ne = b_off[b+1] - b_off[b];
+      R->GetBatchElements().GetSubArray(b_off[b], batch->ne, batch->elements);
+      batch->offset = R->GetBatchEOffset(b);
+      batch->size = R->GetBatchEOffset(b+1) - batch->offset;
+      batch->fe = fes.GetFE(batch->elements[0]);
+      batch->dofs1D = batch->quad1D = 0;
+   }
+}
+
+void PAElementBatch::DeleteBatches(Array<PAElementBatch*> &batches)
+{
+   for (int b = 0; b < batches.Size(); b++) { delete batches[b]; }
+   batches.SetSize(0);
+}
+
+void PAElementBatch::SetIntRule(int order)
+{
+   delete simplex_maps;
+   simplex_maps = NULL;
+   maps = NULL;
+   if (IsSimplexPAGeometry(geom))
+   {
+      simplex_maps = new SimplexPAMaps(*fe, order);
+      ir = simplex_maps->IntRule;
+      return;
+   }
+   MFEM_VERIFY(dynamic_cast<const TensorBasisElement*>(fe),
+               "the elements of geometry " << Geometry::Name[geom]
+               << " must have a tensor basis");
+   ir = &IntRules.Get(geom, order);
+   maps = &fe->GetDofToQuad(*ir, DofToQuad::TENSOR);
+   dofs1D = maps->ndof;
+   quad1D = maps->nqpt;
+}
+
+void PAElementBatch::GetJacobians(Mesh &mesh, Vector &J) const
+{
+   const int dim = Geometry::Dimension[geom];
+   const int NQ = ir->GetNPoints();
+   MFEM_VERIFY(mesh.SpaceDimension() == dim,
+               "PA on mixed meshes requires a mesh with sdim == dim");
+   J.SetSize(NQ*dim*dim*ne);
+   auto d_J = Reshape(J.HostWrite(), NQ, dim, dim, ne);
+   IsoparametricTransformation T;
+   for (int i = 0; i < ne; i++)
+   {
+      mesh.GetElementTransformation(elements[i], &T);
+      T.SetIntRule(ir);
+      for (int q = 0; q < NQ; q++)
+      {
+         T.SetIntPoint(&ir->IntPoint(q));
+         const DenseMatrix &Jq = T.Jacobian();
+         for (int k = 0; k < dim; k++)
+         {
+            for (int j = 0; j < dim; j++) { d_J(q,j,k,i) = Jq(j,k); }
+         }
+      }
+   }
+}
+
+void PAElementBatch::GetCoefficient(Coefficient *Q, Mesh &mesh,
+                                    Vector &C) const
+{
+   if (Q == nullptr)
+   {
+      C.SetSize(1);
+      C(0) = 1.0;
+      return;
+   }
+   if (ConstantCoefficient* cQ = dynamic_cast<ConstantCoefficient*>(Q))
+   {
+      C.SetSize(1);
+      C(0) = cQ->constant;
+      return;
+   }
+   MFEM_VERIFY(!dynamic_cast<QuadratureFunctionCoefficient*>(Q),
+               "QuadratureFunctionCoefficient is not supported on meshes with"
+               " more than one geometry");
+   // The points of the elements of the batch are stored in the order of
+   // #elements, which is increasing.
+   QuadratureSpace qs(&mesh, geom, *ir);
+   QuadratureFunction qf(&qs);
+   Q->Project(qf);
+   C = qf;
+}
+
+// Evaluate the scalar coefficient Q at the points of the collapsed rule ir, as
+// in the tensor product AssemblePA methods.
+static void SimplexPACoefficient(Coefficient *Q, Mesh *mesh,
+                                 const IntegrationRule &ir, Vector &coeff)
+{
+   if (Q == nullptr)
+   {
+      coeff.SetSize(1);
+      coeff(0) = 1.0;
+   }
+   else if (ConstantCoefficient* cQ = dynamic_cast<ConstantCoefficient*>(Q))
+   {
+      coeff.SetSize(1);
+      coeff(0) = cQ->constant;
+   }
+   else if (QuadratureFunctionCoefficient* cQ =
+               dynamic_cast<QuadratureFunctionCoefficient*>(Q))
+   {
+      const QuadratureFunction &qFun = cQ->GetQuadFunction();
+      MFEM_VERIFY(qFun.Size() == ir.GetNPoints() * mesh->GetNE(),
+                  "Incompatible QuadratureFunction dimension \n");
+      MFEM_VERIFY(&ir == &qFun.GetSpace()->GetElementIntRule(0),
+                  "The QuadratureFunction must be defined on the rule "
+                  "SimplexPAMaps::GetCollapsedRule()");
+      qFun.Read();
+      coeff.MakeRef(const_cast<QuadratureFunction &>(qFun),0);
+   }
+   else
+   {
+      QuadratureSpace qs(mesh, ir);
+      QuadratureFunction qf(&qs);
+      Q->Project(qf);
+      coeff.Swap(qf);
+   }
+}
+
+void MassIntegrator::AssemblePASimplex(const FiniteElementSpace &fes,
+                                       const IntegrationRule &ir)
+{
+   Mesh *mesh = fes.GetMesh();
+   MFEM_VERIFY(mesh->SpaceDimension() == mesh->Dimension(),
+               "PA on simplices requires a mesh with sdim == dim");
+   delete simplex_maps;
+   simplex_maps = new SimplexPAMaps(*fes.GetFE(0), ir.GetOrder());
+   const IntegrationRule &s_ir = *simplex_maps->IntRule;
+   dim = mesh->Dimension();
+   ne = fes.GetNE();
+   nq = s_ir.GetNPoints();
+   geom = mesh->GetGeometricFactors(s_ir, GeometricFactors::JACOBIANS);
+   maps = NULL;
+   Vector coeff;
+   SimplexPACoefficient(Q, mesh, s_ir, coeff);
+   simplex_maps->MassSetup(ne, geom->J, coeff, pa_data);
+}
+
+void DiffusionIntegrator::AssemblePASimplex(const FiniteElementSpace &fes,
+                                            const IntegrationRule &ir)
+{
+   Mesh *mesh = fes.GetMesh();
+   MFEM_VERIFY(mesh->SpaceDimension() == mesh->Dimension(),
+               "PA on simplices requires a mesh with sdim == dim");
+   MFEM_VERIFY(!VQ && !MQ && !SMQ,
+               "PA on simplices supports only scalar coefficients");
+   delete simplex_maps;
+   simplex_maps = new SimplexPAMaps(*fes.GetFE(0), ir.GetOrder());
+   const IntegrationRule &s_ir = *simplex_maps->IntRule;
+   dim = mesh->Dimension();
+   ne = fes.GetNE();
+   symmetric = true;
+   geom = mesh->GetGeometricFactors(s_ir, GeometricFactors::JACOBIANS);
+   maps = NULL;
+   Vector coeff;
+   SimplexPACoefficient(Q, mesh, s_ir, coeff);
+   simplex_maps->DiffusionSetup(ne, geom->J, coeff, pa_data);
+}
+
+} // namespace mfem
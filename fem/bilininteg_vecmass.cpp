@@ -10,6 +10,7 @@
 // CONTRIBUTING.md for details.
 
 #include "../general/forall.hpp"
+#include "../general/kernel_registry.hpp"
 #include "bilininteg.hpp"
 #include "gridfunc.hpp"
 #include "libceed/mass.hpp"
@@ -346,6 +347,32 @@ static void PAVectorMassApply3D(const int NE,
    });
 }
 
+typedef void (*VectorMassApplyKernel)(const int, const Array<double>&,
+                                      const Array<double>&, const Vector&,
+                                      const Vector&, Vector&,
+                                      const int, const int);
+
+// The SimdPA mass kernel applied to the DIM components of the vector.
+template <int DIM>
+static void SimdPAVectorMassApply(const int NE, const Array<double> &B,
+                                  const Array<double> &, const Vector &op,
+                                  const Vector &x, Vector &y,
+                                  const int D1D, const int Q1D)
+{
+   SimdPA::MassApply(DIM, D1D, Q1D, NE, DIM, B, op, x, y);
+}
+
+struct VectorMassApplyKernels : KernelRegistry<VectorMassApplyKernel>
+{
+   VectorMassApplyKernels() : KernelRegistry("PAVectorMassApply")
+   {
+      AddFallback(2, PAVectorMassApply2D<>);
+      AddFallback(3, PAVectorMassApply3D<>);
+      AddVectorized(2, SimdPAVectorMassApply<2>);
+      AddVectorized(3, SimdPAVectorMassApply<3>);
+   }
+};
+
 static void PAVectorMassApply(const int dim,
                               const int D1D,
                               const int Q1D,
@@ -356,15 +383,8 @@ static void PAVectorMassApply(const int dim,
                               const Vector &x,
                               Vector &y)
 {
-   if (dim == 2)
-   {
-      return PAVectorMassApply2D(NE, B, Bt, op, x, y, D1D, Q1D);
-   }
-   if (dim == 3)
-   {
-      return PAVectorMassApply3D(NE, B, Bt, op, x, y, D1D, Q1D);
-   }
-   MFEM_ABORT("Unknown kernel.");
+   static const VectorMassApplyKernels kernels;
+   kernels.Get(dim, D1D, Q1D, SimdPA::Enabled())(NE, B, Bt, op, x, y, D1D, Q1D);
 }
 
 void VectorMassIntegrator::AddMultPA(const Vector &x, Vector &y) const
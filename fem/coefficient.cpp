@@ -12,6 +12,7 @@
 // Implementation of Coefficient class
 
 #include "fem.hpp"
+#include "../general/forall.hpp"
 
 #include <cmath>
 #include <limits>
@@ -991,4 +992,385 @@ double QuadratureFunctionCoefficient::Eval(ElementTransformation &T,
    return temp[0];
 }
 
+// Return the number of quadrature points per element of @a qs if all elements
+// use the same IntegrationRule, otherwise return -1.
+static int UniformNumPoints(const QuadratureSpace &qs)
+{
+   const Mesh *mesh = qs.GetMesh();
+   if (mesh->GetNE() == 0) { return 0; }
+   if (mesh->GetNumGeometries(mesh->Dimension()) > 1) { return -1; }
+   return qs.GetElementIntRule(0).GetNPoints();
+}
+
+// Return true if @a qf1 and @a qf2 share the same quadrature points.
+static bool SameQuadraturePoints(const QuadratureFunction &qf1,
+                                 const QuadratureFunction &qf2)
+{
+   const QuadratureSpace *qs1 = qf1.GetSpace(), *qs2 = qf2.GetSpace();
+   if (qs1 == qs2) { return true; }
+   if (qs1->GetMesh() != qs2->GetMesh() || qs1->GetSize() != qs2->GetSize() ||
+       UniformNumPoints(*qs1) < 0) { return false; }
+   return (qs1->GetNE() == 0 ||
+           &qs1->GetElementIntRule(0) == &qs2->GetElementIntRule(0));
+}
+
+// Interpolate the GridFunction @a gf at the points of @a qs on the device,
+// storing the result in @a q_val with layout (VDIM x NQ x NE). Return false,
+// without modifying @a q_val, if the space of @a gf is not supported, e.g. for
+// vector finite elements or meshes with more than one element geometry.
+static bool GridFunctionValues(const GridFunction &gf,
+                               const QuadratureSpace &qs, Vector &q_val)
+{
+   const FiniteElementSpace &fes = *gf.FESpace();
+   const int NE = qs.GetNE();
+   if (fes.GetMesh() != qs.GetMesh() || NE == 0 || fes.GetNURBSext() ||
+       UniformNumPoints(qs) < 0) { return false; }
+   const FiniteElement *fe = fes.GetFE(0);
+   if (fe->GetRangeType() != FiniteElement::SCALAR ||
+       fe->GetMapType() != FiniteElement::VALUE) { return false; }
+
+   // The points of qs may be transient, e.g. the nodes of another element, so
+   // the shape functions are not cached with FiniteElement::GetDofToQuad().
+   const IntegrationRule &ir = qs.GetElementIntRule(0);
+   const int ND = fe->GetDof();
+   const int NQ = ir.GetNPoints();
+   Vector shape(ND), b(NQ*ND);
+   for (int q = 0; q < NQ; q++)
+   {
+      fe->CalcShape(ir.IntPoint(q), shape);
+      for (int d = 0; d < ND; d++) { b(q+NQ*d) = shape(d); }
+   }
+   const Operator *R = fes.GetElementRestriction(ElementDofOrdering::NATIVE);
+   Vector e_vec(R->Height());
+   R->Mult(gf, e_vec);
+
+   const int vdim = fes.GetVDim();
+   q_val.SetSize(vdim*NQ*NE);
+   auto B = Reshape(b.Read(), NQ, ND);
+   auto E = Reshape(e_vec.Read(), ND, vdim, NE);
+   auto Q = Reshape(q_val.Write(), vdim, NQ, NE);
+   MFEM_FORALL(i, NQ*NE,
+   {
+      const int q = i % NQ;
+      const int e = i / NQ;
+      for (int c = 0; c < vdim; c++)
+      {
+         double u = 0.0;
+         for (int d = 0; d < ND; d++) { u += B(q,d)*E(d,c,e); }
+         Q(c,q,e) = u;
+      }
+   });
+   return true;
+}
+
+// Compute the physical coordinates of the points of @a qs, with layout
+// (SDIM x NQ x NE), by interpolating the mesh nodes, or the vertices of a mesh
+// without nodes, on the device. Return false if the mesh nodes are not
+// supported by GridFunctionValues() or the mesh has mixed geometries.
+static bool PhysicalCoordinates(const QuadratureSpace &qs, Vector &x)
+{
+   const Mesh *mesh = qs.GetMesh();
+   const GridFunction *nodes = mesh->GetNodes();
+   if (nodes) { return GridFunctionValues(*nodes, qs, x); }
+   if (mesh->GetNE() == 0 || UniformNumPoints(qs) < 0) { return false; }
+
+   const IntegrationRule &ir = qs.GetElementIntRule(0);
+   GeometricFactors geom(mesh, ir, GeometricFactors::COORDINATES);
+   const int sdim = mesh->SpaceDimension();
+   const int NQ = ir.GetNPoints();
+   const int NE = mesh->GetNE();
+   x.SetSize(sdim*NQ*NE);
+   auto X = Reshape(geom.X.Read(), NQ, sdim, NE);
+   auto Y = Reshape(x.Write(), sdim, NQ, NE);
+   MFEM_FORALL(i, NQ*NE,
+   {
+      const int q = i % NQ;
+      const int e = i / NQ;
+      for (int d = 0; d < sdim; d++) { Y(d,q,e) = X(q,d,e); }
+   });
+   return true;
+}
+
+// Set all points of @a qf to the constant vector @a c.
+static void ProjectConstant(const Vector &c, QuadratureFunction &qf)
+{
+   const int vdim = c.Size();
+   const int N = qf.Size() / vdim;
+   auto C = c.Read();
+   auto Q = Reshape(qf.Write(), vdim, N);
+   MFEM_FORALL(i, N,
+   {
+      for (int j = 0; j < vdim; j++) { Q(j,i) = C[j]; }
+   });
+}
+
+void Coefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetVDim() == 1, "invalid QuadratureFunction vdim");
+   Mesh &mesh = *qf.GetSpace()->GetMesh();
+   Vector values;
+   qf.HostWrite();
+   for (int e = 0; e < mesh.GetNE(); e++)
+   {
+      ElementTransformation &T = *mesh.GetElementTransformation(e);
+      const IntegrationRule &ir = qf.GetElementIntRule(e);
+      qf.GetElementValues(e, values);
+      for (int i = 0; i < ir.GetNPoints(); i++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(i);
+         T.SetIntPoint(&ip);
+         values(i) = Eval(T, ip);
+      }
+   }
+}
+
+void ConstantCoefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetVDim() == 1, "invalid QuadratureFunction vdim");
+   qf = constant;
+}
+
+void PWConstCoefficient::Project(QuadratureFunction &qf)
+{
+   const QuadratureSpace &qs = *qf.GetSpace();
+   const int NQ = UniformNumPoints(qs);
+   if (NQ < 0 || qf.GetVDim() != 1) { Coefficient::Project(qf); return; }
+
+   const Mesh &mesh = *qs.GetMesh();
+   const int NE = mesh.GetNE();
+   Array<int> attr(NE);
+   for (int e = 0; e < NE; e++) { attr[e] = mesh.GetAttribute(e); }
+   // Use a copy of the constants, so that Eval() can keep using them on host.
+   const Vector pw_const(constants);
+   auto A = attr.Read();
+   auto C = pw_const.Read();
+   auto Q = qf.Write();
+   MFEM_FORALL(i, NQ*NE, Q[i] = C[A[i/NQ]-1];);
+}
+
+void FunctionCoefficient::Project(QuadratureFunction &qf)
+{
+   const QuadratureSpace &qs = *qf.GetSpace();
+   Vector x;
+   if (qf.GetVDim() != 1 || !PhysicalCoordinates(qs, x))
+   {
+      Coefficient::Project(qf);
+      return;
+   }
+
+   // The function is a host callback: evaluate it at the points computed on
+   // the device, avoiding the per-point ElementTransformation.
+   const int sdim = qs.GetMesh()->SpaceDimension();
+   const int N = qf.Size();
+   const double *X = x.HostRead();
+   double *Q = qf.HostWrite();
+   Vector transip;
+   for (int i = 0; i < N; i++)
+   {
+      transip.SetDataAndSize(const_cast<double*>(X) + i*sdim, sdim);
+      Q[i] = Function ? Function(transip) : TDFunction(transip, GetTime());
+   }
+}
+
+void GridFunctionCoefficient::Project(QuadratureFunction &qf)
+{
+   Vector q_val;
+   if (qf.GetVDim() != 1 ||
+       !GridFunctionValues(*GridF, *qf.GetSpace(), q_val))
+   {
+      Coefficient::Project(qf);
+      return;
+   }
+   const int vdim = GridF->FESpace()->GetVDim();
+   const int comp = Component - 1;
+   const int N = qf.Size();
+   auto V = Reshape(q_val.Read(), vdim, N);
+   auto Q = qf.Write();
+   MFEM_FORALL(i, N, Q[i] = V(comp,i););
+}
+
+void SumCoefficient::Project(QuadratureFunction &qf)
+{
+   b->Project(qf);
+   qf *= beta;
+   if (a == NULL)
+   {
+      qf += alpha*aConst;
+   }
+   else
+   {
+      QuadratureFunction qa(qf.GetSpace());
+      a->Project(qa);
+      qf.Add(alpha, qa);
+   }
+}
+
+void ProductCoefficient::Project(QuadratureFunction &qf)
+{
+   b->Project(qf);
+   if (a == NULL)
+   {
+      qf *= aConst;
+   }
+   else
+   {
+      QuadratureFunction qa(qf.GetSpace());
+      a->Project(qa);
+      auto A = qa.Read();
+      auto Q = qf.ReadWrite();
+      MFEM_FORALL(i, qf.Size(), Q[i] *= A[i];);
+   }
+}
+
+void PowerCoefficient::Project(QuadratureFunction &qf)
+{
+   a->Project(qf);
+   const double pow_p = p;
+   auto Q = qf.ReadWrite();
+   MFEM_FORALL(i, qf.Size(), Q[i] = pow(Q[i], pow_p););
+}
+
+void VectorCoefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetVDim() == vdim, "invalid QuadratureFunction vdim");
+   Mesh &mesh = *qf.GetSpace()->GetMesh();
+   DenseMatrix values;
+   Vector V(vdim);
+   qf.HostWrite();
+   for (int e = 0; e < mesh.GetNE(); e++)
+   {
+      ElementTransformation &T = *mesh.GetElementTransformation(e);
+      const IntegrationRule &ir = qf.GetElementIntRule(e);
+      qf.GetElementValues(e, values);
+      for (int i = 0; i < ir.GetNPoints(); i++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(i);
+         T.SetIntPoint(&ip);
+         Eval(V, T, ip);
+         values.SetCol(i, V);
+      }
+   }
+}
+
+void VectorConstantCoefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetVDim() == vdim, "invalid QuadratureFunction vdim");
+   ProjectConstant(Vector(vec), qf);
+}
+
+void VectorFunctionCoefficient::Project(QuadratureFunction &qf)
+{
+   const QuadratureSpace &qs = *qf.GetSpace();
+   Vector x;
+   if (qf.GetVDim() != vdim || !PhysicalCoordinates(qs, x))
+   {
+      VectorCoefficient::Project(qf);
+      return;
+   }
+
+   const int sdim = qs.GetMesh()->SpaceDimension();
+   const int N = qf.Size() / vdim;
+   const double *X = x.HostRead();
+   double *Y = qf.HostWrite();
+   Vector transip, V;
+   for (int i = 0; i < N; i++)
+   {
+      transip.SetDataAndSize(const_cast<double*>(X) + i*sdim, sdim);
+      V.SetDataAndSize(Y + i*vdim, vdim);
+      if (Function) { Function(transip, V); }
+      else { TDFunction(transip, GetTime(), V); }
+   }
+   if (Q)
+   {
+      QuadratureFunction qq(qf.GetSpace());
+      Q->SetTime(GetTime());
+      Q->Project(qq);
+      const int vd = vdim;
+      auto S = qq.Read();
+      auto R = Reshape(qf.ReadWrite(), vd, N);
+      MFEM_FORALL(i, N,
+      {
+         for (int j = 0; j < vd; j++) { R(j,i) *= S[i]; }
+      });
+   }
+}
+
+void VectorGridFunctionCoefficient::Project(QuadratureFunction &qf)
+{
+   if (qf.GetVDim() != vdim ||
+       !GridFunctionValues(*GridFunc, *qf.GetSpace(), qf))
+   {
+      VectorCoefficient::Project(qf);
+   }
+}
+
+void MatrixCoefficient::Project(QuadratureFunction &qf, bool transpose)
+{
+   MFEM_VERIFY(qf.GetVDim() == height*width, "invalid QuadratureFunction vdim");
+   Mesh &mesh = *qf.GetSpace()->GetMesh();
+   DenseMatrix values, K(height, width);
+   qf.HostWrite();
+   for (int e = 0; e < mesh.GetNE(); e++)
+   {
+      ElementTransformation &T = *mesh.GetElementTransformation(e);
+      const IntegrationRule &ir = qf.GetElementIntRule(e);
+      qf.GetElementValues(e, values);
+      for (int i = 0; i < ir.GetNPoints(); i++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(i);
+         T.SetIntPoint(&ip);
+         Eval(K, T, ip);
+         for (int c = 0; c < width; c++)
+         {
+            for (int r = 0; r < height; r++)
+            {
+               values(transpose ? c + r*width : r + c*height, i) = K(r,c);
+            }
+         }
+      }
+   }
+}
+
+void MatrixConstantCoefficient::Project(QuadratureFunction &qf,
+                                        bool transpose)
+{
+   MFEM_VERIFY(qf.GetVDim() == height*width, "invalid QuadratureFunction vdim");
+   Vector c(height*width);
+   for (int j = 0; j < width; j++)
+   {
+      for (int i = 0; i < height; i++)
+      {
+         c(transpose ? j + i*width : i + j*height) = mat(i,j);
+      }
+   }
+   ProjectConstant(c, qf);
+}
+
+void VectorQuadratureFunctionCoefficient::Project(QuadratureFunction &qf)
+{
+   if (qf.GetVDim() != vdim || !SameQuadraturePoints(QuadF, qf))
+   {
+      VectorCoefficient::Project(qf);
+      return;
+   }
+   const int vd = vdim, qvdim = QuadF.GetVDim(), idx = index;
+   const int N = qf.Size() / vd;
+   auto F = Reshape(QuadF.Read(), qvdim, N);
+   auto Q = Reshape(qf.Write(), vd, N);
+   MFEM_FORALL(i, N,
+   {
+      for (int j = 0; j < vd; j++) { Q(j,i) = F(idx+j,i); }
+   });
+}
+
+void QuadratureFunctionCoefficient::Project(QuadratureFunction &qf)
+{
+   if (qf.GetVDim() != 1 || !SameQuadraturePoints(QuadF, qf))
+   {
+      Coefficient::Project(qf);
+      return;
+   }
+   qf = QuadF;
+}
+
 }
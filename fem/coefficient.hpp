@@ -23,6 +23,7 @@ namespace mfem
 {
 
 class Mesh;
+class QuadratureFunction;
 
 #ifdef MFEM_USE_MPI
 class ParMesh;
@@ -70,6 +71,13 @@ public:
       return Eval(T, ip);
    }
 
+   /** @brief Evaluate the coefficient at all quadrature points of the
+       QuadratureFunction @a qf, which must have vector dimension 1. */
+   /** The general implementation provided by the base class calls Eval() at
+       each point; derived classes overload it with batched implementations
+       that can run on the device. */
+   virtual void Project(QuadratureFunction &qf);
+
    virtual ~Coefficient() { }
 };
 
@@ -87,6 +95,9 @@ public:
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip)
    { return (constant); }
+
+   /// Set all values of @a qf to the constant.
+   virtual void Project(QuadratureFunction &qf);
 };
 
 /** @brief A piecewise constant coefficient with the constants keyed
@@ -123,6 +134,9 @@ public:
    /// Evaluate the coefficient.
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip);
+
+   /// Evaluate the coefficient at all points of @a qf using the device.
+   virtual void Project(QuadratureFunction &qf);
 };
 
 /// A general function coefficient
@@ -166,6 +180,10 @@ public:
    /// Evaluate the coefficient at @a ip.
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip);
+
+   /** @brief Evaluate the coefficient at all points of @a qf, using physical
+       coordinates interpolated from the mesh nodes on the device. */
+   virtual void Project(QuadratureFunction &qf);
 };
 
 class GridFunction;
@@ -193,6 +211,10 @@ public:
    /// Evaluate the coefficient at @a ip.
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip);
+
+   /** @brief Evaluate the coefficient at all points of @a qf, interpolating
+       the E-vector of the GridFunction on the device. */
+   virtual void Project(QuadratureFunction &qf);
 };
 
 
@@ -381,6 +403,13 @@ public:
    virtual void Eval(DenseMatrix &M, ElementTransformation &T,
                      const IntegrationRule &ir);
 
+   /** @brief Evaluate the vector coefficient at all quadrature points of the
+       QuadratureFunction @a qf, which must have vector dimension GetVDim(). */
+   /** The general implementation provided by the base class calls Eval() at
+       each point; derived classes overload it with batched implementations
+       that can run on the device. */
+   virtual void Project(QuadratureFunction &qf);
+
    virtual ~VectorCoefficient() { }
 };
 
@@ -400,6 +429,9 @@ public:
    virtual void Eval(Vector &V, ElementTransformation &T,
                      const IntegrationPoint &ip) { V = vec; }
 
+   /// Set all values of @a qf to the constant vector.
+   virtual void Project(QuadratureFunction &qf);
+
    /// Return a reference to the constant vector in this class.
    const Vector& GetVec() { return vec; }
 };
@@ -438,6 +470,10 @@ public:
    virtual void Eval(Vector &V, ElementTransformation &T,
                      const IntegrationPoint &ip);
 
+   /** @brief Evaluate the vector coefficient at all points of @a qf, using
+       physical coordinates interpolated from the mesh nodes on the device. */
+   virtual void Project(QuadratureFunction &qf);
+
    virtual ~VectorFunctionCoefficient() { }
 };
 
@@ -512,6 +548,10 @@ public:
    virtual void Eval(DenseMatrix &M, ElementTransformation &T,
                      const IntegrationRule &ir);
 
+   /** @brief Evaluate the vector coefficient at all points of @a qf,
+       interpolating the E-vector of the GridFunction on the device. */
+   virtual void Project(QuadratureFunction &qf);
+
    virtual ~VectorGridFunctionCoefficient() { }
 };
 
@@ -744,6 +784,16 @@ public:
                               const IntegrationPoint &ip)
    { mfem_error("MatrixCoefficient::EvalSymmetric"); }
 
+   /** @brief Evaluate the matrix coefficient at all quadrature points of the
+       QuadratureFunction @a qf, which must have vector dimension
+       GetHeight()*GetWidth(). */
+   /** At each point, the matrix is stored in column-major order, or in
+       row-major order (i.e. its transpose is stored) when @a transpose is
+       true. The general implementation provided by the base class calls Eval()
+       at each point; derived classes overload it with batched implementations
+       that can run on the device. */
+   virtual void Project(QuadratureFunction &qf, bool transpose = false);
+
    virtual ~MatrixCoefficient() { }
 };
 
@@ -761,6 +811,9 @@ public:
    /// Evaluate the matrix coefficient at @a ip.
    virtual void Eval(DenseMatrix &M, ElementTransformation &T,
                      const IntegrationPoint &ip) { M = mat; }
+
+   /// Set all values of @a qf to the constant matrix.
+   virtual void Project(QuadratureFunction &qf, bool transpose = false);
 };
 
 
@@ -943,6 +996,10 @@ public:
       return alpha * ((a == NULL ) ? aConst : a->Eval(T, ip) )
              + beta * b->Eval(T, ip);
    }
+
+   /** @brief Evaluate the coefficient at all points of @a qf by projecting the
+       terms of the sum and combining them with Vector operations. */
+   virtual void Project(QuadratureFunction &qf);
 };
 
 
@@ -1082,6 +1139,10 @@ public:
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip)
    { return ((a == NULL ) ? aConst : a->Eval(T, ip) ) * b->Eval(T, ip); }
+
+   /** @brief Evaluate the coefficient at all points of @a qf by projecting the
+       factors of the product and combining them with Vector operations. */
+   virtual void Project(QuadratureFunction &qf);
 };
 
 /** @brief Scalar coefficient defined as the ratio of two scalars where one or
@@ -1165,6 +1226,10 @@ public:
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip)
    { return pow(a->Eval(T, ip), p); }
+
+   /** @brief Evaluate the coefficient at all points of @a qf by projecting the
+       base coefficient and raising the values to the power on the device. */
+   virtual void Project(QuadratureFunction &qf);
 };
 
 
@@ -1658,8 +1723,6 @@ public:
 };
 ///@}
 
-class QuadratureFunction;
-
 /** @brief Vector quadrature function coefficient which requires that the
     quadrature rules used for this vector coefficient be the same as those that
     live within the supplied QuadratureFunction. */
@@ -1684,6 +1747,10 @@ public:
    virtual void Eval(Vector &V, ElementTransformation &T,
                      const IntegrationPoint &ip);
 
+   /** @brief Copy the selected components of the QuadratureFunction to @a qf
+       on the device, when both share the same quadrature points. */
+   virtual void Project(QuadratureFunction &qf);
+
    virtual ~VectorQuadratureFunctionCoefficient() { }
 };
 
@@ -1703,6 +1770,10 @@ public:
 
    virtual double Eval(ElementTransformation &T, const IntegrationPoint &ip);
 
+   /** @brief Copy the QuadratureFunction to @a qf on the device, when both
+       share the same quadrature points. */
+   virtual void Project(QuadratureFunction &qf);
+
    virtual ~QuadratureFunctionCoefficient() { }
 };
 
@@ -20,13 +20,38 @@ ElementTransformation::ElementTransformation()
    : IntPoint(static_cast<IntegrationPoint *>(NULL)),
      EvalState(0),
      geom(Geometry::INVALID),
+     batch_ir(NULL),
      Attribute(-1),
      ElementNo(-1)
 { }
 
+int ElementTransformation::BatchIndex() const
+{
+   if (batch_ir == NULL || IntPoint == NULL) { return -1; }
+   const int nq = batch_ir->GetNPoints();
+   if (nq == 0) { return -1; }
+   const IntegrationPoint *ip0 = &batch_ir->IntPoint(0);
+   if (IntPoint < ip0 || IntPoint >= ip0 + nq) { return -1; }
+   const int i = (int)(IntPoint - ip0);
+   // The coordinates are also compared, in case the rule was destroyed and
+   // its memory reused since the call to SetIntRule().
+   const double *x = batch_pts.GetColumn(i);
+   if (IntPoint->x != x[0] || IntPoint->y != x[1] || IntPoint->z != x[2])
+   {
+      return -1;
+   }
+   return i;
+}
+
 double ElementTransformation::EvalWeight()
 {
    MFEM_ASSERT((EvalState & WEIGHT_MASK) == 0, "");
+   const int i = BatchIndex();
+   if (i >= 0)
+   {
+      EvalState |= WEIGHT_MASK;
+      return (Wght = batch_W(i));
+   }
    Jacobian();
    EvalState |= WEIGHT_MASK;
    return (Wght = (dFdx.Width() == 0) ? 1.0 : dFdx.Weight());
@@ -35,6 +60,16 @@ double ElementTransformation::EvalWeight()
 const DenseMatrix &ElementTransformation::EvalAdjugateJ()
 {
    MFEM_ASSERT((EvalState & ADJUGATE_MASK) == 0, "");
+   const int i = BatchIndex();
+   if (i >= 0)
+   {
+      const int dim = batch_adjJ.Height();
+      const int sdim = batch_adjJ.Width()/batch_W.Size();
+      adjJ.SetSize(dim, sdim);
+      adjJ = batch_adjJ.GetColumn(i*sdim);
+      EvalState |= ADJUGATE_MASK;
+      return adjJ;
+   }
    Jacobian();
    adjJ.SetSize(dFdx.Width(), dFdx.Height());
    if (dFdx.Width() > 0) { CalcAdjugate(dFdx, adjJ); }
@@ -392,12 +427,135 @@ void IsoparametricTransformation::SetIdentityTransformation(
       nodes.IntPoint(j).Get(&PointMat(0,j), dim);
    }
    geom = GeomType;
+   Reset();
+}
+
+void IsoparametricTransformation::SetIntRule(const IntegrationRule *ir)
+{
+   if (ir == NULL) { batch_ir = NULL; return; }
+   const int nq = ir->GetNPoints();
+   if (ir == batch_ir && batch_W.Size() == nq)
+   {
+      // Reuse the data if the points have not changed.
+      bool same = true;
+      for (int i = 0; same && i < nq; i++)
+      {
+         const IntegrationPoint &ip = ir->IntPoint(i);
+         const double *x = batch_pts.GetColumn(i);
+         same = (ip.x == x[0] && ip.y == x[1] && ip.z == x[2]);
+      }
+      if (same) { return; }
+   }
+   batch_ir = NULL;
+
+   const int dim = FElem->GetDim(), nd = FElem->GetDof();
+   const int sdim = PointMat.Height();
+   if (dim == 0 || nq == 0) { return; }
+
+   // Reference gradients at all points as a (nd) x (dim*nq) matrix
+   DenseMatrix dshape_all;
+   const ShapeTable *table = FElem->GetShapeTable(*ir);
+   if (table)
+   {
+      dshape_all.UseExternalData(table->dshape.Data(),
+                                 nd, dim*nq);
+   }
+   else
+   {
+      dshape_all.SetSize(nd, dim*nq);
+      DenseMatrix ds;
+      for (int i = 0; i < nq; i++)
+      {
+         ds.UseExternalData(dshape_all.GetColumn(i*dim), nd, dim);
+         FElem->CalcDShape(ir->IntPoint(i), ds);
+      }
+   }
+
+   batch_pts.SetSize(3, nq);
+   for (int i = 0; i < nq; i++)
+   {
+      const IntegrationPoint &ip = ir->IntPoint(i);
+      batch_pts(0,i) = ip.x;
+      batch_pts(1,i) = ip.y;
+      batch_pts(2,i) = ip.z;
+   }
+
+   // All Jacobians: (sdim) x (dim*nq)
+   batch_J.SetSize(sdim, dim*nq);
+   Mult(PointMat, dshape_all, batch_J);
+
+   batch_W.SetSize(nq);
+   batch_adjJ.SetSize(dim, sdim*nq);
+   const double *J = batch_J.Data();
+   double *A = batch_adjJ.Data();
+   double *W = batch_W.GetData();
+   if (dim == sdim && dim == 1)
+   {
+      for (int i = 0; i < nq; i++)
+      {
+         W[i] = J[i];
+         A[i] = 1.0;
+      }
+   }
+   else if (dim == sdim && dim == 2)
+   {
+      for (int i = 0; i < nq; i++)
+      {
+         const double *j = J + 4*i;
+         double *a = A + 4*i;
+         W[i] = j[0]*j[3] - j[1]*j[2];
+         a[0] =  j[3];
+         a[1] = -j[1];
+         a[2] = -j[2];
+         a[3] =  j[0];
+      }
+   }
+   else if (dim == sdim && dim == 3)
+   {
+      for (int i = 0; i < nq; i++)
+      {
+         const double *j = J + 9*i;
+         double *a = A + 9*i;
+         a[0] = j[4]*j[8] - j[7]*j[5];
+         a[1] = j[7]*j[2] - j[1]*j[8];
+         a[2] = j[1]*j[5] - j[4]*j[2];
+         a[3] = j[6]*j[5] - j[3]*j[8];
+         a[4] = j[0]*j[8] - j[6]*j[2];
+         a[5] = j[3]*j[2] - j[0]*j[5];
+         a[6] = j[3]*j[7] - j[6]*j[4];
+         a[7] = j[6]*j[1] - j[0]*j[7];
+         a[8] = j[0]*j[4] - j[3]*j[1];
+         W[i] = j[0]*a[0] + j[1]*a[3] + j[2]*a[6];
+      }
+   }
+   else
+   {
+      DenseMatrix Ji, Ai;
+      for (int i = 0; i < nq; i++)
+      {
+         Ji.UseExternalData(batch_J.GetColumn(i*dim), sdim, dim);
+         Ai.UseExternalData(batch_adjJ.GetColumn(i*sdim), dim, sdim);
+         W[i] = Ji.Weight();
+         CalcAdjugate(Ji, Ai);
+      }
+   }
+   batch_ir = ir;
 }
 
 const DenseMatrix &IsoparametricTransformation::EvalJacobian()
 {
    MFEM_ASSERT((EvalState & JACOBIAN_MASK) == 0, "");
 
+   const int i = BatchIndex();
+   if (i >= 0)
+   {
+      const int dim = FElem->GetDim();
+      dFdx.SetSize(PointMat.Height(), dim);
+      dFdx = batch_J.GetColumn(i*dim);
+      EvalState |= JACOBIAN_MASK;
+      return dFdx;
+   }
+
    dshape.SetSize(FElem->GetDof(), FElem->GetDim());
    dFdx.SetSize(PointMat.Height(), dshape.Width());
    if (dshape.Width() > 0)
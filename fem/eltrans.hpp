@@ -38,6 +38,18 @@ protected:
    };
    Geometry::Type geom;
 
+   /// The IntegrationRule given to SetIntRule(), or NULL. Not owned.
+   const IntegrationRule *batch_ir;
+   /** Data computed by SetIntRule() at all points of #batch_ir: the point
+       coordinates (3 x NQ), the Jacobians (SDIM x DIM*NQ), their adjugates
+       (DIM x SDIM*NQ) and the weights. */
+   DenseMatrix batch_pts, batch_J, batch_adjJ;
+   Vector batch_W;
+
+   /** @brief Return the index of the IntPoint in #batch_ir, or -1 if the
+       IntPoint is not a point of #batch_ir. */
+   int BatchIndex() const;
+
    /** @brief Evaluate the Jacobian of the transformation at the IntPoint and
        store it in dFdx. */
    virtual const DenseMatrix &EvalJacobian() = 0;
@@ -78,13 +90,24 @@ public:
    ElementTransformation();
 
    /** @brief Force the reevaluation of the Jacobian in the next call. */
-   void Reset() { EvalState = 0; }
+   /** This also discards the data computed by SetIntRule(). */
+   void Reset() { EvalState = 0; batch_ir = NULL; }
 
    /** @brief Set the integration point @a ip that weights and Jacobians will
        be evaluated at. */
    void SetIntPoint(const IntegrationPoint *ip)
    { IntPoint = ip; EvalState = 0; }
 
+   /** @brief Compute the Jacobians, weights and adjugate Jacobians at all
+       points of @a ir at once. */
+   /** After this call, Jacobian(), Weight() and AdjugateJacobian() return the
+       precomputed values whenever the point set with SetIntPoint() is one of
+       the points of @a ir, i.e. a reference returned by ir->IntPoint(i). The
+       data is discarded by Reset(), e.g. when the transformation is moved to
+       another element. Calling the method again with the same @a ir does not
+       recompute the data. The default implementation does nothing. */
+   virtual void SetIntRule(const IntegrationRule *ir) { }
+
    /** @brief Get a const reference to the currently set integration point.  This
        will return NULL if no integration point is set. */
    const IntegrationPoint &GetIntPoint() { return *IntPoint; }
@@ -368,7 +391,7 @@ public:
    void SetFE(const FiniteElement *FE)
    {
       MFEM_ASSERT(FE != NULL, "Must provide a valid FiniteElement object!");
-      EvalState = (FE != FElem) ? 0 : EvalState;
+      if (FE != FElem) { Reset(); }
       FElem = FE; geom = FE->GetGeomType();
    }
 
@@ -385,7 +408,7 @@ public:
        the column-vector of all basis functions evaluated at \f$ \hat x \f$ .
        The columns of @a P represent the control points in physical space
        defining the transformation. */
-   void SetPointMat(const DenseMatrix &pm) { PointMat = pm; EvalState = 0; }
+   void SetPointMat(const DenseMatrix &pm) { PointMat = pm; Reset(); }
 
    /// Return the stored point matrix.
    const DenseMatrix &GetPointMat() const { return PointMat; }
@@ -393,8 +416,9 @@ public:
    /// @brief Write access to the stored point matrix. Use with caution.
    /** If the point matrix is altered using this member function the Reset
        function should also be called to force the reevaluation of the
-       Jacobian, etc.. */
-   DenseMatrix &GetPointMat() { return PointMat; }
+       Jacobian, etc.. This method discards the data computed by
+       SetIntRule(). */
+   DenseMatrix &GetPointMat() { batch_ir = NULL; return PointMat; }
 
    /// Set the FiniteElement Geometry for the reference elements being used.
    void SetIdentityTransformation(Geometry::Type GeomType);
@@ -413,6 +437,13 @@ public:
        coordinates and store them as column vectors in @a result. */
    virtual void Transform(const DenseMatrix &matrix, DenseMatrix &result);
 
+   /** @brief Compute the Jacobians, weights and adjugate Jacobians at all
+       points of @a ir at once, see ElementTransformation::SetIntRule(). */
+   /** The Jacobians are computed with a single matrix-matrix product of the
+       point matrix with the reference gradients of the transformation element
+       at all points, as tabulated by FiniteElement::GetShapeTable(). */
+   virtual void SetIntRule(const IntegrationRule *ir);
+
    /// Return the order of the current element we are using for the transformation.
    virtual int Order() const { return FElem->GetOrder(); }
 
@@ -387,6 +387,10 @@ FiniteElement::~FiniteElement()
    {
       delete dof2quad_array[i];
    }
+   for (int i = 0; i < shape_table_array.Size(); i++)
+   {
+      delete shape_table_array[i];
+   }
 }
 
 
@@ -549,6 +553,63 @@ const DofToQuad &ScalarFiniteElement::GetDofToQuad(const IntegrationRule &ir,
    return *d2q;
 }
 
+// Return true if the points of the two rules have the same coordinates.
+static bool SamePoints(const IntegrationRule &a, const IntegrationRule &b)
+{
+   if (a.GetNPoints() != b.GetNPoints()) { return false; }
+   for (int i = 0; i < a.GetNPoints(); i++)
+   {
+      const IntegrationPoint &ipa = a.IntPoint(i), &ipb = b.IntPoint(i);
+      if (ipa.x != ipb.x || ipa.y != ipb.y || ipa.z != ipb.z) { return false; }
+   }
+   return true;
+}
+
+const ShapeTable *ScalarFiniteElement::GetShapeTable(
+   const IntegrationRule &ir) const
+{
+   // Limit on the number of tables stored by one element, in case it is used
+   // with many different rules.
+   const int max_tables = 32;
+
+   ShapeTable *table = NULL;
+#ifdef MFEM_USE_LEGACY_OPENMP
+   #pragma omp critical (ShapeTable)
+#endif
+   {
+      for (int i = 0; i < shape_table_array.Size(); i++)
+      {
+         if (SamePoints(shape_table_array[i]->IntRule, ir))
+         {
+            table = shape_table_array[i];
+            break;
+         }
+      }
+      if (table == NULL && shape_table_array.Size() < max_tables)
+      {
+         const int nqpt = ir.GetNPoints();
+         table = new ShapeTable;
+         table->FE = this;
+         table->IntRule = ir;
+         table->ndof = dof;
+         table->dim = dim;
+         table->shape.SetSize(dof, nqpt);
+         table->dshape.SetSize(dof*dim, nqpt);
+         Vector shape;
+         DenseMatrix dshape;
+         for (int i = 0; i < nqpt; i++)
+         {
+            shape.SetDataAndSize(table->shape.GetColumn(i), dof);
+            dshape.UseExternalData(table->dshape.GetColumn(i), dof, dim);
+            CalcShape(ir.IntPoint(i), shape);
+            CalcDShape(ir.IntPoint(i), dshape);
+         }
+         shape_table_array.Append(table);
+      }
+   }
+   return table;
+}
+
 // protected method
 const DofToQuad &ScalarFiniteElement::GetTensorDofToQuad(
    const TensorBasisElement &tb,
@@ -209,6 +209,51 @@ public:
 };
 
 
+/** @brief Structure storing the reference shape functions and gradients of a
+    scalar FiniteElement tabulated at the points of an IntegrationRule. */
+/** Objects of this type are created and owned by the FiniteElement, see
+    FiniteElement::GetShapeTable(). They replace repeated calls to
+    FiniteElement::CalcShape() and FiniteElement::CalcDShape() at the same
+    points, e.g. in the element assembly loops. */
+class ShapeTable
+{
+public:
+   /// The FiniteElement that created and owns this object.
+   /** This pointer is not owned. */
+   const class FiniteElement *FE;
+
+   /** @brief Copy of the IntegrationRule that defines the points at which the
+       basis functions of the #FE are evaluated. */
+   IntegrationRule IntRule;
+
+   /// Number of degrees of freedom and reference space dimension of the #FE.
+   int ndof, dim;
+
+   /// Basis functions evaluated at the points, with dimensions ndof x nqpt.
+   DenseMatrix shape;
+
+   /** @brief Reference gradients of the basis functions evaluated at the
+       points, with dimensions (ndof x dim) x nqpt. */
+   /** Column @a i is the ndof x dim matrix returned by CalcDShape() at the
+       @a i-th point, in column-major layout. */
+   DenseMatrix dshape;
+
+   /// Same as FE->CalcShape(IntRule.IntPoint(i), s).
+   void CalcShape(int i, Vector &s) const
+   {
+      s.SetSize(ndof);
+      s = shape.GetColumn(i);
+   }
+
+   /// Same as FE->CalcDShape(IntRule.IntPoint(i), ds).
+   void CalcDShape(int i, DenseMatrix &ds) const
+   {
+      ds.SetSize(ndof, dim);
+      ds = dshape.GetColumn(i);
+   }
+};
+
+
 /// Describes the function space on each element
 class FunctionSpace
 {
@@ -251,6 +296,8 @@ protected:
    /** Multiple DofToQuad objects may be needed when different quadrature rules
        or different DofToQuad::Mode are used. */
    mutable Array<DofToQuad*> dof2quad_array;
+   /// Container for all ShapeTable objects created by GetShapeTable().
+   mutable Array<ShapeTable*> shape_table_array;
 
 public:
    /// Enumeration for range_type and deriv_range_type
@@ -569,6 +616,18 @@ public:
    /** See the documentation for DofToQuad for more details. */
    virtual const DofToQuad &GetDofToQuad(const IntegrationRule &ir,
                                          DofToQuad::Mode mode) const;
+
+   /** @brief Return a ShapeTable with the shape functions and reference
+       gradients tabulated at the points of @a ir, or NULL if the element
+       does not support tabulation. */
+   /** The tables are cached by the FiniteElement and matched by the
+       coordinates of the points (not by the address of @a ir), so @a ir may
+       be a temporary object. The returned pointer remains valid for the
+       lifetime of the FiniteElement. The default implementation returns
+       NULL. */
+   virtual const ShapeTable *GetShapeTable(const IntegrationRule &ir) const
+   { return NULL; }
+
    /// Deconstruct the FiniteElement
    virtual ~FiniteElement();
 
@@ -691,6 +750,8 @@ public:
 
    virtual const DofToQuad &GetDofToQuad(const IntegrationRule &ir,
                                          DofToQuad::Mode mode) const;
+
+   virtual const ShapeTable *GetShapeTable(const IntegrationRule &ir) const;
 };
 
 
@@ -3319,6 +3380,10 @@ public:
    Vector              &Weights    ()         const { return weights; }
    /// Update the NURBSFiniteElement according to the currently set knot vectors
    virtual void         SetOrder   ()         const { }
+
+   /// The shape functions depend on the current patch and element.
+   virtual const ShapeTable *GetShapeTable(const IntegrationRule &ir) const
+   { return NULL; }
 };
 
 
@@ -60,7 +60,7 @@ DofsToVDofs<Ordering::byVDIM>(int ndofs, int vdim, Array<int> &dofs)
 FiniteElementSpace::FiniteElementSpace()
    : mesh(NULL), fec(NULL), vdim(0), ordering(Ordering::byNODES),
      ndofs(0), nvdofs(0), nedofs(0), nfdofs(0), nbdofs(0),
-     fdofs(NULL), bdofs(NULL),
+     fdofs(NULL), bdofs(NULL), dof_renumbering(DofRenumbering::NATIVE),
      elem_dof(NULL), bdrElem_dof(NULL), face_dof(NULL),
      NURBSext(NULL), own_ext(false),
      cP(NULL), cR(NULL), cP_is_set(false),
@@ -309,6 +309,161 @@ void FiniteElementSpace::ReorderElementToDofTable()
    }
 }
 
+void FiniteElementSpace::SetDofRenumbering(DofRenumbering::Type type)
+{
+   MFEM_VERIFY(!NURBSext, "DOF renumbering is not supported for NURBS spaces");
+   if (type == dof_renumbering) { return; }
+
+   dof_renumbering = type;
+   Destroy();
+   Construct(); // calls BuildDofRenumbering()
+   BuildElementToDofTable();
+}
+
+// Breadth-first search of the connected component of 'graph' containing
+// 'root', skipping the vertices with marker[v] >= 0. On return, 'queue'
+// contains the vertices of the component level by level and 'level_start' the
+// offsets of the levels in 'queue'.
+static void DofGraphLevels(const Table &graph, int root,
+                           const Array<int> &marker, Array<int> &level,
+                           Array<int> &queue, Array<int> &level_start)
+{
+   queue.SetSize(0);
+   level_start.SetSize(0);
+   queue.Append(root);
+   level[root] = 0;
+   for (int head = 0; head < queue.Size(); head++)
+   {
+      const int v = queue[head];
+      if (level_start.Size() == level[v]) { level_start.Append(head); }
+      const int *row = graph.GetRow(v), size = graph.RowSize(v);
+      for (int j = 0; j < size; j++)
+      {
+         const int u = row[j];
+         if (marker[u] < 0 && level[u] < 0)
+         {
+            level[u] = level[v] + 1;
+            queue.Append(u);
+         }
+      }
+   }
+   level_start.Append(queue.Size());
+   for (int i = 0; i < queue.Size(); i++) { level[queue[i]] = -1; }
+}
+
+void FiniteElementSpace::BuildDofRenumbering()
+{
+   // The DOFs returned by GetElementDofs() are native while dof_renum is
+   // empty; the new numbering is built in 'renum'.
+   const int NE = mesh->GetNE();
+   Array<int> dofs, renum(ndofs);
+
+   MFEM_ASSERT(dof_renum.Size() == 0, "internal error");
+   renum = -1;
+
+   if (dof_renumbering == DofRenumbering::ELEMENT)
+   {
+      int counter = 0;
+      for (int i = 0; i < NE; i++)
+      {
+         GetElementDofs(i, dofs);
+         for (int j = 0; j < dofs.Size(); j++)
+         {
+            const int d = DecodeDof(dofs[j]);
+            if (renum[d] < 0) { renum[d] = counter++; }
+         }
+      }
+      for (int d = 0; d < ndofs; d++)
+      {
+         if (renum[d] < 0) { renum[d] = counter++; }
+      }
+      Swap(dof_renum, renum);
+      return;
+   }
+
+   MFEM_VERIFY(dof_renumbering == DofRenumbering::RCM,
+               "unknown DOF renumbering: " << dof_renumbering);
+
+   // The DOF-to-DOF graph: two DOFs are connected if they share an element.
+   Table el_dof;
+   el_dof.MakeI(NE);
+   for (int i = 0; i < NE; i++)
+   {
+      GetElementDofs(i, dofs);
+      el_dof.AddColumnsInRow(i, dofs.Size());
+   }
+   el_dof.MakeJ();
+   for (int i = 0; i < NE; i++)
+   {
+      GetElementDofs(i, dofs);
+      for (int j = 0; j < dofs.Size(); j++) { dofs[j] = DecodeDof(dofs[j]); }
+      el_dof.AddConnections(i, dofs.GetData(), dofs.Size());
+   }
+   el_dof.ShiftUpI();
+   Table dof_el, graph;
+   Transpose(el_dof, dof_el, ndofs);
+   Mult(dof_el, el_dof, graph);
+
+   // Cuthill-McKee ordering of each connected component, starting from a
+   // pseudo-peripheral vertex (George and Liu); 'renum' is used as marker.
+   Array<int> cm(ndofs), level(ndofs), queue, level_start;
+   Array<Pair<int,int> > nbrs;
+   level = -1;
+   cm.SetSize(0);
+   for (int start = 0; start < ndofs; start++)
+   {
+      if (renum[start] >= 0) { continue; }
+
+      int root = start, ecc = -1;
+      while (true)
+      {
+         DofGraphLevels(graph, root, renum, level, queue, level_start);
+         const int new_ecc = level_start.Size() - 2;
+         if (new_ecc <= ecc) { break; }
+         ecc = new_ecc;
+         // Continue from a vertex of minimal degree in the last level.
+         int next = queue[level_start[ecc]];
+         for (int k = level_start[ecc]+1; k < level_start[ecc+1]; k++)
+         {
+            if (graph.RowSize(queue[k]) < graph.RowSize(next))
+            {
+               next = queue[k];
+            }
+         }
+         if (next == root) { break; }
+         root = next;
+      }
+
+      int head = cm.Size();
+      cm.Append(root);
+      renum[root] = 0;
+      for ( ; head < cm.Size(); head++)
+      {
+         const int v = cm[head];
+         const int *row = graph.GetRow(v), size = graph.RowSize(v);
+         nbrs.SetSize(0);
+         for (int j = 0; j < size; j++)
+         {
+            const int u = row[j];
+            if (renum[u] < 0)
+            {
+               nbrs.Append(Pair<int,int>(graph.RowSize(u), u));
+               renum[u] = 0;
+            }
+         }
+         SortPairs<int,int>(nbrs, nbrs.Size());
+         for (int j = 0; j < nbrs.Size(); j++) { cm.Append(nbrs[j].two); }
+      }
+   }
+
+   // Reverse the Cuthill-McKee ordering.
+   for (int k = 0; k < ndofs; k++)
+   {
+      renum[cm[k]] = ndofs-1-k;
+   }
+   Swap(dof_renum, renum);
+}
+
 void FiniteElementSpace::BuildDofToArrays()
 {
    if (dof_elem_array.Size()) { return; }
@@ -1506,6 +1661,7 @@ void FiniteElementSpace::Constructor(Mesh *mesh, NURBSExtension *NURBSext,
    this->fec = fec;
    this->vdim = vdim;
    this->ordering = (Ordering::Type) ordering;
+   dof_renumbering = DofRenumbering::NATIVE;
 
    elem_dof = NULL;
    face_dof = NULL;
@@ -1689,6 +1845,12 @@ void FiniteElementSpace::Construct()
 
    ndofs = nvdofs + nedofs + nfdofs + nbdofs;
 
+   dof_renum.DeleteAll();
+   if (dof_renumbering != DofRenumbering::NATIVE)
+   {
+      BuildDofRenumbering();
+   }
+
    // Do not build elem_dof Table here: in parallel it has to be constructed
    // later.
 }
@@ -1792,6 +1954,7 @@ void FiniteElementSpace::GetElementDofs(int i, Array<int> &dofs) const
             dofs[ne+j] = k + j;
          }
       }
+      RenumberDofs(dofs);
    }
 }
 
@@ -1892,6 +2055,7 @@ void FiniteElementSpace::GetBdrElementDofs(int i, Array<int> &dofs) const
             }
          }
       }
+      RenumberDofs(dofs);
    }
 }
 
@@ -1960,6 +2124,7 @@ void FiniteElementSpace::GetFaceDofs(int i, Array<int> &dofs) const
             dofs[ne+k] = j;
          }
       }
+      RenumberDofs(dofs);
    }
 }
 
@@ -1990,6 +2155,7 @@ void FiniteElementSpace::GetEdgeDofs(int i, Array<int> &dofs) const
    {
       dofs[nv+j] = k;
    }
+   RenumberDofs(dofs);
 }
 
 void FiniteElementSpace::GetVertexDofs(int i, Array<int> &dofs) const
@@ -2002,6 +2168,7 @@ void FiniteElementSpace::GetVertexDofs(int i, Array<int> &dofs) const
    {
       dofs[j] = i*nv+j;
    }
+   RenumberDofs(dofs);
 }
 
 void FiniteElementSpace::GetElementInteriorDofs (int i, Array<int> &dofs) const
@@ -2015,6 +2182,7 @@ void FiniteElementSpace::GetElementInteriorDofs (int i, Array<int> &dofs) const
    {
       dofs[j] = k + j;
    }
+   RenumberDofs(dofs);
 }
 
 void FiniteElementSpace::GetEdgeInteriorDofs (int i, Array<int> &dofs) const
@@ -2027,6 +2195,7 @@ void FiniteElementSpace::GetEdgeInteriorDofs (int i, Array<int> &dofs) const
    {
       dofs[j] = k;
    }
+   RenumberDofs(dofs);
 }
 
 void FiniteElementSpace::GetFaceInteriorDofs (int i, Array<int> &dofs) const
@@ -2042,6 +2211,7 @@ void FiniteElementSpace::GetFaceInteriorDofs (int i, Array<int> &dofs) const
          dofs[j] = k;
       }
    }
+   RenumberDofs(dofs);
 }
 
 const FiniteElement *FiniteElementSpace::GetBE (int i) const
@@ -2132,6 +2302,7 @@ void FiniteElementSpace::Destroy()
    {
       delete x.second;
    }
+   L2F.clear();
    for (int i = 0; i < E2IFQ_array.Size(); i++)
    {
       delete E2IFQ_array[i];
@@ -2478,9 +2649,11 @@ FiniteElementCollection *FiniteElementSpace::Load(Mesh *m, std::istream &input)
 }
 
 
-void QuadratureSpace::Construct()
+void QuadratureSpace::Construct(const IntegrationRule *ir,
+                                Geometry::Type ir_geom)
 {
    // protected method
+   static const IntegrationRule empty_rule;
    int offset = 0;
    const int num_elem = mesh->GetNE();
    element_offsets = new int[num_elem + 1];
@@ -2494,13 +2667,33 @@ void QuadratureSpace::Construct()
       int geom = mesh->GetElementBaseGeometry(i);
       if (int_rule[geom] == NULL)
       {
-         int_rule[geom] = &IntRules.Get(geom, order);
+         if (!ir) { int_rule[geom] = &IntRules.Get(geom, order); }
+         else if (ir_geom == Geometry::INVALID || geom == ir_geom)
+         {
+            int_rule[geom] = ir;
+         }
+         else { int_rule[geom] = &empty_rule; }
       }
       offset += int_rule[geom]->GetNPoints();
    }
    element_offsets[num_elem] = size = offset;
 }
 
+QuadratureSpace::QuadratureSpace(Mesh *mesh_, const IntegrationRule &ir)
+   : mesh(mesh_), order(ir.GetOrder())
+{
+   MFEM_VERIFY(mesh->GetNumGeometries(mesh->Dimension()) <= 1,
+               "the mesh must have only one element geometry");
+   Construct(&ir);
+}
+
+QuadratureSpace::QuadratureSpace(Mesh *mesh_, Geometry::Type geom,
+                                 const IntegrationRule &ir)
+   : mesh(mesh_), order(ir.GetOrder())
+{
+   Construct(&ir, geom);
+}
+
 QuadratureSpace::QuadratureSpace(Mesh *mesh_, std::istream &in)
    : mesh(mesh_)
 {
@@ -74,6 +74,29 @@ enum class ElementDofOrdering
    LEXICOGRAPHIC
 };
 
+/** @brief The numbering of the scalar DOFs of a FiniteElementSpace, see
+    FiniteElementSpace::SetDofRenumbering(). */
+/** A locality-preserving numbering makes the gather/scatter of the element
+    restriction and the assembled sparse matrices access memory in a nearly
+    contiguous way. */
+class DofRenumbering
+{
+public:
+   /// %DOF numbering methods:
+   enum Type
+   {
+      NATIVE,  /**< DOFs are numbered by mesh entity: first all vertex DOFs,
+                    then all edge, face and element interior DOFs */
+      ELEMENT, /**< DOFs are numbered in the order in which they are first
+                    reached when looping over the elements of the mesh; best
+                    combined with a locality-preserving element ordering, e.g.
+                    Mesh::GetHilbertElementOrdering() */
+      RCM      /**< reverse Cuthill-McKee ordering of the graph connecting the
+                    DOFs that share an element; minimizes the bandwidth of the
+                    assembled matrices */
+   };
+};
+
 // Forward declarations
 class NURBSExtension;
 class BilinearFormIntegrator;
@@ -110,6 +133,12 @@ protected:
    int nvdofs, nedofs, nfdofs, nbdofs;
    int *fdofs, *bdofs;
 
+   /// The DOF numbering method, see SetDofRenumbering().
+   DofRenumbering::Type dof_renumbering;
+   /** Map from the native scalar DOFs to the renumbered DOFs; empty when
+       #dof_renumbering is DofRenumbering::NATIVE. */
+   Array<int> dof_renum;
+
    mutable Table *elem_dof; // if NURBS FE space, not owned; otherwise, owned.
    mutable Table *bdrElem_dof; // not owned only if NURBS FE space.
    mutable Table *face_dof; // owned
@@ -161,6 +190,20 @@ protected:
 
    void BuildElementToDofTable() const;
    void BuildBdrElementToDofTable() const;
+
+   /// Compute #dof_renum from the native DOF numbering.
+   void BuildDofRenumbering();
+
+   /// Map native scalar DOFs to renumbered ones, preserving the encoded sign.
+   inline void RenumberDofs(Array<int> &dofs) const
+   {
+      if (!dof_renum.Size()) { return; }
+      for (int i = 0; i < dofs.Size(); i++)
+      {
+         const int d = dofs[i];
+         dofs[i] = (d >= 0) ? dof_renum[d] : -1-dof_renum[-1-d];
+      }
+   }
    void BuildFaceToDofTable() const;
 
    /** @brief  Generates partial face_dof table for a NURBS space.
@@ -423,6 +466,23 @@ public:
    /// Return the ordering method.
    inline Ordering::Type GetOrdering() const { return ordering; }
 
+   /** @brief Renumber the scalar DOFs of the space to improve memory locality,
+       see DofRenumbering. */
+   /** The DOF tables and all cached operators (element restriction,
+       conforming prolongation, etc.) are rebuilt; vectors defined on the space
+       before the call are not permuted. The numbering is preserved by Update(),
+       while copies of the space use the native numbering. For best results,
+       reorder the mesh first, e.g. with
+       Mesh::ReorderElements(mesh.GetHilbertElementOrdering(), true), and then
+       use DofRenumbering::ELEMENT or DofRenumbering::RCM.
+
+       @note Data saved from a renumbered space must be loaded into a space
+       with the same numbering. Not supported for NURBS spaces. */
+   virtual void SetDofRenumbering(DofRenumbering::Type type);
+
+   /// Return the DOF numbering method, see SetDofRenumbering().
+   DofRenumbering::Type GetDofRenumbering() const { return dof_renumbering; }
+
    const FiniteElementCollection *FEColl() const { return fec; }
 
    /// Number of all scalar vertex dofs
@@ -752,14 +812,31 @@ protected:
    // protected functions
 
    // Assuming mesh and order are set, construct the members: int_rule,
-   // element_offsets, and size.
-   void Construct();
+   // element_offsets, and size. If @a ir is not NULL, it is used instead of
+   // the global rules from #IntRules for all elements, or only for those with
+   // geometry @a ir_geom if it is valid; the other elements have no points.
+   void Construct(const IntegrationRule *ir = NULL,
+                  Geometry::Type ir_geom = Geometry::INVALID);
 
 public:
    /// Create a QuadratureSpace based on the global rules from #IntRules.
    QuadratureSpace(Mesh *mesh_, int order_)
       : mesh(mesh_), order(order_) { Construct(); }
 
+   /** @brief Create a QuadratureSpace using the IntegrationRule @a ir in all
+       elements of the mesh, which must have only one element geometry. */
+   /** The rule @a ir is not copied and must remain valid for the lifetime of
+       the QuadratureSpace. Note that Save() writes only the order of @a ir. */
+   QuadratureSpace(Mesh *mesh_, const IntegrationRule &ir);
+
+   /** @brief Create a QuadratureSpace using the IntegrationRule @a ir in the
+       elements of the mesh with geometry @a geom, and no points in the other
+       elements. */
+   /** The rule @a ir is not copied and must remain valid for the lifetime of
+       the QuadratureSpace. The points of the elements with geometry @a geom
+       are stored in the order of the elements. */
+   QuadratureSpace(Mesh *mesh_, Geometry::Type geom, const IntegrationRule &ir);
+
    /// Read a QuadratureSpace from the stream @a in.
    QuadratureSpace(Mesh *mesh_, std::istream &in);
 
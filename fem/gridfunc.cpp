@@ -12,8 +12,11 @@
 // Implementation of GridFunction
 
 #include "gridfunc.hpp"
+#include "quadinterpolator.hpp"
 #include "../mesh/nurbs.hpp"
 #include "../general/text.hpp"
+#include "../general/forall.hpp"
+#include "../linalg/kernels.hpp"
 
 #ifdef MFEM_USE_MPI
 #include "pfespace.hpp"
@@ -479,6 +482,12 @@ const
    GetSubVector(dofs, loc_data);
    if (FElem->GetMapType() == FiniteElement::VALUE)
    {
+      const ShapeTable *table = FElem->GetShapeTable(ir);
+      if (table)
+      {
+         table->shape.MultTranspose(loc_data, vals);
+         return;
+      }
       for (int k = 0; k < n; k++)
       {
          FElem->CalcShape(ir.IntPoint(k), DofVal);
@@ -840,6 +849,16 @@ void GridFunction::GetValues(ElementTransformation &T,
       T.Transform(ir, *tr);
    }
 
+   // Elements with T.ElementNo >= GetNE() are face neighbors of a
+   // ParGridFunction, evaluated by its GetValue() override.
+   if (T.ElementType == ElementTransformation::ELEMENT &&
+       T.ElementNo < fes->GetNE() &&
+       fes->GetFE(T.ElementNo)->GetMapType() == FiniteElement::VALUE)
+   {
+      GetValues(T.ElementNo, ir, vals, comp);
+      return;
+   }
+
    int nip = ir.GetNPoints();
    vals.SetSize(nip);
    for (int j = 0; j < nip; j++)
@@ -1647,10 +1666,13 @@ void GridFunction::GetGradients(ElementTransformation &tr,
    fes->GetElementDofs(elNo, dofs);
    GetSubVector(dofs, lval);
    grad.SetSize(fe->GetDim(), ir.GetNPoints());
+   const ShapeTable *table = fe->GetShapeTable(ir);
+   tr.SetIntRule(&ir);
    for (int i = 0; i < ir.GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir.IntPoint(i);
-      fe->CalcDShape(ip, dshape);
+      if (table) { table->CalcDShape(i, dshape); }
+      else { fe->CalcDShape(ip, dshape); }
       dshape.MultTranspose(lval, gh);
       tr.SetIntPoint(&ip);
       grad.GetColumnReference(i, gcol);
@@ -2276,12 +2298,63 @@ void GridFunction::ProjectDeltaCoefficient(DeltaCoefficient &delta_coeff,
    }
 }
 
+// Batched projection of @a coeff (or @a vcoeff) on a nodal space: the
+// coefficient is evaluated at the nodes of all elements with
+// Coefficient::Project() and the element values are scattered to the L-vector
+// @a x on the device. As in the element-by-element loop, the value from the
+// last element containing a shared dof is used. Return false, without
+// modifying @a x, if the space is not supported.
+static bool BatchedProjectCoefficient(const FiniteElementSpace &fes,
+                                      Coefficient *coeff,
+                                      VectorCoefficient *vcoeff, Vector &x)
+{
+   Mesh *mesh = fes.GetMesh();
+   const int NE = mesh->GetNE();
+   if (NE == 0 || mesh->NURBSext || fes.GetNURBSext() ||
+       mesh->GetNumGeometries(mesh->Dimension()) != 1) { return false; }
+   const NodalFiniteElement *fe =
+      dynamic_cast<const NodalFiniteElement*>(fes.GetFE(0));
+   const int vdim = fes.GetVDim();
+   if (fe == NULL || fe->GetMapType() != FiniteElement::VALUE ||
+       (coeff && vdim != 1) || (vcoeff && vcoeff->GetVDim() != vdim))
+   {
+      return false;
+   }
+
+   const IntegrationRule &nodes = fe->GetNodes();
+   const int ND = nodes.GetNPoints();
+   QuadratureSpace qs(mesh, nodes);
+   QuadratureFunction qf(&qs, vdim);
+   if (coeff) { coeff->Project(qf); }
+   else { vcoeff->Project(qf); }
+
+   // Reorder the values from (VDIM x ND x NE) to the E-vector layout
+   // (ND x VDIM x NE).
+   Vector e_vec(ND*vdim*NE);
+   auto Q = Reshape(qf.Read(), vdim, ND, NE);
+   auto E = Reshape(e_vec.Write(), ND, vdim, NE);
+   MFEM_FORALL(i, ND*NE,
+   {
+      const int j = i % ND;
+      const int e = i / ND;
+      for (int c = 0; c < vdim; c++) { E(j,c,e) = Q(c,j,e); }
+   });
+
+   const Operator *R = fes.GetElementRestriction(ElementDofOrdering::NATIVE);
+   const ElementRestriction *ER = dynamic_cast<const ElementRestriction*>(R);
+   if (ER) { ER->MultLeftInverse(e_vec, x); }
+   else { R->MultTranspose(e_vec, x); } // L2ElementRestriction
+   return true;
+}
+
 void GridFunction::ProjectCoefficient(Coefficient &coeff)
 {
    DeltaCoefficient *delta_c = dynamic_cast<DeltaCoefficient *>(&coeff);
 
    if (delta_c == NULL)
    {
+      if (BatchedProjectCoefficient(*fes, &coeff, NULL, *this)) { return; }
+
       Array<int> vdofs;
       Vector vals;
 
@@ -2331,6 +2404,8 @@ void GridFunction::ProjectCoefficient(
 
 void GridFunction::ProjectCoefficient(VectorCoefficient &vcoeff)
 {
+   if (BatchedProjectCoefficient(*fes, NULL, &vcoeff, *this)) { return; }
+
    int i;
    Array<int> vdofs;
    Vector vals;
@@ -2591,6 +2666,187 @@ void GridFunction::ProjectBdrCoefficientTangent(
 #endif
 }
 
+// Return the integration rule used by the batched error computations below, or
+// NULL if the space is not supported: the (local) mesh must have a single
+// element geometry and the space must use scalar, VALUE-mapped finite elements
+// without a NURBS extension.
+static const IntegrationRule *BatchedErrorRule(const FiniteElementSpace &fes,
+                                               const IntegrationRule *irs[])
+{
+   const Mesh *mesh = fes.GetMesh();
+   if (mesh->GetNE() == 0 || mesh->NURBSext || fes.GetNURBSext() ||
+       mesh->GetNumGeometries(mesh->Dimension()) != 1) { return NULL; }
+   const FiniteElement *fe = fes.GetFE(0);
+   if (fe->GetRangeType() != FiniteElement::SCALAR ||
+       fe->GetMapType() != FiniteElement::VALUE) { return NULL; }
+   const Geometry::Type geom = fe->GetGeomType();
+   return irs ? irs[geom] : &IntRules.Get(geom, 2*fe->GetOrder() + 3);
+}
+
+// Interpolate the values and/or the reference derivatives of @a u at the
+// points of @a ir on the device, using the layouts of QVectorLayout::byNODES.
+static void BatchedInterpolate(const GridFunction &u, const IntegrationRule &ir,
+                               unsigned eval_flags, Vector &q_val,
+                               Vector &q_der)
+{
+   const FiniteElementSpace &fes = *u.FESpace();
+   const DofToQuad &maps = fes.GetFE(0)->GetDofToQuad(ir, DofToQuad::FULL);
+   const Operator *R = fes.GetElementRestriction(ElementDofOrdering::NATIVE);
+   const int NE = fes.GetNE(), vdim = fes.GetVDim();
+   const int NQ = maps.nqpt, dim = maps.FE->GetDim();
+   Vector e_vec(R->Height()), q_det;
+   R->Mult(u, e_vec);
+   if (eval_flags & QuadratureInterpolator::VALUES)
+   {
+      q_val.SetSize(NQ*vdim*NE);
+   }
+   if (eval_flags & QuadratureInterpolator::DERIVATIVES)
+   {
+      q_der.SetSize(NQ*vdim*dim*NE);
+   }
+   QuadratureInterpolator::EvalGeneric(NE, vdim, maps, e_vec, q_val, q_der,
+                                       q_det, eval_flags);
+}
+
+// Batched computation of the Lp error of the scalar (@a exsol) or vector
+// (@a vexsol) GridFunction @a u, see GridFunction::ComputeLpError(). All
+// quadrature points are processed on the device with a single reduction. For
+// finite @a p the sum of the weighted pointwise errors raised to the power @a p
+// is returned in @a error, otherwise their maximum. Return false if the space
+// is not supported by BatchedErrorRule().
+static bool BatchedLpError(const GridFunction &u, const double p,
+                           Coefficient *exsol, VectorCoefficient *vexsol,
+                           Coefficient *weight, VectorCoefficient *v_weight,
+                           const IntegrationRule *irs[], double &error)
+{
+   const FiniteElementSpace &fes = *u.FESpace();
+   const IntegrationRule *ir = BatchedErrorRule(fes, irs);
+   const int vdim = fes.GetVDim();
+   if (ir == NULL || (vexsol && vexsol->GetVDim() != vdim) ||
+       (v_weight && v_weight->GetVDim() != vdim)) { return false; }
+
+   Mesh *mesh = fes.GetMesh();
+   const int NE = mesh->GetNE();
+   const int NQ = ir->GetNPoints();
+   const int vd = vexsol ? vdim : 1; // number of compared components
+   const bool use_w = (weight != NULL), use_vw = (v_weight != NULL);
+   const bool finite = (p < infinity());
+
+   QuadratureSpace qs(mesh, *ir);
+   QuadratureFunction ex(&qs, vd), w, vw;
+   if (vexsol) { vexsol->Project(ex); }
+   else { exsol->Project(ex); }
+   if (use_w) { w.SetSpace(&qs, 1); weight->Project(w); }
+   if (use_vw) { vw.SetSpace(&qs, vdim); v_weight->Project(vw); }
+
+   Vector u_val, u_der;
+   BatchedInterpolate(u, *ir, QuadratureInterpolator::VALUES, u_val, u_der);
+   GeometricFactors geom(mesh, *ir, GeometricFactors::DETERMINANTS);
+
+   Vector err(NQ*NE), dV(NQ*NE);
+   auto IW = ir->GetWeights().Read();
+   auto detJ = Reshape(geom.detJ.Read(), NQ, NE);
+   auto U = Reshape(u_val.Read(), NQ, vdim, NE);
+   auto X = Reshape(ex.Read(), vd, NQ, NE);
+   auto W = Reshape(w.Read(), NQ, NE);
+   auto VW = Reshape(vw.Read(), vd, NQ, NE);
+   auto ERR = Reshape(err.Write(), NQ, NE);
+   auto DV = Reshape(dV.Write(), NQ, NE);
+   MFEM_FORALL(i, NQ*NE,
+   {
+      const int q = i % NQ;
+      const int e = i / NQ;
+      double a = 0.0;
+      if (use_vw)
+      {
+         for (int c = 0; c < vd; c++) { a += (U(q,c,e) - X(c,q,e))*VW(c,q,e); }
+         a = fabs(a);
+      }
+      else if (vd == 1)
+      {
+         a = fabs(U(q,0,e) - X(0,q,e));
+      }
+      else
+      {
+         for (int c = 0; c < vd; c++)
+         {
+            const double d = U(q,c,e) - X(c,q,e);
+            a += d*d;
+         }
+         a = sqrt(a);
+      }
+      if (finite) { a = pow(a, p); }
+      if (use_w) { a *= W(q,e); }
+      // For p = infinity store -err, so that the maximum is given by Min().
+      ERR(q,e) = finite ? a : -a;
+      DV(q,e) = IW[q]*detJ(q,e);
+   });
+   error = finite ? err*dV : std::max(0.0, -err.Min());
+   return true;
+}
+
+// Batched computation of the square of the L2 error of the gradient of the
+// scalar GridFunction @a u, see GridFunction::ComputeGradError(). Return false
+// if the space is not supported by BatchedErrorRule() or the mesh is embedded
+// in a higher dimensional space.
+static bool BatchedGradError(const GridFunction &u, VectorCoefficient &exgrad,
+                             const IntegrationRule *irs[], double &error)
+{
+   const FiniteElementSpace &fes = *u.FESpace();
+   const IntegrationRule *ir = BatchedErrorRule(fes, irs);
+   Mesh *mesh = fes.GetMesh();
+   const int dim = mesh->Dimension();
+   if (ir == NULL || fes.GetVDim() != 1 || mesh->SpaceDimension() != dim ||
+       exgrad.GetVDim() != dim || dim > 3) { return false; }
+
+   const int NE = mesh->GetNE();
+   const int NQ = ir->GetNPoints();
+   QuadratureSpace qs(mesh, *ir);
+   QuadratureFunction ex(&qs, dim);
+   exgrad.Project(ex);
+
+   Vector u_val, u_der;
+   BatchedInterpolate(u, *ir, QuadratureInterpolator::DERIVATIVES,
+                      u_val, u_der);
+   GeometricFactors geom(mesh, *ir, GeometricFactors::JACOBIANS |
+                         GeometricFactors::DETERMINANTS);
+
+   Vector err(NQ*NE), dV(NQ*NE);
+   auto IW = ir->GetWeights().Read();
+   auto J = Reshape(geom.J.Read(), NQ, dim, dim, NE);
+   auto detJ = Reshape(geom.detJ.Read(), NQ, NE);
+   auto D = Reshape(u_der.Read(), NQ, dim, NE);
+   auto X = Reshape(ex.Read(), dim, NQ, NE);
+   auto ERR = Reshape(err.Write(), NQ, NE);
+   auto DV = Reshape(dV.Write(), NQ, NE);
+   MFEM_FORALL(i, NQ*NE,
+   {
+      const int q = i % NQ;
+      const int e = i / NQ;
+      double Jq[9], Jinv[9];
+      for (int c = 0; c < dim; c++)
+      {
+         for (int r = 0; r < dim; r++) { Jq[r+dim*c] = J(q,r,c,e); }
+      }
+      if (dim == 1) { Jinv[0] = 1.0/Jq[0]; }
+      else if (dim == 2) { kernels::CalcInverse<2>(Jq, Jinv); }
+      else { kernels::CalcInverse<3>(Jq, Jinv); }
+      // The physical gradient is J^{-t} times the reference gradient.
+      double a = 0.0;
+      for (int j = 0; j < dim; j++)
+      {
+         double g = 0.0;
+         for (int k = 0; k < dim; k++) { g += Jinv[k+dim*j]*D(q,k,e); }
+         const double d = X(j,q,e) - g;
+         a += d*d;
+      }
+      ERR(q,e) = a;
+      DV(q,e) = IW[q]*detJ(q,e);
+   });
+   error = err*dV;
+   return true;
+}
+
 double GridFunction::ComputeL2Error(
    Coefficient *exsol[], const IntegrationRule *irs[]) const
 {
@@ -2654,6 +2910,12 @@ double GridFunction::ComputeL2Error(
    DenseMatrix vals, exact_vals;
    Vector loc_errs;
 
+   if (elems == NULL &&
+       BatchedLpError(*this, 2.0, NULL, &exsol, NULL, NULL, irs, error))
+   {
+      return (error < 0.0) ? -sqrt(-error) : sqrt(error);
+   }
+
    for (int i = 0; i < fes->GetNE(); i++)
    {
       if (elems != NULL && (*elems)[i] == 0) { continue; }
@@ -2697,6 +2959,11 @@ double GridFunction::ComputeGradError(VectorCoefficient *exgrad,
    int dim = fes->GetMesh()->SpaceDimension();
    Vector vec(dim);
 
+   if (BatchedGradError(*this, *exgrad, irs, error))
+   {
+      return (error < 0.0) ? -sqrt(-error) : sqrt(error);
+   }
+
    for (int i = 0; i < fes->GetNE(); i++)
    {
       fe = fes->GetFE(i);
@@ -3141,42 +3408,45 @@ double GridFunction::ComputeLpError(const double p, Coefficient &exsol,
    ElementTransformation *T;
    Vector vals;
 
-   for (int i = 0; i < fes->GetNE(); i++)
+   if (!BatchedLpError(*this, p, &exsol, NULL, weight, NULL, irs, error))
    {
-      fe = fes->GetFE(i);
-      const IntegrationRule *ir;
-      if (irs)
-      {
-         ir = irs[fe->GetGeomType()];
-      }
-      else
-      {
-         int intorder = 2*fe->GetOrder() + 3; // <----------
-         ir = &(IntRules.Get(fe->GetGeomType(), intorder));
-      }
-      GetValues(i, *ir, vals);
-      T = fes->GetElementTransformation(i);
-      for (int j = 0; j < ir->GetNPoints(); j++)
+      for (int i = 0; i < fes->GetNE(); i++)
       {
-         const IntegrationPoint &ip = ir->IntPoint(j);
-         T->SetIntPoint(&ip);
-         double err = fabs(vals(j) - exsol.Eval(*T, ip));
-         if (p < infinity())
+         fe = fes->GetFE(i);
+         const IntegrationRule *ir;
+         if (irs)
          {
-            err = pow(err, p);
-            if (weight)
-            {
-               err *= weight->Eval(*T, ip);
-            }
-            error += ip.weight * T->Weight() * err;
+            ir = irs[fe->GetGeomType()];
          }
          else
          {
-            if (weight)
+            int intorder = 2*fe->GetOrder() + 3; // <----------
+            ir = &(IntRules.Get(fe->GetGeomType(), intorder));
+         }
+         GetValues(i, *ir, vals);
+         T = fes->GetElementTransformation(i);
+         for (int j = 0; j < ir->GetNPoints(); j++)
+         {
+            const IntegrationPoint &ip = ir->IntPoint(j);
+            T->SetIntPoint(&ip);
+            double err = fabs(vals(j) - exsol.Eval(*T, ip));
+            if (p < infinity())
             {
-               err *= weight->Eval(*T, ip);
+               err = pow(err, p);
+               if (weight)
+               {
+                  err *= weight->Eval(*T, ip);
+               }
+               error += ip.weight * T->Weight() * err;
+            }
+            else
+            {
+               if (weight)
+               {
+                  err *= weight->Eval(*T, ip);
+               }
+               error = std::max(error, err);
             }
-            error = std::max(error, err);
          }
       }
    }
@@ -3274,66 +3544,70 @@ double GridFunction::ComputeLpError(const double p, VectorCoefficient &exsol,
    DenseMatrix vals, exact_vals;
    Vector loc_errs;
 
-   for (int i = 0; i < fes->GetNE(); i++)
+   if (!BatchedLpError(*this, p, NULL, &exsol, weight, v_weight, irs,
+                       error))
    {
-      fe = fes->GetFE(i);
-      const IntegrationRule *ir;
-      if (irs)
-      {
-         ir = irs[fe->GetGeomType()];
-      }
-      else
-      {
-         int intorder = 2*fe->GetOrder() + 3; // <----------
-         ir = &(IntRules.Get(fe->GetGeomType(), intorder));
-      }
-      T = fes->GetElementTransformation(i);
-      GetVectorValues(*T, *ir, vals);
-      exsol.Eval(exact_vals, *T, *ir);
-      vals -= exact_vals;
-      loc_errs.SetSize(vals.Width());
-      if (!v_weight)
-      {
-         // compute the lengths of the errors at the integration points
-         // thus the vector norm is rotationally invariant
-         vals.Norm2(loc_errs);
-      }
-      else
+      for (int i = 0; i < fes->GetNE(); i++)
       {
-         v_weight->Eval(exact_vals, *T, *ir);
-         // column-wise dot product of the vector error (in vals) and the
-         // vector weight (in exact_vals)
-         for (int j = 0; j < vals.Width(); j++)
+         fe = fes->GetFE(i);
+         const IntegrationRule *ir;
+         if (irs)
          {
-            double err = 0.0;
-            for (int d = 0; d < vals.Height(); d++)
-            {
-               err += vals(d,j)*exact_vals(d,j);
-            }
-            loc_errs(j) = fabs(err);
+            ir = irs[fe->GetGeomType()];
          }
-      }
-      for (int j = 0; j < ir->GetNPoints(); j++)
-      {
-         const IntegrationPoint &ip = ir->IntPoint(j);
-         T->SetIntPoint(&ip);
-         double err = loc_errs(j);
-         if (p < infinity())
+         else
          {
-            err = pow(err, p);
-            if (weight)
+            int intorder = 2*fe->GetOrder() + 3; // <----------
+            ir = &(IntRules.Get(fe->GetGeomType(), intorder));
+         }
+         T = fes->GetElementTransformation(i);
+         GetVectorValues(*T, *ir, vals);
+         exsol.Eval(exact_vals, *T, *ir);
+         vals -= exact_vals;
+         loc_errs.SetSize(vals.Width());
+         if (!v_weight)
+         {
+            // compute the lengths of the errors at the integration points
+            // thus the vector norm is rotationally invariant
+            vals.Norm2(loc_errs);
+         }
+         else
+         {
+            v_weight->Eval(exact_vals, *T, *ir);
+            // column-wise dot product of the vector error (in vals) and the
+            // vector weight (in exact_vals)
+            for (int j = 0; j < vals.Width(); j++)
             {
-               err *= weight->Eval(*T, ip);
+               double err = 0.0;
+               for (int d = 0; d < vals.Height(); d++)
+               {
+                  err += vals(d,j)*exact_vals(d,j);
+               }
+               loc_errs(j) = fabs(err);
             }
-            error += ip.weight * T->Weight() * err;
          }
-         else
+         for (int j = 0; j < ir->GetNPoints(); j++)
          {
-            if (weight)
+            const IntegrationPoint &ip = ir->IntPoint(j);
+            T->SetIntPoint(&ip);
+            double err = loc_errs(j);
+            if (p < infinity())
             {
-               err *= weight->Eval(*T, ip);
+               err = pow(err, p);
+               if (weight)
+               {
+                  err *= weight->Eval(*T, ip);
+               }
+               error += ip.weight * T->Weight() * err;
+            }
+            else
+            {
+               if (weight)
+               {
+                  err *= weight->Eval(*T, ip);
+               }
+               error = std::max(error, err);
             }
-            error = std::max(error, err);
          }
       }
    }
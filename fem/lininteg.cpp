@@ -40,6 +40,8 @@ void DomainLFIntegrator::AssembleRHSElementVect(const FiniteElement &el,
       //                    oa * el.GetOrder() + ob + Tr.OrderW());
       ir = &IntRules.Get(el.GetGeomType(), oa * el.GetOrder() + ob);
    }
+   const ShapeTable *table = el.GetShapeTable(*ir);
+   Tr.SetIntRule(ir);
 
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
@@ -48,7 +50,8 @@ void DomainLFIntegrator::AssembleRHSElementVect(const FiniteElement &el,
       Tr.SetIntPoint (&ip);
       double val = Tr.Weight() * Q.Eval(Tr, ip);
 
-      el.CalcShape(ip, shape);
+      if (table) { table->CalcShape(i, shape); }
+      else { el.CalcShape(ip, shape); }
 
       add(elvect, ip.weight * val, shape, elvect);
    }
@@ -0,0 +1,446 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "lor.hpp"
+#include "../linalg/solvers.hpp"
+
+#ifdef MFEM_USE_MPI
+#include "pbilinearform.hpp"
+#endif
+
+namespace mfem
+{
+
+// Compute the vectors @a v such that the dof i of the vector element @a fe,
+// mapped by @a T, applied to a constant vector field u is v_i.u.
+static void GetDofVectors(const FiniteElement &fe, ElementTransformation &T,
+                          DenseMatrix &v)
+{
+   const int dim = fe.GetDim();
+   Vector e(dim), d(fe.GetDof());
+   v.SetSize(dim, fe.GetDof());
+   for (int k = 0; k < dim; k++)
+   {
+      e = 0.0;
+      e(k) = 1.0;
+      VectorConstantCoefficient coeff(e);
+      fe.Project(coeff, T, d);
+      v.SetRow(k, d);
+   }
+}
+
+// Evaluate the dof functional @a j of the LOR element @a fe_lor, mapped by
+// @a T_lor to the reference space of the high-order element @a fe_ho, on the
+// basis functions of @a fe_ho. For vector elements, the point value at the
+// edge (ND) or face (RT) center is replaced by the average over the edge or
+// face, which commutes with the curl and the divergence.
+static void EvalDofFunctional(const FiniteElement &fe_lor, int j,
+                              ElementTransformation &T_lor,
+                              const FiniteElement &fe_ho, Vector &w)
+{
+   const int dim = fe_lor.GetDim();
+   const IntegrationPoint &node = fe_lor.GetNodes().IntPoint(j);
+   IntegrationPoint ip_lor, ip_ho;
+   Vector x(dim);
+   if (fe_lor.GetRangeType() != FiniteElement::VECTOR)
+   {
+      T_lor.Transform(node, x);
+      ip_ho.Set(x.GetData(), dim);
+      w.SetSize(fe_ho.GetDof());
+      fe_ho.CalcShape(ip_ho, w);
+      return;
+   }
+
+   // The reference vector of the dof is along one axis: the tangent of an
+   // edge or the normal of a face.
+   IsoparametricTransformation T_ref;
+   T_ref.SetIdentityTransformation(fe_lor.GetGeomType());
+   DenseMatrix v_ref, v_lor;
+   GetDofVectors(fe_lor, T_ref, v_ref);
+   GetDofVectors(fe_lor, T_lor, v_lor);
+   int axis = 0;
+   for (int k = 1; k < dim; k++)
+   {
+      if (std::abs(v_ref(k,j)) > std::abs(v_ref(axis,j))) { axis = k; }
+   }
+   const bool nd = (fe_lor.GetMapType() == FiniteElement::H_CURL);
+   Array<int> axes;
+   for (int k = 0; k < dim; k++)
+   {
+      if ((k == axis) == nd) { axes.Append(k); }
+   }
+
+   const IntegrationRule &ir = IntRules.Get(Geometry::SEGMENT,
+                                            2*fe_ho.GetOrder());
+   const int nq = ir.GetNPoints();
+   const int nqe = (axes.Size() == 1) ? nq : nq*nq;
+   DenseMatrix vshape(fe_ho.GetDof(), dim);
+   Vector vj(dim);
+   v_lor.GetColumn(j, vj);
+   w.SetSize(fe_ho.GetDof());
+   w = 0.0;
+   for (int q = 0; q < nqe; q++)
+   {
+      double xi[3] = { node.x, node.y, node.z }, weight = 1.0;
+      for (int a = 0, qa = q; a < axes.Size(); a++, qa /= nq)
+      {
+         xi[axes[a]] = ir.IntPoint(qa % nq).x;
+         weight *= ir.IntPoint(qa % nq).weight;
+      }
+      ip_lor.Set(xi, dim);
+      T_lor.Transform(ip_lor, x);
+      ip_ho.Set(x.GetData(), dim);
+      fe_ho.CalcVShape(ip_ho, vshape);
+      vshape.AddMult_a(weight, vj, w);
+   }
+}
+
+// Return the true dof of the local dof @a ldof, or -1 if it is not owned.
+static int LocalTrueDof(const FiniteElementSpace &fes, int ldof)
+{
+#ifdef MFEM_USE_MPI
+   const ParFiniteElementSpace *pfes =
+      dynamic_cast<const ParFiniteElementSpace*>(&fes);
+   if (pfes) { return pfes->GetLocalTDofNumber(ldof); }
+#endif
+   return ldof;
+}
+
+LORSolver::LORSolver(BilinearForm &a_ho, const Array<int> &ess_bdr)
+   : Solver(a_ho.FESpace()->GetTrueVSize()),
+     A(NULL), solver(NULL), own_solver(NULL), P(NULL), Pt(NULL)
+{
+   FiniteElementSpace &fes_ho = *a_ho.FESpace();
+   Mesh &mesh_ho = *fes_ho.GetMesh();
+   const int dim = mesh_ho.Dimension();
+   MFEM_VERIFY(mesh_ho.Conforming(), "nonconforming meshes are not supported");
+   for (int e = 0; e < mesh_ho.GetNE(); e++)
+   {
+      const Geometry::Type geom = mesh_ho.GetElementBaseGeometry(e);
+      MFEM_VERIFY(geom == Geometry::SQUARE || geom == Geometry::CUBE,
+                  "only quadrilateral and hexahedral meshes are supported");
+   }
+
+   int order = (mesh_ho.GetNE() > 0) ? fes_ho.GetFE(0)->GetOrder() : 0;
+#ifdef MFEM_USE_MPI
+   ParFiniteElementSpace *pfes_ho =
+      dynamic_cast<ParFiniteElementSpace*>(&fes_ho);
+   if (pfes_ho)
+   {
+      MPI_Allreduce(MPI_IN_PLACE, &order, 1, MPI_INT, MPI_MAX,
+                    pfes_ho->GetComm());
+   }
+#endif
+
+   const FiniteElementCollection *fec_ho = fes_ho.FEColl();
+   if (dynamic_cast<const H1_FECollection*>(fec_ho))
+   {
+      fec_lor = new H1_FECollection(1, dim);
+   }
+   else if (dynamic_cast<const ND_FECollection*>(fec_ho))
+   {
+      fec_lor = new ND_FECollection(1, dim);
+   }
+   else if (dynamic_cast<const RT_FECollection*>(fec_ho))
+   {
+      fec_lor = new RT_FECollection(0, dim);
+   }
+   else
+   {
+      MFEM_ABORT("only H1, ND and RT spaces are supported");
+   }
+
+   const int vdim = fes_ho.GetVDim();
+   const int ref_type = BasisType::GaussLobatto;
+#ifdef MFEM_USE_MPI
+   if (pfes_ho)
+   {
+      ParMesh *pmesh_lor = new ParMesh(pfes_ho->GetParMesh(), order, ref_type);
+      ParFiniteElementSpace *pfes_lor =
+         new ParFiniteElementSpace(pmesh_lor, fec_lor, vdim,
+                                   fes_ho.GetOrdering());
+      mesh_lor = pmesh_lor;
+      fes_lor = pfes_lor;
+      a_lor = new ParBilinearForm(pfes_lor);
+   }
+   else
+#endif
+   {
+      mesh_lor = new Mesh(&mesh_ho, order, ref_type);
+      fes_lor = new FiniteElementSpace(mesh_lor, fec_lor, vdim,
+                                       fes_ho.GetOrdering());
+      a_lor = new BilinearForm(fes_lor);
+   }
+
+   // The integrators are owned by a_ho.
+   a_lor->UseExternalIntegrators();
+   Array<BilinearFormIntegrator*> &dbfi = *a_ho.GetDBFI();
+   for (int i = 0; i < dbfi.Size(); i++)
+   {
+      a_lor->AddDomainIntegrator(dbfi[i]);
+   }
+   Array<BilinearFormIntegrator*> &bbfi = *a_ho.GetBBFI();
+   Array<Array<int>*> &bbfi_marker = *a_ho.GetBBFI_Marker();
+   for (int i = 0; i < bbfi.Size(); i++)
+   {
+      if (bbfi_marker[i])
+      {
+         a_lor->AddBoundaryIntegrator(bbfi[i], *bbfi_marker[i]);
+      }
+      else
+      {
+         a_lor->AddBoundaryIntegrator(bbfi[i]);
+      }
+   }
+   a_lor->Assemble();
+
+   fes_lor->GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+#ifdef MFEM_USE_MPI
+   ParBilinearForm *pa_lor = dynamic_cast<ParBilinearForm*>(a_lor);
+   if (pa_lor)
+   {
+      HypreParMatrix *hA = new HypreParMatrix;
+      pa_lor->FormSystemMatrix(ess_tdof_list, *hA);
+      A = hA;
+   }
+   else
+#endif
+   {
+      SparseMatrix *sA = new SparseMatrix;
+      a_lor->FormSystemMatrix(ess_tdof_list, *sA);
+      A = sA;
+   }
+
+   BuildDofMap(fes_ho);
+   SetDefaultSolver();
+}
+
+// Return the root of @a i in the union-find forest @a root.
+static int FindRoot(Array<int> &root, int i)
+{
+   while (root[i] != i) { i = root[i] = root[root[i]]; }
+   return i;
+}
+
+void LORSolver::BuildDofMap(FiniteElementSpace &fes_ho)
+{
+   const int ndofs = fes_lor->GetNDofs();
+   MFEM_VERIFY(ndofs == fes_ho.GetNDofs(), "incompatible LOR space");
+   const CoarseFineTransformations &cf_tr =
+      mesh_lor->GetRefinementTransforms();
+
+   // Interpolation D from the high-order to the LOR (scalar) dofs, computed
+   // in the reference space of the parent high-order elements.
+   SparseMatrix D(ndofs, ndofs);
+   Array<bool> done(ndofs);
+   done = false;
+   IsoparametricTransformation T_lor;
+   Array<int> dofs_ho, dofs_lor;
+   Vector w;
+   for (int el = 0; el < mesh_lor->GetNE(); el++)
+   {
+      const Embedding &emb = cf_tr.embeddings[el];
+      const Geometry::Type geom = mesh_lor->GetElementBaseGeometry(el);
+      const FiniteElement &fe_ho = *fes_ho.GetFE(emb.parent);
+      const FiniteElement &fe_lor = *fes_lor->GetFE(el);
+      T_lor.SetIdentityTransformation(geom);
+      T_lor.SetPointMat(cf_tr.point_matrices[geom](emb.matrix));
+      fes_ho.GetElementDofs(emb.parent, dofs_ho);
+      fes_lor->GetElementDofs(el, dofs_lor);
+
+      for (int j = 0; j < dofs_lor.Size(); j++)
+      {
+         const int row = (dofs_lor[j] >= 0) ? dofs_lor[j] : -1 - dofs_lor[j];
+         if (done[row]) { continue; }
+         done[row] = true;
+
+         EvalDofFunctional(fe_lor, j, T_lor, fe_ho, w);
+         const double tol = 1e-10*w.Normlinf();
+         for (int i = 0; i < dofs_ho.Size(); i++)
+         {
+            if (std::abs(w(i)) <= tol) { continue; }
+            const bool flip = (dofs_ho[i] < 0) != (dofs_lor[j] < 0);
+            const int col = (dofs_ho[i] >= 0) ? dofs_ho[i] : -1 - dofs_ho[i];
+            D.Set(row, col, flip ? -w(i) : w(i));
+         }
+      }
+   }
+   D.Finalize();
+
+   // D is block diagonal, up to permutations, with one block for each line
+   // (ND) or plane (RT) of dofs, and a permutation for H1. Invert it by blocks,
+   // using the connected components of the graph of D, where the LOR dof i is
+   // the vertex i and the high-order dof j the vertex ndofs + j.
+   Array<int> root(2*ndofs);
+   for (int i = 0; i < root.Size(); i++) { root[i] = i; }
+   for (int i = 0; i < ndofs; i++)
+   {
+      for (int k = D.GetI()[i]; k < D.GetI()[i+1]; k++)
+      {
+         root[FindRoot(root, i)] = FindRoot(root, ndofs + D.GetJ()[k]);
+      }
+   }
+   Table comp_rows, comp_cols;
+   Array<int> comp(2*ndofs);
+   comp = -1;
+   int ncomp = 0;
+   for (int i = 0; i < root.Size(); i++)
+   {
+      const int r = FindRoot(root, i);
+      if (comp[r] < 0) { comp[r] = ncomp++; }
+      comp[i] = comp[r];
+   }
+   comp_rows.MakeI(ncomp);
+   comp_cols.MakeI(ncomp);
+   for (int i = 0; i < ndofs; i++)
+   {
+      comp_rows.AddAColumnInRow(comp[i]);
+      comp_cols.AddAColumnInRow(comp[ndofs + i]);
+   }
+   comp_rows.MakeJ();
+   comp_cols.MakeJ();
+   for (int i = 0; i < ndofs; i++)
+   {
+      comp_rows.AddConnection(comp[i], i);
+      comp_cols.AddConnection(comp[ndofs + i], i);
+   }
+   comp_rows.ShiftUpI();
+   comp_cols.ShiftUpI();
+
+   SparseMatrix D_inv(ndofs, ndofs);
+   DenseMatrix B, B_inv;
+   Array<int> col_pos(ndofs);
+   for (int c = 0; c < ncomp; c++)
+   {
+      const int *rows = comp_rows.GetRow(c), *cols = comp_cols.GetRow(c);
+      const int n = comp_rows.RowSize(c);
+      MFEM_VERIFY(comp_cols.RowSize(c) == n, "the LOR interpolation is "
+                  "singular; check the basis type of the high-order space");
+      for (int b = 0; b < n; b++) { col_pos[cols[b]] = b; }
+      B.SetSize(n);
+      B = 0.0;
+      for (int a = 0; a < n; a++)
+      {
+         for (int k = D.GetI()[rows[a]]; k < D.GetI()[rows[a]+1]; k++)
+         {
+            B(a, col_pos[D.GetJ()[k]]) = D.GetData()[k];
+         }
+      }
+      DenseMatrixInverse(B).GetInverseMatrix(B_inv);
+      for (int b = 0; b < n; b++)
+      {
+         for (int a = 0; a < n; a++)
+         {
+            if (B_inv(b,a) != 0.0) { D_inv.Set(cols[b], rows[a], B_inv(b,a)); }
+         }
+      }
+   }
+   D_inv.Finalize();
+
+   // Expand D^{-1} to the vector and true dofs.
+   const int vdim = fes_lor->GetVDim();
+   P = new SparseMatrix(fes_ho.GetTrueVSize(), fes_lor->GetTrueVSize());
+   for (int i = 0; i < ndofs; i++)
+   {
+      for (int k = D_inv.GetI()[i]; k < D_inv.GetI()[i+1]; k++)
+      {
+         const int j = D_inv.GetJ()[k];
+         for (int c = 0; c < vdim; c++)
+         {
+            const int t_ho = LocalTrueDof(fes_ho, fes_ho.DofToVDof(i, c));
+            const int t_lor = LocalTrueDof(*fes_lor, fes_lor->DofToVDof(j, c));
+            MFEM_VERIFY((t_ho < 0) == (t_lor < 0), "incompatible true dofs");
+            if (t_ho >= 0) { P->Set(t_ho, t_lor, D_inv.GetData()[k]); }
+         }
+      }
+   }
+   P->Finalize();
+   Pt = Transpose(*P);
+}
+
+void LORSolver::SetDefaultSolver()
+{
+#ifdef MFEM_USE_MPI
+   ParFiniteElementSpace *pfes_lor =
+      dynamic_cast<ParFiniteElementSpace*>(fes_lor);
+   if (pfes_lor)
+   {
+      HypreParMatrix &hA = *static_cast<HypreParMatrix*>(A);
+      const int dim = mesh_lor->Dimension();
+      if (dynamic_cast<ND_FECollection*>(fec_lor))
+      {
+         HypreAMS *ams = new HypreAMS(hA, pfes_lor);
+         ams->SetPrintLevel(0);
+         own_solver = ams;
+      }
+      else if (dynamic_cast<RT_FECollection*>(fec_lor) && dim == 3)
+      {
+         HypreADS *ads = new HypreADS(hA, pfes_lor);
+         ads->SetPrintLevel(0);
+         own_solver = ads;
+      }
+      else
+      {
+         HypreBoomerAMG *amg = new HypreBoomerAMG(hA);
+         amg->SetPrintLevel(0);
+         const int vdim = pfes_lor->GetVDim();
+         if (vdim > 1)
+         {
+            const bool by_nodes =
+               (pfes_lor->GetOrdering() == Ordering::byNODES);
+            amg->SetSystemsOptions(vdim, by_nodes);
+         }
+         own_solver = amg;
+      }
+   }
+   else
+#endif
+   {
+      SparseMatrix &sA = *static_cast<SparseMatrix*>(A);
+#ifdef MFEM_USE_SUITESPARSE
+      own_solver = new UMFPackSolver(sA);
+#else
+      own_solver = new GSSmoother(sA);
+#endif
+   }
+   solver = own_solver;
+}
+
+void LORSolver::SetSolver(Solver &s)
+{
+   s.SetOperator(*A);
+   solver = &s;
+   delete own_solver;
+   own_solver = NULL;
+}
+
+void LORSolver::Mult(const Vector &x, Vector &y) const
+{
+   X.SetSize(Pt->Height());
+   Y.SetSize(Pt->Height());
+   Pt->Mult(x, X);
+   solver->Mult(X, Y);
+   P->Mult(Y, y);
+}
+
+LORSolver::~LORSolver()
+{
+   delete Pt;
+   delete P;
+   delete own_solver;
+   delete A;
+   delete a_lor;
+   delete fes_lor;
+   delete fec_lor;
+   delete mesh_lor;
+}
+
+} // namespace mfem
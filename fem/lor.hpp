@@ -0,0 +1,99 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#ifndef MFEM_LOR
+#define MFEM_LOR
+
+#include "../config/config.hpp"
+#include "bilinearform.hpp"
+
+namespace mfem
+{
+
+/** @brief Preconditioner for a high-order, typically partially assembled,
+    BilinearForm based on the spectrally equivalent low-order-refined (LOR)
+    discretization.
+
+    The LOR mesh subdivides each element of the high-order mesh p times in each
+    direction, with the new vertices at the Gauss-Lobatto points, and the LOR
+    space is the lowest order space of the same family (H1, ND or RT) on this
+    mesh. The LOR form, built from the domain and boundary integrators of the
+    high-order form, is fully assembled. The high-order dofs are mapped to the
+    LOR dofs with the interpolation D given by the LOR dof functionals, where
+    the ND and RT point values are replaced by edge and face averages, so that
+    D commutes with the curl and the divergence. The preconditioner is then
+    D^{-1} A_lor^{-1} D^{-T}, where D is a permutation for H1 and is block
+    diagonal, with one block for each line or plane of dofs, for ND and RT.
+
+    By default, the LOR system is solved with HypreBoomerAMG (H1 and 2D RT),
+    HypreAMS (ND) or HypreADS (3D RT) in parallel, and with UMFPackSolver (if
+    available) or GSSmoother in serial. Another solver can be set with
+    SetSolver().
+
+    Only conforming meshes of quadrilaterals or hexahedra are supported. The H1
+    spaces should use a nodal Gauss-Lobatto basis, the default, for which D is
+    a permutation. */
+class LORSolver : public Solver
+{
+protected:
+   Mesh *mesh_lor;
+   FiniteElementCollection *fec_lor;
+   FiniteElementSpace *fes_lor;
+   BilinearForm *a_lor;
+   Array<int> ess_tdof_list;
+   Operator *A;
+   Solver *solver, *own_solver;
+
+   /// The inverse P = D^{-1} of the interpolation, and its transpose.
+   SparseMatrix *P, *Pt;
+   mutable Vector X, Y;
+
+   /// Compute P from the high-order space @a fes_ho.
+   void BuildDofMap(FiniteElementSpace &fes_ho);
+
+   /// Set the default LOR solver, see the class description.
+   void SetDefaultSolver();
+
+public:
+   /** @brief Build the LOR discretization of @a a_ho with essential boundary
+       attributes @a ess_bdr. The integrators of @a a_ho are shared with the
+       LOR form, so @a a_ho must outlive the LORSolver. */
+   LORSolver(BilinearForm &a_ho, const Array<int> &ess_bdr);
+
+   /** @brief Use the solver @a s for the LOR system, instead of the default
+       one. The operator of @a s is set to the assembled LOR matrix. */
+   void SetSolver(Solver &s);
+
+   /// Return the solver of the LOR system.
+   Solver &GetSolver() const { return *solver; }
+
+   /// Return the assembled LOR matrix, a SparseMatrix or a HypreParMatrix.
+   const Operator &GetAssembledMatrix() const { return *A; }
+
+   /// Return the LOR finite element space.
+   FiniteElementSpace &GetFESpace() const { return *fes_lor; }
+
+   /** @brief Return the map from the LOR true dofs to the high-order true
+       dofs, the inverse of the interpolation. */
+   const SparseMatrix &GetDofMap() const { return *P; }
+
+   /// The high-order operator is not used.
+   virtual void SetOperator(const Operator &op) { }
+
+   /// Approximately solve the high-order system with the LOR solver.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   virtual ~LORSolver();
+};
+
+} // namespace mfem
+
+#endif
@@ -10,6 +10,12 @@
 // CONTRIBUTING.md for details.
 
 #include "multigrid.hpp"
+#include "transfer.hpp"
+#include "../linalg/solvers.hpp"
+
+#ifdef MFEM_USE_MPI
+#include "pbilinearform.hpp"
+#endif
 
 namespace mfem
 {
@@ -261,4 +267,185 @@ const Operator* GeometricMultigrid::GetProlongationAtLevel(int level) const
    return fespaces.GetProlongationAtLevel(level);
 }
 
+PMultigrid::PMultigrid(BilinearForm &a, const Array<int> &ess_bdr,
+                       IntegratorSetup setup, int cheb_order)
+   : Multigrid(), coarse_prec(NULL)
+{
+   FiniteElementSpace &fes = *a.FESpace();
+   const H1_FECollection *h1 =
+      dynamic_cast<const H1_FECollection*>(fes.FEColl());
+   MFEM_VERIFY(h1, "PMultigrid requires an H1 space");
+   Mesh *mesh = fes.GetMesh();
+   const int dim = mesh->Dimension();
+#ifdef MFEM_USE_MPI
+   ParFiniteElementSpace *pfes = dynamic_cast<ParFiniteElementSpace*>(&fes);
+#endif
+
+   // Orders from the coarsest to the finest level.
+   const int p = h1->FiniteElementForGeometry(Geometry::SEGMENT)->GetOrder();
+   for (int o = p; o >= 1; o /= 2) { orders.Append(o); }
+   orders.Sort();
+   const int nlevels = orders.Size();
+
+   FiniteElementSpace *prev = NULL;
+   for (int level = 0; level < nlevels; level++)
+   {
+      FiniteElementSpace *lfes = &fes;
+      if (level < nlevels - 1)
+      {
+         fecs.Append(new H1_FECollection(orders[level], dim,
+                                         h1->GetBasisType()));
+#ifdef MFEM_USE_MPI
+         if (pfes)
+         {
+            lfes = new ParFiniteElementSpace(pfes->GetParMesh(), fecs.Last(),
+                                             fes.GetVDim(), fes.GetOrdering());
+         }
+         else
+#endif
+         {
+            lfes = new FiniteElementSpace(mesh, fecs.Last(), fes.GetVDim(),
+                                          fes.GetOrdering());
+         }
+         fespaces.Append(lfes);
+      }
+      ess_tdofs.Append(new Array<int>);
+      lfes->GetEssentialTrueDofs(ess_bdr, *ess_tdofs.Last());
+
+      if (prev)
+      {
+         // Prolongation between the true dofs of consecutive levels.
+         Operator *P;
+#ifdef MFEM_USE_MPI
+         if (pfes)
+         {
+            P = new TrueTransferOperator(
+               *static_cast<ParFiniteElementSpace*>(prev),
+               *static_cast<ParFiniteElementSpace*>(lfes));
+         }
+         else
+#endif
+         if (lfes->Conforming())
+         {
+            P = new TransferOperator(*prev, *lfes);
+         }
+         else
+         {
+            P = new TripleProductOperator(
+               lfes->GetConformingRestriction(),
+               new TransferOperator(*prev, *lfes),
+               prev->GetConformingProlongation(), false, true, false);
+         }
+         prolongations.Append(P);
+         ownedProlongations.Append(true);
+      }
+
+      if (level == 0)
+      {
+         AddCoarseLevel(*lfes, setup);
+      }
+      else if (level < nlevels - 1)
+      {
+         forms.Append(NewForm(*lfes));
+         forms.Last()->SetAssemblyLevel(AssemblyLevel::PARTIAL);
+         setup(*forms.Last());
+         forms.Last()->Assemble();
+         AddSmoothedLevel(*forms.Last(), cheb_order);
+      }
+      else
+      {
+         AddSmoothedLevel(a, cheb_order);
+      }
+      prev = lfes;
+   }
+}
+
+BilinearForm *PMultigrid::NewForm(FiniteElementSpace &fes)
+{
+#ifdef MFEM_USE_MPI
+   ParFiniteElementSpace *pfes = dynamic_cast<ParFiniteElementSpace*>(&fes);
+   if (pfes) { return new ParBilinearForm(pfes); }
+#endif
+   return new BilinearForm(&fes);
+}
+
+void PMultigrid::AddCoarseLevel(FiniteElementSpace &fes,
+                                const IntegratorSetup &setup)
+{
+   BilinearForm *form = NewForm(fes);
+   setup(*form);
+   form->Assemble();
+   forms.Append(form);
+
+   CGSolver *cg;
+   Operator *A;
+#ifdef MFEM_USE_MPI
+   ParBilinearForm *pform = dynamic_cast<ParBilinearForm*>(form);
+   if (pform)
+   {
+      HypreParMatrix *hA = new HypreParMatrix;
+      pform->FormSystemMatrix(*ess_tdofs.Last(), *hA);
+      HypreBoomerAMG *amg = new HypreBoomerAMG(*hA);
+      amg->SetPrintLevel(0);
+      coarse_prec = amg;
+      cg = new CGSolver(pform->ParFESpace()->GetComm());
+      A = hA;
+   }
+   else
+#endif
+   {
+      SparseMatrix *sA = new SparseMatrix;
+      form->FormSystemMatrix(*ess_tdofs.Last(), *sA);
+      coarse_prec = new GSSmoother(*sA);
+      cg = new CGSolver;
+      A = sA;
+   }
+   cg->SetPrintLevel(-1);
+   cg->SetMaxIter(10);
+   cg->SetRelTol(1e-2);
+   cg->SetAbsTol(0.0);
+   cg->SetOperator(*A);
+   cg->SetPreconditioner(*coarse_prec);
+   AddLevel(A, cg, true, true);
+}
+
+void PMultigrid::AddSmoothedLevel(BilinearForm &a, int cheb_order)
+{
+   FiniteElementSpace &fes = *a.FESpace();
+   OperatorPtr opr;
+   opr.SetType(Operator::ANY_TYPE);
+   a.FormSystemMatrix(*ess_tdofs.Last(), opr);
+   opr.SetOperatorOwner(false);
+
+   diags.Append(new Vector(fes.GetTrueVSize()));
+   a.AssembleDiagonal(*diags.Last());
+
+   Solver *smoother;
+#ifdef MFEM_USE_MPI
+   ParFiniteElementSpace *pfes = dynamic_cast<ParFiniteElementSpace*>(&fes);
+   if (pfes)
+   {
+      smoother = new OperatorChebyshevSmoother(opr.Ptr(), *diags.Last(),
+                                               *ess_tdofs.Last(), cheb_order,
+                                               pfes->GetComm());
+   }
+   else
+#endif
+   {
+      smoother = new OperatorChebyshevSmoother(opr.Ptr(), *diags.Last(),
+                                               *ess_tdofs.Last(), cheb_order);
+   }
+   AddLevel(opr.Ptr(), smoother, true, true);
+}
+
+PMultigrid::~PMultigrid()
+{
+   delete coarse_prec;
+   for (int i = 0; i < forms.Size(); i++) { delete forms[i]; }
+   for (int i = 0; i < fespaces.Size(); i++) { delete fespaces[i]; }
+   for (int i = 0; i < fecs.Size(); i++) { delete fecs[i]; }
+   for (int i = 0; i < ess_tdofs.Size(); i++) { delete ess_tdofs[i]; }
+   for (int i = 0; i < diags.Size(); i++) { delete diags[i]; }
+}
+
 } // namespace mfem
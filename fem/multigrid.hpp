@@ -18,6 +18,8 @@
 #include "../linalg/operator.hpp"
 #include "../linalg/handle.hpp"
 
+#include <functional>
+
 namespace mfem
 {
 
@@ -145,6 +147,62 @@ private:
    virtual const Operator* GetProlongationAtLevel(int level) const override;
 };
 
+/** @brief Turnkey p-multigrid preconditioner for a high-order, partially
+    assembled BilinearForm on an H1 space.
+
+    The levels are spaces of orders p, p/2, p/4, ..., 1 on the mesh of the form
+    (halving the order and rounding down), connected with TransferOperator,
+    which uses TensorProductPRefinementTransferOperator on tensor product
+    elements. All levels except the coarsest are partially assembled and
+    smoothed with OperatorChebyshevSmoother, using the diagonal from
+    AssembleDiagonal(). The order 1 level is fully assembled and solved
+    approximately by a few CG iterations, preconditioned with HypreBoomerAMG
+    for a ParBilinearForm and with GSSmoother in serial.
+
+    The given form is the operator of the finest level. Since integrators
+    cannot be shared between forms, the integrators of the lower order forms
+    are added by the function @a setup, typically the code that built the
+    finest form. */
+class PMultigrid : public Multigrid
+{
+public:
+   /// Function adding the integrators to the BilinearForm of a level.
+   typedef std::function<void(BilinearForm &)> IntegratorSetup;
+
+protected:
+   Array<int> orders;
+   Array<FiniteElementCollection*> fecs;
+   Array<FiniteElementSpace*> fespaces;
+   Array<BilinearForm*> forms;
+   Array<Array<int>*> ess_tdofs;
+   Array<Vector*> diags;
+   Solver *coarse_prec;
+
+   /// Add the fully assembled coarsest level on @a fes.
+   void AddCoarseLevel(FiniteElementSpace &fes, const IntegratorSetup &setup);
+
+   /** @brief Add a level with the partially assembled form @a a and a
+       Chebyshev smoother of order @a cheb_order. */
+   void AddSmoothedLevel(BilinearForm &a, int cheb_order);
+
+   /// Return a new form on @a fes, a ParBilinearForm for a parallel space.
+   static BilinearForm *NewForm(FiniteElementSpace &fes);
+
+public:
+   /** @brief Build the hierarchy for the partially assembled form @a a with
+       essential boundary attributes @a ess_bdr. */
+   PMultigrid(BilinearForm &a, const Array<int> &ess_bdr,
+              IntegratorSetup setup, int cheb_order = 2);
+
+   /// Return the polynomial order of the space at the given level.
+   int GetOrderAtLevel(int level) const { return orders[level]; }
+
+   /// Return the essential true dofs of the finest level.
+   const Array<int> &GetEssentialTrueDofs() const { return *ess_tdofs.Last(); }
+
+   virtual ~PMultigrid();
+};
+
 } // namespace mfem
 
 #endif
@@ -2923,6 +2923,12 @@ void ParFiniteElementSpace::GetTrueTransferOperator(
    }
 }
 
+void ParFiniteElementSpace::SetDofRenumbering(DofRenumbering::Type type)
+{
+   MFEM_VERIFY(type == DofRenumbering::NATIVE,
+               "DOF renumbering is not supported for ParFiniteElementSpace");
+}
+
 void ParFiniteElementSpace::Update(bool want_transform)
 {
    if (mesh->GetSequence() == sequence)
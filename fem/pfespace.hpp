@@ -389,6 +389,10 @@ public:
        /rebalance matrices, unless want_transform is false. */
    virtual void Update(bool want_transform = true);
 
+   /** The shared DOF communication assumes the native DOF numbering: only
+       DofRenumbering::NATIVE is supported in parallel. */
+   virtual void SetDofRenumbering(DofRenumbering::Type type);
+
    /// Free ParGridFunction transformation matrix (if any), to save memory.
    virtual void UpdatesFinished()
    {
@@ -0,0 +1,595 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "pointlocator.hpp"
+#include "../general/forall.hpp"
+#include "../linalg/kernels.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace mfem
+{
+
+// Evaluate the 1D Lagrange basis with @a n nodes @a z and barycentric weights
+// @a w at the point @a x. The derivatives are computed if @a g is not NULL.
+MFEM_HOST_DEVICE static inline
+void Lagrange1D(const int n, const double *z, const double *w, const double x,
+                double *b, double *g)
+{
+   // L[j] = prod_{k<j} (x - z[k]) and its derivative
+   double L[MAX_D1D], dL[MAX_D1D];
+   L[0] = 1.0;
+   dL[0] = 0.0;
+   for (int j = 1; j < n; j++)
+   {
+      L[j] = L[j-1]*(x - z[j-1]);
+      dL[j] = dL[j-1]*(x - z[j-1]) + L[j-1];
+   }
+   // R = prod_{k>j} (x - z[k]) and its derivative
+   double R = 1.0, dR = 0.0;
+   for (int j = n-1; j >= 0; j--)
+   {
+      b[j] = w[j]*L[j]*R;
+      if (g) { g[j] = w[j]*(dL[j]*R + L[j]*dR); }
+      dR = dR*(x - z[j]) + R;
+      R *= (x - z[j]);
+   }
+}
+
+// Return true if the mesh consists of segments, quadrilaterals or hexahedra.
+static bool TensorProductMesh(const Mesh &mesh)
+{
+   const int dim = mesh.Dimension();
+   return (mesh.GetNE() > 0 && mesh.GetNumGeometries(dim) == 1 &&
+           mesh.GetElementBaseGeometry(0) ==
+           TensorBasisElement::GetTensorProductGeometry(dim));
+}
+
+// Return the 1D nodes and barycentric weights of the nodal tensor-product
+// element @a fe, or false if the element is not supported by Lagrange1D().
+static bool TensorNodes1D(const FiniteElement *fe, Vector &z, Vector &w)
+{
+   const NodalTensorFiniteElement *tfe =
+      dynamic_cast<const NodalTensorFiniteElement*>(fe);
+   if (tfe == NULL || fe->GetOrder() + 1 > MAX_D1D) { return false; }
+   const int p = fe->GetOrder();
+   const double *pts = poly1d.GetPoints(p, tfe->GetBasisType());
+   z.SetSize(p + 1);
+   w.SetSize(p + 1);
+   for (int j = 0; j <= p; j++)
+   {
+      z(j) = pts[j];
+      w(j) = 1.0;
+      for (int k = 0; k <= p; k++)
+      {
+         if (k != j) { w(j) /= (pts[j] - pts[k]); }
+      }
+   }
+   return true;
+}
+
+PointLocator::PointLocator()
+   : mesh(NULL), dim(0), sdim(0), NE(0), bb_t(0.1), newt_tol(1e-12),
+     max_iter(20), tensor(false), d1d(0), npts(0), default_value(0.0)
+{
+   for (int d = 0; d < 3; d++)
+   {
+      grid_min[d] = grid_h[d] = 0.0;
+      grid_n[d] = 1;
+   }
+}
+
+PointLocator::PointLocator(Mesh &m, const double bb_t, const double newt_tol,
+                           const int max_iter)
+   : PointLocator()
+{
+   Setup(m, bb_t, newt_tol, max_iter);
+}
+
+void PointLocator::Setup(Mesh &m, const double bb_t_, const double newt_tol_,
+                         const int max_iter_)
+{
+   mesh = &m;
+   dim = m.Dimension();
+   sdim = m.SpaceDimension();
+   NE = m.GetNE();
+   bb_t = bb_t_;
+   newt_tol = newt_tol_;
+   max_iter = max_iter_;
+   npts = 0;
+   elem.SetSize(0);
+   ref.SetSize(0);
+
+   SetupElements();
+   SetupGrid();
+}
+
+void PointLocator::SetupElements()
+{
+   bb_min.SetSize(sdim*NE);
+   bb_max.SetSize(sdim*NE);
+   tensor = false;
+   e_nodes.Destroy();
+   if (NE == 0) { return; }
+
+   const GridFunction *nodes = mesh->GetNodes();
+   if (TensorProductMesh(*mesh) && sdim == dim && !mesh->NURBSext)
+   {
+      if (nodes == NULL)
+      {
+         // Linear elements: lexicographic vertices, see the vertex numbering
+         // of Segment, Quadrilateral and Hexahedron.
+         static const int lex_to_vert[8] = { 0, 1, 3, 2, 4, 5, 7, 6 };
+         const int ND = 1 << dim;
+         d1d = 2;
+         nodes1d.SetSize(2);
+         nodes1d(0) = 0.0;
+         nodes1d(1) = 1.0;
+         weights1d.SetSize(2);
+         weights1d(0) = -1.0;
+         weights1d(1) = 1.0;
+         e_nodes.SetSize(ND*sdim*NE);
+         auto X = Reshape(e_nodes.HostWrite(), ND, sdim, NE);
+         Array<int> v;
+         for (int e = 0; e < NE; e++)
+         {
+            mesh->GetElementVertices(e, v);
+            for (int l = 0; l < ND; l++)
+            {
+               const double *x = mesh->GetVertex(v[lex_to_vert[l]]);
+               for (int d = 0; d < sdim; d++) { X(l,d,e) = x[d]; }
+            }
+         }
+         tensor = true;
+      }
+      else if (!nodes->FESpace()->GetNURBSext() &&
+               TensorNodes1D(nodes->FESpace()->GetFE(0), nodes1d, weights1d))
+      {
+         const FiniteElementSpace &nfes = *nodes->FESpace();
+         d1d = nodes1d.Size();
+         const Operator *R =
+            nfes.GetElementRestriction(ElementDofOrdering::LEXICOGRAPHIC);
+         e_nodes.SetSize(R->Height());
+         R->Mult(*nodes, e_nodes);
+         tensor = true;
+      }
+   }
+
+   const double t = bb_t;
+   if (tensor)
+   {
+      const int SDIM = sdim;
+      const int ND = e_nodes.Size()/(sdim*NE);
+      auto X = Reshape(e_nodes.Read(), ND, SDIM, NE);
+      auto BMIN = Reshape(bb_min.Write(), SDIM, NE);
+      auto BMAX = Reshape(bb_max.Write(), SDIM, NE);
+      MFEM_FORALL(e, NE,
+      {
+         double h = 0.0;
+         for (int d = 0; d < SDIM; d++)
+         {
+            double lo = X(0,d,e), hi = X(0,d,e);
+            for (int l = 1; l < ND; l++)
+            {
+               lo = fmin(lo, X(l,d,e));
+               hi = fmax(hi, X(l,d,e));
+            }
+            BMIN(d,e) = lo;
+            BMAX(d,e) = hi;
+            h = fmax(h, hi - lo);
+         }
+         for (int d = 0; d < SDIM; d++)
+         {
+            BMIN(d,e) -= t*h;
+            BMAX(d,e) += t*h;
+         }
+      });
+   }
+   else
+   {
+      auto BMIN = Reshape(bb_min.HostWrite(), sdim, NE);
+      auto BMAX = Reshape(bb_max.HostWrite(), sdim, NE);
+      IsoparametricTransformation T;
+      for (int e = 0; e < NE; e++)
+      {
+         mesh->GetElementTransformation(e, &T);
+         const DenseMatrix &pm = T.GetPointMat();
+         double h = 0.0;
+         for (int d = 0; d < sdim; d++)
+         {
+            double lo = pm(d,0), hi = pm(d,0);
+            for (int l = 1; l < pm.Width(); l++)
+            {
+               lo = std::min(lo, pm(d,l));
+               hi = std::max(hi, pm(d,l));
+            }
+            BMIN(d,e) = lo;
+            BMAX(d,e) = hi;
+            h = std::max(h, hi - lo);
+         }
+         for (int d = 0; d < sdim; d++)
+         {
+            BMIN(d,e) -= t*h;
+            BMAX(d,e) += t*h;
+         }
+      }
+   }
+}
+
+void PointLocator::SetupGrid()
+{
+   for (int d = 0; d < 3; d++)
+   {
+      grid_min[d] = 0.0;
+      grid_h[d] = 1.0;
+      grid_n[d] = 1;
+   }
+   if (NE == 0) { cell_elem.MakeI(0); cell_elem.MakeJ(); return; }
+
+   // Choose the cell size so that the number of cells is about the number of
+   // elements.
+   auto BMIN = Reshape(bb_min.HostRead(), sdim, NE);
+   auto BMAX = Reshape(bb_max.HostRead(), sdim, NE);
+   double grid_max[3], ext[3], vol = 1.0, max_ext = 0.0;
+   for (int d = 0; d < sdim; d++)
+   {
+      grid_min[d] = BMIN(d,0);
+      grid_max[d] = BMAX(d,0);
+      for (int e = 1; e < NE; e++)
+      {
+         grid_min[d] = std::min(grid_min[d], BMIN(d,e));
+         grid_max[d] = std::max(grid_max[d], BMAX(d,e));
+      }
+      ext[d] = grid_max[d] - grid_min[d];
+      max_ext = std::max(max_ext, ext[d]);
+   }
+   int nd = 0;
+   for (int d = 0; d < sdim; d++)
+   {
+      if (ext[d] > 1e-12*max_ext) { vol *= ext[d]; nd++; }
+   }
+   const double h = (nd > 0) ? pow(vol/NE, 1.0/nd) : 1.0;
+   int num_cells = 1;
+   for (int d = 0; d < sdim; d++)
+   {
+      if (ext[d] > 1e-12*max_ext)
+      {
+         grid_n[d] = std::max(1, std::min(NE, (int) ceil(ext[d]/h)));
+         grid_h[d] = ext[d]/grid_n[d];
+      }
+      num_cells *= grid_n[d];
+   }
+
+   // For each element, loop over the range of cells overlapping its bounding
+   // box; the first pass counts the elements of each cell, the second one
+   // stores them.
+   cell_elem.MakeI(num_cells);
+   for (int pass = 0; pass < 2; pass++)
+   {
+      for (int e = 0; e < NE; e++)
+      {
+         int lo[3] = {0, 0, 0}, hi[3] = {0, 0, 0};
+         for (int d = 0; d < sdim; d++)
+         {
+            const double s0 = (BMIN(d,e) - grid_min[d])/grid_h[d];
+            const double s1 = (BMAX(d,e) - grid_min[d])/grid_h[d];
+            lo[d] = std::max(0, std::min(grid_n[d]-1, (int) floor(s0)));
+            hi[d] = std::max(0, std::min(grid_n[d]-1, (int) floor(s1)));
+         }
+         for (int k = lo[2]; k <= hi[2]; k++)
+         {
+            for (int j = lo[1]; j <= hi[1]; j++)
+            {
+               for (int i = lo[0]; i <= hi[0]; i++)
+               {
+                  const int c = i + grid_n[0]*(j + grid_n[1]*k);
+                  if (pass == 0) { cell_elem.AddAColumnInRow(c); }
+                  else { cell_elem.AddConnection(c, e); }
+               }
+            }
+         }
+      }
+      if (pass == 0) { cell_elem.MakeJ(); }
+   }
+   cell_elem.ShiftUpI();
+}
+
+void PointLocator::GetCandidates(const Vector &point_pos, Array<int> &offsets,
+                                 Array<int> &cands) const
+{
+   auto P = Reshape(point_pos.HostRead(), npts, sdim);
+   auto BMIN = Reshape(bb_min.HostRead(), sdim, NE);
+   auto BMAX = Reshape(bb_max.HostRead(), sdim, NE);
+   offsets.SetSize(npts + 1);
+   offsets[0] = 0;
+   cands.SetSize(0);
+   for (int p = 0; p < npts; p++)
+   {
+      int idx[3] = {0, 0, 0};
+      bool in_grid = (NE > 0);
+      for (int d = 0; d < sdim && in_grid; d++)
+      {
+         const double s = floor((P(p,d) - grid_min[d])/grid_h[d]);
+         // Points on the upper boundary of the grid belong to the last cell.
+         idx[d] = (s == grid_n[d]) ? grid_n[d]-1 : (int) s;
+         in_grid = (s >= 0.0 && s <= grid_n[d]);
+      }
+      if (in_grid)
+      {
+         const int c = idx[0] + grid_n[0]*(idx[1] + grid_n[1]*idx[2]);
+         const int *els = cell_elem.GetRow(c);
+         for (int i = 0; i < cell_elem.RowSize(c); i++)
+         {
+            const int e = els[i];
+            bool inside = true;
+            for (int d = 0; d < sdim && inside; d++)
+            {
+               inside = (BMIN(d,e) <= P(p,d) && P(p,d) <= BMAX(d,e));
+            }
+            if (inside) { cands.Append(e); }
+         }
+      }
+      offsets[p+1] = cands.Size();
+   }
+}
+
+int PointLocator::FindPoints(const Vector &point_pos)
+{
+   MFEM_VERIFY(mesh != NULL, "Setup() must be called first");
+   npts = point_pos.Size()/sdim;
+   MFEM_VERIFY(npts*sdim == point_pos.Size(), "invalid size of point_pos");
+   elem.SetSize(npts);
+   ref.SetSize(npts*dim);
+
+   Array<int> offsets, cands;
+   GetCandidates(point_pos, offsets, cands);
+
+   if (tensor)
+   {
+      // Newton iteration for all points in parallel, trying the candidate
+      // elements one after the other. The iterates are projected on the
+      // reference element, so for points outside of an element the iteration
+      // stagnates on its boundary.
+      const int DIM = dim;
+      const int SDIM = sdim;
+      const int D1D = d1d;
+      const int ND = e_nodes.Size()/(sdim*NE);
+      const int NP = npts;
+      const int max_it = max_iter;
+      const double tol = newt_tol;
+      auto P = Reshape(point_pos.Read(), NP, SDIM);
+      auto X = Reshape(e_nodes.Read(), ND, SDIM, NE);
+      auto BMIN = Reshape(bb_min.Read(), SDIM, NE);
+      auto BMAX = Reshape(bb_max.Read(), SDIM, NE);
+      auto Z = nodes1d.Read();
+      auto W = weights1d.Read();
+      auto OFF = offsets.Read();
+      auto C = cands.Read();
+      auto EL = elem.Write();
+      auto REF = Reshape(ref.Write(), DIM, NP);
+      MFEM_FORALL(p, NP,
+      {
+         double x[3], r[3], F[3], J[9], Jinv[9];
+         double b[3][MAX_D1D], g[3][MAX_D1D];
+         double scale = 0.0;
+         for (int d = 0; d < SDIM; d++)
+         {
+            x[d] = P(p,d);
+            scale = fmax(scale, fabs(x[d]));
+         }
+         int found = -1;
+         for (int c = OFF[p]; c < OFF[p+1] && found < 0; c++)
+         {
+            const int e = C[c];
+            double h = 0.0;
+            for (int d = 0; d < SDIM; d++)
+            {
+               h = fmax(h, BMAX(d,e) - BMIN(d,e));
+            }
+            const double phys_tol = tol*(scale + h);
+            for (int d = 0; d < DIM; d++) { r[d] = 0.5; }
+            for (int it = 0; it <= max_it; it++)
+            {
+               for (int d = 0; d < DIM; d++)
+               {
+                  Lagrange1D(D1D, Z, W, r[d], b[d], g[d]);
+               }
+               for (int s = 0; s < SDIM; s++)
+               {
+                  F[s] = 0.0;
+                  for (int d = 0; d < DIM; d++) { J[s+SDIM*d] = 0.0; }
+               }
+               for (int l = 0; l < ND; l++)
+               {
+                  const int i[3] = { l % D1D, (l/D1D) % D1D, l/(D1D*D1D) };
+                  double w = 1.0, dw[3];
+                  for (int d = 0; d < DIM; d++)
+                  {
+                     dw[d] = 1.0;
+                     w *= b[d][i[d]];
+                     for (int d2 = 0; d2 < DIM; d2++)
+                     {
+                        dw[d] *= (d2 == d) ? g[d2][i[d2]] : b[d2][i[d2]];
+                     }
+                  }
+                  for (int s = 0; s < SDIM; s++)
+                  {
+                     F[s] += w*X(l,s,e);
+                     for (int d = 0; d < DIM; d++)
+                     {
+                        J[s+SDIM*d] += dw[d]*X(l,s,e);
+                     }
+                  }
+               }
+               double dist = 0.0;
+               for (int s = 0; s < SDIM; s++)
+               {
+                  F[s] = x[s] - F[s];
+                  dist += F[s]*F[s];
+               }
+               if (sqrt(dist) <= phys_tol)
+               {
+                  found = e;
+                  break;
+               }
+               if (it == max_it) { break; }
+
+               if (DIM == 1) { Jinv[0] = 1.0/J[0]; }
+               else if (DIM == 2) { kernels::CalcInverse<2>(J, Jinv); }
+               else { kernels::CalcInverse<3>(J, Jinv); }
+               double dr = 0.0;
+               for (int d = 0; d < DIM; d++)
+               {
+                  double rd = r[d];
+                  for (int s = 0; s < SDIM; s++) { rd += Jinv[d+DIM*s]*F[s]; }
+                  rd = fmin(1.0, fmax(0.0, rd));
+                  dr = fmax(dr, fabs(rd - r[d]));
+                  r[d] = rd;
+               }
+               if (dr < tol) { break; }
+            }
+         }
+         EL[p] = found;
+         for (int d = 0; d < DIM; d++) { REF(d,p) = (found >= 0) ? r[d] : 0.0; }
+      });
+   }
+   else
+   {
+      InverseElementTransformation inv_tr;
+      inv_tr.SetReferenceTol(newt_tol);
+      inv_tr.SetPhysicalRelTol(newt_tol);
+      inv_tr.SetMaxIter(max_iter);
+      IntegrationPoint ip;
+      Vector pt(sdim);
+      auto P = Reshape(point_pos.HostRead(), npts, sdim);
+      auto REF = Reshape(ref.HostWrite(), dim, npts);
+      for (int p = 0; p < npts; p++)
+      {
+         elem[p] = -1;
+         for (int d = 0; d < sdim; d++) { pt(d) = P(p,d); }
+         for (int c = offsets[p]; c < offsets[p+1]; c++)
+         {
+            inv_tr.SetTransformation(*mesh->GetElementTransformation(cands[c]));
+            const int res = inv_tr.Transform(pt, ip);
+            if (res == InverseElementTransformation::Inside)
+            {
+               elem[p] = cands[c];
+               break;
+            }
+         }
+         double ipx[3] = {0.0, 0.0, 0.0};
+         if (elem[p] >= 0) { ip.Get(ipx, dim); }
+         for (int d = 0; d < dim; d++) { REF(d,p) = ipx[d]; }
+      }
+   }
+
+   int found = 0;
+   const int *h_elem = elem.HostRead();
+   for (int p = 0; p < npts; p++) { found += (h_elem[p] >= 0); }
+   return found;
+}
+
+void PointLocator::Interpolate(const GridFunction &field_in,
+                               Vector &field_out) const
+{
+   const FiniteElementSpace &fes = *field_in.FESpace();
+   MFEM_VERIFY(fes.GetMesh() == mesh, "the field must be defined on the mesh"
+               " given to Setup()");
+   const int vdim = field_in.VectorDim();
+   field_out.SetSize(npts*vdim);
+   if (npts == 0) { return; }
+
+   Vector z, w;
+   if (TensorProductMesh(*mesh) && !fes.GetNURBSext() &&
+       fes.GetFE(0)->GetMapType() == FiniteElement::VALUE &&
+       TensorNodes1D(fes.GetFE(0), z, w))
+   {
+      const Operator *R =
+         fes.GetElementRestriction(ElementDofOrdering::LEXICOGRAPHIC);
+      Vector e_vec(R->Height());
+      R->Mult(field_in, e_vec);
+
+      const int DIM = dim;
+      const int VDIM = vdim;
+      const int D1D = z.Size();
+      const int ND = e_vec.Size()/(vdim*NE);
+      const int NP = npts;
+      const double def = default_value;
+      auto E = Reshape(e_vec.Read(), ND, VDIM, NE);
+      auto Z = z.Read();
+      auto W = w.Read();
+      auto EL = elem.Read();
+      auto REF = Reshape(ref.Read(), DIM, NP);
+      auto OUT = Reshape(field_out.Write(), NP, VDIM);
+      MFEM_FORALL(p, NP,
+      {
+         const int e = EL[p];
+         double b[3][MAX_D1D];
+         if (e >= 0)
+         {
+            for (int d = 0; d < DIM; d++)
+            {
+               Lagrange1D(D1D, Z, W, REF(d,p), b[d], NULL);
+            }
+         }
+         for (int c = 0; c < VDIM; c++)
+         {
+            double u = def;
+            if (e >= 0)
+            {
+               u = 0.0;
+               for (int l = 0; l < ND; l++)
+               {
+                  const int i[3] = { l % D1D, (l/D1D) % D1D, l/(D1D*D1D) };
+                  double s = E(l,c,e);
+                  for (int d = 0; d < DIM; d++) { s *= b[d][i[d]]; }
+                  u += s;
+               }
+            }
+            OUT(p,c) = u;
+         }
+      });
+      return;
+   }
+
+   Array<IntegrationPoint> ips;
+   GetIntegrationPoints(ips);
+   const int *h_elem = elem.HostRead();
+   auto OUT = Reshape(field_out.HostWrite(), npts, vdim);
+   Vector val;
+   for (int p = 0; p < npts; p++)
+   {
+      if (h_elem[p] >= 0)
+      {
+         field_in.GetVectorValue(h_elem[p], ips[p], val);
+      }
+      for (int c = 0; c < vdim; c++)
+      {
+         OUT(p,c) = (h_elem[p] >= 0) ? val(c) : default_value;
+      }
+   }
+}
+
+void PointLocator::GetIntegrationPoints(Array<IntegrationPoint> &ips) const
+{
+   ips.SetSize(npts);
+   auto REF = Reshape(ref.HostRead(), dim, npts);
+   for (int p = 0; p < npts; p++)
+   {
+      double x[3] = {0.0, 0.0, 0.0};
+      for (int d = 0; d < dim; d++) { x[d] = REF(d,p); }
+      ips[p].Set(x, dim);
+      ips[p].weight = 0.0;
+   }
+}
+
+} // namespace mfem
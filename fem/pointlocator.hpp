@@ -0,0 +1,145 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#ifndef MFEM_POINTLOCATOR
+#define MFEM_POINTLOCATOR
+
+#include "../config/config.hpp"
+#include "gridfunc.hpp"
+
+namespace mfem
+{
+
+/** @brief PointLocator finds the elements and reference coordinates of many
+    points in a Mesh at once, and evaluates GridFunctions at the located points.
+    It is a native alternative to FindPointsGSLIB. */
+/** There are three steps, which can be used separately:
+
+    1. Setup - computes the bounding boxes of the mesh elements, enlarged by a
+       relative tolerance, and a uniform grid of cells covering the mesh. Each
+       cell lists the elements whose bounding boxes overlap it.
+
+    2. FindPoints - for each point, the elements whose bounding boxes contain
+       the point are taken from its grid cell and the element transformation is
+       inverted until the point is found. For meshes of segments,
+       quadrilaterals or hexahedra, with no nodes or with nodes in a nodal
+       tensor-product space, the inversion is a Newton iteration executed for
+       all points in parallel (on the device, when enabled). Other meshes use
+       InverseElementTransformation on the host.
+
+    3. Interpolate - evaluates a GridFunction at the located points. All
+       components of the GridFunction are evaluated together, so several scalar
+       fields on the same mesh are best evaluated as one vector GridFunction.
+       Fields in nodal tensor-product spaces are evaluated in parallel for all
+       points; other fields use GridFunction::GetVectorValue().
+
+    For a ParMesh, only the local elements are searched. */
+class PointLocator
+{
+protected:
+   Mesh *mesh;
+   int dim, sdim, NE;
+   double bb_t, newt_tol;
+   int max_iter;
+
+   /// Element bounding boxes, with layout (SDIM x NE).
+   Vector bb_min, bb_max;
+
+   /// Uniform grid of cells: origin, cell size, number of cells per direction,
+   /// and the elements overlapping each cell.
+   double grid_min[3], grid_h[3];
+   int grid_n[3];
+   Table cell_elem;
+
+   /// Data for the tensor-product Newton kernel: 1D nodes, their barycentric
+   /// weights, and the lexicographic element nodes with layout
+   /// (D1D^DIM x SDIM x NE).
+   bool tensor;
+   int d1d;
+   Vector nodes1d, weights1d, e_nodes;
+
+   /// Results of the last call to FindPoints().
+   int npts;
+   Array<int> elem;
+   Vector ref;
+
+   double default_value;
+
+   /// Compute the element bounding boxes and the data for the Newton kernel.
+   void SetupElements();
+
+   /// Build the grid of cells and #cell_elem.
+   void SetupGrid();
+
+   /// Collect the candidate elements of the points with layout byNODES.
+   void GetCandidates(const Vector &point_pos, Array<int> &offsets,
+                      Array<int> &cands) const;
+
+public:
+   PointLocator();
+
+   /// Construct and Setup() a PointLocator for the Mesh @a m.
+   PointLocator(Mesh &m, const double bb_t = 0.1,
+                const double newt_tol = 1.0e-12, const int max_iter = 20);
+
+   /** @brief Build the element bounding boxes and the grid of cells.
+       @param[in] m         Input mesh. It must not be modified while the
+                            PointLocator is in use.
+       @param[in] bb_t      Relative size of the enlargement of the bounding box
+                            around each element.
+       @param[in] newt_tol  Relative tolerance for the Newton iteration and for
+                            the physical distance of the found points.
+       @param[in] max_iter  Maximal number of Newton iterations per element. */
+   void Setup(Mesh &m, const double bb_t = 0.1,
+              const double newt_tol = 1.0e-12, const int max_iter = 20);
+
+   /** @brief Locate the points given in physical space by @a point_pos, ordered
+       by nodes: (XXX...,YYY...,ZZZ...).
+
+       The element ids and reference coordinates of the points are returned by
+       GetElem() and GetReferencePosition(). @returns The number of points that
+       were found. */
+   int FindPoints(const Vector &point_pos);
+
+   /** @brief Evaluate @a field_in at the points located by the last call to
+       FindPoints().
+
+       The result @a field_out is ordered by nodes: all points of the first
+       component, then all points of the second component, etc. Points that
+       were not found are set to the default interpolation value. The space of
+       @a field_in must be defined on the Mesh given to Setup(). */
+   void Interpolate(const GridFunction &field_in, Vector &field_out) const;
+
+   /// Locate the points @a point_pos and evaluate @a field_in at them.
+   void Interpolate(const Vector &point_pos, const GridFunction &field_in,
+                    Vector &field_out)
+   {
+      FindPoints(point_pos);
+      Interpolate(field_in, field_out);
+   }
+
+   /// Set the value used by Interpolate() for points that were not found.
+   void SetDefaultInterpolationValue(double value) { default_value = value; }
+
+   /// Return the element id for each point, or -1 if it was not found.
+   const Array<int> &GetElem() const { return elem; }
+
+   /// Return the reference coordinates for each point, ordered by vdim
+   /// (XYZ,XYZ,...). Points that were not found have undefined coordinates.
+   const Vector &GetReferencePosition() const { return ref; }
+
+   /// Return the reference coordinates of the points as IntegrationPoints.
+   void GetIntegrationPoints(Array<IntegrationPoint> &ips) const;
+};
+
+} // namespace mfem
+
+#endif // MFEM_POINTLOCATOR
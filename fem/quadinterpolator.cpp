@@ -232,6 +232,80 @@ void QuadratureInterpolator::Eval3D(
    });
 }
 
+void QuadratureInterpolator::EvalGeneric(
+   const int NE,
+   const int vdim,
+   const DofToQuad &maps,
+   const Vector &e_vec,
+   Vector &q_val,
+   Vector &q_der,
+   Vector &q_det,
+   const int eval_flags)
+{
+   const int dim = maps.FE->GetDim();
+   const int ND = maps.ndof;
+   const int NQ = maps.nqpt;
+   const int VDIM = vdim;
+   MFEM_VERIFY(!(eval_flags & DETERMINANTS) || (dim <= vdim && vdim <= 3),
+               "invalid vdim = " << vdim << " for the DETERMINANTS flag");
+   auto B = Reshape(maps.B.Read(), NQ, ND);
+   auto G = Reshape(maps.G.Read(), NQ, dim, ND);
+   auto E = Reshape(e_vec.Read(), ND, VDIM, NE);
+   auto val = Reshape(q_val.Write(), NQ, VDIM, NE);
+   auto der = Reshape(q_der.Write(), NQ, VDIM, dim, NE);
+   auto det = Reshape(q_det.Write(), NQ, NE);
+   MFEM_FORALL(i, NQ*NE,
+   {
+      const int q = i % NQ;
+      const int e = i / NQ;
+      double J[9];
+      for (int c = 0; c < VDIM; c++)
+      {
+         if (eval_flags & VALUES)
+         {
+            double u = 0.0;
+            for (int d = 0; d < ND; d++) { u += B(q,d)*E(d,c,e); }
+            val(q,c,e) = u;
+         }
+         if (eval_flags & (DERIVATIVES | DETERMINANTS))
+         {
+            for (int k = 0; k < dim; k++)
+            {
+               double du = 0.0;
+               for (int d = 0; d < ND; d++) { du += G(q,k,d)*E(d,c,e); }
+               if (eval_flags & DERIVATIVES) { der(q,c,k,e) = du; }
+               if (VDIM <= 3) { J[c+VDIM*k] = du; }
+            }
+         }
+      }
+      if (eval_flags & DETERMINANTS)
+      {
+         if (VDIM == dim)
+         {
+            det(q,e) = (dim == 1) ? J[0] :
+                       (dim == 2) ? kernels::Det<2>(J) : kernels::Det<3>(J);
+         }
+         else if (dim == 1)
+         {
+            double w = 0.0;
+            for (int c = 0; c < VDIM; c++) { w += J[c]*J[c]; }
+            det(q,e) = sqrt(w);
+         }
+         else // dim == 2, VDIM == 3
+         {
+            double a = 0.0, b = 0.0, f = 0.0;
+            for (int c = 0; c < 3; c++)
+            {
+               a += J[c]*J[c];
+               b += J[c+3]*J[c+3];
+               f += J[c]*J[c+3];
+            }
+            det(q,e) = sqrt(a*b - f*f);
+         }
+      }
+   });
+}
+
 void QuadratureInterpolator::Mult(
    const Vector &e_vec, unsigned eval_flags,
    Vector &q_val, Vector &q_der, Vector &q_det) const
@@ -403,13 +477,17 @@ void QuadratureInterpolator::Mult(
          }
       }
    }
-   if (eval_func)
+   const bool fits = (dim == 2) ? (nd <= MAX_ND2D && nq <= MAX_NQ2D) :
+                     (nd <= MAX_ND3D && nq <= MAX_NQ3D);
+   // The templated kernels compute determinants only for square Jacobians.
+   const bool square = (vdim == dim) || !(eval_flags & DETERMINANTS);
+   if (eval_func && fits && square)
    {
       eval_func(ne, vdim, maps, e_vec, q_val, q_der, q_det, eval_flags);
    }
    else
    {
-      MFEM_ABORT("case not supported yet");
+      EvalGeneric(ne, vdim, maps, e_vec, q_val, q_der, q_det, eval_flags);
    }
 }
 
@@ -136,6 +136,21 @@ public:
                       Vector &q_der,
                       Vector &q_det,
                       const int eval_flags);
+
+   /** @brief Generic compute kernel for any dimension, number of dofs and
+       number of quadrature points; the @a maps must use DofToQuad::FULL. */
+   /** This kernel is used when the templated kernels do not apply. When the
+       DETERMINANTS flag is set and @a vdim is larger than the dimension, the
+       weight sqrt(det(J^t J)) is computed instead of the determinant, as in
+       ElementTransformation::Weight(). */
+   static void EvalGeneric(const int NE,
+                           const int vdim,
+                           const DofToQuad &maps,
+                           const Vector &e_vec,
+                           Vector &q_val,
+                           Vector &q_der,
+                           Vector &q_det,
+                           const int eval_flags);
 };
 
 }
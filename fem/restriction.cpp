@@ -17,6 +17,12 @@
 namespace mfem
 {
 
+// Return the total number of dofs of the elements of the space.
+static int GetNEDofs(const FiniteElementSpace &fes)
+{
+   return fes.GetElementToDofTable().Size_of_connections();
+}
+
 ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
                                        ElementDofOrdering e_ordering)
    : fes(f),
@@ -25,48 +31,98 @@ ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
      byvdim(fes.GetOrdering() == Ordering::byVDIM),
      ndofs(fes.GetNDofs()),
      dof(ne > 0 ? fes.GetFE(0)->GetDof() : 0),
-     nedofs(ne*dof),
+     nedofs(GetNEDofs(f)),
      offsets(ndofs+1),
-     indices(ne*dof),
-     gatherMap(ne*dof)
+     indices(nedofs),
+     gatherMap(nedofs)
 {
-   // Assuming all finite elements are the same.
-   height = vdim*ne*dof;
+   height = vdim*nedofs;
    width = fes.GetVSize();
-   const bool dof_reorder = (e_ordering == ElementDofOrdering::LEXICOGRAPHIC);
-   const int *dof_map = NULL;
-   if (dof_reorder && ne > 0)
+
+   // Group the elements by geometry, keeping their order within each batch.
+   const Mesh &mesh = *fes.GetMesh();
+   int geom_batch[Geometry::NumGeom];
+   for (int g = 0; g < Geometry::NumGeom; g++) { geom_batch[g] = 0; }
+   for (int e = 0; e < ne; ++e)
+   {
+      geom_batch[mesh.GetElementBaseGeometry(e)]++;
+   }
+   batch_offsets.SetSize(1);
+   batch_offsets[0] = 0;
+   for (int g = 0; g < Geometry::NumGeom; g++)
    {
-      for (int e = 0; e < ne; ++e)
+      if (geom_batch[g] == 0) { continue; }
+      const int count = geom_batch[g];
+      geom_batch[g] = batch_geom.Size();
+      batch_geom.Append(Geometry::Type(g));
+      batch_offsets.Append(batch_offsets.Last() + count);
+   }
+   const int nb = batch_geom.Size();
+   const bool mixed = nb > 1;
+   Array<int> pos(batch_offsets);
+   batch_elements.SetSize(ne);
+   for (int e = 0; e < ne; ++e)
+   {
+      batch_elements[pos[geom_batch[mesh.GetElementBaseGeometry(e)]]++] = e;
+   }
+   batch_dofs.SetSize(nb);
+   batch_dof_offsets.SetSize(nb+1);
+   batch_dof_offsets[0] = 0;
+   for (int b = 0; b < nb; ++b)
+   {
+      batch_dofs[b] = fes.GetFE(batch_elements[batch_offsets[b]])->GetDof();
+      const int nbe = batch_offsets[b+1] - batch_offsets[b];
+      batch_dof_offsets[b+1] = batch_dof_offsets[b] + batch_dofs[b]*nbe;
+   }
+   MFEM_VERIFY(nb == 0 || batch_dof_offsets[nb] == nedofs,
+               "the elements with the same geometry must have the same number"
+               " of dofs");
+
+   if (mixed)
+   {
+      dof_batch.SetSize(nedofs);
+      for (int b = 0; b < nb; ++b)
       {
-         const FiniteElement *fe = fes.GetFE(e);
-         const TensorBasisElement* el =
-            dynamic_cast<const TensorBasisElement*>(fe);
-         if (el) { continue; }
-         mfem_error("Finite element not suitable for lexicographic ordering");
+         for (int k = batch_dof_offsets[b]; k < batch_dof_offsets[b+1]; ++k)
+         {
+            dof_batch[k] = b;
+         }
       }
-      const FiniteElement *fe = fes.GetFE(0);
+   }
+
+   const bool dof_reorder = (e_ordering == ElementDofOrdering::LEXICOGRAPHIC);
+   Array<const int*> dof_maps(nb);
+   for (int b = 0; b < nb; ++b)
+   {
+      dof_maps[b] = NULL;
+      if (!dof_reorder) { continue; }
+      const FiniteElement *fe = fes.GetFE(batch_elements[batch_offsets[b]]);
       const TensorBasisElement* el =
          dynamic_cast<const TensorBasisElement*>(fe);
+      if (!el)
+      {
+         // Elements without a tensor basis keep the native ordering on meshes
+         // with more than one geometry.
+         if (mixed) { continue; }
+         mfem_error("Finite element not suitable for lexicographic ordering");
+      }
       const Array<int> &fe_dof_map = el->GetDofMap();
       MFEM_VERIFY(fe_dof_map.Size() > 0, "invalid dof map");
-      dof_map = fe_dof_map.GetData();
+      dof_maps[b] = fe_dof_map.GetData();
    }
    const Table& e2dTable = fes.GetElementToDofTable();
+   const int* elementI = e2dTable.GetI();
    const int* elementMap = e2dTable.GetJ();
    // We will be keeping a count of how many local nodes point to its global dof
    for (int i = 0; i <= ndofs; ++i)
    {
       offsets[i] = 0;
    }
-   for (int e = 0; e < ne; ++e)
+   for (int k = 0; k < nedofs; ++k)
    {
-      for (int d = 0; d < dof; ++d)
-      {
-         const int sgid = elementMap[dof*e + d];  // signed
-         const int gid = (sgid >= 0) ? sgid : -1 - sgid;
-         ++offsets[gid + 1];
-      }
+      const int sgid = elementMap[k];  // signed
+      const int gid = (sgid >= 0) ? sgid : -1 - sgid;
+      ++offsets[gid + 1];
    }
    // Aggregate to find offsets for each global dof
    for (int i = 1; i <= ndofs; ++i)
@@ -74,18 +130,25 @@ ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
       offsets[i] += offsets[i - 1];
    }
    // For each global dof, fill in all local nodes that point to it
-   for (int e = 0; e < ne; ++e)
+   for (int b = 0; b < nb; ++b)
    {
-      for (int d = 0; d < dof; ++d)
+      const int nd = batch_dofs[b];
+      const int *dof_map = dof_maps[b];
+      for (int be = batch_offsets[b]; be < batch_offsets[b+1]; ++be)
       {
-         const int sdid = dof_reorder ? dof_map[d] : 0;  // signed
-         const int did = (!dof_reorder)?d:(sdid >= 0 ? sdid : -1-sdid);
-         const int sgid = elementMap[dof*e + did];  // signed
-         const int gid = (sgid >= 0) ? sgid : -1-sgid;
-         const int lid = dof*e + d;
-         const bool plus = (sgid >= 0 && sdid >= 0) || (sgid < 0 && sdid < 0);
-         gatherMap[lid] = plus ? gid : -1-gid;
-         indices[offsets[gid]++] = plus ? lid : -1-lid;
+         const int e = batch_elements[be];
+         for (int d = 0; d < nd; ++d)
+         {
+            const int sdid = dof_map ? dof_map[d] : 0;  // signed
+            const int did = (!dof_map)?d:(sdid >= 0 ? sdid : -1-sdid);
+            const int sgid = elementMap[elementI[e] + did];  // signed
+            const int gid = (sgid >= 0) ? sgid : -1-sgid;
+            const int lid = batch_dof_offsets[b] + nd*(be-batch_offsets[b]) + d;
+            const bool plus = (sgid >= 0 && sdid >= 0) ||
+                              (sgid < 0 && sdid < 0);
+            gatherMap[lid] = plus ? gid : -1-gid;
+            indices[offsets[gid]++] = plus ? lid : -1-lid;
+         }
       }
    }
    // We shifted the offsets vector by 1 by using it as a counter.
@@ -97,16 +160,29 @@ ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
    offsets[0] = 0;
 }
 
+// Return the index in the E-vector of the component c of the element dof lid,
+// where lid numbers the element dofs of all batches as in a scalar E-vector.
+// The batch of lid is read from dof_b, which is NULL for a single batch.
+static MFEM_HOST_DEVICE inline int EIndex(const int lid, const int c,
+                                          const int vd, const int *dof_b,
+                                          const int *b_off, const int *b_dofs)
+{
+   const int b = dof_b ? dof_b[lid] : 0;
+   const int nd = b_dofs[b], i = lid - b_off[b];
+   return vd*b_off[b] + i % nd + nd*(c + vd*(i / nd));
+}
+
 void ElementRestriction::Mult(const Vector& x, Vector& y) const
 {
-   // Assumes all elements have the same number of dofs
-   const int nd = dof;
    const int vd = vdim;
    const bool t = byvdim;
+   auto dof_b = dof_batch.Size() ? dof_batch.Read() : NULL;
+   auto b_off = batch_dof_offsets.Read();
+   auto b_dofs = batch_dofs.Read();
    auto d_x = Reshape(x.Read(), t?vd:ndofs, t?ndofs:vd);
-   auto d_y = Reshape(y.Write(), nd, vd, ne);
+   auto d_y = y.Write();
    auto d_gatherMap = gatherMap.Read();
-   MFEM_FORALL(i, dof*ne,
+   MFEM_FORALL(i, nedofs,
    {
       const int gid = d_gatherMap[i];
       const bool plus = gid >= 0;
@@ -114,41 +190,44 @@ void ElementRestriction::Mult(const Vector& x, Vector& y) const
       for (int c = 0; c < vd; ++c)
       {
          const double dofValue = d_x(t?c:j, t?j:c);
-         d_y(i % nd, c, i / nd) = plus ? dofValue : -dofValue;
+         const int k = EIndex(i, c, vd, dof_b, b_off, b_dofs);
+         d_y[k] = plus ? dofValue : -dofValue;
       }
    });
 }
 
 void ElementRestriction::MultUnsigned(const Vector& x, Vector& y) const
 {
-   // Assumes all elements have the same number of dofs
-   const int nd = dof;
    const int vd = vdim;
    const bool t = byvdim;
+   auto dof_b = dof_batch.Size() ? dof_batch.Read() : NULL;
+   auto b_off = batch_dof_offsets.Read();
+   auto b_dofs = batch_dofs.Read();
    auto d_x = Reshape(x.Read(), t?vd:ndofs, t?ndofs:vd);
-   auto d_y = Reshape(y.Write(), nd, vd, ne);
+   auto d_y = y.Write();
    auto d_gatherMap = gatherMap.Read();
 
-   MFEM_FORALL(i, dof*ne,
+   MFEM_FORALL(i, nedofs,
    {
       const int gid = d_gatherMap[i];
       const int j = gid >= 0 ? gid : -1-gid;
       for (int c = 0; c < vd; ++c)
       {
-         d_y(i % nd, c, i / nd) = d_x(t?c:j, t?j:c);
+         d_y[EIndex(i, c, vd, dof_b, b_off, b_dofs)] = d_x(t?c:j, t?j:c);
       }
    });
 }
 
 void ElementRestriction::MultTranspose(const Vector& x, Vector& y) const
 {
-   // Assumes all elements have the same number of dofs
-   const int nd = dof;
    const int vd = vdim;
    const bool t = byvdim;
+   auto dof_b = dof_batch.Size() ? dof_batch.Read() : NULL;
+   auto b_off = batch_dof_offsets.Read();
+   auto b_dofs = batch_dofs.Read();
    auto d_offsets = offsets.Read();
    auto d_indices = indices.Read();
-   auto d_x = Reshape(x.Read(), nd, vd, ne);
+   auto d_x = x.Read();
    auto d_y = Reshape(y.Write(), t?vd:ndofs, t?ndofs:vd);
    MFEM_FORALL(i, ndofs,
    {
@@ -160,8 +239,9 @@ void ElementRestriction::MultTranspose(const Vector& x, Vector& y) const
          for (int j = offset; j < nextOffset; ++j)
          {
             const int idx_j = (d_indices[j] >= 0) ? d_indices[j] : -1 - d_indices[j];
-            dofValue += (d_indices[j] >= 0) ? d_x(idx_j % nd, c,
-            idx_j / nd) : -d_x(idx_j % nd, c, idx_j / nd);
+            const int k = EIndex(idx_j, c, vd, dof_b, b_off, b_dofs);
+            const double value = d_x[k];
+            dofValue += (d_indices[j] >= 0) ? value : -value;
          }
          d_y(t?c:i,t?i:c) = dofValue;
       }
@@ -170,13 +250,14 @@ void ElementRestriction::MultTranspose(const Vector& x, Vector& y) const
 
 void ElementRestriction::MultTransposeUnsigned(const Vector& x, Vector& y) const
 {
-   // Assumes all elements have the same number of dofs
-   const int nd = dof;
    const int vd = vdim;
    const bool t = byvdim;
+   auto dof_b = dof_batch.Size() ? dof_batch.Read() : NULL;
+   auto b_off = batch_dof_offsets.Read();
+   auto b_dofs = batch_dofs.Read();
    auto d_offsets = offsets.Read();
    auto d_indices = indices.Read();
-   auto d_x = Reshape(x.Read(), nd, vd, ne);
+   auto d_x = x.Read();
    auto d_y = Reshape(y.Write(), t?vd:ndofs, t?ndofs:vd);
    MFEM_FORALL(i, ndofs,
    {
@@ -188,7 +269,7 @@ void ElementRestriction::MultTransposeUnsigned(const Vector& x, Vector& y) const
          for (int j = offset; j < nextOffset; ++j)
          {
             const int idx_j = (d_indices[j] >= 0) ? d_indices[j] : -1 - d_indices[j];
-            dofValue += d_x(idx_j % nd, c, idx_j / nd);
+            dofValue += d_x[EIndex(idx_j, c, vd, dof_b, b_off, b_dofs)];
          }
          d_y(t?c:i,t?i:c) = dofValue;
       }
@@ -197,13 +278,14 @@ void ElementRestriction::MultTransposeUnsigned(const Vector& x, Vector& y) const
 
 void ElementRestriction::MultLeftInverse(const Vector& x, Vector& y) const
 {
-   // Assumes all elements have the same number of dofs
-   const int nd = dof;
    const int vd = vdim;
    const bool t = byvdim;
+   auto dof_b = dof_batch.Size() ? dof_batch.Read() : NULL;
+   auto b_off = batch_dof_offsets.Read();
+   auto b_dofs = batch_dofs.Read();
    auto d_offsets = offsets.Read();
    auto d_indices = indices.Read();
-   auto d_x = Reshape(x.Read(), nd, vd, ne);
+   auto d_x = x.Read();
    auto d_y = Reshape(y.Write(), t?vd:ndofs, t?ndofs:vd);
    MFEM_FORALL(i, ndofs,
    {
@@ -213,8 +295,9 @@ void ElementRestriction::MultLeftInverse(const Vector& x, Vector& y) const
          double dofValue = 0;
          const int j = nextOffset - 1;
          const int idx_j = (d_indices[j] >= 0) ? d_indices[j] : -1 - d_indices[j];
-         dofValue = (d_indices[j] >= 0) ? d_x(idx_j % nd, c, idx_j / nd) :
-         -d_x(idx_j % nd, c, idx_j / nd);
+         const int k = EIndex(idx_j, c, vd, dof_b, b_off, b_dofs);
+         const double value = d_x[k];
+         dofValue = (d_indices[j] >= 0) ? value : -value;
          d_y(t?c:i,t?i:c) = dofValue;
       }
    });
@@ -222,18 +305,18 @@ void ElementRestriction::MultLeftInverse(const Vector& x, Vector& y) const
 
 void ElementRestriction::BooleanMask(Vector& y) const
 {
-   // Assumes all elements have the same number of dofs
-   const int nd = dof;
    const int vd = vdim;
    const bool t = byvdim;
-
    Array<char> processed(vd * ndofs);
    processed = 0;
 
+   auto dof_b = dof_batch.Size() ? dof_batch.HostRead() : NULL;
+   auto b_off = batch_dof_offsets.HostRead();
+   auto b_dofs = batch_dofs.HostRead();
    auto d_offsets = offsets.HostRead();
    auto d_indices = indices.HostRead();
    auto d_x = Reshape(processed.HostReadWrite(), t?vd:ndofs, t?ndofs:vd);
-   auto d_y = Reshape(y.HostWrite(), nd, vd, ne);
+   auto d_y = y.HostWrite();
    for (int i = 0; i < ndofs; ++i)
    {
       const int offset = d_offsets[i];
@@ -242,14 +325,15 @@ void ElementRestriction::BooleanMask(Vector& y) const
       {
          for (int j = offset; j < nextOffset; ++j)
          {
-            const int idx_j = d_indices[j];
+            const int idx_j = d_indices[j] >= 0 ? d_indices[j] : -1-d_indices[j];
+            const int k = EIndex(idx_j, c, vd, dof_b, b_off, b_dofs);
             if (d_x(t?c:i,t?i:c))
             {
-               d_y(idx_j % nd, c, idx_j / nd) = 0.0;
+               d_y[k] = 0.0;
             }
             else
             {
-               d_y(idx_j % nd, c, idx_j / nd) = 1.0;
+               d_y[k] = 1.0;
                d_x(t?c:i,t?i:c) = 1;
             }
          }
@@ -308,6 +392,8 @@ static MFEM_HOST_DEVICE int GetAndIncrementNnzIndex(const int i_L, int* I)
 
 int ElementRestriction::FillI(SparseMatrix &mat) const
 {
+   MFEM_VERIFY(batch_geom.Size() <= 1, "meshes with more than one geometry"
+               " are not supported");
    static constexpr int Max = MaxNbNbr;
    const int all_dofs = ndofs;
    const int vd = vdim;
@@ -382,6 +468,8 @@ int ElementRestriction::FillI(SparseMatrix &mat) const
 void ElementRestriction::FillJAndData(const Vector &ea_data,
                                       SparseMatrix &mat) const
 {
+   MFEM_VERIFY(batch_geom.Size() <= 1, "meshes with more than one geometry"
+               " are not supported");
    static constexpr int Max = MaxNbNbr;
    const int all_dofs = ndofs;
    const int vd = vdim;
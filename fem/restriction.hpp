@@ -27,7 +27,15 @@ enum class L2FaceValues : bool {SingleValued, DoubleValued};
 
 /// Operator that converts FiniteElementSpace L-vectors to E-vectors.
 /** Objects of this type are typically created and owned by FiniteElementSpace
-    objects, see FiniteElementSpace::GetElementRestriction(). */
+    objects, see FiniteElementSpace::GetElementRestriction().
+
+    The elements are grouped in batches of elements with the same geometry,
+    ordered by Geometry::Type. The E-vector stores the batches one after the
+    other, each with layout (dofs x vdim x batch elements), so the batches can
+    be processed by separate kernels. When all elements have the same geometry,
+    there is a single batch and the E-vector has the usual layout (dofs x vdim x
+    NE). With LEXICOGRAPHIC ordering, the elements of a mesh with more than one
+    geometry that do not have a tensor basis use the NATIVE ordering. */
 class ElementRestriction : public Operator
 {
 private:
@@ -41,14 +49,42 @@ protected:
    const int vdim;
    const bool byvdim;
    const int ndofs;
-   const int dof;
+   const int dof; ///< Dofs per element, if there is a single batch
    const int nedofs;
    Array<int> offsets;
    Array<int> indices;
    Array<int> gatherMap;
 
+   /// The element batches, see GetBatchElements().
+   Array<Geometry::Type> batch_geom;
+   Array<int> batch_offsets, batch_elements, batch_dof_offsets, batch_dofs;
+   /// The batch of each element dof, empty if there is a single batch.
+   Array<int> dof_batch;
+
 public:
    ElementRestriction(const FiniteElementSpace&, ElementDofOrdering);
+
+   /// Return the number of element batches.
+   int GetNumBatches() const { return batch_geom.Size(); }
+
+   /// Return the geometry of the elements of the batch @a b.
+   Geometry::Type GetBatchGeometry(int b) const { return batch_geom[b]; }
+
+   /** @brief Return the mesh elements of all batches, in E-vector order. The
+       elements of the batch b are those with index in [GetBatchOffsets()[b],
+       GetBatchOffsets()[b+1]). */
+   const Array<int> &GetBatchElements() const { return batch_elements; }
+
+   /// Return the offsets of the batches in GetBatchElements().
+   const Array<int> &GetBatchOffsets() const { return batch_offsets; }
+
+   /** @brief Return the offset of the batch @a b in the E-vector, which is
+       vdim times the number of element dofs of the previous batches. */
+   int GetBatchEOffset(int b) const { return vdim*batch_dof_offsets[b]; }
+
+   /// Return the number of dofs of each element of the batch @a b.
+   int GetBatchDofs(int b) const { return batch_dofs[b]; }
+
    void Mult(const Vector &x, Vector &y) const;
    void MultTranspose(const Vector &x, Vector &y) const;
 
@@ -0,0 +1,79 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "kernel_registry.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace mfem
+{
+
+bool KernelRegistryBase::report = false;
+
+static std::vector<const KernelRegistryBase*> &KernelRegistries()
+{
+   static std::vector<const KernelRegistryBase*> registries;
+   return registries;
+}
+
+KernelRegistryBase::KernelRegistryBase(const char *name_) : name(name_)
+{
+   KernelRegistries().push_back(this);
+}
+
+KernelRegistryBase::~KernelRegistryBase()
+{
+   std::vector<const KernelRegistryBase*> &r = KernelRegistries();
+   r.erase(std::remove(r.begin(), r.end(), this), r.end());
+}
+
+void KernelRegistryBase::Fallback(int dim, int d1d, int q1d) const
+{
+   long &count = fallbacks[Key(dim, d1d, q1d)];
+   if (count++ == 0 && report)
+   {
+      mfem::out << "Warning: " << name << " uses the generic kernel for dim = "
+                << dim << ", D1D = " << d1d << ", Q1D = " << q1d << '\n';
+   }
+}
+
+long KernelRegistryBase::GetNumFallbacks() const
+{
+   long count = 0;
+   for (auto &f : fallbacks) { count += f.second; }
+   return count;
+}
+
+const KernelRegistryBase *KernelRegistryBase::Find(const std::string &name)
+{
+   for (const KernelRegistryBase *r : KernelRegistries())
+   {
+      if (r->name == name) { return r; }
+   }
+   return NULL;
+}
+
+void KernelRegistryBase::PrintFallbacks(std::ostream &out)
+{
+   for (const KernelRegistryBase *r : KernelRegistries())
+   {
+      for (auto &f : r->fallbacks)
+      {
+         out << r->name << ": dim = " << (f.first >> 16)
+             << ", D1D = " << ((f.first >> 8) & 0xff)
+             << ", Q1D = " << (f.first & 0xff)
+             << ", generic kernel calls = " << f.second << '\n';
+      }
+   }
+}
+
+}
@@ -0,0 +1,131 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#ifndef MFEM_KERNEL_REGISTRY
+#define MFEM_KERNEL_REGISTRY
+
+#include "../config/config.hpp"
+#include "error.hpp"
+#include "globals.hpp"
+
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace mfem
+{
+
+/** @brief Base class of KernelRegistry: keeps the list of all registries and
+    the number of calls that fell back to a generic kernel. */
+class KernelRegistryBase
+{
+protected:
+   std::string name;
+   /// Number of fallback calls for each (dim, D1D, Q1D) key.
+   mutable std::map<int, long> fallbacks;
+
+   static bool report;
+
+   static int Key(int dim, int d1d, int q1d)
+   { return (dim << 16) | (d1d << 8) | q1d; }
+
+   /// Record a fallback call for (dim, d1d, q1d), see ReportFallbacks().
+   void Fallback(int dim, int d1d, int q1d) const;
+
+   KernelRegistryBase(const char *name_);
+
+   ~KernelRegistryBase();
+
+public:
+   /// Return the name of the registry, e.g. "PADiffusionApply".
+   const std::string &GetName() const { return name; }
+
+   /// Return the number of calls that used a fallback kernel.
+   long GetNumFallbacks() const;
+
+   /// Reset the fallback counters of this registry.
+   void ResetFallbacks() const { fallbacks.clear(); }
+
+   /** @brief Return the registry with the given @a name, or NULL. Registries
+       are created on the first call of their kernels. */
+   static const KernelRegistryBase *Find(const std::string &name);
+
+   /** @brief Print a warning to mfem::out the first time a fallback kernel is
+       used for a given (dim, D1D, Q1D) key. Disabled by default. */
+   static void ReportFallbacks(bool enable) { report = enable; }
+
+   /// Print the fallback counters of all registries.
+   static void PrintFallbacks(std::ostream &out = mfem::out);
+};
+
+/** @brief Table of kernel specializations indexed by (dim, D1D, Q1D).
+
+    The specializations are registered once, typically from a function-local
+    static built from a list of template instantiations, and are looked up in a
+    hash table at runtime. The generic kernel of each dimension, registered
+    with AddFallback(), is returned for the other keys and its use is counted.
+    A host kernel vectorized across elements, registered with AddVectorized(),
+    can replace all the kernels of its dimension when requested in Get().
+
+    @a Kernel is a function pointer type. All the kernels of a registry share
+    the same signature, which includes the runtime values of D1D and Q1D. */
+template <typename Kernel>
+class KernelRegistry : public KernelRegistryBase
+{
+   std::unordered_map<int, Kernel> kernels;
+   std::unordered_map<int, Kernel> generic;
+   std::unordered_map<int, Kernel> vectorized;
+
+public:
+   KernelRegistry(const char *name_) : KernelRegistryBase(name_) { }
+
+   /// Register the kernel specialized for (@a dim, @a d1d, @a q1d).
+   void Add(int dim, int d1d, int q1d, Kernel kernel)
+   { kernels[Key(dim, d1d, q1d)] = kernel; }
+
+   /// Register the generic kernel used in dimension @a dim.
+   void AddFallback(int dim, Kernel kernel) { generic[dim] = kernel; }
+
+   /** @brief Register the host kernel of dimension @a dim vectorized across
+       elements, which handles all values of D1D and Q1D. */
+   void AddVectorized(int dim, Kernel kernel) { vectorized[dim] = kernel; }
+
+   /// Return true if there is a kernel specialized for (dim, d1d, q1d).
+   bool Has(int dim, int d1d, int q1d) const
+   { return kernels.find(Key(dim, d1d, q1d)) != kernels.end(); }
+
+   /// Return the number of specialized kernels.
+   int Size() const { return (int) kernels.size(); }
+
+   /** @brief Return the kernel specialized for (@a dim, @a d1d, @a q1d), or
+       the generic kernel of dimension @a dim. */
+   /** If @a use_vectorized is true and a vectorized kernel of dimension @a dim
+       is registered, it is returned instead and no fallback is counted. */
+   Kernel Get(int dim, int d1d, int q1d, bool use_vectorized = false) const
+   {
+      if (use_vectorized)
+      {
+         auto v = vectorized.find(dim);
+         if (v != vectorized.end()) { return v->second; }
+      }
+      auto it = kernels.find(Key(dim, d1d, q1d));
+      if (it != kernels.end()) { return it->second; }
+      auto g = generic.find(dim);
+      MFEM_VERIFY(g != generic.end(), "Unknown kernel: " << name
+                  << ", dim = " << dim);
+      Fallback(dim, d1d, q1d);
+      return g->second;
+   }
+};
+
+}
+
+#endif
@@ -15,6 +15,7 @@
 #include <list>
 #include <cstring> // std::memcpy, std::memcmp
 #include <unordered_map>
+#include <vector>
 #include <algorithm> // std::max
 
 // Uncomment to try _WIN32 platform
@@ -72,10 +73,12 @@ MemoryType MemoryManager::GetDualMemoryType_(MemoryType mt)
       case MemoryType::HOST_64:        return MemoryType::DEVICE;
       case MemoryType::HOST_DEBUG:     return MemoryType::DEVICE_DEBUG;
       case MemoryType::HOST_UMPIRE:    return MemoryType::DEVICE_UMPIRE;
+      case MemoryType::HOST_POOL:      return MemoryType::DEVICE_POOL;
       case MemoryType::MANAGED:        return MemoryType::MANAGED;
       case MemoryType::DEVICE:         return MemoryType::HOST;
       case MemoryType::DEVICE_DEBUG:   return MemoryType::HOST_DEBUG;
       case MemoryType::DEVICE_UMPIRE:  return MemoryType::HOST_UMPIRE;
+      case MemoryType::DEVICE_POOL:    return MemoryType::HOST_POOL;
       default: mfem_error("Unknown memory type!");
    }
    MFEM_VERIFY(false,"");
@@ -89,6 +92,7 @@ static void MFEM_VERIFY_TYPES(const MemoryType h_mt, const MemoryType d_mt)
    const bool sync =
       (h_mt == MemoryType::HOST_UMPIRE && d_mt == MemoryType::DEVICE_UMPIRE) ||
       (h_mt == MemoryType::HOST_DEBUG && d_mt == MemoryType::DEVICE_DEBUG) ||
+      (h_mt == MemoryType::HOST_POOL && d_mt == MemoryType::DEVICE_POOL) ||
       (h_mt == MemoryType::MANAGED && d_mt == MemoryType::MANAGED) ||
       (h_mt == MemoryType::HOST_64 && d_mt == MemoryType::DEVICE) ||
       (h_mt == MemoryType::HOST_32 && d_mt == MemoryType::DEVICE) ||
@@ -464,6 +468,128 @@ public:
    { return std::memcpy(dst, src, bytes); }
 };
 
+/** @brief Size-class memory pool: freed blocks are cached, per rounded size,
+    and recycled by later allocations of the same size class. */
+/** The size classes are the multiples of 64 bytes up to 256 bytes and then
+    four classes per power of two, so that at most 25% of a block is unused.
+    Cached blocks are returned to the backing allocator by Release(). */
+class MemoryPool
+{
+public:
+   virtual ~MemoryPool() { }
+
+   /// Return the size class of a request of @a bytes.
+   static size_t RoundUp(size_t bytes)
+   {
+      if (bytes <= 256) { return bytes ? (bytes + 63) & ~size_t(63) : 64; }
+      size_t step = 64; // = 2^(e-2), where 2^e < bytes <= 2^(e+1)
+      while ((step << 3) < bytes) { step <<= 1; }
+      return (bytes + step - 1) / step * step;
+   }
+
+   void *Get(size_t bytes)
+   {
+      const size_t size = RoundUp(bytes);
+      std::vector<void*> &blocks = cache[size];
+      void *ptr;
+      if (blocks.size() > 0)
+      {
+         ptr = blocks.back();
+         blocks.pop_back();
+         stats.num_reuses++;
+      }
+      else
+      {
+         ptr = AllocBlock(size);
+         stats.bytes_reserved += size;
+      }
+      stats.num_allocs++;
+      stats.bytes_in_use += size;
+      stats.high_water_mark = std::max(stats.high_water_mark,
+                                       stats.bytes_in_use);
+      return ptr;
+   }
+
+   void Put(void *ptr, size_t bytes)
+   {
+      const size_t size = RoundUp(bytes);
+      MFEM_ASSERT(stats.bytes_in_use >= size, "invalid pool block");
+      cache[size].push_back(ptr);
+      stats.bytes_in_use -= size;
+   }
+
+   /// Free all cached blocks.
+   void Release()
+   {
+      for (auto &c : cache)
+      {
+         for (void *ptr : c.second) { FreeBlock(ptr); }
+         stats.bytes_reserved -= c.first * c.second.size();
+      }
+      cache.clear();
+   }
+
+   const MemoryPoolStats &Stats() const { return stats; }
+
+protected:
+   virtual void *AllocBlock(size_t bytes) = 0;
+   virtual void FreeBlock(void *ptr) = 0;
+
+private:
+   std::unordered_map<size_t, std::vector<void*>> cache;
+   MemoryPoolStats stats;
+};
+
+/// The pooled host memory space
+class PoolHostMemorySpace : public HostMemorySpace, public MemoryPool
+{
+public:
+   PoolHostMemorySpace(): HostMemorySpace() { }
+   ~PoolHostMemorySpace() { Release(); }
+   void Alloc(void **ptr, size_t bytes) { *ptr = Get(bytes); }
+   void Dealloc(void *ptr) { Put(ptr, maps->memories.at(ptr).bytes); }
+protected:
+   void *AllocBlock(size_t bytes)
+   {
+      void *ptr;
+      if (mfem_memalign(&ptr, 64, bytes) != 0) { throw ::std::bad_alloc(); }
+      return ptr;
+   }
+   void FreeBlock(void *ptr) { mfem_aligned_free(ptr); }
+};
+
+/// The pooled device memory space, on top of the CUDA or HIP memory space
+class PoolDeviceMemorySpace : public DeviceMemorySpace, public MemoryPool
+{
+   DeviceMemorySpace *dev; // owned
+public:
+   PoolDeviceMemorySpace(DeviceMemorySpace *dev)
+      : DeviceMemorySpace(), dev(dev) { }
+   ~PoolDeviceMemorySpace() { Release(); delete dev; }
+   void Alloc(Memory &base) { base.d_ptr = Get(base.bytes); }
+   void Dealloc(Memory &base) { Put(base.d_ptr, base.bytes); }
+   void *HtoD(void *dst, const void *src, size_t bytes)
+   { return dev->HtoD(dst, src, bytes); }
+   void *DtoD(void* dst, const void* src, size_t bytes)
+   { return dev->DtoD(dst, src, bytes); }
+   void *DtoH(void *dst, const void *src, size_t bytes)
+   { return dev->DtoH(dst, src, bytes); }
+protected:
+   void *AllocBlock(size_t bytes)
+   {
+      Memory block(nullptr, bytes, MemoryType::HOST_POOL,
+                   MemoryType::DEVICE_POOL);
+      dev->Alloc(block);
+      return block.d_ptr;
+   }
+   void FreeBlock(void *ptr)
+   {
+      Memory block(nullptr, 0, MemoryType::HOST_POOL, MemoryType::DEVICE_POOL);
+      block.d_ptr = ptr;
+      dev->Dealloc(block);
+   }
+};
+
 #ifndef MFEM_USE_UMPIRE
 class UmpireHostMemorySpace : public NoHostMemorySpace { };
 class UmpireDeviceMemorySpace : public NoDeviceMemorySpace { };
@@ -577,6 +703,7 @@ public:
       // HOST_DEBUG is delayed, as it reroutes signals
       host[static_cast<int>(MT::HOST_DEBUG)] = nullptr;
       host[static_cast<int>(MT::HOST_UMPIRE)] = new UmpireHostMemorySpace();
+      host[static_cast<int>(MT::HOST_POOL)] = new PoolHostMemorySpace();
       host[static_cast<int>(MT::MANAGED)] = new UvmHostMemorySpace();
 
       // Filling the device memory backends, shifting with the device size
@@ -586,6 +713,7 @@ public:
       device[static_cast<int>(MemoryType::DEVICE)-shift] = nullptr;
       device[static_cast<int>(MT::DEVICE_DEBUG)-shift] = nullptr;
       device[static_cast<int>(MT::DEVICE_UMPIRE)-shift] = nullptr;
+      device[static_cast<int>(MT::DEVICE_POOL)-shift] = nullptr;
    }
 
    HostMemorySpace* Host(const MemoryType mt)
@@ -629,6 +757,17 @@ private:
       {
          case MT::DEVICE_UMPIRE: return new UmpireDeviceMemorySpace();
          case MT::DEVICE_DEBUG: return new MmuDeviceMemorySpace();
+         case MT::DEVICE_POOL:
+         {
+#if defined(MFEM_USE_CUDA)
+            return new PoolDeviceMemorySpace(new CudaDeviceMemorySpace());
+#elif defined(MFEM_USE_HIP)
+            return new PoolDeviceMemorySpace(new HipDeviceMemorySpace());
+#else
+            MFEM_ABORT("No device memory controller!");
+            break;
+#endif
+         }
          case MT::DEVICE:
          {
 #if defined(MFEM_USE_CUDA)
@@ -778,12 +917,14 @@ bool MemoryManager::MemoryClassCheck_(MemoryClass mc, void *h_ptr,
       case MemoryClass::HOST_32:
       {
          MFEM_VERIFY(h_mt == MemoryType::HOST_32 ||
-                     h_mt == MemoryType::HOST_64,"");
+                     h_mt == MemoryType::HOST_64 ||
+                     h_mt == MemoryType::HOST_POOL,"");
          return true;
       }
       case MemoryClass::HOST_64:
       {
-         MFEM_VERIFY(h_mt == MemoryType::HOST_64,"");
+         MFEM_VERIFY(h_mt == MemoryType::HOST_64 ||
+                     h_mt == MemoryType::HOST_POOL,"");
          return true;
       }
       case MemoryClass::DEVICE:
@@ -791,6 +932,7 @@ bool MemoryManager::MemoryClassCheck_(MemoryClass mc, void *h_ptr,
          MFEM_VERIFY(d_mt == MemoryType::DEVICE ||
                      d_mt == MemoryType::DEVICE_DEBUG ||
                      d_mt == MemoryType::DEVICE_UMPIRE ||
+                     d_mt == MemoryType::DEVICE_POOL ||
                      d_mt == MemoryType::MANAGED,"");
          return true;
       }
@@ -1346,6 +1488,33 @@ int MemoryManager::PrintAliases(std::ostream &out)
    return n_out;
 }
 
+static internal::MemoryPool *GetMemoryPool(MemoryType mt)
+{
+   MFEM_VERIFY(mt == MemoryType::HOST_POOL || mt == MemoryType::DEVICE_POOL,
+               "not a pooled memory type: " << MemoryTypeName[(int)mt]);
+   if (mt == MemoryType::HOST_POOL)
+   {
+      return dynamic_cast<internal::MemoryPool*>(ctrl->Host(mt));
+   }
+   // Do not create the device pool just for querying it.
+   const int mt_i = static_cast<int>(mt) - DeviceMemoryType;
+   return dynamic_cast<internal::MemoryPool*>(ctrl->device[mt_i]);
+}
+
+MemoryPoolStats MemoryManager::GetPoolStats(MemoryType mt)
+{
+   MFEM_VERIFY(exists, "MemoryManager has not been initialized!");
+   internal::MemoryPool *pool = GetMemoryPool(mt);
+   return pool ? pool->Stats() : MemoryPoolStats();
+}
+
+void MemoryManager::ReleasePoolMemory(MemoryType mt)
+{
+   MFEM_VERIFY(exists, "MemoryManager has not been initialized!");
+   internal::MemoryPool *pool = GetMemoryPool(mt);
+   if (pool) { pool->Release(); }
+}
+
 int MemoryManager::CompareHostAndDevice_(void *h_ptr, size_t size,
                                          unsigned flags)
 {
@@ -1398,7 +1567,7 @@ MemoryType MemoryManager::device_mem_type = MemoryType::HOST;
 
 const char *MemoryTypeName[MemoryTypeSize] =
 {
-   "host-std", "host-32", "host-64", "host-debug", "host-umpire",
+   "host-std", "host-32", "host-64", "host-debug", "host-umpire", "host-pool",
 #if defined(MFEM_USE_CUDA)
    "cuda-uvm",
    "cuda",
@@ -1411,11 +1580,14 @@ const char *MemoryTypeName[MemoryTypeSize] =
 #endif
    "device-debug",
 #if defined(MFEM_USE_CUDA)
-   "cuda-umpire"
+   "cuda-umpire",
+   "cuda-pool"
 #elif defined(MFEM_USE_HIP)
-   "hip-umpire"
+   "hip-umpire",
+   "hip-pool"
 #else
-   "device-umpire"
+   "device-umpire",
+   "device-pool"
 #endif
 };
 
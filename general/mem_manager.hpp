@@ -32,12 +32,16 @@ enum class MemoryType
    HOST_64,        ///< Host memory; aligned at 64 bytes
    HOST_DEBUG,     ///< Host memory; allocated from a "host-debug" pool
    HOST_UMPIRE,    ///< Host memory; using Umpire
+   HOST_POOL,      /**< Host memory; aligned at 64 bytes and recycled by a
+                        size-class pool, see MemoryManager::GetPoolStats() */
    MANAGED,        /**< Managed memory; using CUDA or HIP *MallocManaged
                         and *Free */
    DEVICE,         ///< Device memory; using CUDA or HIP *Malloc and *Free
    DEVICE_DEBUG,   /**< Pseudo-device memory; allocated on host from a
                         "device-debug" pool */
    DEVICE_UMPIRE,  ///< Device memory; using Umpire
+   DEVICE_POOL,    /**< Device memory; using CUDA or HIP *Malloc, recycled by a
+                        size-class pool */
    SIZE            ///< Number of host and device memory types
 };
 
@@ -58,10 +62,11 @@ extern const char *MemoryTypeName[MemoryTypeSize];
 enum class MemoryClass
 {
    HOST,    /**< Memory types: { HOST, HOST_32, HOST_64, HOST_DEBUG,
-                                 HOST_UMPIRE, MANAGED } */
-   HOST_32, ///< Memory types: { HOST_32, HOST_64, HOST_DEBUG }
-   HOST_64, ///< Memory types: { HOST_64, HOST_DEBUG }
-   DEVICE,  ///< Memory types: { DEVICE, DEVICE_DEBUG, DEVICE_UMPIRE, MANAGED }
+                                 HOST_UMPIRE, HOST_POOL, MANAGED } */
+   HOST_32, ///< Memory types: { HOST_32, HOST_64, HOST_DEBUG, HOST_POOL }
+   HOST_64, ///< Memory types: { HOST_64, HOST_DEBUG, HOST_POOL }
+   DEVICE,  /**< Memory types: { DEVICE, DEVICE_DEBUG, DEVICE_UMPIRE,
+                                 DEVICE_POOL, MANAGED } */
    MANAGED  ///< Memory types: { MANAGED }
 };
 
@@ -471,6 +476,23 @@ private:
 };
 
 
+/// Usage statistics of a pooled memory type, see MemoryManager::GetPoolStats().
+struct MemoryPoolStats
+{
+   /// Bytes currently in use, counting the requested sizes rounded up to the
+   /// size class of the pool.
+   std::size_t bytes_in_use = 0;
+   /// Maximum of #bytes_in_use since the creation of the pool.
+   std::size_t high_water_mark = 0;
+   /// Bytes currently held by the pool: in use or cached for reuse.
+   std::size_t bytes_reserved = 0;
+   /// Number of allocations requested from the pool.
+   std::size_t num_allocs = 0;
+   /// Number of allocations served by recycling a cached block.
+   std::size_t num_reuses = 0;
+};
+
+
 /** The MFEM memory manager class. Host-side pointers are inserted into this
     manager which keeps track of the associated device pointer, and where the
     data currently resides. */
@@ -652,6 +674,14 @@ public:
    /// returning the number of printed pointers
    int PrintAliases(std::ostream &out = mfem::out);
 
+   /** @brief Return the usage statistics of the pooled memory type @a mt,
+       MemoryType::HOST_POOL or MemoryType::DEVICE_POOL. */
+   MemoryPoolStats GetPoolStats(MemoryType mt);
+
+   /** @brief Return the cached, currently unused, blocks of the pooled memory
+       type @a mt to the system. */
+   void ReleasePoolMemory(MemoryType mt);
+
    static MemoryType GetHostMemoryType() { return host_mem_type; }
    static MemoryType GetDeviceMemoryType() { return device_mem_type; }
 };
@@ -49,6 +49,7 @@
 #ifdef MFEM_USE_MPI
 #include "hypre_parcsr.hpp"
 #include "hypre.hpp"
+#include "mgrit.hpp"
 
 #ifdef MFEM_USE_MUMPS
 #include "mumps.hpp"
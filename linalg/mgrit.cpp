@@ -0,0 +1,202 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "../config/config.hpp"
+
+#ifdef MFEM_USE_MPI
+
+#include "mgrit.hpp"
+
+#include <cmath>
+
+namespace mfem
+{
+
+MGRITSolver::MGRITSolver(MPI_Comm time_comm)
+   : comm(time_comm), spatial_comm(MPI_COMM_NULL), f(NULL), fine(NULL),
+     coarse(NULL), cf(8), max_iter(10), print_level(0), fcf(true), tol(1e-8),
+     num_iter(0), final_norm(0.0), j0(0), j1(0), dt(0.0)
+{
+   MPI_Comm_rank(comm, &rank);
+   MPI_Comm_size(comm, &nranks);
+}
+
+void MGRITSolver::Fine(Vector &x, double t, int n)
+{
+   fine->Init(*f);
+   for (int s = 0; s < n; s++)
+   {
+      double h = dt;
+      fine->Step(x, t, h);
+   }
+}
+
+void MGRITSolver::Coarse(Vector &x, double t, int n)
+{
+   coarse->Init(*f);
+   double h = n*dt;
+   coarse->Step(x, t, h);
+}
+
+void MGRITSolver::RecvPrev(Vector &x)
+{
+   MPI_Recv(x.HostWrite(), x.Size(), MPI_DOUBLE, rank - 1, 0, comm,
+            MPI_STATUS_IGNORE);
+}
+
+void MGRITSolver::SendNext(const Vector &x)
+{
+   MPI_Send(const_cast<double*>(x.HostRead()), x.Size(), MPI_DOUBLE, rank + 1,
+            0, comm);
+}
+
+double MGRITSolver::Norm(const Vector &x) const
+{
+   if (spatial_comm == MPI_COMM_NULL) { return x.Norml2(); }
+   return std::sqrt(InnerProduct(spatial_comm, x, x));
+}
+
+double MGRITSolver::CoarseSweep(const Vector &x0, bool correct)
+{
+   const int nloc = j1 - j0;
+   double change = 0.0;
+   if (rank == 0) { w = x0; }
+   else { RecvPrev(w); }
+   if (correct)
+   {
+      subtract(w, *U[0], r);
+      change = Norm(r);
+   }
+   *U[0] = w;
+   for (int i = 0; i < nloc; i++)
+   {
+      Vector &next = (i + 1 < nloc) ? *U[i+1] : u_end;
+      w = *U[i];
+      Coarse(w, t_start[i], nsteps[i]);
+      if (correct)
+      {
+         w += *delta[i];
+         subtract(w, next, r);
+         change = std::max(change, Norm(r));
+      }
+      next = w;
+   }
+   if (rank < nranks - 1) { SendNext(u_end); }
+   return change;
+}
+
+void MGRITSolver::CRelax(const Vector &x0)
+{
+   // The last rank does not need the fine propagation of its last interval.
+   const int nloc = j1 - j0, nprop = (rank < nranks - 1) ? nloc : nloc - 1;
+   for (int i = 0; i < nprop; i++)
+   {
+      Vector &next = (i + 1 < nloc) ? *V[i+1] : w;
+      next = *U[i];
+      Fine(next, t_start[i], nsteps[i]);
+   }
+   if (rank < nranks - 1) { SendNext(w); }
+   if (rank == 0) { *V[0] = x0; }
+   else { RecvPrev(*V[0]); }
+}
+
+void MGRITSolver::Run(Vector &x, double &t, double dt_, double tf)
+{
+   MFEM_VERIFY(f && fine && coarse, "the operator and the fine and coarse "
+               "solvers must be set");
+   const int n = std::max(1, int(std::ceil((tf - t)/dt_ - 1e-10)));
+   dt = (tf - t)/n;
+   const int nc = (n + cf - 1)/cf;
+   MFEM_VERIFY(nc >= nranks, "the " << nc << " coarse intervals are fewer "
+               "than the " << nranks << " ranks");
+
+   j0 = int(long(rank)*nc/nranks);
+   j1 = int(long(rank + 1)*nc/nranks);
+   const int nloc = j1 - j0, size = x.Size();
+   t_start.SetSize(nloc + 1);
+   nsteps.SetSize(nloc);
+   for (int i = 0; i <= nloc; i++)
+   {
+      t_start[i] = t + std::min((j0 + i)*cf, n)*dt;
+      if (i < nloc) { nsteps[i] = std::min(cf, n - (j0 + i)*cf); }
+   }
+   for (int i = 0; i < U.Size(); i++)
+   {
+      delete U[i];
+      delete V[i];
+      delete delta[i];
+   }
+   U.SetSize(nloc);
+   V.SetSize(nloc);
+   delta.SetSize(nloc);
+   for (int i = 0; i < nloc; i++)
+   {
+      U[i] = new Vector(size);
+      V[i] = new Vector(size);
+      delta[i] = new Vector(size);
+   }
+   u_end.SetSize(size);
+   w.SetSize(size);
+   r.SetSize(size);
+
+   // Initial guess from the coarse propagator.
+   CoarseSweep(x, false);
+
+   final_norm = 0.0;
+   for (num_iter = 0; num_iter < max_iter; )
+   {
+      // Relaxation: V = U (F) or V_j = Phi(U_{j-1}) (FCF).
+      if (fcf) { CRelax(x); }
+      else
+      {
+         for (int i = 0; i < nloc; i++) { *V[i] = *U[i]; }
+      }
+
+      // F-relaxation and coarse correction, delta_j = Phi(V_j) - Psi(V_j).
+      for (int i = 0; i < nloc; i++)
+      {
+         *delta[i] = *V[i];
+         Fine(*delta[i], t_start[i], nsteps[i]);
+         w = *V[i];
+         Coarse(w, t_start[i], nsteps[i]);
+         *delta[i] -= w;
+      }
+      double change = CoarseSweep(x, true);
+      MPI_Allreduce(&change, &final_norm, 1, MPI_DOUBLE, MPI_MAX, comm);
+      num_iter++;
+
+      if (print_level > 0 && rank == 0)
+      {
+         mfem::out << "   MGRIT iteration " << num_iter
+                   << " : max ||U_new - U_old|| = " << final_norm << '\n';
+      }
+      // After k iterations, the first k (F) or 2k (FCF) intervals are exact.
+      if (final_norm <= tol || num_iter*(fcf ? 2 : 1) >= nc) { break; }
+   }
+
+   if (rank == nranks - 1) { x = u_end; }
+   MPI_Bcast(x.HostReadWrite(), size, MPI_DOUBLE, nranks - 1, comm);
+   t = tf;
+}
+
+MGRITSolver::~MGRITSolver()
+{
+   for (int i = 0; i < U.Size(); i++)
+   {
+      delete U[i];
+      delete V[i];
+      delete delta[i];
+   }
+}
+
+}
+
+#endif // MFEM_USE_MPI
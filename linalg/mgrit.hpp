@@ -0,0 +1,148 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#ifndef MFEM_MGRIT
+#define MFEM_MGRIT
+
+#include "../config/config.hpp"
+
+#ifdef MFEM_USE_MPI
+
+#include <mpi.h>
+#include "ode.hpp"
+
+namespace mfem
+{
+
+/** @brief Two-level multigrid-reduction-in-time (MGRIT) driver, with F- or
+    FCF-relaxation, distributing the time intervals over an MPI communicator.
+
+    The time interval [t, tf] is divided in fine steps of size dt, grouped in
+    coarse intervals of SetCoarseningFactor() fine steps. The coarse intervals
+    are distributed in contiguous blocks over the ranks of the time
+    communicator. The fine propagator advances the solution over a coarse
+    interval with the fine steps of an ODESolver, and the coarse propagator
+    takes one step of another (cheaper) ODESolver over the whole interval.
+
+    Each iteration relaxes the solution at the coarse interval boundaries
+    (C-points) with the fine propagator, in parallel, and corrects it with a
+    sequential sweep of the coarse propagator:
+       U_{j+1} = Psi(U_j) + Phi(V_j) - Psi(V_j),
+    where V is the relaxed solution. With F-relaxation, V = U and the method is
+    Parareal; FCF-relaxation first updates the C-points with the fine
+    propagator, V_j = Phi(U_{j-1}). After k iterations, the first k (F) or 2k
+    (FCF) coarse intervals are exact, so the method converges to the
+    sequential fine solution in at most as many iterations as coarse
+    intervals.
+
+    Every rank holds the full spatial state, i.e. its own copy of the
+    TimeDependentOperator and of the two ODESolvers. With spatial parallelism,
+    the time communicator groups the ranks that own the same spatial
+    subdomain, and the spatial communicator, see SetSpatialComm(), is used to
+    compute the norms of the corrections. */
+class MGRITSolver
+{
+protected:
+   MPI_Comm comm, spatial_comm;
+   int rank, nranks;
+
+   TimeDependentOperator *f;
+   ODESolver *fine, *coarse;
+
+   int cf, max_iter, print_level;
+   bool fcf;
+   double tol;
+
+   int num_iter;
+   double final_norm;
+
+   // Local coarse intervals [j0, j1): the times of their C-points (including
+   // the end of the last one), their numbers of fine steps, and the C-point
+   // values at their start, plus the last end point.
+   int j0, j1;
+   double dt;
+   Array<double> t_start;
+   Array<int> nsteps;
+   Array<Vector*> U, V, delta;
+   Vector u_end, w, r;
+
+   /// Advance @a x from time @a t with @a n fine steps of size dt.
+   void Fine(Vector &x, double t, int n);
+
+   /// Advance @a x from time @a t with one coarse step of size n*dt.
+   void Coarse(Vector &x, double t, int n);
+
+   /** @brief Sequential coarse sweep from @a x0, adding the corrections delta
+       if @a correct is true. Returns the largest local change of U. */
+   double CoarseSweep(const Vector &x0, bool correct);
+
+   /// Set V_j to Phi(U_{j-1}), receiving Phi(U_{j0-1}) from the previous rank.
+   void CRelax(const Vector &x0);
+
+   /// Receive/send a vector from/to the previous/next rank in time.
+   void RecvPrev(Vector &x);
+   void SendNext(const Vector &x);
+
+   double Norm(const Vector &x) const;
+
+public:
+   /// Construct the driver on the time communicator @a time_comm.
+   MGRITSolver(MPI_Comm time_comm);
+
+   /// Set the communicator of the spatial subdomains, used to compute norms.
+   void SetSpatialComm(MPI_Comm comm_) { spatial_comm = comm_; }
+
+   /// Set the operator f and the fine and coarse ODE solvers.
+   void SetOperator(TimeDependentOperator &f_) { f = &f_; }
+   void SetFineSolver(ODESolver &fine_) { fine = &fine_; }
+   void SetCoarseSolver(ODESolver &coarse_) { coarse = &coarse_; }
+
+   /// Set the number of fine steps per coarse interval, default 8.
+   void SetCoarseningFactor(int cf_) { cf = cf_; }
+
+   /// Use FCF-relaxation (default) or F-relaxation (Parareal).
+   void SetFCFRelaxation(bool fcf_) { fcf = fcf_; }
+
+   /** @brief Stop when the largest l2 norm of the change of the C-points is
+       below @a tol_, or after @a max_iter_ iterations. */
+   void SetTolerance(double tol_) { tol = tol_; }
+   void SetMaxIter(int max_iter_) { max_iter = max_iter_; }
+
+   void SetPrintLevel(int print_level_) { print_level = print_level_; }
+
+   /** @brief Solve from time @a t [in] to @a tf with fine steps of size @a dt.
+       @a x [in] is the initial condition and @a x [out] the solution at @a tf
+       [out] on all ranks. @a dt is reduced, if needed, so that an integer
+       number of fine steps fits in the interval. */
+   void Run(Vector &x, double &t, double dt, double tf);
+
+   int GetNumIterations() const { return num_iter; }
+   double GetFinalNorm() const { return final_norm; }
+
+   /// Return the range [j0, j1) of coarse intervals owned by this rank.
+   void GetLocalIntervals(int &j0_, int &j1_) const { j0_ = j0; j1_ = j1; }
+
+   /** @brief Return the solution at the start of the local coarse interval
+       @a j, or at the end of the last one for @a j = j1. */
+   const Vector &GetCPoint(int j) const
+   { return (j == j1) ? u_end : *U[j - j0]; }
+
+   /// Return the time of the C-point @a j, with j0 <= @a j <= j1.
+   double GetCPointTime(int j) const { return t_start[j - j0]; }
+
+   virtual ~MGRITSolver();
+};
+
+}
+
+#endif // MFEM_USE_MPI
+
+#endif
@@ -11,6 +11,9 @@
 
 #include "operator.hpp"
 #include "ode.hpp"
+#include "../general/forall.hpp"
+
+#include <algorithm>
 
 namespace mfem
 {
@@ -344,6 +347,136 @@ const double RK8Solver::c[] =
 };
 
 
+LowStorageRKSolver::LowStorageRKSolver(int _s, const double *_A,
+                                       const double *_B, const double *_c)
+   : s(_s), A(_A), B(_B), c(_c)
+{
+   MFEM_VERIFY(A[0] == 0.0, "invalid low-storage RK coefficients");
+}
+
+void LowStorageRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   w.SetSize(n, mem_type);
+   k.SetSize(n, mem_type);
+}
+
+void LowStorageRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   const int n = x.Size();
+   const bool use_dev = x.UseDevice() || k.UseDevice();
+   for (int i = 0; i < s; i++)
+   {
+      f->SetTime(t + c[i]*dt);
+      f->Mult(x, k);
+
+      // w = A[i] w + dt k, x = x + B[i] w
+      const double a = A[i], b = B[i], h = dt;
+      const double *K = k.Read(use_dev);
+      double *W = (i == 0) ? w.Write(use_dev) : w.ReadWrite(use_dev);
+      double *X = x.ReadWrite(use_dev);
+      if (i == 0)
+      {
+         MFEM_FORALL_SWITCH(use_dev, j, n,
+         {
+            W[j] = h*K[j];
+            X[j] += b*W[j];
+         });
+      }
+      else
+      {
+         MFEM_FORALL_SWITCH(use_dev, j, n,
+         {
+            W[j] = a*W[j] + h*K[j];
+            X[j] += b*W[j];
+         });
+      }
+   }
+   t += dt;
+}
+
+const double LSRK3Solver::A[] = { 0., -5./9., -153./128. };
+const double LSRK3Solver::B[] = { 1./3., 15./16., 8./15. };
+const double LSRK3Solver::c[] = { 0., 1./3., 3./4. };
+
+const double LSRK54Solver::A[] =
+{
+   0.,
+   -567301805773./1357537059087.,
+   -2404267990393./2016746695238.,
+   -3550918686646./2091501179385.,
+   -1275806237668./842570457699.
+};
+const double LSRK54Solver::B[] =
+{
+   1432997174477./9575080441755.,
+   5161836677717./13612068292357.,
+   1720146321549./2090206949498.,
+   3134564353537./4481467310338.,
+   2277821191437./14882151754819.
+};
+const double LSRK54Solver::c[] =
+{
+   0.,
+   1432997174477./9575080441755.,
+   2526269341429./6820363962896.,
+   2006345519317./3224310063776.,
+   2802321613138./2924317926251.
+};
+
+
+void SSPRK104Solver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   q.SetSize(n, mem_type);
+   k.SetSize(n, mem_type);
+}
+
+void SSPRK104Solver::Step(Vector &x, double &t, double &dt)
+{
+   // Ketcheson, "Highly efficient strong stability-preserving Runge-Kutta
+   // methods with low-storage implementations", SISC 30(4), 2008.
+   const int n = x.Size();
+   const bool use_dev = x.UseDevice() || q.UseDevice();
+   q = x;
+   for (int i = 0; i < 5; i++)
+   {
+      f->SetTime(t + (i/6.)*dt);
+      f->Mult(x, k);
+      x.Add(dt/6., k);
+   }
+   {
+      // q = q/25 + 9/25 x, x = 15 q - 5 x
+      double *Q = q.ReadWrite(use_dev);
+      double *X = x.ReadWrite(use_dev);
+      MFEM_FORALL_SWITCH(use_dev, j, n,
+      {
+         Q[j] = Q[j]/25. + (9./25.)*X[j];
+         X[j] = 15.*Q[j] - 5.*X[j];
+      });
+   }
+   for (int i = 0; i < 4; i++)
+   {
+      f->SetTime(t + (1./3. + i/6.)*dt);
+      f->Mult(x, k);
+      x.Add(dt/6., k);
+   }
+   f->SetTime(t + dt);
+   f->Mult(x, k);
+   {
+      // x = q + 3/5 x + dt/10 k
+      const double h = dt/10.;
+      const double *Q = q.Read(use_dev);
+      const double *K = k.Read(use_dev);
+      double *X = x.ReadWrite(use_dev);
+      MFEM_FORALL_SWITCH(use_dev, j, n, X[j] = Q[j] + 0.6*X[j] + h*K[j];);
+   }
+   t += dt;
+}
+
+
 AdamsBashforthSolver::AdamsBashforthSolver(int _s, const double *_a)
 {
    smax = std::min(_s,5);
@@ -781,6 +914,668 @@ void ESDIRK33Solver::Step(Vector &x, double &t, double &dt)
    t += dt;
 }
 
+EmbeddedRKSolver::EmbeddedRKSolver(int _s, const double *_a, const double *_b,
+                                   const double *_bh, const double *_c,
+                                   int _order, bool _fsal)
+   : s(_s), order(_order), a(_a), b(_b), bh(_bh), c(_c), fsal(_fsal),
+     k0_valid(false), rel_tol(1e-6), abs_tol(1e-8), dt_min(0.0),
+     dt_max(infinity()), dt_next(0.0), safety(0.9), fac_min(0.2),
+     fac_max(5.0), beta1(0.7), beta2(0.4), err_prev(1.0), num_accepted(0),
+     num_rejected(0)
+{
+   MFEM_VERIFY(a[0] == 0.0 && c[0] == 0.0,
+               "the first stage of an embedded pair must be explicit");
+   k = new Vector[s];
+#ifdef MFEM_USE_MPI
+   comm = MPI_COMM_NULL;
+#endif
+}
+
+#ifdef MFEM_USE_MPI
+EmbeddedRKSolver::EmbeddedRKSolver(MPI_Comm _comm, int _s, const double *_a,
+                                   const double *_b, const double *_bh,
+                                   const double *_c, int _order, bool _fsal)
+   : EmbeddedRKSolver(_s, _a, _b, _bh, _c, _order, _fsal)
+{
+   comm = _comm;
+}
+#endif
+
+void EmbeddedRKSolver::SetController(double _beta1, double _beta2,
+                                     double _safety, double fmin, double fmax)
+{
+   beta1 = _beta1;
+   beta2 = _beta2;
+   safety = _safety;
+   fac_min = fmin;
+   fac_max = fmax;
+}
+
+void EmbeddedRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   y.SetSize(n, mem_type);
+   z.SetSize(n, mem_type);
+   err.SetSize(n, mem_type);
+   for (int i = 0; i < s; i++)
+   {
+      k[i].SetSize(n, mem_type);
+   }
+   k0_valid = false;
+   dt_next = 0.0;
+   err_prev = 1.0;
+   num_accepted = num_rejected = 0;
+}
+
+void EmbeddedRKSolver::TryStep(const Vector &x, double t, double dt)
+{
+   if (!k0_valid)
+   {
+      f->SetTime(t);
+      f->Mult(x, k[0]);
+      k0_valid = true;
+   }
+   for (int i = 1; i < s; i++)
+   {
+      z = x;
+      for (int j = 0; j < i; j++)
+      {
+         if (a[i*s+j] != 0.0) { z.Add(a[i*s+j]*dt, k[j]); }
+      }
+      f->SetTime(t + c[i]*dt);
+      const double aii = a[i*s+i];
+      if (aii == 0.0)
+      {
+         f->Mult(z, k[i]);
+      }
+      else
+      {
+         f->ImplicitSolve(aii*dt, z, k[i]);
+      }
+   }
+   y = x;
+   err = 0.0;
+   for (int i = 0; i < s; i++)
+   {
+      if (b[i] != 0.0) { y.Add(b[i]*dt, k[i]); }
+      if (b[i] != bh[i]) { err.Add((b[i] - bh[i])*dt, k[i]); }
+   }
+}
+
+double EmbeddedRKSolver::ErrorNorm(const Vector &x) const
+{
+   const int n = x.Size();
+   const double rtol = rel_tol, atol = abs_tol;
+   const bool use_dev = x.UseDevice() || err.UseDevice();
+   const double *X = x.Read(use_dev);
+   const double *Y = y.Read(use_dev);
+   const double *E = err.Read(use_dev);
+   double *W = const_cast<Vector&>(z).Write(use_dev);
+   MFEM_FORALL_SWITCH(use_dev, i, n,
+   {
+      const double sc = atol + rtol*fmax(fabs(X[i]), fabs(Y[i]));
+      W[i] = E[i] / sc;
+   });
+   double loc[2] = { z*z, double(n) }, glob[2] = { loc[0], loc[1] };
+#ifdef MFEM_USE_MPI
+   if (comm != MPI_COMM_NULL)
+   {
+      MPI_Allreduce(loc, glob, 2, MPI_DOUBLE, MPI_SUM, comm);
+   }
+#endif
+   return (glob[1] > 0.0) ? sqrt(glob[0]/glob[1]) : 0.0;
+}
+
+void EmbeddedRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   const double t_target = t + dt;
+   const double q1 = order + 1.0;
+   if (dt_next <= 0.0) { dt_next = dt; }
+
+   double dt_taken = 0.0;
+   while (t_target - t > 1e-14*std::max(1.0, fabs(t_target)))
+   {
+      const double remaining = t_target - t;
+      double h = std::min(std::min(dt_next, dt_max), remaining);
+      bool clipped = (h == remaining), rejected = false;
+      while (true)
+      {
+         TryStep(x, t, h);
+         const double e = ErrorNorm(x);
+         if (e <= 1.0)
+         {
+            // PI controller, with err_prev bounded away from zero.
+            const double en = std::max(e, 1e-10);
+            double fac = safety*pow(en, -beta1/q1)*pow(err_prev, beta2/q1);
+            fac = std::min(fac_max, std::max(fac_min, fac));
+            if (rejected) { fac = std::min(fac, 1.0); }
+            const double h_new = std::min(h*fac, dt_max);
+            dt_next = clipped ? std::max(dt_next, h_new) : h_new;
+            err_prev = std::max(e, 1e-4);
+
+            x = y;
+            t = clipped ? t_target : t + h;
+            dt_taken = h;
+            num_accepted++;
+            if (fsal) { k[0].Swap(k[s-1]); }
+            else { k0_valid = false; }
+            break;
+         }
+         // Rejected step: k[0] is still valid at (x,t).
+         num_rejected++;
+         h *= std::max(fac_min, safety*pow(e, -1.0/q1));
+         MFEM_VERIFY(h >= dt_min, "EmbeddedRKSolver: step size " << h
+                     << " below the minimum " << dt_min << " at t = " << t);
+         clipped = false;
+         rejected = true;
+      }
+   }
+   dt = dt_taken;
+}
+
+void EmbeddedRKSolver::Run(Vector &x, double &t, double &dt, double tf)
+{
+   if (dt_next <= 0.0) { dt_next = dt; }
+   if (t < tf)
+   {
+      dt = tf - t;
+      Step(x, t, dt);
+   }
+}
+
+EmbeddedRKSolver::~EmbeddedRKSolver()
+{
+   delete [] k;
+}
+
+const double DormandPrince54Solver::a[] =
+{
+   0., 0., 0., 0., 0., 0., 0.,
+   1./5., 0., 0., 0., 0., 0., 0.,
+   3./40., 9./40., 0., 0., 0., 0., 0.,
+   44./45., -56./15., 32./9., 0., 0., 0., 0.,
+   19372./6561., -25360./2187., 64448./6561., -212./729., 0., 0., 0.,
+   9017./3168., -355./33., 46732./5247., 49./176., -5103./18656., 0., 0.,
+   35./384., 0., 500./1113., 125./192., -2187./6784., 11./84., 0.
+};
+const double DormandPrince54Solver::b[] =
+{
+   35./384., 0., 500./1113., 125./192., -2187./6784., 11./84., 0.
+};
+const double DormandPrince54Solver::bh[] =
+{
+   5179./57600., 0., 7571./16695., 393./640., -92097./339200., 187./2100.,
+   1./40.
+};
+const double DormandPrince54Solver::c[] =
+{
+   0., 1./5., 3./10., 4./5., 8./9., 1., 1.
+};
+
+const double BogackiShampine32Solver::a[] =
+{
+   0., 0., 0., 0.,
+   1./2., 0., 0., 0.,
+   0., 3./4., 0., 0.,
+   2./9., 1./3., 4./9., 0.
+};
+const double BogackiShampine32Solver::b[] =
+{
+   2./9., 1./3., 4./9., 0.
+};
+const double BogackiShampine32Solver::bh[] =
+{
+   7./24., 1./4., 1./3., 1./8.
+};
+const double BogackiShampine32Solver::c[] =
+{
+   0., 1./2., 3./4., 1.
+};
+
+// gamma = 1767732205903/4055673282236
+const double ESDIRK32EmbeddedSolver::a[] =
+{
+   0., 0., 0., 0.,
+   1767732205903./4055673282236., 1767732205903./4055673282236., 0., 0.,
+   2746238789719./10658868560708., -640167445237./6845629431997.,
+   1767732205903./4055673282236., 0.,
+   1471266399579./7840856788654., -4482444167858./7529755066697.,
+   11266239266428./11593286722821., 1767732205903./4055673282236.
+};
+const double ESDIRK32EmbeddedSolver::b[] =
+{
+   1471266399579./7840856788654., -4482444167858./7529755066697.,
+   11266239266428./11593286722821., 1767732205903./4055673282236.
+};
+const double ESDIRK32EmbeddedSolver::bh[] =
+{
+   2756255671327./12835298489170., -10771552573575./22201958757719.,
+   9247589265047./10645013368117., 2193209047091./5459859503100.
+};
+const double ESDIRK32EmbeddedSolver::c[] =
+{
+   0., 1767732205903./2027836641118., 3./5., 1.
+};
+
+IMEXRKSolver::IMEXRKSolver(int _s, const double *_ae, const double *_be,
+                           const double *_ai, const double *_bi,
+                           const double *_c)
+   : s(_s), ae(_ae), be(_be), ai(_ai), bi(_bi), c(_c)
+{
+   k1 = new Vector[s];
+   k2 = new Vector[s];
+}
+
+bool IMEXRKSolver::Used(int i, bool imp) const
+{
+   const double *a = imp ? ai : ae;
+   if ((imp ? bi : be)[i] != 0.0) { return true; }
+   for (int j = i+1; j < s; j++)
+   {
+      if (a[j*s+i] != 0.0) { return true; }
+   }
+   return false;
+}
+
+void IMEXRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   z.SetSize(n, mem_type);
+   for (int i = 0; i < s; i++)
+   {
+      k1[i].SetSize(Used(i, false) ? n : 0, mem_type);
+      k2[i].SetSize(Used(i, true) || ai[i*s+i] != 0.0 ? n : 0, mem_type);
+   }
+}
+
+void IMEXRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   for (int i = 0; i < s; i++)
+   {
+      z = x;
+      for (int j = 0; j < i; j++)
+      {
+         if (ae[i*s+j] != 0.0) { z.Add(ae[i*s+j]*dt, k1[j]); }
+         if (ai[i*s+j] != 0.0) { z.Add(ai[i*s+j]*dt, k2[j]); }
+      }
+      f->SetTime(t + c[i]*dt);
+      f->SetEvalMode(TimeDependentOperator::ADDITIVE_TERM_2);
+      const double aii = ai[i*s+i];
+      if (aii != 0.0)
+      {
+         f->ImplicitSolve(aii*dt, z, k2[i]);
+         z.Add(aii*dt, k2[i]);
+      }
+      else if (Used(i, true))
+      {
+         f->Mult(z, k2[i]);
+      }
+      if (Used(i, false))
+      {
+         f->SetEvalMode(TimeDependentOperator::ADDITIVE_TERM_1);
+         f->Mult(z, k1[i]);
+      }
+   }
+   for (int i = 0; i < s; i++)
+   {
+      if (be[i] != 0.0) { x.Add(be[i]*dt, k1[i]); }
+      if (bi[i] != 0.0) { x.Add(bi[i]*dt, k2[i]); }
+   }
+   f->SetEvalMode(TimeDependentOperator::NORMAL);
+   t += dt;
+}
+
+IMEXRKSolver::~IMEXRKSolver()
+{
+   delete [] k2;
+   delete [] k1;
+}
+
+// gamma = 1 - 1/sqrt(2), delta = 1 - 1/(2 gamma)
+const double ARS222Solver::ae[] =
+{
+   0., 0., 0.,
+   1. - M_SQRT1_2, 0., 0.,
+   1. - 1./(2. - M_SQRT2), 1./(2. - M_SQRT2), 0.
+};
+const double ARS222Solver::be[] =
+{
+   1. - 1./(2. - M_SQRT2), 1./(2. - M_SQRT2), 0.
+};
+const double ARS222Solver::ai[] =
+{
+   0., 0., 0.,
+   0., 1. - M_SQRT1_2, 0.,
+   0., M_SQRT1_2, 1. - M_SQRT1_2
+};
+const double ARS222Solver::bi[] = { 0., M_SQRT1_2, 1. - M_SQRT1_2 };
+const double ARS222Solver::c[] = { 0., 1. - M_SQRT1_2, 1. };
+
+const double ARS443Solver::ae[] =
+{
+   0., 0., 0., 0., 0.,
+   1./2., 0., 0., 0., 0.,
+   11./18., 1./18., 0., 0., 0.,
+   5./6., -5./6., 1./2., 0., 0.,
+   1./4., 7./4., 3./4., -7./4., 0.
+};
+const double ARS443Solver::be[] = { 1./4., 7./4., 3./4., -7./4., 0. };
+const double ARS443Solver::ai[] =
+{
+   0., 0., 0., 0., 0.,
+   0., 1./2., 0., 0., 0.,
+   0., 1./6., 1./2., 0., 0.,
+   0., -1./2., 1./2., 1./2., 0.,
+   0., 3./2., -3./2., 1./2., 1./2.
+};
+const double ARS443Solver::bi[] = { 0., 3./2., -3./2., 1./2., 1./2. };
+const double ARS443Solver::c[] = { 0., 1./2., 2./3., 1./2., 1. };
+
+const double ARK3Solver::ae[] =
+{
+   0., 0., 0., 0.,
+   1767732205903./2027836641118., 0., 0., 0.,
+   5535828885825./10492691773637., 788022342437./10882634858940., 0., 0.,
+   6485989280629./16251701735622., -4246266847089./9704473918619.,
+   10755448449292./10357097424841., 0.
+};
+const double ARK3Solver::ai[] =
+{
+   0., 0., 0., 0.,
+   1767732205903./4055673282236., 1767732205903./4055673282236., 0., 0.,
+   2746238789719./10658868560708., -640167445237./6845629431997.,
+   1767732205903./4055673282236., 0.,
+   1471266399579./7840856788654., -4482444167858./7529755066697.,
+   11266239266428./11593286722821., 1767732205903./4055673282236.
+};
+const double ARK3Solver::b[] =
+{
+   1471266399579./7840856788654., -4482444167858./7529755066697.,
+   11266239266428./11593286722821., 1767732205903./4055673282236.
+};
+const double ARK3Solver::c[] =
+{
+   0., 1767732205903./2027836641118., 3./5., 1.
+};
+
+const double ARK4Solver::ae[] =
+{
+   0., 0., 0., 0., 0., 0.,
+   1./2., 0., 0., 0., 0., 0.,
+   13861./62500., 6889./62500., 0., 0., 0., 0.,
+   -116923316275./2393684061468., -2731218467317./15368042101831.,
+   9408046702089./11113171139209., 0., 0., 0.,
+   -451086348788./2902428689909., -2682348792572./7519795681897.,
+   12662868775082./11960479115383., 3355817975965./11060851509271., 0., 0.,
+   647845179188./3216320057751., 73281519250./8382639484533.,
+   552539513391./3454668386233., 3354512671639./8306763924573.,
+   4040./17871., 0.
+};
+const double ARK4Solver::ai[] =
+{
+   0., 0., 0., 0., 0., 0.,
+   1./4., 1./4., 0., 0., 0., 0.,
+   8611./62500., -1743./31250., 1./4., 0., 0., 0.,
+   5012029./34652500., -654441./2922500., 174375./388108., 1./4., 0., 0.,
+   15267082809./155376265600., -71443401./120774400.,
+   730878875./902184768., 2285395./8070912., 1./4., 0.,
+   82889./524892., 0., 15625./83664., 69875./102672., -2260./8211., 1./4.
+};
+const double ARK4Solver::b[] =
+{
+   82889./524892., 0., 15625./83664., 69875./102672., -2260./8211., 1./4.
+};
+const double ARK4Solver::c[] =
+{
+   0., 1./2., 83./250., 31./50., 17./20., 1.
+};
+
+MultirateABSolver::MultirateABSolver(int _order)
+   : order(_order), max_rate(0), dt_prev(0.0)
+{
+   MFEM_VERIFY(order >= 1 && order <= 3, "invalid order: " << order);
+   F = new Vector[order];
+}
+
+void MultirateABSolver::SetRates(const Array<int> &elem_rate,
+                                 const Table &elem_dof, const Table *elem_read)
+{
+   MFEM_VERIFY(elem_rate.Size() == elem_dof.Size(), "invalid element rates");
+   max_rate = elem_rate.Size() ? elem_rate.Max() : 0;
+   MFEM_VERIFY(elem_rate.Size() == 0 || elem_rate.Min() >= 0,
+               "invalid element rates");
+
+   // The rate of each unknown is the largest rate of its elements.
+   Array<int> dof_rate(elem_dof.Width());
+   dof_rate = 0;
+   for (int e = 0; e < elem_dof.Size(); e++)
+   {
+      const int *dofs = elem_dof.GetRow(e);
+      for (int j = 0; j < elem_dof.RowSize(e); j++)
+      {
+         const int d = dofs[j] >= 0 ? dofs[j] : -1-dofs[j];
+         dof_rate[d] = std::max(dof_rate[d], elem_rate[e]);
+      }
+   }
+
+   // Bin r evaluates the elements that have at least one unknown of rate r.
+   Array<Connection> dof_list, elem_list;
+   for (int d = 0; d < dof_rate.Size(); d++)
+   {
+      dof_list.Append(Connection(dof_rate[d], d));
+   }
+   dof_list.Sort();
+   for (int e = 0; e < elem_dof.Size(); e++)
+   {
+      const int *dofs = elem_dof.GetRow(e);
+      for (int j = 0; j < elem_dof.RowSize(e); j++)
+      {
+         const int d = dofs[j] >= 0 ? dofs[j] : -1-dofs[j];
+         elem_list.Append(Connection(dof_rate[d], e));
+      }
+   }
+   elem_list.Sort();
+   elem_list.Unique();
+   bin_dofs.MakeFromList(max_rate + 1, dof_list);
+   bin_elems.MakeFromList(max_rate + 1, elem_list);
+
+   // The fastest bin that reads each unknown: an element is evaluated by the
+   // bins of the rates of its unknowns, the fastest of which is its rate.
+   Array<int> dof_read(dof_rate);
+   if (elem_read)
+   {
+      MFEM_VERIFY(elem_read->Size() == elem_dof.Size(),
+                  "invalid element read table");
+      for (int e = 0; e < elem_read->Size(); e++)
+      {
+         int e_rate = 0;
+         const int *dofs = elem_dof.GetRow(e);
+         for (int j = 0; j < elem_dof.RowSize(e); j++)
+         {
+            const int d = dofs[j] >= 0 ? dofs[j] : -1-dofs[j];
+            e_rate = std::max(e_rate, dof_rate[d]);
+         }
+         const int *rdofs = elem_read->GetRow(e);
+         for (int j = 0; j < elem_read->RowSize(e); j++)
+         {
+            const int d = rdofs[j] >= 0 ? rdofs[j] : -1-rdofs[j];
+            dof_read[d] = std::max(dof_read[d], e_rate);
+         }
+      }
+   }
+   else
+   {
+      dof_read = max_rate;
+   }
+
+   // Order the unknowns of each bin by decreasing dof_read, so that the
+   // unknowns of bin r read by the bins >= s are the first
+   // num_read[r*(max_rate+1)+s] ones.
+   num_read.SetSize((max_rate + 1)*(max_rate + 1));
+   for (int r = 0; r <= max_rate; r++)
+   {
+      int *dofs = bin_dofs.GetRow(r);
+      const int nd = bin_dofs.RowSize(r);
+      std::sort(dofs, dofs + nd, [&](int a, int b)
+      { return dof_read[a] > dof_read[b]; });
+      for (int s = 0, j = nd; s <= max_rate; s++)
+      {
+         while (j > 0 && dof_read[dofs[j-1]] < s) { j--; }
+         num_read[r*(max_rate+1)+s] = j;
+      }
+   }
+
+   nhist.SetSize(max_rate + 1);
+   nhist = 0;
+   fresh.SetSize(max_rate + 1);
+   fresh = false;
+}
+
+void MultirateABSolver::ComputeRates(const Vector &elem_dt, double dt,
+                                     Array<int> &elem_rate, int max_r)
+{
+   elem_rate.SetSize(elem_dt.Size());
+   for (int e = 0; e < elem_dt.Size(); e++)
+   {
+      int r = 0;
+      while (r < max_r && dt > elem_dt(e)*(1 << r)) { r++; }
+      elem_rate[e] = r;
+   }
+}
+
+void MultirateABSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   xs.SetSize(n, mem_type);
+   z.SetSize(n, mem_type);
+   w.SetSize(n, mem_type);
+   for (int i = 0; i < order; i++)
+   {
+      F[i].SetSize(n, mem_type);
+   }
+   nhist = 0;
+   fresh = false;
+}
+
+void MultirateABSolver::Extrapolate(int r, double tau, double h, int nd)
+{
+   // Integral of the Newton form of the interpolant of F through the times
+   // 0, -h, -2h: F0 + s d1/h + s (s + h) d2/(2 h^2).
+   const int nh = std::min(nhist[r], order);
+   const double c1 = (nh > 1) ? tau*tau/(2*h) : 0.0;
+   const double c2 = (nh > 2) ? (tau*tau*tau/3 + h*tau*tau/2)/(2*h*h) : 0.0;
+   const double *F0 = F[0].HostRead();
+   const double *F1 = (nh > 1) ? F[1].HostRead() : F0;
+   const double *F2 = (nh > 2) ? F[2].HostRead() : F1;
+   const double *X = xs.HostRead();
+   double *Z = z.HostReadWrite();
+   const int *dofs = bin_dofs.GetRow(r);
+   for (int j = 0; j < nd; j++)
+   {
+      const int d = dofs[j];
+      Z[d] = X[d] + tau*F0[d] + c1*(F0[d] - F1[d]) +
+             c2*(F0[d] - 2*F1[d] + F2[d]);
+   }
+}
+
+void MultirateABSolver::Step(Vector &x, double &t, double &dt)
+{
+   MFEM_VERIFY(bin_dofs.Size() > 0 && bin_dofs.Width() == x.Size(),
+               "SetRates() must be called before Step()");
+   if (dt != dt_prev)
+   {
+      nhist = 0;
+      fresh = false;
+      dt_prev = dt;
+   }
+   const int R = max_rate, K = 1 << R;
+   const double h0 = dt/K;
+   xs = x;
+   z = x;
+   for (int k = 0; k <= K; k++)
+   {
+      // The bins r >= a end a step at t + k h0 and start a new one; their
+      // state is computed on all their unknowns, and the first step of a bin
+      // is corrected below. The slower bins are only computed on the unknowns
+      // read by the bins r >= a.
+      int a = R;
+      while (a > 0 && k % (1 << (R - a + 1)) == 0) { a--; }
+      for (int r = 0; k > 0 && r <= R; r++)
+      {
+         const int m = 1 << (R - r);
+         const int start = (k - 1)/m*m;
+         Extrapolate(r, (k - start)*h0, m*h0,
+                     num_read[r*(R+1) + std::max(a, r)]);
+         if (k % m == 0 && !Startup(r)) { CopyBin(r, z, xs); }
+      }
+
+      for (int r = 0; r <= R; r++)
+      {
+         const int m = 1 << (R - r);
+         if (k % m != 0 || bin_dofs.RowSize(r) == 0) { continue; }
+         // At k = K, the right-hand side is evaluated by the next Step().
+         if (k == K && !Startup(r)) { continue; }
+         if (k == 0 && fresh[r]) { fresh[r] = false; continue; }
+
+         Array<int> elems(bin_elems.GetRow(r), bin_elems.RowSize(r));
+         f->SetTime(t + k*h0);
+         f->MultSubset(elems, z, w);
+
+         const int *dofs = bin_dofs.GetRow(r);
+         const double *W = w.HostRead();
+         if (k > 0 && Startup(r))
+         {
+            // Correct the forward Euler predictor of the first step with the
+            // trapezoidal rule, using the right-hand side at the predictor.
+            const double h2 = 0.5*m*h0;
+            const double *F0 = F[0].HostRead();
+            double *Z = z.HostReadWrite();
+            const double *X = xs.HostRead();
+            for (int j = 0; j < bin_dofs.RowSize(r); j++)
+            {
+               const int d = dofs[j];
+               Z[d] = X[d] + h2*(F0[d] + W[d]);
+            }
+            CopyBin(r, z, xs);
+            fresh[r] = (k == K);
+         }
+
+         // Shift the history of the bin and store the new right-hand side.
+         for (int i = order - 1; i >= 0; i--)
+         {
+            double *Fi = F[i].HostReadWrite();
+            const double *Fp = (i > 0) ? F[i-1].HostRead() : W;
+            for (int j = 0; j < bin_dofs.RowSize(r); j++)
+            {
+               Fi[dofs[j]] = Fp[dofs[j]];
+            }
+         }
+         nhist[r]++;
+      }
+   }
+   x = z;
+   t += dt;
+}
+
+void MultirateABSolver::CopyBin(int r, const Vector &src, Vector &dst) const
+{
+   const double *S = src.HostRead();
+   double *D = dst.HostReadWrite();
+   const int *dofs = bin_dofs.GetRow(r);
+   for (int j = 0; j < bin_dofs.RowSize(r); j++)
+   {
+      D[dofs[j]] = S[dofs[j]];
+   }
+}
+
+MultirateABSolver::~MultirateABSolver()
+{
+   delete [] F;
+}
+
 void GeneralizedAlphaSolver::Init(TimeDependentOperator &_f)
 {
    ODESolver::Init(_f);
@@ -14,6 +14,11 @@
 
 #include "../config/config.hpp"
 #include "operator.hpp"
+#include "../general/table.hpp"
+
+#ifdef MFEM_USE_MPI
+#include <mpi.h>
+#endif
 
 namespace mfem
 {
@@ -223,6 +228,68 @@ public:
 };
 
 
+/** @brief A low-storage (2N) explicit Runge-Kutta method in Williamson form:
+    for i = 0, ..., s-1,
+       w = A[i] w + dt f(x, t + c[i] dt),
+       x = x + B[i] w,
+    with A[0] = 0. Besides the solution, only the register w and the output k
+    of f are stored, independently of the number of stages, and the two updates
+    of each stage are fused in one pass over the vectors. */
+class LowStorageRKSolver : public ODESolver
+{
+private:
+   int s;
+   const double *A, *B, *c;
+   Vector w, k;
+
+public:
+   LowStorageRKSolver(int _s, const double *_A, const double *_B,
+                      const double *_c);
+
+   void Init(TimeDependentOperator &_f) override;
+
+   void Step(Vector &x, double &t, double &dt) override;
+};
+
+
+/// Williamson's 3-stage, third order low-storage RK method.
+class LSRK3Solver : public LowStorageRKSolver
+{
+private:
+   static const double A[3], B[3], c[3];
+
+public:
+   LSRK3Solver() : LowStorageRKSolver(3, A, B, c) { }
+};
+
+
+/** The 5-stage, fourth order low-storage RK method of Carpenter and Kennedy,
+    LSRK(5,4) (solution 3 in NASA TM-109112). */
+class LSRK54Solver : public LowStorageRKSolver
+{
+private:
+   static const double A[5], B[5], c[5];
+
+public:
+   LSRK54Solver() : LowStorageRKSolver(5, A, B, c) { }
+};
+
+
+/** Ketcheson's 10-stage, fourth order strong stability preserving method,
+    SSPRK(10,4), with SSP coefficient 6. Stored with two registers besides the
+    solution: a copy of the initial state and the output of f. */
+class SSPRK104Solver : public ODESolver
+{
+private:
+   Vector q, k;
+
+public:
+   void Init(TimeDependentOperator &_f) override;
+
+   void Step(Vector &x, double &t, double &dt) override;
+};
+
+
 /** An explicit Adams-Bashforth method. */
 class AdamsBashforthSolver : public ODESolver
 {
@@ -502,6 +569,335 @@ public:
 };
 
 
+/** @brief Runge-Kutta method with an embedded error estimate and adaptive time
+    step control, corresponding to the extended Butcher tableau
+    +--------+------------------------------------+
+    | c[0]   | a[0]                               |
+    | c[1]   | a[s]      a[s+1]                   |
+    | ...    |    ...                             |
+    | c[s-1] | a[s(s-1)] ...      a[s*s-1]        |
+    +--------+------------------------------------+
+    |        | b[0]      b[1]     ...    b[s-1]   |
+    |        | bh[0]     bh[1]    ...    bh[s-1]  |
+    +--------+------------------------------------+
+    where @a a is a dense, lower triangular s x s matrix stored by rows. Stages
+    with a[i*s+i] != 0 are computed with TimeDependentOperator::ImplicitSolve(),
+    so the same class covers explicit and (E)SDIRK pairs.
+
+    The difference between the solutions with weights @a b and @a bh is used
+    as an error estimate, measured in a weighted RMS norm with the relative and
+    absolute tolerances set with SetTolerances(). Rejected steps are repeated
+    with a smaller step size, and the next step size after an accepted step is
+    chosen by a PI controller, see SetController().
+
+    Step() advances the solution to the target time t + dt, taking as many
+    internal steps as needed, the last one being shortened to hit the target
+    exactly. To let the controller choose the steps freely, call Step() with a
+    large @a dt, or use Run(). The first internal step size after Init() is the
+    input @a dt, unless set with SetInitialStep() after Init().
+
+    If the method is FSAL (first same as last), the last stage of an accepted
+    step is reused as the first stage of the next one. For any method, the first
+    stage is reused when a step is rejected. In both cases the solution @a x
+    must not be modified between consecutive calls to Step() without calling
+    Init().
+
+    The error norm is global when the solver is constructed with an MPI
+    communicator, so all ranks take the same steps. */
+class EmbeddedRKSolver : public ODESolver
+{
+protected:
+   int s, order;
+   const double *a, *b, *bh, *c;
+   bool fsal;
+
+   Vector y, z, err, *k;
+   bool k0_valid;
+
+   double rel_tol, abs_tol;
+   double dt_min, dt_max, dt_next;
+   double safety, fac_min, fac_max, beta1, beta2, err_prev;
+   long num_accepted, num_rejected;
+
+#ifdef MFEM_USE_MPI
+   MPI_Comm comm;
+#endif
+
+   /// Compute the new solution @a y and the error estimate @a err.
+   void TryStep(const Vector &x, double t, double dt);
+
+   /** @brief Return the weighted RMS norm of @a err, relative to the larger
+       of |x| and |y| entrywise. The step is accepted if the norm is <= 1. */
+   double ErrorNorm(const Vector &x) const;
+
+public:
+   /** @brief Create a pair with @a _s stages. @a _order is the order of the
+       lower order solution (the embedded one, if @a b is used to advance the
+       solution), which defines the exponents of the step size controller. */
+   EmbeddedRKSolver(int _s, const double *_a, const double *_b,
+                    const double *_bh, const double *_c, int _order,
+                    bool _fsal);
+
+#ifdef MFEM_USE_MPI
+   /// Create a pair whose error norm is reduced over @a _comm.
+   EmbeddedRKSolver(MPI_Comm _comm, int _s, const double *_a,
+                    const double *_b, const double *_bh, const double *_c,
+                    int _order, bool _fsal);
+
+   /// Set the communicator used to compute the global error norm.
+   void SetComm(MPI_Comm _comm) { comm = _comm; }
+#endif
+
+   /// Set the relative and absolute tolerances of the error estimate.
+   void SetTolerances(double rtol, double atol)
+   { rel_tol = rtol; abs_tol = atol; }
+
+   /** @brief Set the smallest and largest allowed internal step sizes. Step()
+       aborts if the step size falls below @a dtmin. */
+   void SetStepLimits(double dtmin, double dtmax)
+   { dt_min = dtmin; dt_max = dtmax; }
+
+   /// Set the first internal step size; Init() resets it.
+   void SetInitialStep(double dt) { dt_next = dt; }
+
+   /** @brief Set the PI controller parameters: the new step size is
+       dt_new = dt * safety * err^(-beta1/(q+1)) * err_prev^(beta2/(q+1)),
+       limited to [fmin, fmax] * dt, where q is the order given to the
+       constructor. The defaults are (0.7, 0.4, 0.9, 0.2, 5.0); beta2 = 0
+       gives the classical I controller. */
+   void SetController(double _beta1, double _beta2, double _safety = 0.9,
+                      double fmin = 0.2, double fmax = 5.0);
+
+   void Init(TimeDependentOperator &_f) override;
+
+   void Step(Vector &x, double &t, double &dt) override;
+
+   /// Integrate to @a tf with the step sizes chosen by the controller.
+   void Run(Vector &x, double &t, double &dt, double tf) override;
+
+   /// Return the step size proposed by the controller for the next step.
+   double GetNextStep() const { return dt_next; }
+
+   /// Return the number of accepted internal steps since Init().
+   long GetNumAccepted() const { return num_accepted; }
+
+   /// Return the number of rejected internal steps since Init().
+   long GetNumRejected() const { return num_rejected; }
+
+   virtual ~EmbeddedRKSolver();
+};
+
+
+/** The 7-stage, FSAL Dormand-Prince 5(4) pair, advancing the solution with
+    the fifth order weights. */
+class DormandPrince54Solver : public EmbeddedRKSolver
+{
+private:
+   static const double a[49], b[7], bh[7], c[7];
+
+public:
+   DormandPrince54Solver() : EmbeddedRKSolver(7, a, b, bh, c, 4, true) { }
+#ifdef MFEM_USE_MPI
+   DormandPrince54Solver(MPI_Comm comm)
+      : EmbeddedRKSolver(comm, 7, a, b, bh, c, 4, true) { }
+#endif
+};
+
+
+/** The 4-stage, FSAL Bogacki-Shampine 3(2) pair, advancing the solution with
+    the third order weights. */
+class BogackiShampine32Solver : public EmbeddedRKSolver
+{
+private:
+   static const double a[16], b[4], bh[4], c[4];
+
+public:
+   BogackiShampine32Solver() : EmbeddedRKSolver(4, a, b, bh, c, 2, true) { }
+#ifdef MFEM_USE_MPI
+   BogackiShampine32Solver(MPI_Comm comm)
+      : EmbeddedRKSolver(comm, 4, a, b, bh, c, 2, true) { }
+#endif
+};
+
+
+/** Four stage, stiffly accurate ESDIRK 3(2) pair of Kennedy and Carpenter
+    (ESDIRK3(2)4L[2]SA, the implicit part of ARK3(2)4L[2]SA). L-stable and
+    FSAL. Uses TimeDependentOperator::ImplicitSolve() for the last three
+    stages. */
+class ESDIRK32EmbeddedSolver : public EmbeddedRKSolver
+{
+private:
+   static const double a[16], b[4], bh[4], c[4];
+
+public:
+   ESDIRK32EmbeddedSolver() : EmbeddedRKSolver(4, a, b, bh, c, 2, true) { }
+#ifdef MFEM_USE_MPI
+   ESDIRK32EmbeddedSolver(MPI_Comm comm)
+      : EmbeddedRKSolver(comm, 4, a, b, bh, c, 2, true) { }
+#endif
+};
+
+
+/** @brief Implicit-explicit (IMEX) additive Runge-Kutta method for the split
+    system dx/dt = f1(x,t) + f2(x,t), where f1 is non-stiff and f2 is stiff.
+
+    The two terms are selected with TimeDependentOperator::SetEvalMode(): f1
+    is evaluated with Mult() in the mode ADDITIVE_TERM_1, while f2 is solved
+    for with ImplicitSolve() (or evaluated with Mult(), for stages with a zero
+    diagonal coefficient) in the mode ADDITIVE_TERM_2. The evaluation mode is
+    reset to NORMAL at the end of Step().
+
+    The explicit and implicit tableaux, @a ae and @a ai, are dense s x s
+    matrices stored by rows; @a ae is strictly lower triangular and @a ai is
+    lower triangular. Stage i solves for
+       k2[i] = f2(z + ai[i,i] dt k2[i], t + c[i] dt),
+       z = x + dt sum_{j<i} (ae[i,j] k1[j] + ai[i,j] k2[j]),
+    and the new solution is x + dt sum_i (be[i] k1[i] + bi[i] k2[i]). Stage
+    derivatives with no later use are not computed. */
+class IMEXRKSolver : public ODESolver
+{
+private:
+   int s;
+   const double *ae, *be, *ai, *bi, *c;
+   Vector z, *k1, *k2;
+
+   /// True if k1[i] (@a imp false) or k2[i] (@a imp true) is used.
+   bool Used(int i, bool imp) const;
+
+public:
+   IMEXRKSolver(int _s, const double *_ae, const double *_be,
+                const double *_ai, const double *_bi, const double *_c);
+
+   void Init(TimeDependentOperator &_f) override;
+
+   void Step(Vector &x, double &t, double &dt) override;
+
+   virtual ~IMEXRKSolver();
+};
+
+
+/** The L-stable, second order IMEX method ARS(2,2,2) of Ascher, Ruuth and
+    Spiteri, with two implicit stages. */
+class ARS222Solver : public IMEXRKSolver
+{
+private:
+   static const double ae[9], be[3], ai[9], bi[3], c[3];
+
+public:
+   ARS222Solver() : IMEXRKSolver(3, ae, be, ai, bi, c) { }
+};
+
+
+/** The L-stable, third order IMEX method ARS(4,4,3) of Ascher, Ruuth and
+    Spiteri, with four implicit stages. */
+class ARS443Solver : public IMEXRKSolver
+{
+private:
+   static const double ae[25], be[5], ai[25], bi[5], c[5];
+
+public:
+   ARS443Solver() : IMEXRKSolver(5, ae, be, ai, bi, c) { }
+};
+
+
+/** The third order IMEX method ARK3(2)4L[2]SA of Kennedy and Carpenter, with
+    an L-stable, stiffly accurate ESDIRK implicit part. */
+class ARK3Solver : public IMEXRKSolver
+{
+private:
+   static const double ae[16], ai[16], b[4], c[4];
+
+public:
+   ARK3Solver() : IMEXRKSolver(4, ae, b, ai, b, c) { }
+};
+
+
+/** The fourth order IMEX method ARK4(3)6L[2]SA of Kennedy and Carpenter,
+    with an L-stable, stiffly accurate ESDIRK implicit part. */
+class ARK4Solver : public IMEXRKSolver
+{
+private:
+   static const double ae[36], ai[36], b[6], c[6];
+
+public:
+   ARK4Solver() : IMEXRKSolver(6, ae, b, ai, b, c) { }
+};
+
+
+/** @brief Multirate (local time stepping) Adams-Bashforth method of order 1,
+    2 or 3, for explicit discretizations on graded meshes.
+
+    Each element e has a rate r_e >= 0, see SetRates(), and its unknowns are
+    advanced with 2^r_e substeps of size dt/2^r_e in each Step() of size dt.
+    Unknowns shared by elements with different rates take the largest one. The
+    right-hand side of each rate bin is evaluated with
+    TimeDependentOperator::MultSubset() on the elements of the bin, using the
+    Adams-Bashforth polynomials of the slower bins for their states at the
+    intermediate times (the fastest-first scheme of Gear and Wells). The number
+    of element evaluations in a Step() is then the sum of 2^r_e over the
+    elements, rather than the number of elements times 2^max(r_e).
+
+    The slower bins are extrapolated at every substep on the unknowns that the
+    evaluated bins may read. By default, these are all unknowns, which costs
+    O(n 2^max(r_e)) vector operations per Step() for n unknowns. If the
+    unknowns read by each element in MultSubset() are given to SetRates(), the
+    slower bins are only extrapolated on these unknowns, i.e. on the interfaces
+    between the bins, and at the end of their own steps.
+
+    The history of each bin is restarted after Init() or SetRates(), and when
+    @a dt changes, with a forward Euler predictor and trapezoidal corrector
+    step followed by lower order Adams-Bashforth steps. */
+class MultirateABSolver : public ODESolver
+{
+private:
+   int order, max_rate;
+   Table bin_elems, bin_dofs;
+   Array<int> nhist, num_read;
+   Array<bool> fresh;
+   double dt_prev;
+   Vector xs, z, w, *F;
+
+   /// Set z = xs + int_0^tau p(s) ds on the first @a nd unknowns of bin @a r,
+   /// where p is the Adams-Bashforth interpolant of F with step @a h.
+   void Extrapolate(int r, double tau, double h, int nd);
+
+   /// Copy the entries of @a src on the unknowns of bin @a r to @a dst.
+   void CopyBin(int r, const Vector &src, Vector &dst) const;
+
+   /** @brief The first step of a bin, with only one right-hand side in its
+       history, uses a trapezoidal corrector to keep the order of the method. */
+   bool Startup(int r) const { return order > 1 && nhist[r] == 1; }
+
+public:
+   MultirateABSolver(int _order = 3);
+
+   /** @brief Set the rate of each element, @a elem_rate, and the unknowns of
+       each element, @a elem_dof, e.g.
+       FiniteElementSpace::GetElementToDofTable() for scalar spaces.
+
+       If given, @a elem_read lists the unknowns that
+       TimeDependentOperator::MultSubset() reads for each element, e.g. also
+       the unknowns of the face neighbors for DG discretizations. Otherwise,
+       the operator may read any unknown. */
+   void SetRates(const Array<int> &elem_rate, const Table &elem_dof,
+                 const Table *elem_read = NULL);
+
+   /** @brief Compute the smallest rates r_e such that dt/2^r_e does not exceed
+       the stable time step @a elem_dt of each element, limited to @a max_r. */
+   static void ComputeRates(const Vector &elem_dt, double dt,
+                            Array<int> &elem_rate, int max_r = 8);
+
+   /// Return the largest element rate.
+   int GetMaxRate() const { return max_rate; }
+
+   void Init(TimeDependentOperator &_f) override;
+
+   void Step(Vector &x, double &t, double &dt) override;
+
+   virtual ~MultirateABSolver();
+};
+
+
 /// Generalized-alpha ODE solver from "A generalized-α method for integrating
 /// the filtered Navier-Stokes equations with a stabilized finite element
 /// method" by K.E. Jansen, C.H. Whiting and G.M. Hulbert.
@@ -227,6 +227,12 @@ void TimeDependentOperator::Mult(const Vector &, Vector &) const
    mfem_error("TimeDependentOperator::Mult() is not overridden!");
 }
 
+void TimeDependentOperator::MultSubset(const Array<int> &, const Vector &x,
+                                       Vector &y) const
+{
+   Mult(x, y);
+}
+
 void TimeDependentOperator::ImplicitSolve(const double, const Vector &,
                                           Vector &)
 {
@@ -594,10 +600,11 @@ void RectangularConstrainedOperator::MultTranspose(const Vector &x,
 }
 
 double PowerMethod::EstimateLargestEigenvalue(Operator& opr, Vector& v0,
-                                              int numSteps, double tolerance, int seed)
+                                              int numSteps, double tolerance,
+                                              int seed, bool randomize)
 {
    v1.SetSize(v0.Size());
-   v0.Randomize(seed);
+   if (randomize) { v0.Randomize(seed); }
 
    double eigenvalue = 1.0;
 
@@ -359,6 +359,18 @@ public:
        current time. */
    virtual void Mult(const Vector &x, Vector &y) const;
 
+   /** @brief Perform the action of the operator, @a y = f(@a x, t), only on
+       the unknowns of the elements listed in @a elems.
+
+       The entries of @a y that belong to these elements must be the same as
+       with Mult(); the other entries are not used and may be left unchanged.
+       Used by local time stepping methods, e.g. MultirateABSolver, to update
+       a subset of the elements with a smaller time step.
+
+       If not re-implemented, this method calls Mult(). */
+   virtual void MultSubset(const Array<int> &elems, const Vector &x,
+                           Vector &y) const;
+
    /** @brief Solve the equation: @a k = f(@a x + @a dt @a k, t), for the
        unknown @a k at the current time t.
 
@@ -936,10 +948,11 @@ public:
        the eigenvector corresponding to the largest eigenvalue after convergence.
        The maximum number of iterations may set with \p numSteps, the relative
        tolerance with \p tolerance and the seed of the random initialization of
-       \p v0 with \p seed. */
+       \p v0 with \p seed. If \p randomize is false, the given \p v0 is used
+       as the initial vector, e.g. the eigenvector of a previous estimate. */
    double EstimateLargestEigenvalue(Operator& opr, Vector& v0,
                                     int numSteps = 10, double tolerance = 1e-8,
-                                    int seed = 12345);
+                                    int seed = 12345, bool randomize = true);
 };
 
 }
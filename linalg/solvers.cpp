@@ -67,6 +67,55 @@ double IterativeSolver::Dot(const Vector &x, const Vector &y) const
 #endif
 }
 
+void IterativeSolver::Dots(int n, const Vector *const *x, int p,
+                           const Vector *const *y, double *d) const
+{
+   for (int j = 0; j < p; j++)
+   {
+      for (int i = 0; i < n; i++) { d[i+n*j] = (*x[i]) * (*y[j]); }
+   }
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0 && n*p > 0)
+   {
+      MPI_Allreduce(MPI_IN_PLACE, d, n*p, MPI_DOUBLE, MPI_SUM, comm);
+   }
+#endif
+}
+
+double IterativeSolver::Orthogonalize(Orthogonalization type, int n,
+                                      const Vector *const *v, Vector &w,
+                                      double *h) const
+{
+   if (type == Orthogonalization::MGS)
+   {
+      for (int k = 0; k < n; k++)
+      {
+         h[k] = Dot(w, *v[k]);
+         w.Add(-h[k], *v[k]);
+      }
+      return Norm(w);
+   }
+
+   // CGS2: the norm of w is computed with the second projection, and
+   // ||w - V c||^2 = ||w||^2 - ||c||^2 since V is orthonormal.
+   Array<const Vector*> vw(n+1);
+   for (int k = 0; k < n; k++) { vw[k] = v[k]; }
+   vw[n] = &w;
+   Vector c(n+1);
+   Dots(n, v, w, h);
+   for (int k = 0; k < n; k++) { w.Add(-h[k], *v[k]); }
+   Dots(n+1, vw.GetData(), w, c.GetData());
+   double c2 = 0.0;
+   for (int k = 0; k < n; k++)
+   {
+      w.Add(-c(k), *v[k]);
+      h[k] += c(k);
+      c2 += c(k)*c(k);
+   }
+   // Recompute the norm when the update above is inaccurate.
+   return (c2 <= 0.5*c(n)) ? sqrt(c(n) - c2) : Norm(w);
+}
+
 void IterativeSolver::SetPrintLevel(int print_lvl)
 {
 #ifndef MFEM_USE_MPI
@@ -179,44 +228,71 @@ void OperatorJacobiSmoother::Mult(const Vector &x, Vector &y) const
    MFEM_FORALL(i, N, Y[i] += DI[i] * R[i]; );
 }
 
+#ifdef MFEM_USE_MPI
 OperatorChebyshevSmoother::OperatorChebyshevSmoother(Operator* oper_,
                                                      const Vector &d,
                                                      const Array<int>& ess_tdofs,
-                                                     int order_, double max_eig_estimate_)
+                                                     int order_,
+                                                     double max_eig_estimate_,
+                                                     MPI_Comm comm_)
+#else
+OperatorChebyshevSmoother::OperatorChebyshevSmoother(Operator* oper_,
+                                                     const Vector &d,
+                                                     const Array<int>& ess_tdofs,
+                                                     int order_,
+                                                     double max_eig_estimate_)
+#endif
    :
    Solver(d.Size()),
    order(order_),
    max_eig_estimate(max_eig_estimate_),
    N(d.Size()),
+   kind(Kind::FIRST),
    dinv(N),
    diag(d),
-   coeffs(order),
    ess_tdof_list(ess_tdofs),
    residual(N),
-   oper(oper_) { Setup(); }
+   oper(oper_)
+#ifdef MFEM_USE_MPI
+   , comm(comm_)
+#endif
+{ Setup(); }
 
 #ifdef MFEM_USE_MPI
 OperatorChebyshevSmoother::OperatorChebyshevSmoother(Operator* oper_,
                                                      const Vector &d,
                                                      const Array<int>& ess_tdofs,
-                                                     int order_, MPI_Comm comm, int power_iterations, double power_tolerance)
+                                                     int order_, MPI_Comm comm_,
+                                                     int power_iterations,
+                                                     double power_tolerance)
 #else
 OperatorChebyshevSmoother::OperatorChebyshevSmoother(Operator* oper_,
                                                      const Vector &d,
                                                      const Array<int>& ess_tdofs,
-                                                     int order_, int power_iterations, double power_tolerance)
+                                                     int order_,
+                                                     int power_iterations,
+                                                     double power_tolerance)
 #endif
    : Solver(d.Size()),
      order(order_),
      N(d.Size()),
+     kind(Kind::FIRST),
      dinv(N),
      diag(d),
-     coeffs(order),
      ess_tdof_list(ess_tdofs),
      residual(N),
      oper(oper_)
+#ifdef MFEM_USE_MPI
+   , comm(comm_)
+#endif
+{
+   EstimateMaxEigenvalue(power_iterations, power_tolerance);
+}
+
+void OperatorChebyshevSmoother::EstimateMaxEigenvalue(int power_iterations,
+                                                      double power_tolerance)
 {
-   OperatorJacobiSmoother invDiagOperator(diag, ess_tdofs, 1.0);
+   OperatorJacobiSmoother invDiagOperator(diag, ess_tdof_list, 1.0);
    ProductOperator diagPrecond(&invDiagOperator, oper, false, false);
 
 #ifdef MFEM_USE_MPI
@@ -224,15 +300,19 @@ OperatorChebyshevSmoother::OperatorChebyshevSmoother(Operator* oper_,
 #else
    PowerMethod powerMethod;
 #endif
-   Vector ev(oper->Width());
-   max_eig_estimate = powerMethod.EstimateLargestEigenvalue(diagPrecond, ev,
-                                                            power_iterations, power_tolerance);
+   const bool warm_start = (eigenvector.Size() == oper->Width());
+   eigenvector.SetSize(oper->Width());
+   max_eig_estimate = powerMethod.EstimateLargestEigenvalue(
+                         diagPrecond, eigenvector, power_iterations,
+                         power_tolerance, 12345, !warm_start);
 
    Setup();
 }
 
 void OperatorChebyshevSmoother::Setup()
 {
+   MFEM_VERIFY(order >= 1, "invalid Chebyshev order = " << order);
+
    // Invert diagonal
    residual.UseDevice(true);
    auto D = diag.Read();
@@ -241,70 +321,40 @@ void OperatorChebyshevSmoother::Setup()
    auto I = ess_tdof_list.Read();
    MFEM_FORALL(i, ess_tdof_list.Size(), X[I[i]] = 1.0; );
 
-   // Set up Chebyshev coefficients
-   // For reference, see e.g., Parallel multigrid smoothing: polynomial versus
-   // Gauss-Seidel by Adams et al.
+   // Set up the coefficients of the recurrence
+   // d_k = alpha_k d_{k-1} + beta_k D^{-1} r_k, x_k = x_{k-1} + d_k.
+   alpha.SetSize(order);
+   beta.SetSize(order);
+   alpha[0] = 0.0;
    double upper_bound = 1.2 * max_eig_estimate;
-   double lower_bound = 0.3 * max_eig_estimate;
-   double theta = 0.5 * (upper_bound + lower_bound);
-   double delta = 0.5 * (upper_bound - lower_bound);
-
-   switch (order-1)
-   {
-      case 0:
+   if (kind == Kind::FIRST)
+   {
+      // Chebyshev iteration, see e.g. Saad, Iterative Methods for Sparse
+      // Linear Systems, Algorithm 12.1, and for the bounds Parallel multigrid
+      // smoothing: polynomial versus Gauss-Seidel by Adams et al.
+      double lower_bound = 0.3 * max_eig_estimate;
+      double theta = 0.5 * (upper_bound + lower_bound);
+      double delta = 0.5 * (upper_bound - lower_bound);
+      double sigma = theta / delta;
+      double rho = 1.0 / sigma;
+      beta[0] = 1.0 / theta;
+      for (int k = 1; k < order; k++)
       {
-         coeffs[0] = 1.0 / theta;
-         break;
-      }
-      case 1:
-      {
-         double tmp_0 = 1.0/(pow(delta, 2) - 2*pow(theta, 2));
-         coeffs[0] = -4*theta*tmp_0;
-         coeffs[1] = 2*tmp_0;
-         break;
+         double rho_new = 1.0 / (2.0 * sigma - rho);
+         alpha[k] = rho_new * rho;
+         beta[k] = 2.0 * rho_new / delta;
+         rho = rho_new;
       }
-      case 2:
-      {
-         double tmp_0 = 3*pow(delta, 2);
-         double tmp_1 = pow(theta, 2);
-         double tmp_2 = 1.0/(-4*pow(theta, 3) + theta*tmp_0);
-         coeffs[0] = tmp_2*(tmp_0 - 12*tmp_1);
-         coeffs[1] = 12/(tmp_0 - 4*tmp_1);
-         coeffs[2] = -4*tmp_2;
-         break;
-      }
-      case 3:
+   }
+   else
+   {
+      // See Lottes, Optimal polynomial smoothers for multigrid V-cycles, 2022.
+      beta[0] = 4.0 / (3.0 * upper_bound);
+      for (int k = 1; k < order; k++)
       {
-         double tmp_0 = pow(delta, 2);
-         double tmp_1 = pow(theta, 2);
-         double tmp_2 = 8*tmp_0;
-         double tmp_3 = 1.0/(pow(delta, 4) + 8*pow(theta, 4) - tmp_1*tmp_2);
-         coeffs[0] = tmp_3*(32*pow(theta, 3) - 16*theta*tmp_0);
-         coeffs[1] = tmp_3*(-48*tmp_1 + tmp_2);
-         coeffs[2] = 32*theta*tmp_3;
-         coeffs[3] = -8*tmp_3;
-         break;
-      }
-      case 4:
-      {
-         double tmp_0 = 5*pow(delta, 4);
-         double tmp_1 = pow(theta, 4);
-         double tmp_2 = pow(theta, 2);
-         double tmp_3 = pow(delta, 2);
-         double tmp_4 = 60*tmp_3;
-         double tmp_5 = 20*tmp_3;
-         double tmp_6 = 1.0/(16*pow(theta, 5) - pow(theta, 3)*tmp_5 + theta*tmp_0);
-         double tmp_7 = 160*tmp_2;
-         double tmp_8 = 1.0/(tmp_0 + 16*tmp_1 - tmp_2*tmp_5);
-         coeffs[0] = tmp_6*(tmp_0 + 80*tmp_1 - tmp_2*tmp_4);
-         coeffs[1] = tmp_8*(tmp_4 - tmp_7);
-         coeffs[2] = tmp_6*(-tmp_5 + tmp_7);
-         coeffs[3] = -80*tmp_8;
-         coeffs[4] = 16*tmp_6;
-         break;
+         alpha[k] = (2.0 * k - 1.0) / (2.0 * k + 3.0);
+         beta[k] = (8.0 * k + 4.0) / ((2.0 * k + 3.0) * upper_bound);
       }
-      default:
-         MFEM_ABORT("Chebyshev smoother not implemented for order = " << order);
    }
 }
 
@@ -322,29 +372,43 @@ void OperatorChebyshevSmoother::Mult(const Vector& x, Vector &y) const
 
    residual = x;
    helperVector.SetSize(x.Size());
-
+   direction.SetSize(x.Size());
+   helperVector.UseDevice(true);
+   direction.UseDevice(true);
    y.UseDevice(true);
-   y = 0.0;
 
-   for (int k = 0; k < order; ++k)
+   // First step, with x_0 = 0: y = d_0 = beta_0 D^{-1} r_0
+   const int n = N;
+   auto Dinv = dinv.Read();
    {
-      // Apply
-      if (k > 0)
+      const double b = beta[0];
+      auto R = residual.Read();
+      auto Dir = direction.Write();
+      auto Y = y.Write();
+      MFEM_FORALL(i, n,
       {
-         oper->Mult(residual, helperVector);
-         residual = helperVector;
-      }
+         Dir[i] = b * Dinv[i] * R[i];
+         Y[i] = Dir[i];
+      });
+   }
 
-      // Scale residual by inverse diagonal
-      const int n = N;
-      auto Dinv = dinv.Read();
-      auto R = residual.ReadWrite();
-      MFEM_FORALL(i, n, R[i] *= Dinv[i]; );
+   for (int k = 1; k < order; ++k)
+   {
+      // Apply
+      oper->Mult(direction, helperVector);
 
-      // Add weighted contribution to y
+      // Fused update of the residual, the direction and y
+      const double a = alpha[k], b = beta[k];
+      auto AD = helperVector.Read();
+      auto R = residual.ReadWrite();
+      auto Dir = direction.ReadWrite();
       auto Y = y.ReadWrite();
-      auto C = coeffs.Read();
-      MFEM_FORALL(i, n, Y[i] += C[k] * R[i]; );
+      MFEM_FORALL(i, n,
+      {
+         R[i] -= AD[i];
+         Dir[i] = a * Dir[i] + b * Dinv[i] * R[i];
+         Y[i] += Dir[i];
+      });
    }
 }
 
@@ -745,6 +809,399 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
 }
 
 
+// Delete the vectors of @a v and set its size to zero.
+static void DeleteVectors(Array<Vector*> &v)
+{
+   for (int i = 0; i < v.Size(); i++) { delete v[i]; }
+   v.SetSize(0);
+}
+
+// Orthonormalize the columns of Y with modified Gram-Schmidt, repeated twice,
+// in the inner product given by the SPD matrix F, or in the Euclidean one if F
+// is NULL. Columns that are numerically dependent on the previous ones are
+// removed. Returns the number of remaining columns.
+static int OrthonormalizeColumns(DenseMatrix &Y, const DenseMatrix *F = NULL)
+{
+   const int n = Y.Height();
+   Vector yj(n);
+   int rank = 0;
+   for (int j = 0; j < Y.Width(); j++)
+   {
+      Y.GetColumn(j, yj);
+      const double nrm0 = sqrt(F ? F->InnerProduct(yj, yj) : yj*yj);
+      for (int pass = 0; pass < 2; pass++)
+      {
+         for (int i = 0; i < rank; i++)
+         {
+            Vector yi(Y.GetColumn(i), n);
+            yj.Add(-(F ? F->InnerProduct(yi, yj) : yi*yj), yi);
+         }
+      }
+      const double nrm = sqrt(F ? F->InnerProduct(yj, yj) : yj*yj);
+      if (nrm <= 1e-10*nrm0 || nrm == 0.0) { continue; }
+      yj /= nrm;
+      Y.SetCol(rank++, yj);
+   }
+   Y.SetSize(n, rank);
+   return rank;
+}
+
+// Compute in the columns of Y an orthonormal basis of the invariant subspace
+// of G^{-1} F associated with its k eigenvalues of largest modulus, using
+// orthogonal iteration. The subspace is real, also when some of these
+// eigenvalues are complex.
+static void DominantSubspace(const DenseMatrix &G, const DenseMatrix &F,
+                             int k, DenseMatrix &Y)
+{
+   const int n = G.Height();
+   DenseMatrix S(n), SY, YtSY;
+   DenseMatrixInverse(G).Mult(F, S);
+
+   Y.SetSize(n, k);
+   Vector y(n);
+   for (int j = 0; j < k; j++)
+   {
+      y.Randomize(j + 1);
+      Y.SetCol(j, y);
+   }
+   OrthonormalizeColumns(Y);
+
+   for (int it = 0; it < 200; it++)
+   {
+      SY.SetSize(n, Y.Width());
+      YtSY.SetSize(Y.Width());
+      Mult(S, Y, SY);
+      // Stop when the subspace is (nearly) invariant: S Y = Y (Y^t S Y).
+      MultAtB(Y, SY, YtSY);
+      const double nrm = SY.FNorm();
+      AddMult_a(-1.0, Y, YtSY, SY);
+      if (SY.FNorm() <= 1e-10*nrm) { break; }
+      AddMult(Y, YtSY, SY);
+      Y = SY;
+      OrthonormalizeColumns(Y);
+   }
+}
+
+void DeflatedCGSolver::ClearRecycleSpace()
+{
+   DeleteVectors(W);
+   DeleteVectors(AW);
+   GW.SetSize(0);
+}
+
+void DeflatedCGSolver::RefreshRecycleSpace() const
+{
+   refresh = false;
+   const int kw = W.Size();
+   for (int i = 0; i < kw; i++) { oper->Mult(*W[i], *AW[i]); }
+
+   // A-orthonormalize W with classical Gram-Schmidt, repeated twice, and
+   // remove the dependent vectors.
+   Vector c(kw);
+   int rank = 0;
+   for (int j = 0; j < kw; j++)
+   {
+      const double nrm0 = Dot(*W[j], *AW[j]);
+      for (int pass = 0; pass < 2; pass++)
+      {
+         Dots(rank, W.GetData(), *AW[j], c.GetData());
+         for (int i = 0; i < rank; i++)
+         {
+            W[j]->Add(-c(i), *W[i]);
+            AW[j]->Add(-c(i), *AW[i]);
+         }
+      }
+      const double nrm = Dot(*W[j], *AW[j]);
+      if (nrm <= 1e-20*nrm0) { continue; }
+      *W[j] /= sqrt(nrm);
+      *AW[j] /= sqrt(nrm);
+      std::swap(W[rank], W[j]);
+      std::swap(AW[rank], AW[j]);
+      rank++;
+   }
+   for (int j = rank; j < kw; j++)
+   {
+      delete W[j];
+      delete AW[j];
+   }
+   W.SetSize(rank);
+   AW.SetSize(rank);
+
+   // GW = (A W)^t B A W
+   Vector BAw(width);
+   GW.SetSize(rank);
+   for (int j = 0; j < rank; j++)
+   {
+      if (prec) { prec->Mult(*AW[j], BAw); }
+      else { BAw = *AW[j]; }
+      Dots(rank, AW.GetData(), BAw, GW.GetColumn(j));
+   }
+   GW.Symmetrize();
+}
+
+void DeflatedCGSolver::UpdateRecycleSpace() const
+{
+   const int kw = W.Size(), m = P.Size(), q = kw + m;
+   if (k <= 0 || m == 0)
+   {
+      DeleteVectors(P);
+      DeleteVectors(AP);
+      alpha_p.SetSize(0);
+      rho_p.SetSize(0);
+      return;
+   }
+
+   // Ritz vectors of B A in span(V), V = [W, P], with respect to the
+   // A-inner product, with the smallest Ritz values: G y = theta y, where
+   // G = (A V)^t B A V since V^t A V = I. With the unscaled directions d_j,
+   // A d_j = (r_j - r_{j+1}) / alpha_j, B A d_j = (z_j - z_{j+1}) / alpha_j
+   // and (z_i, r_j) = rho_j delta_ij, so the P-P block of G is tridiagonal
+   // and given by the CG coefficients, and the W-P block by the products
+   // (A W)^t z_j of the iteration, see Saad et al., SISC 2000.
+   DenseMatrix G(q), F, Y;
+   G = 0.0;
+   G.CopyMN(GW, 0, 0);
+   for (int j = 0; j < m; j++)
+   {
+      // the scaling of the j-th direction is alpha_j sqrt(d_j^t A d_j)
+      const double sj = sqrt(alpha_p[j]*rho_p[j]);
+      G(kw+j,kw+j) = (rho_p[j] + rho_p[j+1])/(alpha_p[j]*rho_p[j]);
+      if (j+1 < m)
+      {
+         G(kw+j,kw+j+1) = G(kw+j+1,kw+j) =
+                             -rho_p[j+1]/(sj*sqrt(alpha_p[j+1]*rho_p[j+1]));
+      }
+      for (int i = 0; i < kw; i++)
+      {
+         G(i,kw+j) = G(kw+j,i) = (CZ(i,j) - CZ(i,j+1))/sj;
+      }
+   }
+   F.Diag(1.0, q);
+   DominantSubspace(G, F, std::min(k, q), Y);
+   const int kn = OrthonormalizeColumns(Y);
+   DenseMatrix GY(q, kn);
+   mfem::Mult(G, Y, GY);
+   GW.SetSize(kn);
+   MultAtB(Y, GY, GW);
+
+   Array<Vector*> V(W), AV(AW);
+   V.Append(P);
+   AV.Append(AP);
+   Array<Vector*> W_new(kn), AW_new(kn);
+   for (int j = 0; j < kn; j++)
+   {
+      W_new[j] = new Vector(width);
+      AW_new[j] = new Vector(width);
+      *W_new[j] = 0.0;
+      *AW_new[j] = 0.0;
+      for (int i = 0; i < q; i++)
+      {
+         W_new[j]->Add(Y(i,j), *V[i]);
+         AW_new[j]->Add(Y(i,j), *AV[i]);
+      }
+   }
+   DeleteVectors(V);
+   DeleteVectors(AV);
+   P.SetSize(0);
+   AP.SetSize(0);
+   alpha_p.SetSize(0);
+   rho_p.SetSize(0);
+   W = W_new;
+   AW = AW_new;
+}
+
+void DeflatedCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   if (refresh) { RefreshRecycleSpace(); }
+
+   const int kw = W.Size();
+   Vector c(kw), Ad(width);
+   double r0, nom, nom0, betanom, alpha, beta, den;
+   int nc = 0; // number of computed columns of CZ
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+
+   // Deflated initial guess: x = x + W W^t r, r = r - A W W^t r
+   Dots(kw, W.GetData(), r, c.GetData());
+   for (int i = 0; i < kw; i++)
+   {
+      x.Add(c(i), *W[i]);
+      r.Add(-c(i), *AW[i]);
+   }
+
+   if (prec)
+   {
+      prec->Mult(r, z); // z = B r
+   }
+   else
+   {
+      z = r;
+   }
+   // d = z - W (A W)^t z
+   d = z;
+   Dots(kw, AW.GetData(), z, c.GetData());
+   for (int i = 0; i < kw; i++) { d.Add(-c(i), *W[i]); }
+   if (k > 0 && nh > 0)
+   {
+      CZ.SetSize(kw, nh+1);
+      CZ.SetCol(nc++, c);
+   }
+
+   nom0 = nom = betanom = Dot(z, r);
+   MFEM_ASSERT(IsFinite(nom), "nom = " << nom);
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                << nom << (print_level == 3 ? " ...\n" : "\n");
+   }
+   Monitor(0, nom, r, x);
+
+   if (nom < 0.0)
+   {
+      if (print_level >= 0)
+      {
+         mfem::out << "DCG: The preconditioner is not positive definite. "
+                   << "(Br, r) = " << nom << '\n';
+      }
+      converged = 0;
+      final_iter = 0;
+      final_norm = nom;
+      return;
+   }
+   r0 = std::max(nom*rel_tol*rel_tol, abs_tol*abs_tol);
+   if (nom <= r0)
+   {
+      converged = 1;
+      final_iter = 0;
+      final_norm = sqrt(nom);
+      return;
+   }
+
+   // start iteration
+   converged = 0;
+   final_iter = max_iter;
+   for (int i = 1; true; )
+   {
+      oper->Mult(d, Ad);        //  Ad = A d
+      den = Dot(d, Ad);
+      MFEM_ASSERT(IsFinite(den), "den = " << den);
+      if (den <= 0.0)
+      {
+         if (Dot(d, d) > 0.0 && print_level >= 0)
+         {
+            mfem::out << "DCG: The operator is not positive definite. "
+                      << "(Ad, d) = " << den << '\n';
+         }
+         final_iter = i - 1;
+         break;
+      }
+      alpha = nom/den;
+      add(x,  alpha, d, x);     //  x = x + alpha d
+      add(r, -alpha, Ad, r);    //  r = r - alpha A d
+      if (prec)
+      {
+         prec->Mult(r, z);      //  z = B r
+      }
+      else
+      {
+         z = r;
+      }
+
+      betanom = Dot(r, z);
+      MFEM_ASSERT(IsFinite(betanom), "betanom = " << betanom);
+
+      // Keep the first search directions, A-normalized, and their CG
+      // coefficients to update the deflation space.
+      if (k > 0 && P.Size() < nh)
+      {
+         P.Append(new Vector(width));
+         AP.Append(new Vector(width));
+         P.Last()->Set(1.0/sqrt(den), d);
+         AP.Last()->Set(1.0/sqrt(den), Ad);
+         if (rho_p.Size() == 0) { rho_p.Append(nom); }
+         alpha_p.Append(alpha);
+         rho_p.Append(betanom);
+      }
+      if (betanom < 0.0)
+      {
+         if (print_level >= 0)
+         {
+            mfem::out << "DCG: The preconditioner is not positive definite. "
+                      << "(Br, r) = " << betanom << '\n';
+         }
+         final_iter = i;
+         break;
+      }
+
+      if (print_level == 1)
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << betanom << '\n';
+      }
+
+      Monitor(i, betanom, r, x);
+
+      if (betanom <= r0)
+      {
+         if (print_level == 2)
+         {
+            mfem::out << "Number of DCG iterations: " << i << '\n';
+         }
+         else if (print_level == 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                      << betanom << '\n';
+         }
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+
+      if (++i > max_iter)
+      {
+         break;
+      }
+
+      // d = z + beta d - W (A W)^t z
+      beta = betanom/nom;
+      Dots(kw, AW.GetData(), z, c.GetData());
+      if (nc > 0 && nc <= P.Size()) { CZ.SetCol(nc++, c); }
+      add(z, beta, d, d);
+      for (int j = 0; j < kw; j++) { d.Add(-c(j), *W[j]); }
+      nom = betanom;
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "DCG: No convergence!" << '\n';
+   }
+   if (print_level >= 1 || (print_level >= 0 && !converged))
+   {
+      mfem::out << "Average reduction factor = "
+                << pow (betanom/nom0, 0.5/final_iter) << '\n';
+   }
+   final_norm = sqrt(betanom);
+
+   Monitor(final_iter, final_norm, r, x, true);
+
+   // (A W)^t z after the last harvested step, if the iteration stopped there
+   if (nc == P.Size() && nc > 0)
+   {
+      Dots(kw, AW.GetData(), z, c.GetData());
+      CZ.SetCol(nc++, c);
+   }
+   UpdateRecycleSpace();
+}
+
+
 inline void GeneratePlaneRotation(double &dx, double &dy,
                                   double &cs, double &sn)
 {
@@ -884,13 +1341,8 @@ void GMRESSolver::Mult(const Vector &b, Vector &x) const
             oper->Mult(*v[i], w);
          }
 
-         for (k = 0; k <= i; k++)
-         {
-            H(k,i) = Dot(w, *v[k]);  // H(k,i) = w * v[k]
-            w.Add(-H(k,i), *v[k]);   // w -= H(k,i) * v[k]
-         }
-
-         H(i+1,i) = Norm(w);           // H(i+1,i) = ||w||
+         // H(k,i) = w * v[k], w -= H(k,i) * v[k], H(i+1,i) = ||w||
+         H(i+1,i) = Orthogonalize(orth, i+1, v.GetData(), w, H.GetColumn(i));
          MFEM_ASSERT(IsFinite(H(i+1,i)), "Norm(w) = " << H(i+1,i));
          if (v[i+1] == NULL) { v[i+1] = new Vector(n); }
          v[i+1]->Set(1.0/H(i+1,i), w); // v[i+1] = w / H(i+1,i)
@@ -1055,13 +1507,8 @@ void FGMRESSolver::Mult(const Vector &b, Vector &x) const
          }
          oper->Mult(*z[i], r);
 
-         for (k = 0; k <= i; k++)
-         {
-            H(k,i) = Dot( r, *v[k]); // H(k,i) = r * v[k]
-            r.Add(-H(k,i), (*v[k])); // r -= H(k,i) * v[k]
-         }
-
-         H(i+1,i)  = Norm(r);       // H(i+1,i) = ||r||
+         // H(k,i) = r * v[k], r -= H(k,i) * v[k], H(i+1,i) = ||r||
+         H(i+1,i) = Orthogonalize(orth, i+1, v.GetData(), r, H.GetColumn(i));
          if (v[i+1] == NULL) { v[i+1] = new Vector(b.Size()); }
          (*v[i+1]) = 0.0;
          v[i+1] -> Add (1.0/H(i+1,i), r); // v[i+1] = r / H(i+1,i)
@@ -1153,6 +1600,576 @@ void FGMRESSolver::Mult(const Vector &b, Vector &x) const
 }
 
 
+// Householder QR factorization of the m x n matrix A. On exit, A holds the
+// thin factor Q and R the n x n factor R. If m < n, the last n - m columns of
+// Q and rows of R are zero.
+static void HouseholderQR(DenseMatrix &A, DenseMatrix &R)
+{
+   const int m = A.Height(), n = A.Width(), p = std::min(m, n);
+   Vector tau(p);
+   for (int j = 0; j < p; j++)
+   {
+      double *a = A.GetColumn(j);
+      double xn2 = 0.0;
+      for (int i = j+1; i < m; i++) { xn2 += a[i]*a[i]; }
+      if (xn2 == 0.0) { tau(j) = 0.0; continue; }
+      const double alpha = a[j], nrm = sqrt(alpha*alpha + xn2);
+      const double beta = (alpha >= 0.0) ? -nrm : nrm;
+      tau(j) = (beta - alpha)/beta;
+      for (int i = j+1; i < m; i++) { a[i] /= (alpha - beta); }
+      a[j] = beta;
+      // apply I - tau v v^t, with v = [1; a(j+1:m)], to the next columns
+      for (int k = j+1; k < n; k++)
+      {
+         double *b = A.GetColumn(k);
+         double dot = b[j];
+         for (int i = j+1; i < m; i++) { dot += a[i]*b[i]; }
+         dot *= tau(j);
+         b[j] -= dot;
+         for (int i = j+1; i < m; i++) { b[i] -= dot*a[i]; }
+      }
+   }
+
+   R.SetSize(n);
+   R = 0.0;
+   for (int j = 0; j < n; j++)
+   {
+      for (int i = 0; i <= std::min(j, p-1); i++) { R(i,j) = A(i,j); }
+   }
+
+   DenseMatrix Q(m, n);
+   Q = 0.0;
+   for (int j = 0; j < p; j++) { Q(j,j) = 1.0; }
+   for (int j = p-1; j >= 0; j--)
+   {
+      const double *a = A.GetColumn(j);
+      for (int k = j; k < n; k++)
+      {
+         double *q = Q.GetColumn(k);
+         double dot = q[j];
+         for (int i = j+1; i < m; i++) { dot += a[i]*q[i]; }
+         dot *= tau(j);
+         q[j] -= dot;
+         for (int i = j+1; i < m; i++) { q[i] -= dot*a[i]; }
+      }
+   }
+   A = Q;
+}
+
+void CAGMRESSolver::TSQR(int n, Vector *const *w, DenseMatrix &R) const
+{
+   const int nl = w[0]->Size();
+   DenseMatrix Q(nl, n);
+   for (int l = 0; l < n; l++) { Vector(Q.GetColumn(l), nl) = *w[l]; }
+   HouseholderQR(Q, R);
+
+#ifdef MFEM_USE_MPI
+   // Gather the local R factors and factor their stack on all ranks. The
+   // local Q is then multiplied by the block of this rank in the Q of the
+   // stack.
+   MPI_Comm comm = GetComm();
+   if (comm != MPI_COMM_NULL)
+   {
+      int rank, nranks;
+      MPI_Comm_rank(comm, &rank);
+      MPI_Comm_size(comm, &nranks);
+      Array<double> Rs(n*n*nranks);
+      MPI_Allgather(R.Data(), n*n, MPI_DOUBLE, Rs.GetData(), n*n, MPI_DOUBLE,
+                    comm);
+      DenseMatrix S(n*nranks, n);
+      for (int p = 0; p < nranks; p++)
+      {
+         for (int j = 0; j < n; j++)
+         {
+            for (int i = 0; i < n; i++) { S(p*n+i,j) = Rs[p*n*n+i+n*j]; }
+         }
+      }
+      HouseholderQR(S, R);
+      DenseMatrix Qs(n), Ql(Q);
+      for (int j = 0; j < n; j++)
+      {
+         for (int i = 0; i < n; i++) { Qs(i,j) = S(rank*n+i,j); }
+      }
+      mfem::Mult(Ql, Qs, Q);
+   }
+#endif
+
+   for (int l = 0; l < n; l++) { *w[l] = Vector(Q.GetColumn(l), nl); }
+}
+
+void CAGMRESSolver::Mult(const Vector &b, Vector &x) const
+{
+   const int n = width;
+
+   // Hu is the Hessenberg matrix of the Arnoldi relation, H its rotated copy
+   DenseMatrix Hu(m+1, m), H(m+1, m), C, C2, Rn, X;
+   Vector sv(m+1), cs(m+1), sn(m+1);
+   Vector r(n), w(n);
+   Array<Vector *> v(m+1);
+   for (int i = 0; i <= m; i++) { v[i] = new Vector(n); }
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, w);
+   }
+   else
+   {
+      x = 0.0;
+      w = b;
+   }
+   if (prec)
+   {
+      prec->Mult(w, r);    // r = M (b - A x)
+   }
+   else
+   {
+      r = w;
+   }
+   double beta = Norm(r);  // beta = ||r||
+   MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+
+   const double tol = std::max(rel_tol*beta, abs_tol);
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  ||B r|| = " << beta
+                << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   Monitor(0, beta, r, x);
+
+   converged = (beta <= tol);
+   double sigma = 0.0;
+   int j = 0;
+   while (!converged && j < max_iter)
+   {
+      v[0]->Set(1.0/beta, r);
+      sv = 0.0; sv(0) = beta;
+      Hu = 0.0;
+
+      // i is the index of the last basis vector
+      int i = 0;
+      while (i < m && j < max_iter)
+      {
+         const int sb = std::min(s, std::min(m - i, max_iter - j));
+
+         // Scaled monomial basis: v[i+l+1] = M A v[i+l] / sigma
+         for (int l = 0; l < sb; l++)
+         {
+            if (prec)
+            {
+               oper->Mult(*v[i+l], w);
+               prec->Mult(w, *v[i+l+1]);
+            }
+            else
+            {
+               oper->Mult(*v[i+l], *v[i+l+1]);
+            }
+            if (sigma == 0.0)
+            {
+               sigma = Norm(*v[1]);
+               if (sigma == 0.0) { sigma = 1.0; }
+            }
+            *v[i+l+1] /= sigma;
+         }
+
+         // Block CGS2 against v[0..i], then TSQR of the block
+         C.SetSize(i+1, sb);
+         C2.SetSize(i+1, sb);
+         Dots(i+1, v.GetData(), sb, v.GetData()+i+1, C.Data());
+         for (int l = 0; l < sb; l++)
+         {
+            for (int k = 0; k <= i; k++) { v[i+l+1]->Add(-C(k,l), *v[k]); }
+         }
+         Dots(i+1, v.GetData(), sb, v.GetData()+i+1, C2.Data());
+         for (int l = 0; l < sb; l++)
+         {
+            for (int k = 0; k <= i; k++) { v[i+l+1]->Add(-C2(k,l), *v[k]); }
+         }
+         C += C2;
+         TSQR(sb, v.GetData()+i+1, Rn);
+
+         // Keep the new vectors up to the first numerically dependent one
+         int nv = 0;
+         for ( ; nv < sb; nv++)
+         {
+            double nrm2 = 0.0;
+            for (int k = 0; k <= i; k++) { nrm2 += C(k,nv)*C(k,nv); }
+            for (int k = 0; k <= nv; k++) { nrm2 += Rn(k,nv)*Rn(k,nv); }
+            if (fabs(Rn(nv,nv)) <= 1e-10*sqrt(nrm2)) { break; }
+         }
+         if (nv == 0) { break; }
+
+         // The basis block is [v_i, Z] = V [R_top; R_bot], with the first
+         // column e_i. From M A [v_i, Z(:,0:nv-2)] = sigma Z(:,0:nv-1) and the
+         // previous Arnoldi relation, M A V(:,i:i+nv-1) R_bot = X with
+         //   X = sigma [C; Rn](:,0:nv-1) - [Hu(0:i,0:i-1) R_top; 0].
+         X.SetSize(i+nv+1, nv);
+         X = 0.0;
+         for (int k = 0; k < nv; k++)
+         {
+            for (int l = 0; l <= i; l++) { X(l,k) = sigma*C(l,k); }
+            for (int l = 0; l <= k; l++) { X(i+1+l,k) = sigma*Rn(l,k); }
+            if (k == 0) { continue; }
+            // R_top(:,k) = C(0:i-1,k-1)
+            for (int p = 0; p < i; p++)
+            {
+               for (int l = 0; l <= p+1; l++)
+               {
+                  X(l,k) -= Hu(l,p)*C(p,k-1);
+               }
+            }
+         }
+         // Hu(:,i:i+nv-1) = X R_bot^{-1}, with R_bot(0,0) = 1, R_bot(0,k) =
+         // C(i,k-1) and R_bot(l,k) = Rn(l-1,k-1) for 1 <= l <= k.
+         for (int k = 0; k < nv; k++)
+         {
+            for (int l = 0; l < k; l++)
+            {
+               const double rlk = (l == 0) ? C(i,k-1) : Rn(l-1,k-1);
+               for (int q = 0; q <= i+nv; q++) { X(q,k) -= X(q,l)*rlk; }
+            }
+            const double rkk = (k == 0) ? 1.0 : Rn(k-1,k-1);
+            for (int q = 0; q <= i+nv; q++) { X(q,k) /= rkk; }
+            for (int q = 0; q <= i+k+1; q++) { Hu(q,i+k) = X(q,k); }
+         }
+
+         for (int c = i; c < i+nv; c++, j++)
+         {
+            for (int q = 0; q <= c+1; q++) { H(q,c) = Hu(q,c); }
+            for (int k = 0; k < c; k++)
+            {
+               ApplyPlaneRotation(H(k,c), H(k+1,c), cs(k), sn(k));
+            }
+            GeneratePlaneRotation(H(c,c), H(c+1,c), cs(c), sn(c));
+            ApplyPlaneRotation(H(c,c), H(c+1,c), cs(c), sn(c));
+            ApplyPlaneRotation(sv(c), sv(c+1), cs(c), sn(c));
+
+            const double resid = fabs(sv(c+1));
+            MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+            if (print_level == 1)
+            {
+               mfem::out << "   Pass : " << setw(2) << j/m+1
+                         << "   Iteration : " << setw(3) << j+1
+                         << "  ||B r|| = " << resid << '\n';
+            }
+            Monitor(j+1, resid, r, x);
+            if (resid <= tol)
+            {
+               // Solve with the first c+1 basis vectors
+               i = c+1;
+               j++;
+               converged = 1;
+               break;
+            }
+         }
+         if (converged) { break; }
+         i += nv;
+      }
+
+      if (i == 0) { break; }
+      Update(x, i-1, H, sv, v);
+
+      oper->Mult(x, r);
+      subtract(b, r, w);
+      if (prec)
+      {
+         prec->Mult(w, r);    // r = M (b - A x)
+      }
+      else
+      {
+         r = w;
+      }
+      beta = Norm(r);         // beta = ||r||
+      MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+      converged = (beta <= tol);
+
+      if (print_level == 1 && !converged && j < max_iter)
+      {
+         mfem::out << "Restarting..." << '\n';
+      }
+   }
+
+   for (int i = 0; i <= m; i++) { delete v[i]; }
+   final_iter = j;
+   final_norm = beta;
+   Monitor(final_iter, final_norm, r, x, true);
+
+   if (print_level == 2 && converged)
+   {
+      mfem::out << "Number of CA-GMRES iterations: " << final_iter << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "CA-GMRES: No convergence!\n";
+   }
+}
+
+void GCRODRSolver::ClearRecycleSpace()
+{
+   DeleteVectors(U);
+   DeleteVectors(C);
+}
+
+void GCRODRSolver::RefreshRecycleSpace() const
+{
+   refresh = false;
+   const int ku = U.Size();
+   for (int i = 0; i < ku; i++) { oper->Mult(*U[i], *C[i]); }
+
+   // Orthonormalize C with classical Gram-Schmidt, repeated twice, applying
+   // the same operations to U, and remove the dependent vectors.
+   Vector c(ku);
+   int rank = 0;
+   for (int j = 0; j < ku; j++)
+   {
+      const double nrm0 = Norm(*C[j]);
+      for (int pass = 0; pass < 2; pass++)
+      {
+         Dots(rank, C.GetData(), *C[j], c.GetData());
+         for (int i = 0; i < rank; i++)
+         {
+            C[j]->Add(-c(i), *C[i]);
+            U[j]->Add(-c(i), *U[i]);
+         }
+      }
+      const double nrm = Norm(*C[j]);
+      if (nrm <= 1e-10*nrm0) { continue; }
+      *C[j] /= nrm;
+      *U[j] /= nrm;
+      std::swap(C[rank], C[j]);
+      std::swap(U[rank], U[j]);
+      rank++;
+   }
+   for (int j = rank; j < ku; j++)
+   {
+      delete C[j];
+      delete U[j];
+   }
+   C.SetSize(rank);
+   U.SetSize(rank);
+}
+
+void GCRODRSolver::UpdateRecycleSpace(int mk, const Array<Vector*> &v,
+                                      const Array<Vector*> &z,
+                                      const DenseMatrix &H,
+                                      const DenseMatrix &B) const
+{
+   const int kc = C.Size(), q = kc + mk;
+   if (k <= 0 || mk == 0) { return; }
+
+   // A [U, Z] = [C, V] G, with G = [I, B; 0, H].
+   Array<Vector*> W(C), Z(U);
+   for (int i = 0; i <= mk; i++) { W.Append(v[i]); }
+   for (int i = 0; i < mk; i++) { Z.Append(z[i]); }
+   DenseMatrix G(q+1, q);
+   G = 0.0;
+   for (int i = 0; i < kc; i++) { G(i,i) = 1.0; }
+   for (int j = 0; j < mk; j++)
+   {
+      for (int i = 0; i < kc; i++) { G(i,kc+j) = B(i,j); }
+      for (int i = 0; i <= std::min(j+1, mk); i++) { G(kc+i,kc+j) = H(i,j); }
+   }
+   DenseMatrix WtZ(q+1, q);
+   for (int j = 0; j < q; j++)
+   {
+      Dots(q+1, W.GetData(), *Z[j], WtZ.GetColumn(j));
+   }
+
+   // Harmonic Ritz vectors with the smallest harmonic Ritz values:
+   // G^t G p = theta G^t [C, V]^t [U, Z] p.
+   DenseMatrix GtG(q), GtWtZ(q), P;
+   MultAtB(G, G, GtG);
+   MultAtB(G, WtZ, GtWtZ);
+   DominantSubspace(GtG, GtWtZ, std::min(k, q), P);
+   const int kn = OrthonormalizeColumns(P, &GtG);
+   DenseMatrix GP(q+1, kn);
+   mfem::Mult(G, P, GP);
+
+   Array<Vector*> U_new(kn), C_new(kn);
+   for (int j = 0; j < kn; j++)
+   {
+      U_new[j] = new Vector(width);
+      C_new[j] = new Vector(width);
+      *U_new[j] = 0.0;
+      *C_new[j] = 0.0;
+      for (int i = 0; i < q; i++) { U_new[j]->Add(P(i,j), *Z[i]); }
+      for (int i = 0; i <= q; i++) { C_new[j]->Add(GP(i,j), *W[i]); }
+   }
+   DeleteVectors(U);
+   DeleteVectors(C);
+   U = U_new;
+   C = C_new;
+}
+
+void GCRODRSolver::Mult(const Vector &b, Vector &x) const
+{
+   if (refresh) { RefreshRecycleSpace(); }
+
+   DenseMatrix H(m+1, m), Hbar(m+1, m), B;
+   Vector s(m+1), cs(m+1), sn(m+1), c, y;
+   Vector r(b.Size());
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r);
+   }
+   else
+   {
+      x = 0.;
+      r = b;
+   }
+   double beta = Norm(r);  // beta = ||r||
+   MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+
+   const double tol = std::max(rel_tol*beta, abs_tol);
+
+   if (print_level == 1)
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  || r || = " << beta << endl;
+   }
+
+   Monitor(0, beta, r, x);
+
+   Array<Vector*> v(m+1), z(m+1);
+   for (int i = 0; i <= m; i++)
+   {
+      v[i] = new Vector(b.Size());
+      z[i] = new Vector(b.Size());
+   }
+
+   converged = 0;
+   int j = 0, pass = 1;
+   while (true)
+   {
+      // Correct the solution in the recycled space:
+      // x = x + U C^t r, r = r - C C^t r
+      const int kc = C.Size();
+      if (kc > 0)
+      {
+         c.SetSize(kc);
+         Dots(kc, C.GetData(), r, c.GetData());
+         for (int i = 0; i < kc; i++)
+         {
+            x.Add(c(i), *U[i]);
+            r.Add(-c(i), *C[i]);
+         }
+         beta = Norm(r);
+      }
+      if (beta <= tol) { converged = 1; break; }
+      if (j >= max_iter) { break; }
+
+      // Arnoldi process for (I - C C^t) A B
+      B.SetSize(kc, m);
+      H = 0.0;
+      Hbar = 0.0;
+      (*v[0]).Set(1.0/beta, r);   // v[0] = r / ||r||
+      s = 0.0; s(0) = beta;
+      int i = 0;
+      while (i < m && j < max_iter)
+      {
+         if (prec)
+         {
+            prec->Mult(*v[i], *z[i]);
+         }
+         else
+         {
+            (*z[i]) = (*v[i]);
+         }
+         oper->Mult(*z[i], r);
+
+         Dots(kc, C.GetData(), r, B.GetColumn(i));
+         for (int l = 0; l < kc; l++) { r.Add(-B(l,i), *C[l]); }
+         for (int l = 0; l <= i; l++)
+         {
+            H(l,i) = Dot(r, *v[l]); // H(l,i) = r * v[l]
+            r.Add(-H(l,i), *v[l]);  // r -= H(l,i) * v[l]
+         }
+         H(i+1,i) = Norm(r);        // H(i+1,i) = ||r||
+         if (H(i+1,i) > 0.0) { (*v[i+1]).Set(1.0/H(i+1,i), r); }
+         else { (*v[i+1]) = 0.0; }
+         for (int l = 0; l <= i+1; l++) { Hbar(l,i) = H(l,i); }
+
+         for (int l = 0; l < i; l++)
+         {
+            ApplyPlaneRotation(H(l,i), H(l+1,i), cs(l), sn(l));
+         }
+         GeneratePlaneRotation(H(i,i), H(i+1,i), cs(i), sn(i));
+         ApplyPlaneRotation(H(i,i), H(i+1,i), cs(i), sn(i));
+         ApplyPlaneRotation(s(i), s(i+1), cs(i), sn(i));
+         i++, j++;
+
+         const double resid = fabs(s(i));
+         MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+         if (print_level == 1)
+         {
+            mfem::out << "   Pass : " << setw(2) << pass
+                      << "   Iteration : " << setw(3) << j
+                      << "  || r || = " << resid << endl;
+         }
+         Monitor(j, resid, r, x);
+
+         if (resid <= tol || Hbar(i,i-1) == 0.0) { break; }
+      }
+
+      // x = x + Z y - U B y, with y minimizing || s - H y ||
+      y.SetSize(i);
+      for (int l = i-1; l >= 0; l--)
+      {
+         y(l) = s(l);
+         for (int p = l+1; p < i; p++) { y(l) -= H(l,p)*y(p); }
+         y(l) /= H(l,l);
+      }
+      for (int l = 0; l < i; l++) { x.Add(y(l), *z[l]); }
+      if (kc > 0)
+      {
+         B.SetSize(kc, i);
+         c.SetSize(kc);
+         B.Mult(y, c);
+         for (int l = 0; l < kc; l++) { x.Add(-c(l), *U[l]); }
+      }
+
+      UpdateRecycleSpace(i, v, z, Hbar, B);
+
+      oper->Mult(x, r);
+      subtract(b, r, r);
+      beta = Norm(r);
+      MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+      if (beta <= tol) { converged = 1; break; }
+
+      if (print_level == 1)
+      {
+         mfem::out << "Restarting..." << endl;
+      }
+      pass++;
+   }
+
+   for (int i = 0; i <= m; i++)
+   {
+      delete v[i];
+      delete z[i];
+   }
+   final_iter = j;
+   final_norm = beta;
+   Monitor(final_iter, final_norm, r, x, true);
+
+   if (print_level == 2 && converged)
+   {
+      mfem::out << "Number of GCRO-DR iterations: " << final_iter << endl;
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "GCRO-DR: No convergence!" << endl;
+   }
+}
+
+
 int GMRES(const Operator &A, Vector &x, const Vector &b, Solver &M,
           int &max_iter, int m, double &tol, double atol, int printit)
 {
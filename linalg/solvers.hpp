@@ -84,9 +84,32 @@ protected:
 
    double Dot(const Vector &x, const Vector &y) const;
    double Norm(const Vector &x) const { return sqrt(Dot(x, x)); }
+   /** @brief Compute the @a n x @a p inner products @a d[i+n*j] = (@a x[i],
+       @a y[j]) with a single global reduction. */
+   void Dots(int n, const Vector *const *x, int p, const Vector *const *y,
+             double *d) const;
+   /** @brief Compute the @a n inner products @a d[i] = (@a x[i], @a y) with a
+       single global reduction. */
+   void Dots(int n, const Vector *const *x, const Vector &y, double *d) const
+   { const Vector *yp = &y; Dots(n, x, 1, &yp, d); }
    void Monitor(int it, double norm, const Vector& r, const Vector& x,
                 bool final=false) const;
 
+public:
+   /// Gram-Schmidt variants used to orthogonalize Krylov bases.
+   enum class Orthogonalization
+   {
+      MGS, ///< Modified Gram-Schmidt, one global reduction per basis vector
+      CGS2 ///< Classical Gram-Schmidt with reorthogonalization, two reductions
+   };
+
+protected:
+   /** @brief Orthogonalize @a w against the orthonormal vectors @a v[0..n-1]
+       with the Gram-Schmidt variant @a type. The coefficients are returned in
+       @a h[0..n-1] and the norm of the orthogonalized @a w is returned. */
+   double Orthogonalize(Orthogonalization type, int n, const Vector *const *v,
+                        Vector &w, double *h) const;
+
 public:
    IterativeSolver();
 
@@ -168,15 +191,30 @@ private:
 class OperatorChebyshevSmoother : public Solver
 {
 public:
+   /// Kind of the Chebyshev polynomials, see SetKind().
+   enum class Kind
+   {
+      FIRST,  ///< First kind, on [0.3, 1.2] times the eigenvalue estimate
+      FOURTH  ///< Fourth kind, on [0, 1.2] times the eigenvalue estimate
+   };
+
    /** Application is by *inverse* of the given vector. It is assumed the
        underlying operator acts as the identity on entries in ess_tdof_list,
        corresponding to (assembled) DIAG_ONE policy or ConstrainedOperator in
        the matrix-free setting. The estimated largest eigenvalue of the
        diagonally preconditoned operator must be provided via
-       max_eig_estimate. */
+       max_eig_estimate. In parallel, the communicator @a comm is needed only
+       to update the estimate later with EstimateMaxEigenvalue(). */
+#ifdef MFEM_USE_MPI
+   OperatorChebyshevSmoother(Operator* oper_, const Vector &d,
+                             const Array<int>& ess_tdof_list,
+                             int order, double max_eig_estimate,
+                             MPI_Comm comm = MPI_COMM_NULL);
+#else
    OperatorChebyshevSmoother(Operator* oper_, const Vector &d,
                              const Array<int>& ess_tdof_list,
                              int order, double max_eig_estimate);
+#endif
 
    /** Application is by *inverse* of the given vector. It is assumed the
        underlying operator acts as the identity on entries in ess_tdof_list,
@@ -188,12 +226,14 @@ public:
 #ifdef MFEM_USE_MPI
    OperatorChebyshevSmoother(Operator* oper_, const Vector &d,
                              const Array<int>& ess_tdof_list,
-                             int order, MPI_Comm comm = MPI_COMM_NULL, int power_iterations = 10,
+                             int order, MPI_Comm comm = MPI_COMM_NULL,
+                             int power_iterations = 10,
                              double power_tolerance = 1e-8);
 #else
    OperatorChebyshevSmoother(Operator* oper_, const Vector &d,
                              const Array<int>& ess_tdof_list,
-                             int order, int power_iterations = 10, double power_tolerance = 1e-8);
+                             int order, int power_iterations = 10,
+                             double power_tolerance = 1e-8);
 #endif
 
    ~OperatorChebyshevSmoother() {}
@@ -202,24 +242,59 @@ public:
 
    void MultTranspose(const Vector &x, Vector &y) const { Mult(x, y); }
 
+   /** The eigenvalue estimate is not updated, see EstimateMaxEigenvalue() and
+       SetMaxEigenvalueEstimate(). */
    void SetOperator(const Operator &op_)
    {
       oper = &op_;
    }
 
+   /** Compute the inverse of the diagonal and the coefficients of the
+       recurrence, e.g. after the diagonal has changed. */
    void Setup();
 
+   /** @brief Set the kind of the Chebyshev polynomials, Kind::FIRST by
+       default. The fourth kind polynomials (Lottes, 2022) do not use a lower
+       bound of the spectrum and give a better smoothing factor per operator
+       application. */
+   void SetKind(Kind kind_) { kind = kind_; Setup(); }
+
+   /// Return the estimate of the largest eigenvalue of D^{-1} A.
+   double GetMaxEigenvalueEstimate() const { return max_eig_estimate; }
+
+   /** @brief Set the estimate of the largest eigenvalue of D^{-1} A, e.g. from
+       another smoother for a similar operator, and update the coefficients. */
+   void SetMaxEigenvalueEstimate(double max_eig)
+   { max_eig_estimate = max_eig; Setup(); }
+
+   /** @brief Update the estimate of the largest eigenvalue of D^{-1} A for the
+       current operator and diagonal with the power method.
+
+       The iteration starts from the eigenvector of the previous estimate, so
+       that the estimate of a slowly changing operator, e.g. during time
+       stepping, is updated in a few iterations. In parallel, the smoother
+       must have been constructed with a communicator. */
+   void EstimateMaxEigenvalue(int power_iterations = 10,
+                              double power_tolerance = 1e-8);
+
 private:
    const int order;
    double max_eig_estimate;
    const int N;
+   Kind kind;
    Vector dinv;
    const Vector &diag;
-   Array<double> coeffs;
+   // Coefficients of the recurrence d_k = alpha_k d_{k-1} + beta_k D^{-1} r_k.
+   Array<double> alpha, beta;
    const Array<int>& ess_tdof_list;
    mutable Vector residual;
    mutable Vector helperVector;
+   mutable Vector direction;
    const Operator* oper;
+   Vector eigenvector;
+#ifdef MFEM_USE_MPI
+   MPI_Comm comm;
+#endif
 };
 
 
@@ -287,22 +362,110 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
          double RTOLERANCE = 1e-12, double ATOLERANCE = 1e-24);
 
 
+/** @brief Deflated conjugate gradient method, recycling the deflation space
+    across successive solves.
+
+    The deflation space W, of dimension at most SetRecycleDim(), approximates
+    the eigenvectors of B A (B is the preconditioner) with the smallest
+    eigenvalues. At each solve, the initial guess is corrected in W and the
+    search directions are kept A-orthogonal to W, see Saad et al., A deflated
+    version of the conjugate gradient algorithm, SISC 2000. The first
+    SetHarvestDim() search directions of the solve are then combined with W and
+    the new W is given by the Ritz vectors of B A in this space with respect to
+    the A-inner product. The Ritz problem is assembled from the CG coefficients
+    and the products (A W)^t B r of the iteration, without additional
+    applications of A or B and with at most one additional global reduction
+    (of SetRecycleDim() inner products). Besides W
+    and A W, the solver stores the harvested directions and their products
+    with A, i.e. 2 x (SetRecycleDim() + SetHarvestDim()) vectors, and forming
+    the new W costs 2 x SetRecycleDim() x (SetRecycleDim() + SetHarvestDim())
+    vector updates per solve.
+
+    The products A W and (A W)^t B A W are recomputed when SetOperator() or
+    SetPreconditioner() is called, e.g. at each Newton iteration or time step
+    with a new operator. */
+class DeflatedCGSolver : public CGSolver
+{
+protected:
+   int k, nh;
+   mutable bool refresh;
+   // Deflation space, with W^t A W = I, the product A W and the Ritz matrix
+   // GW = (A W)^t B A W.
+   mutable Array<Vector*> W, AW;
+   mutable DenseMatrix GW;
+   // Search directions of the current solve, scaled so that P^t A P = I, and
+   // A P. For the j-th direction, alpha_p[j] is its CG step size,
+   // rho_p[j] = (B r, r) and the column j of CZ is (A W)^t B r, with r the
+   // residual before the step; rho_p and CZ have one more entry, for the
+   // residual after the last harvested step.
+   mutable Array<Vector*> P, AP;
+   mutable Array<double> alpha_p, rho_p;
+   mutable DenseMatrix CZ;
+
+   /// Compute A W and GW, and make W A-orthonormal.
+   void RefreshRecycleSpace() const;
+
+   /// Update W from the space spanned by W and P.
+   void UpdateRecycleSpace() const;
+
+public:
+   DeflatedCGSolver() : k(8), nh(32), refresh(false) { }
+
+#ifdef MFEM_USE_MPI
+   DeflatedCGSolver(MPI_Comm _comm)
+      : CGSolver(_comm), k(8), nh(32), refresh(false) { }
+#endif
+
+   /** @brief Set the maximum dimension of the deflation space, default is 8.
+       The number of harvested search directions is set to 4 x @a dim. */
+   void SetRecycleDim(int dim) { k = dim; nh = 4*dim; }
+
+   /// Set the number of search directions harvested in each solve.
+   void SetHarvestDim(int dim) { nh = dim; }
+
+   /// Return the current dimension of the deflation space.
+   int GetRecycleDim() const { return W.Size(); }
+
+   /// Discard the deflation space.
+   void ClearRecycleSpace();
+
+   virtual void SetOperator(const Operator &op)
+   { CGSolver::SetOperator(op); refresh = true; }
+
+   /// The products B A W of the deflation space are updated in the next Mult.
+   virtual void SetPreconditioner(Solver &pr)
+   { CGSolver::SetPreconditioner(pr); refresh = true; }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   virtual ~DeflatedCGSolver() { ClearRecycleSpace(); }
+};
+
+
 /// GMRES method
 class GMRESSolver : public IterativeSolver
 {
 protected:
    int m; // see SetKDim()
+   Orthogonalization orth; // see SetOrthogonalization()
 
 public:
-   GMRESSolver() { m = 50; }
+   GMRESSolver() { m = 50; orth = Orthogonalization::MGS; }
 
 #ifdef MFEM_USE_MPI
-   GMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm) { m = 50; }
+   GMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm)
+   { m = 50; orth = Orthogonalization::MGS; }
 #endif
 
    /// Set the number of iteration to perform between restarts, default is 50.
    void SetKDim(int dim) { m = dim; }
 
+   /** @brief Set the Gram-Schmidt variant of the Arnoldi process, default is
+       Orthogonalization::MGS. With Orthogonalization::CGS2, each iteration
+       needs two global reductions instead of i + 2 at iteration i, which is
+       faster when the reductions are latency bound. */
+   void SetOrthogonalization(Orthogonalization type) { orth = type; }
+
    virtual void Mult(const Vector &b, Vector &x) const;
 };
 
@@ -311,17 +474,122 @@ class FGMRESSolver : public IterativeSolver
 {
 protected:
    int m;
+   Orthogonalization orth;
+
+public:
+   FGMRESSolver() { m = 50; orth = Orthogonalization::MGS; }
+
+#ifdef MFEM_USE_MPI
+   FGMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm)
+   { m = 50; orth = Orthogonalization::MGS; }
+#endif
+
+   void SetKDim(int dim) { m = dim; }
+
+   /// See GMRESSolver::SetOrthogonalization().
+   void SetOrthogonalization(Orthogonalization type) { orth = type; }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+/** @brief Communication-avoiding s-step GMRES (CA-GMRES).
+
+    The Krylov basis of each restart cycle is built in blocks of s =
+    SetStepSize() vectors. A block computes the scaled monomial basis
+    (M A) v / sigma, ..., ((M A) / sigma)^s v from the last basis vector v with
+    no global communication besides the one in A and M, orthogonalizes it
+    against the previous basis with block classical Gram-Schmidt and
+    reorthogonalization, and orthonormalizes it with the tall skinny QR
+    factorization (TSQR). The Hessenberg matrix is then recovered from the QR
+    factors, see M. Hoemmen, Communication-avoiding Krylov subspace methods,
+    PhD thesis, 2010. A block of s iterations uses three global reductions,
+    while GMRESSolver uses O(s k) of them at iteration k.
+
+    As in GMRESSolver, the preconditioner M is applied on the left. The
+    monomial basis quickly becomes ill-conditioned with s, so s should stay
+    small; numerically dependent basis vectors are dropped. */
+class CAGMRESSolver : public IterativeSolver
+{
+protected:
+   int m, s;
+
+   /** @brief Replace the @a n vectors @a w with an orthonormal basis of their
+       span, computed with TSQR, and return the R factor in @a R. */
+   void TSQR(int n, Vector *const *w, DenseMatrix &R) const;
+
+public:
+   CAGMRESSolver() : m(50), s(4) { }
+
+#ifdef MFEM_USE_MPI
+   CAGMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm), m(50), s(4) { }
+#endif
+
+   /// Set the number of iteration to perform between restarts, default is 50.
+   void SetKDim(int dim) { m = dim; }
+
+   /// Set the number of basis vectors computed per block, default is 4.
+   void SetStepSize(int step) { s = step; }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+/** @brief GCRO-DR method: flexible GMRES with deflated restarting, recycling
+    a subspace across restarts and successive solves.
+
+    The recycled space U, of dimension at most SetRecycleDim(), is kept with
+    C = A U orthonormal. Each restart cycle corrects the solution in U and
+    runs m = SetKDim() Arnoldi steps of (I - C C^t) A B, see Parks et al.,
+    Recycling Krylov subspaces for sequences of linear systems, SISC 2006.
+    After each cycle, U is replaced by the harmonic Ritz space of A in the span
+    of U and the cycle's preconditioned Krylov vectors, without additional
+    applications of A or B. The harmonic Ritz space is computed in real
+    arithmetic with orthogonal iteration, so no eigensolver is needed.
+
+    The product C = A U is recomputed when SetOperator() is called, e.g. at
+    each Newton iteration or time step with a new operator. */
+class GCRODRSolver : public IterativeSolver
+{
+protected:
+   int m, k;
+   mutable bool refresh;
+   mutable Array<Vector*> U, C;
+
+   /// Compute C = A U and make it orthonormal.
+   void RefreshRecycleSpace() const;
+
+   /** @brief Update U and C from the last cycle with @a mk Arnoldi steps,
+       the Arnoldi vectors @a v, the preconditioned vectors @a z, the
+       Hessenberg matrix @a H and the projections @a B = C^t A z. */
+   void UpdateRecycleSpace(int mk, const Array<Vector*> &v,
+                           const Array<Vector*> &z, const DenseMatrix &H,
+                           const DenseMatrix &B) const;
 
 public:
-   FGMRESSolver() { m = 50; }
+   GCRODRSolver() : m(50), k(10), refresh(false) { }
 
 #ifdef MFEM_USE_MPI
-   FGMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm) { m = 50; }
+   GCRODRSolver(MPI_Comm _comm)
+      : IterativeSolver(_comm), m(50), k(10), refresh(false) { }
 #endif
 
+   /// Set the number of iteration to perform between restarts, default is 50.
    void SetKDim(int dim) { m = dim; }
 
+   /// Set the maximum dimension of the recycled space, default is 10.
+   void SetRecycleDim(int dim) { k = dim; }
+
+   /// Return the current dimension of the recycled space.
+   int GetRecycleDim() const { return U.Size(); }
+
+   /// Discard the recycled space.
+   void ClearRecycleSpace();
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); refresh = true; }
+
    virtual void Mult(const Vector &b, Vector &x) const;
+
+   virtual ~GCRODRSolver() { ClearRecycleSpace(); }
 };
 
 /// GMRES method. (tolerances are squared)
@@ -19,6 +19,7 @@
 #include "../general/device.hpp"
 #include "../general/tic_toc.hpp"
 #include "../general/gecko.hpp"
+#include "../general/forall.hpp"
 #include "../fem/quadinterpolator.hpp"
 
 #include <iostream>
@@ -5851,6 +5852,20 @@ int *Mesh::CartesianPartitioning(int nxyz[])
 }
 
 int *Mesh::GeneratePartitioning(int nparts, int part_method)
+{
+   return GeneratePartitioning(nparts, NULL, part_method);
+}
+
+int *Mesh::GeneratePartitioning(int nparts, const Vector &elem_weights,
+                                int part_method)
+{
+   MFEM_VERIFY(elem_weights.Size() == NumOfElements,
+               "the size of the weights vector must be equal to GetNE()");
+   return GeneratePartitioning(nparts, &elem_weights, part_method);
+}
+
+int *Mesh::GeneratePartitioning(int nparts, const Vector *elem_weights,
+                                int part_method)
 {
 #ifdef MFEM_USE_METIS
 
@@ -5890,9 +5905,9 @@ int *Mesh::GeneratePartitioning(int nparts, int part_method)
    }
    else
    {
-      idx_t *I, *J, n;
+      idx_t *I, *J, n, *vwgt = NULL;
 #ifndef MFEM_USE_METIS_5
-      idx_t wgtflag = 0;
+      idx_t wgtflag = elem_weights ? 2 : 0;
       idx_t numflag = 0;
       idx_t options[5];
 #else
@@ -5926,6 +5941,27 @@ int *Mesh::GeneratePartitioning(int nparts, int part_method)
          mpartitioning = new idx_t[n];
          freedata = true;
       }
+      if (elem_weights)
+      {
+         // METIS needs positive integer vertex weights: scale the given
+         // weights so that the largest one maps to 1000, while keeping the
+         // total weight within the range of idx_t.
+         const double *w = elem_weights->GetData();
+         double wmax = 0.0, wsum = 0.0;
+         for (int k = 0; k < n; k++)
+         {
+            MFEM_VERIFY(w[k] >= 0.0, "element weights must be non-negative");
+            wmax = std::max(wmax, w[k]);
+            wsum += w[k];
+         }
+         const double scale = (wmax > 0.0) ?
+                              std::min(1000.0/wmax, 1e9/wsum) : 0.0;
+         vwgt = new idx_t[n];
+         for (int k = 0; k < n; k++)
+         {
+            vwgt[k] = std::max((idx_t) 1, (idx_t) std::floor(scale*w[k] + 0.5));
+         }
+      }
 #ifndef MFEM_USE_METIS_5
       options[0] = 0;
 #else
@@ -5954,7 +5990,7 @@ int *Mesh::GeneratePartitioning(int nparts, int part_method)
          METIS_PartGraphRecursive(&n,
                                   I,
                                   J,
-                                  NULL,
+                                  vwgt,
                                   NULL,
                                   &wgtflag,
                                   &numflag,
@@ -5967,7 +6003,7 @@ int *Mesh::GeneratePartitioning(int nparts, int part_method)
                                         &ncon,
                                         I,
                                         J,
-                                        NULL,
+                                        vwgt,
                                         NULL,
                                         NULL,
                                         &mparts,
@@ -5992,7 +6028,7 @@ int *Mesh::GeneratePartitioning(int nparts, int part_method)
          METIS_PartGraphKway(&n,
                              I,
                              J,
-                             NULL,
+                             vwgt,
                              NULL,
                              &wgtflag,
                              &numflag,
@@ -6005,7 +6041,7 @@ int *Mesh::GeneratePartitioning(int nparts, int part_method)
                                    &ncon,
                                    I,
                                    J,
-                                   NULL,
+                                   vwgt,
                                    NULL,
                                    NULL,
                                    &mparts,
@@ -6030,7 +6066,7 @@ int *Mesh::GeneratePartitioning(int nparts, int part_method)
          METIS_PartGraphVKway(&n,
                               I,
                               J,
-                              NULL,
+                              vwgt,
                               NULL,
                               &wgtflag,
                               &numflag,
@@ -6044,7 +6080,7 @@ int *Mesh::GeneratePartitioning(int nparts, int part_method)
                                    &ncon,
                                    I,
                                    J,
-                                   NULL,
+                                   vwgt,
                                    NULL,
                                    NULL,
                                    &mparts,
@@ -6076,6 +6112,7 @@ int *Mesh::GeneratePartitioning(int nparts, int part_method)
             partitioning[k] = mpartitioning[k];
          }
       }
+      delete [] vwgt;
       if (freedata)
       {
          delete[] I;
@@ -6167,6 +6204,8 @@ int *Mesh::GeneratePartitioning(int nparts, int part_method)
 
 #else
 
+   MFEM_VERIFY(elem_weights == NULL, "Mesh::GeneratePartitioning(...): "
+               "element weights require MFEM to be compiled with Metis.");
    mfem_error("Mesh::GeneratePartitioning(...): "
               "MFEM was compiled without Metis.");
 
@@ -6175,6 +6214,38 @@ int *Mesh::GeneratePartitioning(int nparts, int part_method)
 #endif
 }
 
+double Mesh::PrintPartitionBalance(const int *partitioning, int nparts,
+                                  const Vector *elem_weights,
+                                  std::ostream &out) const
+{
+   MFEM_VERIFY(!elem_weights || elem_weights->Size() == NumOfElements,
+               "the size of the weights vector must be equal to GetNE()");
+
+   Vector load(nparts);
+   Array<int> count(nparts);
+   load = 0.0;
+   count = 0;
+   for (int i = 0; i < NumOfElements; i++)
+   {
+      const int p = partitioning[i];
+      MFEM_ASSERT(0 <= p && p < nparts, "invalid partitioning");
+      load(p) += elem_weights ? (*elem_weights)(i) : 1.0;
+      count[p]++;
+   }
+
+   const double avg = load.Sum() / nparts;
+   const double imbalance = (avg > 0.0) ? load.Max() / avg : 1.0;
+
+   out << "Partition balance (" << nparts << " parts):\n"
+       << "   elements per part  min / max : " << count.Min() << " / "
+       << count.Max() << '\n'
+       << "   load per part min / avg / max : " << load.Min() << " / " << avg
+       << " / " << load.Max() << '\n'
+       << "   imbalance (max / avg)         : " << imbalance << endl;
+
+   return imbalance;
+}
+
 /* required: 0 <= partitioning[i] < num_part */
 void FindPartitioningComponents(Table &elem_elem,
                                 const Array<int> &partitioning,
@@ -8945,6 +9016,347 @@ void Mesh::Printer(std::ostream &out, std::string section_delimiter) const
    }
 }
 
+Mesh::RefinedVertices::RefinedVertices(const Mesh &m,
+                                       const FiniteElementCollection &c)
+   : mesh(m), fec(c)
+{
+   const int dim = mesh.Dimension();
+   nvdofs = mesh.GetNV();
+   nedofs = (dim > 1) ?
+            mesh.GetNEdges()*fec.DofForGeometry(Geometry::SEGMENT) : 0;
+   nfdofs = 0;
+   if (dim == 3)
+   {
+      fdofs.SetSize(mesh.GetNFaces()+1);
+      fdofs[0] = 0;
+      for (int i = 0; i < mesh.GetNFaces(); i++)
+      {
+         const Geometry::Type geom = mesh.GetFaceBaseGeometry(i);
+         fdofs[i+1] = fdofs[i] + fec.DofForGeometry(geom);
+      }
+      nfdofs = fdofs.Last();
+   }
+   bdofs.SetSize(mesh.GetNE()+1);
+   bdofs[0] = 0;
+   for (int i = 0; i < mesh.GetNE(); i++)
+   {
+      bdofs[i+1] = bdofs[i] +
+                   fec.DofForGeometry(mesh.GetElementBaseGeometry(i));
+   }
+   nbdofs = bdofs.Last();
+}
+
+int Mesh::RefinedVertices::EdgeOffset(int i) const
+{
+   return nvdofs + i*fec.DofForGeometry(Geometry::SEGMENT);
+}
+
+void Mesh::RefinedVertices::AddEdges(const Array<int> &edges,
+                                     const Array<int> &ori,
+                                     Array<int> &rv) const
+{
+   const int ne = fec.DofForGeometry(Geometry::SEGMENT);
+   for (int k = 0; k < edges.Size(); k++)
+   {
+      const int *ind = fec.DofOrderForOrientation(Geometry::SEGMENT, ori[k]);
+      for (int j = 0; j < ne; j++)
+      {
+         rv.Append(EdgeOffset(edges[k]) + ind[j]);
+      }
+   }
+}
+
+void Mesh::RefinedVertices::AddFace(int face, int ori, Array<int> &rv) const
+{
+   const Geometry::Type geom = mesh.GetFaceBaseGeometry(face);
+   const int nf = fec.DofForGeometry(geom);
+   const int *ind = (nf > 0) ? fec.DofOrderForOrientation(geom, ori) : NULL;
+   for (int j = 0; j < nf; j++)
+   {
+      rv.Append(FaceOffset(face) + ind[j]);
+   }
+}
+
+void Mesh::RefinedVertices::GetElementVertices(int i, Array<int> &rv) const
+{
+   Array<int> E, Eo, F, Fo;
+   const int dim = mesh.Dimension();
+
+   mesh.GetElementVertices(i, rv);
+   if (dim > 1)
+   {
+      mesh.GetElementEdges(i, E, Eo);
+      AddEdges(E, Eo, rv);
+   }
+   if (dim == 3)
+   {
+      mesh.GetElementFaces(i, F, Fo);
+      for (int k = 0; k < F.Size(); k++) { AddFace(F[k], Fo[k], rv); }
+   }
+   for (int j = bdofs[i]; j < bdofs[i+1]; j++)
+   {
+      rv.Append(nvdofs + nedofs + nfdofs + j);
+   }
+}
+
+void Mesh::RefinedVertices::GetBdrElementVertices(int i, Array<int> &rv) const
+{
+   Array<int> E, Eo;
+   const int dim = mesh.Dimension();
+
+   mesh.GetBdrElementVertices(i, rv);
+   if (dim > 1)
+   {
+      mesh.GetBdrElementEdges(i, E, Eo);
+      AddEdges(E, Eo, rv);
+   }
+   if (dim == 3)
+   {
+      int face, ori;
+      mesh.GetBdrElementFace(i, &face, &ori);
+      AddFace(face, ori, rv);
+   }
+}
+
+void Mesh::RefinedVertices::GetEdgeVertices(int i, Array<int> &rv) const
+{
+   const int ne = fec.DofForGeometry(Geometry::SEGMENT);
+   mesh.GetEdgeVertices(i, rv);
+   for (int j = 0; j < ne; j++) { rv.Append(EdgeOffset(i) + j); }
+}
+
+void Mesh::RefinedVertices::GetFaceVertices(int i, Array<int> &rv) const
+{
+   Array<int> E, Eo;
+   mesh.GetFaceVertices(i, rv);
+   mesh.GetFaceEdges(i, E, Eo);
+   AddEdges(E, Eo, rv);
+   AddFace(i, 0, rv);
+}
+
+void Mesh::RefinedVertices::GetEntityVertices(int i, Geometry::Type geom,
+                                              const int *v, int ori,
+                                              Array<int> &rv) const
+{
+   const int nv = Geometry::NumVerts[geom];
+   rv.SetSize(0);
+   rv.Append(v, nv);
+   Array<int> E(1), Eo(1);
+   if (geom == Geometry::SEGMENT)
+   {
+      E[0] = i;
+      Eo[0] = ori;
+      AddEdges(E, Eo, rv);
+      return;
+   }
+   // the k-th edge of a triangle or a quadrilateral goes from v[k] to
+   // v[(k+1)%nv]; find it among the edges of the face
+   Array<int> fe, feo, ev;
+   mesh.GetFaceEdges(i, fe, feo);
+   E.SetSize(nv);
+   Eo.SetSize(nv);
+   for (int k = 0; k < nv; k++)
+   {
+      const int a = v[k], b = v[(k+1)%nv];
+      for (int j = 0; j < fe.Size(); j++)
+      {
+         mesh.GetEdgeVertices(fe[j], ev);
+         if ((ev[0] == a && ev[1] == b) || (ev[0] == b && ev[1] == a))
+         {
+            E[k] = fe[j];
+            Eo[k] = (ev[0] == a) ? 1 : -1;
+            break;
+         }
+      }
+   }
+   AddEdges(E, Eo, rv);
+   AddFace(i, ori, rv);
+}
+
+void Mesh::RefinedPrinter(std::ostream &out, int ref_factor, int ref_type,
+                          std::string section_delimiter)
+{
+   MFEM_VERIFY(ref_factor >= 1, "the refinement factor must be >= 1");
+   MFEM_VERIFY(ref_type == BasisType::ClosedUniform ||
+               ref_type == BasisType::GaussLobatto, "invalid refinement type");
+   MFEM_VERIFY(!NURBSext && Conforming(),
+               "only conforming, non-NURBS meshes are supported");
+
+   // The refined vertices are the dofs of an H1 space of order ref_factor,
+   // see Mesh(Mesh*, int, int), numbered without constructing the space.
+   H1_FECollection rfec(ref_factor, Dim, ref_type);
+   RefinedVertices rvert(*this, rfec);
+   Array<int> rv;
+
+   // count the refined elements and boundary elements
+   long num_elem = 0, num_bdr = 0;
+   for (int i = 0; i < NumOfElements; i++)
+   {
+      const Geometry::Type geom = GetElementBaseGeometry(i);
+      RefinedGeometry &RG = *GlobGeometryRefiner.Refine(geom, ref_factor);
+      num_elem += RG.RefGeoms.Size()/Geometry::NumVerts[geom];
+   }
+   for (int i = 0; i < NumOfBdrElements; i++)
+   {
+      const Geometry::Type geom = GetBdrElementBaseGeometry(i);
+      RefinedGeometry &RG = *GlobGeometryRefiner.Refine(geom, ref_factor);
+      num_bdr += RG.RefGeoms.Size()/Geometry::NumVerts[geom];
+   }
+
+   out << (section_delimiter.empty()
+           ? "MFEM mesh v1.0\n" : "MFEM mesh v1.2\n");
+
+   // optional
+   out <<
+       "\n#\n# MFEM Geometry Types (see mesh/geom.hpp):\n#\n"
+       "# POINT       = 0\n"
+       "# SEGMENT     = 1\n"
+       "# TRIANGLE    = 2\n"
+       "# SQUARE      = 3\n"
+       "# TETRAHEDRON = 4\n"
+       "# CUBE        = 5\n"
+       "# PRISM       = 6\n"
+       "#\n";
+
+   out << "\ndimension\n" << Dim;
+
+   out << "\n\nelements\n" << num_elem << '\n';
+   for (int i = 0; i < NumOfElements; i++)
+   {
+      const Geometry::Type geom = GetElementBaseGeometry(i);
+      const int nvert = Geometry::NumVerts[geom];
+      RefinedGeometry &RG = *GlobGeometryRefiner.Refine(geom, ref_factor);
+      const int *c2h_map = rfec.GetDofMap(geom);
+
+      rvert.GetElementVertices(i, rv);
+      MFEM_ASSERT(rv.Size() == RG.RefPts.Size(), "");
+      for (int j = 0; j < RG.RefGeoms.Size(); j += nvert)
+      {
+         out << GetAttribute(i) << ' ' << geom;
+         for (int k = 0; k < nvert; k++)
+         {
+            out << ' ' << rv[c2h_map[RG.RefGeoms[j+k]]];
+         }
+         out << '\n';
+      }
+   }
+
+   out << "\nboundary\n" << num_bdr << '\n';
+   for (int i = 0; i < NumOfBdrElements; i++)
+   {
+      const Geometry::Type geom = GetBdrElementBaseGeometry(i);
+      const int nvert = Geometry::NumVerts[geom];
+      RefinedGeometry &RG = *GlobGeometryRefiner.Refine(geom, ref_factor);
+      // in 1D the boundary elements are points, which don't have a DofMap
+      const int *c2h_map = (Dim > 1) ? rfec.GetDofMap(geom) : NULL;
+
+      rvert.GetBdrElementVertices(i, rv);
+      for (int j = 0; j < RG.RefGeoms.Size(); j += nvert)
+      {
+         out << GetBdrAttribute(i) << ' ' << geom;
+         for (int k = 0; k < nvert; k++)
+         {
+            const int cid = RG.RefGeoms[j+k]; // local Cartesian index
+            out << ' ' << rv[c2h_map ? c2h_map[cid] : cid];
+         }
+         out << '\n';
+      }
+   }
+
+   // The coordinates of the refined vertices are computed with the
+   // transformation of an element containing the corresponding coarse
+   // vertex, edge, face or element, in the order of the refined numbering.
+   Array<int> vert_elem(NumOfVertices), edge_elem(Dim > 1 ? NumOfEdges : 0);
+   vert_elem = -1;
+   edge_elem = -1;
+   {
+      Array<int> V, E, Eo;
+      for (int i = 0; i < NumOfElements; i++)
+      {
+         GetElementVertices(i, V);
+         for (int k = 0; k < V.Size(); k++)
+         {
+            if (vert_elem[V[k]] < 0) { vert_elem[V[k]] = i; }
+         }
+         if (Dim > 1)
+         {
+            GetElementEdges(i, E, Eo);
+            for (int k = 0; k < E.Size(); k++)
+            {
+               if (edge_elem[E[k]] < 0) { edge_elem[E[k]] = i; }
+            }
+         }
+      }
+   }
+
+   IntegrationRule ir;
+   DenseMatrix pts;
+   auto print_vertices = [&](int el, int first, int num)
+   {
+      if (num == 0) { return; }
+      const Geometry::Type geom = GetElementBaseGeometry(el);
+      const IntegrationRule &nodes =
+         rfec.FiniteElementForGeometry(geom)->GetNodes();
+      rvert.GetElementVertices(el, rv);
+      ir.SetSize(num);
+      for (int k = 0; k < rv.Size(); k++)
+      {
+         if (first <= rv[k] && rv[k] < first + num)
+         {
+            ir.IntPoint(rv[k] - first) = nodes.IntPoint(k);
+         }
+      }
+      GetElementTransformation(el)->Transform(ir, pts);
+      for (int j = 0; j < num; j++)
+      {
+         out << pts(0, j);
+         for (int d = 1; d < spaceDim; d++)
+         {
+            out << ' ' << pts(d, j);
+         }
+         out << '\n';
+      }
+   };
+
+   out << "\nvertices\n" << rvert.GetNV() << '\n';
+   out << spaceDim << '\n';
+   for (int i = 0; i < NumOfVertices; i++)
+   {
+      if (vert_elem[i] >= 0) { print_vertices(vert_elem[i], i, 1); }
+      else
+      {
+         // vertex not connected to any element: write its coordinates as is
+         out << vertices[i](0);
+         for (int d = 1; d < spaceDim; d++) { out << ' ' << vertices[i](d); }
+         out << '\n';
+      }
+   }
+   const int ne = (Dim > 1) ? rfec.DofForGeometry(Geometry::SEGMENT) : 0;
+   for (int i = 0; i < edge_elem.Size(); i++)
+   {
+      print_vertices(edge_elem[i], rvert.EdgeOffset(i), ne);
+   }
+   if (Dim == 3)
+   {
+      for (int i = 0; i < NumOfFaces; i++)
+      {
+         print_vertices(faces_info[i].Elem1No, rvert.FaceOffset(i),
+                        rfec.DofForGeometry(GetFaceBaseGeometry(i)));
+      }
+   }
+   for (int i = 0; i < NumOfElements; i++)
+   {
+      print_vertices(i, rvert.ElementOffset(i),
+                     rfec.DofForGeometry(GetElementBaseGeometry(i)));
+   }
+   out.flush();
+
+   if (!section_delimiter.empty())
+   {
+      out << section_delimiter << endl; // only with format v1.2
+   }
+}
+
 void Mesh::PrintTopo(std::ostream &out,const Array<int> &e_to_k) const
 {
    int i;
@@ -10762,19 +11174,11 @@ GeometricFactors::GeometricFactors(const Mesh *mesh, const IntegrationRule &ir,
    IntRule = &ir;
    computed_factors = flags;
 
-   const GridFunction *nodes = mesh->GetNodes();
-   const FiniteElementSpace *fespace = nodes->FESpace();
-   const FiniteElement *fe = fespace->GetFE(0);
-   const int dim  = fe->GetDim();
-   const int vdim = fespace->GetVDim();
-   const int NE   = fespace->GetNE();
-   const int ND   = fe->GetDof();
+   const int dim  = mesh->Dimension();
+   const int vdim = mesh->SpaceDimension();
+   const int NE   = mesh->GetNE();
    const int NQ   = ir.GetNPoints();
 
-   // For now, we are not using tensor product evaluation
-   const Operator *elem_restr = fespace->GetElementRestriction(
-                                   ElementDofOrdering::NATIVE);
-
    unsigned eval_flags = 0;
    if (flags & GeometricFactors::COORDINATES)
    {
@@ -10791,6 +11195,68 @@ GeometricFactors::GeometricFactors(const Mesh *mesh, const IntegrationRule &ir,
       detJ.SetSize(NQ*NE);
       eval_flags |= QuadratureInterpolator::DETERMINANTS;
    }
+   if (NE == 0) { return; }
+
+   const GridFunction *nodes = mesh->GetNodes();
+   if (nodes == NULL)
+   {
+      // Interpolate the vertex coordinates with the linear transformation
+      // element, as done by the ElementTransformation of meshes without nodes.
+      const FiniteElement *fe =
+         Mesh::GetTransformationFEforElementType(mesh->GetElementType(0));
+      const int ND = fe->GetDof();
+      Vector Enodes(ND*vdim*NE);
+      auto E = Reshape(Enodes.HostWrite(), ND, vdim, NE);
+      Array<int> v;
+      for (int e = 0; e < NE; e++)
+      {
+         mesh->GetElementVertices(e, v);
+         MFEM_ASSERT(v.Size() == ND, "invalid element type");
+         for (int j = 0; j < ND; j++)
+         {
+            const double *x = mesh->GetVertex(v[j]);
+            for (int d = 0; d < vdim; d++) { E(j,d,e) = x[d]; }
+         }
+      }
+      // The transformation elements are shared by all meshes, so the maps
+      // are computed here instead of being cached in the element.
+      const int nqpt = ir.GetNPoints();
+      DofToQuad maps;
+      maps.FE = fe;
+      maps.IntRule = &ir;
+      maps.mode = DofToQuad::FULL;
+      maps.ndof = ND;
+      maps.nqpt = nqpt;
+      maps.B.SetSize(nqpt*ND);
+      maps.G.SetSize(nqpt*dim*ND);
+      Vector shape(ND);
+      DenseMatrix dshape(ND, dim);
+      for (int q = 0; q < nqpt; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         fe->CalcShape(ip, shape);
+         fe->CalcDShape(ip, dshape);
+         for (int j = 0; j < ND; j++)
+         {
+            maps.B[q+nqpt*j] = shape(j);
+            for (int d = 0; d < dim; d++)
+            {
+               maps.G[q+nqpt*(d+dim*j)] = dshape(j,d);
+            }
+         }
+      }
+      QuadratureInterpolator::EvalGeneric(NE, vdim, maps, Enodes, X, J, detJ,
+                                          eval_flags);
+      return;
+   }
+
+   const FiniteElementSpace *fespace = nodes->FESpace();
+   const FiniteElement *fe = fespace->GetFE(0);
+   const int ND   = fe->GetDof();
+
+   // For now, we are not using tensor product evaluation
+   const Operator *elem_restr = fespace->GetElementRestriction(
+                                   ElementDofOrdering::NATIVE);
 
    const QuadratureInterpolator *qi = fespace->GetQuadratureInterpolator(ir);
    // For now, we are not using tensor product evaluation (not implemented)
@@ -38,6 +38,7 @@ class FaceGeometricFactors;
 class KnotVector;
 class NURBSExtension;
 class FiniteElementSpace;
+class FiniteElementCollection;
 class GridFunction;
 struct Refinement;
 
@@ -447,6 +448,56 @@ protected:
    void Printer(std::ostream &out = mfem::out,
                 std::string section_delimiter = "") const;
 
+   /** @brief Numbering of the vertices of the mesh obtained by refining every
+       element of a conforming mesh, see PrintRefined(). */
+   /** The refined vertices are numbered like the dofs of the H1 collection
+       @a fec on the coarse mesh (vertices, then edge, face and element
+       interiors), without constructing an element-to-dof table. */
+   class RefinedVertices
+   {
+   protected:
+      const Mesh &mesh;
+      const FiniteElementCollection &fec;
+      int nvdofs, nedofs, nfdofs, nbdofs;
+      Array<int> fdofs, bdofs;
+
+      void AddEdges(const Array<int> &edges, const Array<int> &ori,
+                    Array<int> &rv) const;
+      void AddFace(int face, int ori, Array<int> &rv) const;
+
+   public:
+      RefinedVertices(const Mesh &mesh, const FiniteElementCollection &fec);
+
+      /// Return the total number of refined vertices.
+      int GetNV() const { return nvdofs + nedofs + nfdofs + nbdofs; }
+
+      /// Offsets of the edge, face and element interior vertices.
+      int EdgeOffset(int i) const;
+      int FaceOffset(int i) const { return nvdofs + nedofs + fdofs[i]; }
+      int ElementOffset(int i) const
+      { return nvdofs + nedofs + nfdofs + bdofs[i]; }
+
+      /** Get the refined vertices of an entity, in the native dof ordering of
+          the corresponding element of the H1 collection. */
+      void GetElementVertices(int i, Array<int> &rv) const;
+      void GetBdrElementVertices(int i, Array<int> &rv) const;
+      void GetEdgeVertices(int i, Array<int> &rv) const;
+      void GetFaceVertices(int i, Array<int> &rv) const;
+
+      /** Get the refined vertices of the edge or face @a i, in the native
+          ordering of the element with vertices @a v (a permutation of the
+          vertices of @a i) having orientation @a ori with respect to @a i,
+          see GetTriOrientation() and GetQuadOrientation(). */
+      void GetEntityVertices(int i, Geometry::Type geom, const int *v,
+                             int ori, Array<int> &rv) const;
+   };
+
+   /** Write the mesh refined with PrintRefined() in the MFEM v1.0 format or,
+       when @a section_delimiter is not empty, in the serial part of the MFEM
+       v1.2 format (see Printer()). */
+   void RefinedPrinter(std::ostream &out, int ref_factor, int ref_type,
+                       std::string section_delimiter = "");
+
    /** Creates mesh for the parallelepiped [0,sx]x[0,sy]x[0,sz], divided into
        nx*ny*nz hexahedra if type=HEXAHEDRON or into 6*nx*ny*nz tetrahedrons if
        type=TETRAHEDRON. The parameter @a sfc_ordering controls how the elements
@@ -481,6 +532,10 @@ protected:
    void GetElementData(const Array<Element*> &elem_array, int geom,
                        Array<int> &elem_vtx, Array<int> &attr) const;
 
+   /// Common implementation of the GeneratePartitioning() methods.
+   int *GeneratePartitioning(int nparts, const Vector *elem_weights,
+                             int part_method);
+
    double GetElementSize(ElementTransformation *T, int type = 0);
 
 public:
@@ -1093,7 +1148,21 @@ public:
 
    int *CartesianPartitioning(int nxyz[]);
    int *GeneratePartitioning(int nparts, int part_method = 1);
+   /** @brief Generate a partitioning where the i-th element has the cost
+       @a elem_weights(i), e.g. a measured assembly time, see
+       BilinearForm::SetElementCosts(). The weights are passed to METIS as
+       graph vertex weights, so that the parts have (approximately) equal
+       total cost instead of an equal number of elements. */
+   int *GeneratePartitioning(int nparts, const Vector &elem_weights,
+                             int part_method = 1);
    void CheckPartitioning(int *partitioning);
+   /** @brief Print the minimum, maximum and average load of the parts in
+       @a partitioning together with the achieved imbalance (max/avg). If
+       @a elem_weights is NULL, every element has a unit weight. Returns the
+       imbalance. */
+   double PrintPartitionBalance(const int *partitioning, int nparts,
+                                const Vector *elem_weights = NULL,
+                                std::ostream &out = mfem::out) const;
 
    void CheckDisplacements(const Vector &displacements, double &tmax);
 
@@ -1252,6 +1321,21 @@ public:
 #ifdef MFEM_USE_ADIOS2
    virtual void Print(adios2stream &out) const;
 #endif
+   /** @brief Print the mesh obtained by refining every element into
+       @a ref_factor^dim elements, without constructing the refined mesh. */
+   /** The refined mesh is the one constructed by Mesh(Mesh*, int, int) with
+       the same @a ref_factor and @a ref_type (here all element geometries are
+       supported), e.g. @a ref_factor = 2^k gives the same vertices and number
+       of elements as k uniform refinements. The refined elements and vertices
+       are generated and written one coarse entity at a time, so the memory
+       use does not grow with @a ref_factor. Curved meshes are written as linear
+       meshes with vertices on the curved geometry. Only conforming, non-NURBS
+       meshes are supported. */
+   /// \see mfem::ofgzstream() for on-the-fly compression of ascii outputs
+   void PrintRefined(std::ostream &out, int ref_factor,
+                     int ref_type = BasisType::ClosedUniform)
+   { RefinedPrinter(out, ref_factor, ref_type); }
+
    /// Print the mesh in VTK format (linear and quadratic meshes only).
    /// \see mfem::ofgzstream() for on-the-fly compression of ascii outputs
    void PrintVTK(std::ostream &out);
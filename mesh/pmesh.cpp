@@ -22,6 +22,8 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <map>
 
 using namespace std;
 
@@ -1108,6 +1110,781 @@ void ParMesh::LoadSharedEntities(istream &input)
    }
 }
 
+// Exchange variable-size messages between all ranks of 'comm': send[p] is sent
+// to rank p and the message from rank p is stored in 'recv' starting at
+// recv_offsets[p]. Used by ParMesh::LoadDistributed().
+template <typename T>
+static void ExchangeMessages(MPI_Comm comm,
+                             const std::vector<std::vector<T> > &send,
+                             std::vector<T> &recv,
+                             std::vector<int> &recv_offsets)
+{
+   const int nranks = send.size();
+   std::vector<int> send_counts(nranks), recv_counts(nranks);
+   std::vector<int> send_offsets(nranks+1);
+   recv_offsets.resize(nranks+1);
+
+   send_offsets[0] = recv_offsets[0] = 0;
+   for (int p = 0; p < nranks; p++)
+   {
+      send_counts[p] = send[p].size();
+      send_offsets[p+1] = send_offsets[p] + send_counts[p];
+   }
+   MPI_Alltoall(send_counts.data(), 1, MPI_INT,
+                recv_counts.data(), 1, MPI_INT, comm);
+   for (int p = 0; p < nranks; p++)
+   {
+      recv_offsets[p+1] = recv_offsets[p] + recv_counts[p];
+   }
+
+   std::vector<T> send_buf(send_offsets[nranks]);
+   for (int p = 0; p < nranks; p++)
+   {
+      std::copy(send[p].begin(), send[p].end(),
+                send_buf.begin() + send_offsets[p]);
+   }
+   recv.resize(recv_offsets[nranks]);
+
+   MPI_Alltoallv(send_buf.data(), send_counts.data(), send_offsets.data(),
+                 MPITypeMap<T>::mpi_type, recv.data(), recv_counts.data(),
+                 recv_offsets.data(), MPITypeMap<T>::mpi_type, comm);
+}
+
+// Return the rank owning global vertex 'v' in a block distribution of the
+// vertices, where rank p owns the vertices vert_offsets[p] ... .
+static int VertexOwner(const std::vector<int> &vert_offsets, int v)
+{
+   return int(std::upper_bound(vert_offsets.begin(), vert_offsets.end(), v)
+              - vert_offsets.begin()) - 1;
+}
+
+/* Distributed directory lookup used by ParMesh::LoadDistributed(). The mesh
+   entities (vertices, edges, faces) are given in 'keys' as records
+   [n, v_0, ..., v_{n-1}] of their sorted global vertex numbers and are sent to
+   the rank owning v_0. On return, ranks[rank_offsets[i]] ...
+   ranks[rank_offsets[i+1]-1] are the (sorted) ranks that have the i-th entity.
+
+   The boundary element records [attribute, geometry, vertices...] in 'bdr' are
+   forwarded through the same directory to the lowest rank that has a face with
+   the same vertices, so that a boundary element on a shared (interior) face is
+   not duplicated; the boundary elements we receive are returned in 'bdr_recv'.
+*/
+static void FindEntityRanks(MPI_Comm comm, const std::vector<int> &vert_offsets,
+                            const std::vector<int> &keys,
+                            const std::vector<int> &bdr,
+                            std::vector<int> &rank_offsets,
+                            std::vector<int> &ranks,
+                            std::vector<int> &bdr_recv)
+{
+   const int nranks = vert_offsets.size() - 1;
+
+   // messages to the directory: [number of keys, keys..., boundary elements...]
+   std::vector<std::vector<int> > send(nranks);
+   std::vector<int> key_owner;
+   for (int p = 0; p < nranks; p++) { send[p].push_back(0); }
+   for (std::size_t pos = 0; pos < keys.size(); pos += keys[pos] + 1)
+   {
+      const int p = VertexOwner(vert_offsets, keys[pos+1]);
+      key_owner.push_back(p);
+      send[p][0]++;
+      send[p].insert(send[p].end(), &keys[pos], &keys[pos] + keys[pos] + 1);
+   }
+   for (std::size_t pos = 0; pos < bdr.size(); )
+   {
+      const int size = 2 + Geometry::NumVerts[bdr[pos+1]];
+      const int vmin = *std::min_element(&bdr[pos+2], &bdr[pos] + size);
+      std::vector<int> &msg = send[VertexOwner(vert_offsets, vmin)];
+      msg.insert(msg.end(), &bdr[pos], &bdr[pos] + size);
+      pos += size;
+   }
+
+   std::vector<int> recv, recv_offsets;
+   ExchangeMessages(comm, send, recv, recv_offsets);
+
+   // directory side: sort the received keys together with their senders
+   struct Entry { const int *key; int rank, index; };
+   auto key_less = [](const int *a, const int *b)
+   {
+      if (a[0] != b[0]) { return a[0] < b[0]; }
+      return std::lexicographical_compare(a+1, a+1+a[0], b+1, b+1+b[0]);
+   };
+   std::vector<Entry> entries;
+   std::vector<int> bdr_pos, num_keys(nranks);
+   for (int p = 0; p < nranks; p++)
+   {
+      int pos = recv_offsets[p];
+      num_keys[p] = recv[pos++];
+      for (int i = 0; i < num_keys[p]; i++)
+      {
+         Entry e = { &recv[pos], p, i };
+         entries.push_back(e);
+         pos += recv[pos] + 1;
+      }
+      for ( ; pos < recv_offsets[p+1]; pos += 2 + Geometry::NumVerts[recv[pos+1]])
+      {
+         bdr_pos.push_back(pos);
+      }
+   }
+   std::sort(entries.begin(), entries.end(),
+             [&](const Entry &a, const Entry &b)
+   {
+      if (key_less(a.key, b.key)) { return true; }
+      if (key_less(b.key, a.key)) { return false; }
+      return a.rank < b.rank;
+   });
+
+   // reply to each sender, in the order of its keys: [n, ranks...]
+   std::vector<std::vector<int> > reply_size(nranks), reply(nranks);
+   for (int p = 0; p < nranks; p++) { reply_size[p].resize(num_keys[p]+1); }
+   for (std::size_t b = 0, e; b < entries.size(); b = e)
+   {
+      for (e = b+1; e < entries.size() &&
+           !key_less(entries[b].key, entries[e].key); e++) {}
+      for (std::size_t k = b; k < e; k++)
+      {
+         reply_size[entries[k].rank][entries[k].index+1] = 1 + (e - b);
+      }
+   }
+   for (int p = 0; p < nranks; p++)
+   {
+      std::vector<int> &offsets = reply_size[p];
+      for (int i = 0; i < num_keys[p]; i++) { offsets[i+1] += offsets[i]; }
+      reply[p].resize(offsets[num_keys[p]]);
+   }
+   for (std::size_t b = 0, e; b < entries.size(); b = e)
+   {
+      for (e = b+1; e < entries.size() &&
+           !key_less(entries[b].key, entries[e].key); e++) {}
+      for (std::size_t k = b; k < e; k++)
+      {
+         int *r = &reply[entries[k].rank][reply_size[entries[k].rank]
+                                             [entries[k].index]];
+         *r++ = e - b;
+         for (std::size_t j = b; j < e; j++) { *r++ = entries[j].rank; }
+      }
+   }
+
+   // forward the boundary elements to the lowest rank that has the matching
+   // face (the entries of a key are sorted by rank)
+   std::vector<int> bkey;
+   for (std::size_t i = 0; i < bdr_pos.size(); i++)
+   {
+      const int *rec = &recv[bdr_pos[i]];
+      const int nv = Geometry::NumVerts[rec[1]];
+      bkey.assign(1, nv);
+      bkey.insert(bkey.end(), rec+2, rec+2+nv);
+      std::sort(bkey.begin()+1, bkey.end());
+
+      Entry e = { bkey.data(), 0, 0 };
+      auto range = std::equal_range(entries.begin(), entries.end(), e,
+                                    [&](const Entry &a, const Entry &b)
+      { return key_less(a.key, b.key); });
+      MFEM_VERIFY(range.first != range.second,
+                  "boundary element does not match any mesh face");
+      std::vector<int> &msg = reply[range.first->rank];
+      msg.insert(msg.end(), rec, rec+2+nv);
+   }
+
+   std::vector<int> answer, answer_offsets;
+   ExchangeMessages(comm, reply, answer, answer_offsets);
+
+   // unpack the answers, in the order of our keys
+   std::vector<int> cursor(answer_offsets.begin(), answer_offsets.end()-1);
+   rank_offsets.assign(1, 0);
+   ranks.clear();
+   for (std::size_t i = 0; i < key_owner.size(); i++)
+   {
+      int &pos = cursor[key_owner[i]];
+      const int n = answer[pos++];
+      ranks.insert(ranks.end(), &answer[pos], &answer[pos] + n);
+      rank_offsets.push_back(ranks.size());
+      pos += n;
+   }
+   bdr_recv.clear();
+   for (int p = 0; p < nranks; p++)
+   {
+      bdr_recv.insert(bdr_recv.end(), answer.begin() + cursor[p],
+                      answer.begin() + answer_offsets[p+1]);
+   }
+}
+
+// Morton (Z-order) index of the point 'x' inside the box [xmin, xmax].
+static unsigned long long MortonIndex(const double *x, const double *xmin,
+                                      const double *xmax, int sdim)
+{
+   const int bits = 20;
+   unsigned long long q[3] = { 0, 0, 0 }, index = 0;
+   for (int d = 0; d < sdim; d++)
+   {
+      const double h = xmax[d] - xmin[d];
+      const double t = (h > 0.0) ? std::max((x[d] - xmin[d]) / h, 0.0) : 0.0;
+      q[d] = (unsigned long long) std::min(t*(1 << bits), (1 << bits) - 1.0);
+   }
+   for (int b = bits-1; b >= 0; b--)
+   {
+      for (int d = 0; d < sdim; d++)
+      {
+         index = (index << 1) | ((q[d] >> b) & 1);
+      }
+   }
+   return index;
+}
+
+ParMesh *ParMesh::LoadDistributed(MPI_Comm comm, const char *filename,
+                                  bool refine)
+{
+   int nranks, myrank;
+   MPI_Comm_size(comm, &nranks);
+   MPI_Comm_rank(comm, &myrank);
+
+   // block distribution of n items: rank p gets the range [first, first_next)
+   auto first = [nranks](int n, int p) { return int(((long) n * p) / nranks); };
+
+   // *** STEP 1: read our slices of the elements, boundary and vertices ***
+
+   named_ifgzstream input(filename);
+   MFEM_VERIFY(input, "Mesh file not found: " << filename);
+
+   string ident;
+   input >> ws;
+   getline(input, ident);
+   filter_dos(ident);
+   MFEM_VERIFY(ident == "MFEM mesh v1.0", "ParMesh::LoadDistributed: only "
+               "the \"MFEM mesh v1.0\" format is supported");
+
+   int dim, sdim, num_elem, num_bdr, num_vert;
+   skip_comment_lines(input, '#');
+   input >> ident >> dim;
+   MFEM_VERIFY(ident == "dimension", "invalid mesh file");
+
+   // element records: global index, attribute, geometry, vertices
+   std::vector<int> elem_data;
+   skip_comment_lines(input, '#');
+   input >> ident >> num_elem;
+   MFEM_VERIFY(ident == "elements", "invalid mesh file");
+   MFEM_VERIFY(num_elem >= nranks, "the mesh has fewer elements than the "
+               "number of MPI ranks");
+   {
+      const int begin = first(num_elem, myrank);
+      const int end = first(num_elem, myrank+1);
+      for (int i = 0; i < num_elem; i++)
+      {
+         int attr, geom, v;
+         input >> attr >> geom;
+         MFEM_VERIFY(input && geom >= 0 && geom < Geometry::NumGeom,
+                     "invalid element in mesh file");
+         const bool mine = (begin <= i && i < end);
+         if (mine)
+         {
+            elem_data.push_back(i);
+            elem_data.push_back(attr);
+            elem_data.push_back(geom);
+         }
+         for (int j = 0; j < Geometry::NumVerts[geom]; j++)
+         {
+            input >> v;
+            if (mine) { elem_data.push_back(v); }
+         }
+      }
+   }
+
+   // boundary element records: attribute, geometry, vertices
+   std::vector<int> bdr_data;
+   skip_comment_lines(input, '#');
+   input >> ident >> num_bdr;
+   MFEM_VERIFY(ident == "boundary", "invalid mesh file");
+   {
+      const int begin = first(num_bdr, myrank);
+      const int end = first(num_bdr, myrank+1);
+      for (int i = 0; i < num_bdr; i++)
+      {
+         int attr, geom, v;
+         input >> attr >> geom;
+         MFEM_VERIFY(input && geom >= 0 && geom < Geometry::NumGeom,
+                     "invalid boundary element in mesh file");
+         const bool mine = (begin <= i && i < end);
+         if (mine)
+         {
+            bdr_data.push_back(attr);
+            bdr_data.push_back(geom);
+         }
+         for (int j = 0; j < Geometry::NumVerts[geom]; j++)
+         {
+            input >> v;
+            if (mine) { bdr_data.push_back(v); }
+         }
+      }
+   }
+
+   std::vector<double> vert_coord;
+   skip_comment_lines(input, '#');
+   input >> ident >> num_vert;
+   MFEM_VERIFY(ident == "vertices", "invalid mesh file");
+   input >> ws >> ident;
+   MFEM_VERIFY(ident != "nodes", "ParMesh::LoadDistributed: curved meshes "
+               "are not supported");
+   sdim = atoi(ident.c_str());
+   MFEM_VERIFY(sdim >= 1 && sdim <= 3, "invalid mesh file");
+
+   std::vector<int> vert_offsets(nranks+1);
+   for (int p = 0; p <= nranks; p++) { vert_offsets[p] = first(num_vert, p); }
+   {
+      double x;
+      for (int i = 0; i < num_vert; i++)
+      {
+         const bool mine = (VertexOwner(vert_offsets, i) == myrank);
+         for (int d = 0; d < sdim; d++)
+         {
+            input >> x;
+            if (mine) { vert_coord.push_back(x); }
+         }
+      }
+      MFEM_VERIFY(input, "invalid mesh file");
+   }
+
+   // get the coordinates of the sorted global vertices 'verts' from the ranks
+   // that read them
+   auto get_coordinates = [&](const std::vector<int> &verts,
+                              std::vector<double> &coord)
+   {
+      std::vector<std::vector<int> > request(nranks);
+      for (std::size_t i = 0; i < verts.size(); i++)
+      {
+         request[VertexOwner(vert_offsets, verts[i])].push_back(verts[i]);
+      }
+      std::vector<int> recv, recv_offsets, coord_offsets;
+      ExchangeMessages(comm, request, recv, recv_offsets);
+
+      std::vector<std::vector<double> > reply(nranks);
+      for (int p = 0; p < nranks; p++)
+      {
+         for (int k = recv_offsets[p]; k < recv_offsets[p+1]; k++)
+         {
+            const double *x =
+               &vert_coord[(recv[k] - vert_offsets[myrank])*sdim];
+            reply[p].insert(reply[p].end(), x, x + sdim);
+         }
+      }
+      // 'verts' is sorted and the owners are increasing, so the replies come
+      // in the order of 'verts'
+      ExchangeMessages(comm, reply, coord, coord_offsets);
+   };
+
+   // split the records in 'data' with 'hdr' header entries before the vertices
+   auto record_offsets = [](const std::vector<int> &data, int hdr,
+                            std::vector<int> &offsets)
+   {
+      offsets.clear();
+      for (std::size_t pos = 0; pos < data.size();
+           pos += hdr + Geometry::NumVerts[data[pos+hdr-1]])
+      {
+         offsets.push_back(pos);
+      }
+   };
+
+   // *** STEP 2: partition the elements along a space-filling curve ***
+
+   std::vector<int> elem_offsets;
+   record_offsets(elem_data, 3, elem_offsets);
+   const int my_ne = elem_offsets.size();
+   {
+      std::vector<int> verts;
+      for (int i = 0; i < my_ne; i++)
+      {
+         const int *rec = &elem_data[elem_offsets[i]];
+         verts.insert(verts.end(), rec+3, rec+3+Geometry::NumVerts[rec[2]]);
+      }
+      std::sort(verts.begin(), verts.end());
+      verts.erase(std::unique(verts.begin(), verts.end()), verts.end());
+
+      std::vector<double> coord;
+      get_coordinates(verts, coord);
+
+      // element centers and their bounding box
+      std::vector<double> center(my_ne*sdim, 0.0);
+      double bb_min[3], bb_max[3], loc_min[3], loc_max[3];
+      for (int d = 0; d < sdim; d++)
+      {
+         loc_min[d] = infinity();
+         loc_max[d] = -infinity();
+      }
+      for (int i = 0; i < my_ne; i++)
+      {
+         const int *rec = &elem_data[elem_offsets[i]];
+         const int nv = Geometry::NumVerts[rec[2]];
+         double *c = &center[i*sdim];
+         for (int j = 0; j < nv; j++)
+         {
+            const int k = std::lower_bound(verts.begin(), verts.end(), rec[3+j])
+                          - verts.begin();
+            for (int d = 0; d < sdim; d++) { c[d] += coord[k*sdim+d] / nv; }
+         }
+         for (int d = 0; d < sdim; d++)
+         {
+            loc_min[d] = std::min(loc_min[d], c[d]);
+            loc_max[d] = std::max(loc_max[d], c[d]);
+         }
+      }
+      MPI_Allreduce(loc_min, bb_min, sdim, MPI_DOUBLE, MPI_MIN, comm);
+      MPI_Allreduce(loc_max, bb_max, sdim, MPI_DOUBLE, MPI_MAX, comm);
+
+      // curve positions (Morton index, global element index) -- unique
+      typedef std::pair<unsigned long long, int> SFCIndex;
+      std::vector<SFCIndex> sfc(my_ne), sorted_sfc;
+      for (int i = 0; i < my_ne; i++)
+      {
+         sfc[i].first = MortonIndex(&center[i*sdim], bb_min, bb_max, sdim);
+         sfc[i].second = elem_data[elem_offsets[i]];
+      }
+      sorted_sfc = sfc;
+      std::sort(sorted_sfc.begin(), sorted_sfc.end());
+
+      /* Find the splitters between the ranks by parallel bisection: splitter
+         r-1 is the smallest curve position s such that there are 'target'
+         elements at positions <= s. First bisect the Morton index, then the
+         element index among the elements with the same Morton index. */
+      const int nsplit = nranks-1;
+      std::vector<SFCIndex> split(nsplit);
+      std::vector<unsigned long long> lo(nsplit, 0), hi(nsplit, ~0ull >> 4);
+      std::vector<long> target(nsplit), count(nsplit), gcount(nsplit);
+      for (int r = 0; r < nsplit; r++) { target[r] = first(num_elem, r+1); }
+
+      auto count_le = [&](const SFCIndex &s)
+      {
+         return long(std::upper_bound(sorted_sfc.begin(), sorted_sfc.end(), s)
+                     - sorted_sfc.begin());
+      };
+      for (int iter = 0; iter < 64; iter++)
+      {
+         for (int r = 0; r < nsplit; r++)
+         {
+            const unsigned long long mid = lo[r] + (hi[r] - lo[r])/2;
+            count[r] = count_le(SFCIndex(mid, num_elem));
+         }
+         MPI_Allreduce(count.data(), gcount.data(), nsplit, MPI_LONG, MPI_SUM,
+                       comm);
+         for (int r = 0; r < nsplit; r++)
+         {
+            const unsigned long long mid = lo[r] + (hi[r] - lo[r])/2;
+            if (gcount[r] >= target[r]) { hi[r] = mid; }
+            else { lo[r] = mid + 1; }
+         }
+      }
+      std::vector<long> glo(nsplit, 0), ghi(nsplit, num_elem-1);
+      for (int iter = 0; iter < 32; iter++)
+      {
+         for (int r = 0; r < nsplit; r++)
+         {
+            const long mid = (glo[r] + ghi[r])/2;
+            count[r] = count_le(SFCIndex(lo[r], mid));
+         }
+         MPI_Allreduce(count.data(), gcount.data(), nsplit, MPI_LONG, MPI_SUM,
+                       comm);
+         for (int r = 0; r < nsplit; r++)
+         {
+            const long mid = (glo[r] + ghi[r])/2;
+            if (gcount[r] >= target[r]) { ghi[r] = mid; }
+            else { glo[r] = mid + 1; }
+         }
+      }
+      for (int r = 0; r < nsplit; r++)
+      {
+         split[r] = SFCIndex(lo[r], (int) glo[r]);
+      }
+
+      // *** STEP 3: send the elements to their new ranks ***
+
+      std::vector<std::vector<int> > send(nranks);
+      for (int i = 0; i < my_ne; i++)
+      {
+         const int p = std::lower_bound(split.begin(), split.end(), sfc[i])
+                       - split.begin();
+         const int *rec = &elem_data[elem_offsets[i]];
+         send[p].insert(send[p].end(), rec, rec+3+Geometry::NumVerts[rec[2]]);
+      }
+      std::vector<int> recv_offsets;
+      ExchangeMessages(comm, send, elem_data, recv_offsets);
+   }
+
+   // order the received elements by their global index
+   record_offsets(elem_data, 3, elem_offsets);
+   std::sort(elem_offsets.begin(), elem_offsets.end(),
+             [&](int a, int b) { return elem_data[a] < elem_data[b]; });
+   const int ne = elem_offsets.size();
+
+   // *** STEP 4: create the local mesh ***
+
+   std::vector<int> lverts; // local vertex -> global vertex
+   for (int i = 0; i < ne; i++)
+   {
+      const int *rec = &elem_data[elem_offsets[i]];
+      lverts.insert(lverts.end(), rec+3, rec+3+Geometry::NumVerts[rec[2]]);
+   }
+   std::sort(lverts.begin(), lverts.end());
+   lverts.erase(std::unique(lverts.begin(), lverts.end()), lverts.end());
+   const int nv = lverts.size();
+   auto local_vertex = [&](int gv)
+   {
+      return int(std::lower_bound(lverts.begin(), lverts.end(), gv)
+                 - lverts.begin());
+   };
+
+   std::vector<double> lcoord;
+   get_coordinates(lverts, lcoord);
+   vert_coord.clear();
+
+   Mesh mesh(dim, nv, ne, 0, sdim);
+   for (int i = 0; i < nv; i++) { mesh.AddVertex(&lcoord[i*sdim]); }
+   Array<int> v;
+   for (int i = 0; i < ne; i++)
+   {
+      const int *rec = &elem_data[elem_offsets[i]];
+      v.SetSize(Geometry::NumVerts[rec[2]]);
+      for (int j = 0; j < v.Size(); j++) { v[j] = local_vertex(rec[3+j]); }
+      Element *el = mesh.NewElement(rec[2]);
+      el->SetVertices(v);
+      el->SetAttribute(rec[1]);
+      mesh.AddElement(el);
+   }
+   mesh.FinalizeTopology(false);
+
+   // *** STEP 5: find the shared entities and the boundary elements ***
+
+   std::vector<int> keys, no_bdr, unused;
+
+   // vertices
+   std::vector<int> vrank_offsets, vranks;
+   for (int i = 0; i < nv; i++)
+   {
+      keys.push_back(1);
+      keys.push_back(lverts[i]);
+   }
+   FindEntityRanks(comm, vert_offsets, keys, no_bdr, vrank_offsets, vranks,
+                   unused);
+   auto num_vranks = [&](int i) { return vrank_offsets[i+1]-vrank_offsets[i]; };
+
+   // faces (2D: edges, 1D: vertices), also distributes the boundary elements
+   std::vector<int> frank_offsets, franks, bdr_recv;
+   const int nfaces = mesh.GetNumFaces();
+   keys.clear();
+   for (int f = 0; f < nfaces; f++)
+   {
+      mesh.GetFaceVertices(f, v);
+      keys.push_back(v.Size());
+      const int start = keys.size();
+      for (int j = 0; j < v.Size(); j++) { keys.push_back(lverts[v[j]]); }
+      std::sort(keys.begin() + start, keys.end());
+   }
+   FindEntityRanks(comm, vert_offsets, keys, bdr_data, frank_offsets, franks,
+                   bdr_recv);
+   bdr_data.clear();
+
+   // edges (3D only) with shared end points
+   std::vector<int> erank_offsets, eranks, edge_list;
+   if (dim == 3)
+   {
+      keys.clear();
+      for (int e = 0; e < mesh.GetNEdges(); e++)
+      {
+         mesh.GetEdgeVertices(e, v);
+         if (num_vranks(v[0]) > 1 && num_vranks(v[1]) > 1)
+         {
+            edge_list.push_back(e);
+            keys.push_back(2);
+            keys.push_back(std::min(lverts[v[0]], lverts[v[1]]));
+            keys.push_back(std::max(lverts[v[0]], lverts[v[1]]));
+         }
+      }
+      FindEntityRanks(comm, vert_offsets, keys, no_bdr, erank_offsets, eranks,
+                      unused);
+   }
+
+   // *** STEP 6: build the communication groups ***
+
+   std::map<std::vector<int>, int> group_index;
+   std::vector<std::vector<int> > groups(1, std::vector<int>(1, myrank));
+   group_index[groups[0]] = 0;
+   auto get_group = [&](const int *r, int n)
+   {
+      std::vector<int> g(r, r+n);
+      auto it = group_index.find(g);
+      if (it != group_index.end()) { return it->second; }
+      groups.push_back(g);
+      return group_index[g] = groups.size()-1;
+   };
+
+   // shared entities: sort key (global vertices), local vertices
+   typedef std::pair<std::vector<int>, std::vector<int> > SharedEntity;
+   std::vector<std::vector<int> > group_verts(1);
+   std::vector<std::vector<SharedEntity> > group_edges(1), group_faces(1);
+   auto add_group = [&](int g)
+   {
+      if (g >= (int) group_verts.size())
+      {
+         group_verts.resize(g+1);
+         group_edges.resize(g+1);
+         group_faces.resize(g+1);
+      }
+   };
+
+   for (int i = 0; i < nv; i++)
+   {
+      if (num_vranks(i) > 1)
+      {
+         const int g = get_group(&vranks[vrank_offsets[i]], num_vranks(i));
+         add_group(g);
+         group_verts[g].push_back(i); // sorted by the global vertex number
+      }
+   }
+   for (int f = 0; dim >= 2 && f < nfaces; f++)
+   {
+      const int n = frank_offsets[f+1] - frank_offsets[f];
+      if (n < 2) { continue; }
+      const int g = get_group(&franks[frank_offsets[f]], n);
+      add_group(g);
+
+      // use a vertex order common to all ranks: start with the smallest global
+      // vertex and continue towards its smaller neighbor
+      mesh.GetFaceVertices(f, v);
+      const int nfv = v.Size();
+      int s = 0;
+      for (int j = 1; j < nfv; j++)
+      {
+         if (lverts[v[j]] < lverts[v[s]]) { s = j; }
+      }
+      const int dir = (lverts[v[(s+1)%nfv]] <= lverts[v[(s+nfv-1)%nfv]])
+                      ? 1 : nfv-1;
+      SharedEntity se;
+      for (int j = 0; j < nfv; j++)
+      {
+         se.second.push_back(v[(s + j*dir) % nfv]);
+         se.first.push_back(lverts[se.second.back()]);
+      }
+      (dim == 2 ? group_edges : group_faces)[g].push_back(se);
+   }
+   for (std::size_t k = 0; k < edge_list.size(); k++)
+   {
+      const int n = erank_offsets[k+1] - erank_offsets[k];
+      if (n < 2) { continue; }
+      const int g = get_group(&eranks[erank_offsets[k]], n);
+      add_group(g);
+
+      mesh.GetEdgeVertices(edge_list[k], v);
+      if (lverts[v[0]] > lverts[v[1]]) { std::swap(v[0], v[1]); }
+      SharedEntity se;
+      se.second.assign(v.begin(), v.end());
+      se.first.push_back(lverts[v[0]]);
+      se.first.push_back(lverts[v[1]]);
+      group_edges[g].push_back(se);
+   }
+   // the shared entities are listed in the same order on all ranks
+   for (std::size_t g = 0; g < groups.size(); g++)
+   {
+      std::sort(group_edges[g].begin(), group_edges[g].end());
+      std::sort(group_faces[g].begin(), group_faces[g].end());
+   }
+
+   // *** STEP 7: write the local mesh in the parallel MFEM format and load it
+   // with the existing reader, which also sets up the shared entities ***
+
+   std::stringstream out;
+   out.precision(17);
+   out << "MFEM mesh v1.2\n\ndimension\n" << dim
+       << "\n\nelements\n" << ne << '\n';
+   for (int i = 0; i < ne; i++)
+   {
+      const int *rec = &elem_data[elem_offsets[i]];
+      out << rec[1] << ' ' << rec[2];
+      for (int j = 0; j < Geometry::NumVerts[rec[2]]; j++)
+      {
+         out << ' ' << local_vertex(rec[3+j]);
+      }
+      out << '\n';
+   }
+   elem_data.clear();
+
+   std::vector<int> bdr_offsets;
+   record_offsets(bdr_recv, 2, bdr_offsets);
+   out << "\nboundary\n" << bdr_offsets.size() << '\n';
+   for (std::size_t i = 0; i < bdr_offsets.size(); i++)
+   {
+      const int *rec = &bdr_recv[bdr_offsets[i]];
+      out << rec[0] << ' ' << rec[1];
+      for (int j = 0; j < Geometry::NumVerts[rec[1]]; j++)
+      {
+         out << ' ' << local_vertex(rec[2+j]);
+      }
+      out << '\n';
+   }
+   bdr_recv.clear();
+
+   out << "\nvertices\n" << nv << '\n' << sdim << '\n';
+   for (int i = 0; i < nv; i++)
+   {
+      for (int d = 0; d < sdim; d++)
+      {
+         out << lcoord[i*sdim+d] << (d+1 < sdim ? ' ' : '\n');
+      }
+   }
+   out << "\nmfem_serial_mesh_end\n";
+   mesh.Clear();
+
+   out << "\ncommunication_groups\nnumber_of_groups " << groups.size()
+       << "\n\n";
+   for (std::size_t g = 0; g < groups.size(); g++)
+   {
+      out << groups[g].size();
+      for (std::size_t j = 0; j < groups[g].size(); j++)
+      {
+         out << ' ' << groups[g][j];
+      }
+      out << '\n';
+   }
+
+   int num_sverts = 0, num_sedges = 0, num_sfaces = 0;
+   for (std::size_t g = 1; g < groups.size(); g++)
+   {
+      num_sverts += group_verts[g].size();
+      num_sedges += group_edges[g].size();
+      num_sfaces += group_faces[g].size();
+   }
+   out << "\ntotal_shared_vertices " << num_sverts << '\n';
+   if (dim >= 2) { out << "total_shared_edges " << num_sedges << '\n'; }
+   if (dim >= 3) { out << "total_shared_faces " << num_sfaces << '\n'; }
+   for (std::size_t g = 1; g < groups.size(); g++)
+   {
+      out << "\n# group " << g << "\nshared_vertices "
+          << group_verts[g].size() << '\n';
+      for (std::size_t i = 0; i < group_verts[g].size(); i++)
+      {
+         out << group_verts[g][i] << '\n';
+      }
+      if (dim >= 2)
+      {
+         out << "\nshared_edges " << group_edges[g].size() << '\n';
+         for (std::size_t i = 0; i < group_edges[g].size(); i++)
+         {
+            const std::vector<int> &ev = group_edges[g][i].second;
+            out << ev[0] << ' ' << ev[1] << '\n';
+         }
+      }
+      if (dim >= 3)
+      {
+         out << "\nshared_faces " << group_faces[g].size() << '\n';
+         for (std::size_t i = 0; i < group_faces[g].size(); i++)
+         {
+            const std::vector<int> &fv = group_faces[g][i].second;
+            out << (fv.size() == 3 ? Geometry::TRIANGLE : Geometry::SQUARE);
+            for (std::size_t j = 0; j < fv.size(); j++) { out << ' ' << fv[j]; }
+            out << '\n';
+         }
+      }
+   }
+   out << "\nmfem_mesh_end" << endl;
+
+   return new ParMesh(comm, out, refine);
+}
+
 ParMesh::ParMesh(ParMesh *orig_mesh, int ref_factor, int ref_type)
    : Mesh(orig_mesh, ref_factor, ref_type),
      MyComm(orig_mesh->GetComm()),
@@ -3440,6 +4217,40 @@ void ParMesh::Rebalance(const Array<int> &partition)
    RebalanceImpl(&partition);
 }
 
+void ParMesh::Rebalance(const Vector &elem_weights)
+{
+   MFEM_VERIFY(!Conforming(), "Load balancing is currently not supported for"
+               " conforming meshes.");
+   Array<int> partition;
+   pncmesh->GetWeightedPartition(elem_weights, partition);
+   RebalanceImpl(&partition);
+}
+
+double ParMesh::PrintLoadBalance(const Vector *elem_weights,
+                                 std::ostream &out) const
+{
+   MFEM_VERIFY(!elem_weights || elem_weights->Size() == GetNE(),
+               "the size of the weights vector must be equal to GetNE()");
+
+   const double my_load = elem_weights ? elem_weights->Sum() : GetNE();
+   double min_load, max_load, sum_load;
+   MPI_Allreduce(&my_load, &min_load, 1, MPI_DOUBLE, MPI_MIN, MyComm);
+   MPI_Allreduce(&my_load, &max_load, 1, MPI_DOUBLE, MPI_MAX, MyComm);
+   MPI_Allreduce(&my_load, &sum_load, 1, MPI_DOUBLE, MPI_SUM, MyComm);
+
+   const double avg_load = sum_load / NRanks;
+   const double imbalance = (avg_load > 0.0) ? max_load / avg_load : 1.0;
+
+   if (MyRank == 0)
+   {
+      out << "Load balance (" << NRanks << " ranks):\n"
+          << "   load per rank min / avg / max : " << min_load << " / "
+          << avg_load << " / " << max_load << '\n'
+          << "   imbalance (max / avg)         : " << imbalance << endl;
+   }
+   return imbalance;
+}
+
 void ParMesh::RebalanceImpl(const Array<int> *partition)
 {
    if (Conforming())
@@ -5416,6 +6227,175 @@ void ParMesh::ParPrint(ostream &out) const
    out << "\nmfem_mesh_end" << endl;
 }
 
+void ParMesh::ParPrintRefined(ostream &out, int ref_factor, int ref_type)
+{
+   // Write out the refined serial mesh, see Mesh::RefinedPrinter().
+   RefinedPrinter(out, ref_factor, ref_type, "mfem_serial_mesh_end");
+
+   // The refined mesh has the same group topology.
+   gtopo.Save(out);
+
+   // The shared entities of the refined mesh are generated from the coarse
+   // shared edges and faces, in the same order as in
+   // ParMesh(ParMesh*, int, int), so that they match across the processors.
+   H1_FECollection rfec(ref_factor, Dim, ref_type);
+   RefinedVertices rvert(*this, rfec);
+   Array<int> rdofs;
+
+   // refined vertices of a shared edge/face, in the orientation of the
+   // shared entity (which is the same on all processors in the group)
+   auto get_shared_dofs = [&](Geometry::Type geom, int gr, int i)
+   {
+      int l_ent, ori;
+      const int *v;
+      if (geom == Geometry::SEGMENT)
+      {
+         const int sedge = group_sedge.GetRow(gr-1)[i];
+         l_ent = sedge_ledge[sedge];
+         v = shared_edges[sedge]->GetVertices();
+         GetEdgeVertices(l_ent, rdofs);
+         ori = (rdofs[0] == v[0]) ? 1 : -1;
+      }
+      else if (geom == Geometry::TRIANGLE)
+      {
+         GroupTriangle(gr, i, l_ent, ori);
+         v = shared_trias[group_stria.GetRow(gr-1)[i]].v;
+      }
+      else
+      {
+         GroupQuadrilateral(gr, i, l_ent, ori);
+         v = shared_quads[group_squad.GetRow(gr-1)[i]].v;
+      }
+      rvert.GetEntityVertices(l_ent, geom, v, ori, rdofs);
+   };
+
+   // number of refined vertices, edges and faces interior to a coarse shared
+   // edge, triangle or quadrilateral
+   const Geometry::Type sgeom[3] =
+   { Geometry::SEGMENT, Geometry::TRIANGLE, Geometry::SQUARE };
+   int s_verts[3] = { 0, 0, 0 }, s_edges[3] = { 0, 0, 0 };
+   int s_faces[3] = { 0, 0, 0 };
+   for (int t = 0; t < 3; t++)
+   {
+      const Geometry::Type geom = sgeom[t];
+      if (Geometry::Dimension[geom] >= Dim) { continue; }
+      RefinedGeometry &RG = *GlobGeometryRefiner.Refine(geom, ref_factor,
+                                                        ref_factor);
+      s_verts[t] = rfec.DofForGeometry(geom);
+      s_edges[t] = (t == 0) ? ref_factor : RG.RefEdges.Size()/2-RG.NumBdrEdges;
+      s_faces[t] = (t == 0) ? 0 : RG.RefGeoms.Size()/Geometry::NumVerts[geom];
+   }
+   auto group_num = [&](int gr, int t)
+   {
+      if (t == 0) { return (Dim > 1) ? GroupNEdges(gr) : 0; }
+      if (Dim < 3) { return 0; }
+      return (t == 1) ? GroupNTriangles(gr) : GroupNQuadrilaterals(gr);
+   };
+
+   long tot_verts = 0, tot_edges = 0, tot_faces = 0;
+   for (int gr = 1; gr < GetNGroups(); gr++)
+   {
+      tot_verts += GroupNVertices(gr);
+      for (int t = 0; t < 3; t++)
+      {
+         tot_verts += group_num(gr, t)*s_verts[t];
+         tot_edges += group_num(gr, t)*s_edges[t];
+         tot_faces += group_num(gr, t)*s_faces[t];
+      }
+   }
+
+   out << "\ntotal_shared_vertices " << tot_verts << '\n';
+   if (Dim >= 2)
+   {
+      out << "total_shared_edges " << tot_edges << '\n';
+   }
+   if (Dim >= 3)
+   {
+      out << "total_shared_faces " << tot_faces << '\n';
+   }
+   for (int gr = 1; gr < GetNGroups(); gr++)
+   {
+      {
+         int nv = GroupNVertices(gr);
+         for (int t = 0; t < 3; t++) { nv += group_num(gr, t)*s_verts[t]; }
+         out << "\n# group " << gr << "\nshared_vertices " << nv << '\n';
+         for (int i = 0; i < GroupNVertices(gr); i++)
+         {
+            out << GroupVertex(gr, i) << '\n';
+         }
+         for (int t = 0; t < 3; t++)
+         {
+            for (int i = 0; i < group_num(gr, t); i++)
+            {
+               get_shared_dofs(sgeom[t], gr, i);
+               // the interior vertices are the last ones
+               for (int j = rdofs.Size()-s_verts[t]; j < rdofs.Size(); j++)
+               {
+                  out << rdofs[j] << '\n';
+               }
+            }
+         }
+      }
+      if (Dim >= 2)
+      {
+         int ne = 0;
+         for (int t = 0; t < 3; t++) { ne += group_num(gr, t)*s_edges[t]; }
+         out << "\nshared_edges " << ne << '\n';
+         for (int t = 0; t < 3; t++)
+         {
+            const Geometry::Type geom = sgeom[t];
+            if (group_num(gr, t) == 0) { continue; }
+            RefinedGeometry &RG = *GlobGeometryRefiner.Refine(geom, ref_factor,
+                                                              ref_factor);
+            const int *c2h_map = rfec.GetDofMap(geom);
+            // refined coarse edges, or the edges interior to a coarse face
+            const Array<int> &edges = (t == 0) ? RG.RefGeoms : RG.RefEdges;
+            const int first = (t == 0) ? 0 : 2*RG.NumBdrEdges;
+            for (int i = 0; i < group_num(gr, t); i++)
+            {
+               get_shared_dofs(geom, gr, i);
+               for (int j = first; j < edges.Size(); j += 2)
+               {
+                  out << rdofs[c2h_map[edges[j]]] << ' '
+                      << rdofs[c2h_map[edges[j+1]]] << '\n';
+               }
+            }
+         }
+      }
+      if (Dim >= 3)
+      {
+         int nf = 0;
+         for (int t = 1; t < 3; t++) { nf += group_num(gr, t)*s_faces[t]; }
+         out << "\nshared_faces " << nf << '\n';
+         for (int t = 1; t < 3; t++)
+         {
+            const Geometry::Type geom = sgeom[t];
+            if (group_num(gr, t) == 0) { continue; }
+            const int nvert = Geometry::NumVerts[geom];
+            RefinedGeometry &RG = *GlobGeometryRefiner.Refine(geom, ref_factor,
+                                                              ref_factor);
+            const int *c2h_map = rfec.GetDofMap(geom);
+            for (int i = 0; i < group_num(gr, t); i++)
+            {
+               get_shared_dofs(geom, gr, i);
+               for (int j = 0; j < RG.RefGeoms.Size(); j += nvert)
+               {
+                  out << geom;
+                  for (int k = 0; k < nvert; k++)
+                  {
+                     out << ' ' << rdofs[c2h_map[RG.RefGeoms[j+k]]];
+                  }
+                  out << '\n';
+               }
+            }
+         }
+      }
+   }
+
+   // Write out section end tag for mesh.
+   out << "\nmfem_mesh_end" << endl;
+}
+
 void ParMesh::PrintVTU(std::string pathname,
                        VTKFormat format,
                        bool high_order_output,
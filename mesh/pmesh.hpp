@@ -231,6 +231,25 @@ public:
    /** The @a refine parameter is passed to the method Mesh::Finalize(). */
    ParMesh(MPI_Comm comm, std::istream &input, bool refine = true);
 
+   /** @brief Read the serial mesh file @a filename in a distributed way and
+       create a parallel mesh from it, without constructing the global serial
+       Mesh on any MPI rank.
+
+       Every rank keeps only a contiguous slice of the elements, boundary
+       elements and vertices listed in the file. The elements are partitioned
+       in parallel by splitting a space-filling (Morton) curve through their
+       centers into pieces of equal size and are then redistributed. Shared
+       vertices, edges and faces and the owners of the boundary elements are
+       found through distributed directories indexed by the global vertex
+       numbers, so no rank needs data proportional to the global mesh size.
+
+       Currently, only linear conforming meshes in the "MFEM mesh v1.0" format
+       are supported. The @a refine parameter is passed to the method
+       Mesh::Finalize(). The returned ParMesh must be destroyed by the caller.
+   */
+   static ParMesh *LoadDistributed(MPI_Comm comm, const char *filename,
+                                   bool refine = true);
+
    /// Create a uniformly refined (by any factor) version of @a orig_mesh.
    /** @param[in] orig_mesh  The starting coarse mesh.
        @param[in] ref_factor The refinement factor, an integer > 1.
@@ -359,9 +378,30 @@ public:
        for 0 <= i < GetNE(). */
    void Rebalance(const Array<int> &partition);
 
+   /** Load balance a nonconforming mesh by splitting the global space-filling
+       sequence of elements into pieces of equal total cost, where the cost of
+       local element 'i' is @a elem_weights(i), e.g. as measured by
+       BilinearForm::SetElementCosts(). */
+   void Rebalance(const Vector &elem_weights);
+
+   /** Print the minimum, maximum and average load of the MPI ranks and the
+       imbalance (max/avg). The load of a rank is the sum of @a elem_weights
+       over its elements, or its number of elements if @a elem_weights is
+       NULL. Returns the imbalance on all ranks; prints on rank 0 only. */
+   double PrintLoadBalance(const Vector *elem_weights = NULL,
+                           std::ostream &out = mfem::out) const;
+
    /// Save the mesh in a parallel mesh format.
    void ParPrint(std::ostream &out) const;
 
+   /** @brief Save the mesh obtained by refining every element into
+       @a ref_factor^dim elements in a parallel mesh format, without
+       constructing the refined mesh. */
+   /** The output can be loaded with ParMesh(MPI_Comm, std::istream &), see
+       Mesh::PrintRefined() for a description of the refined mesh. */
+   void ParPrintRefined(std::ostream &out, int ref_factor,
+                        int ref_type = BasisType::ClosedUniform);
+
    /** Print the part of the mesh in the calling processor adding the interface
        as boundary (for visualization purposes) using the mfem v1.0 format. */
    virtual void Print(std::ostream &out = mfem::out) const;
@@ -1710,6 +1710,49 @@ void ParNCMesh::Rebalance(const Array<int> *custom_partition)
    Prune();
 }
 
+void ParNCMesh::GetWeightedPartition(const Vector &elem_weights,
+                                     Array<int> &partition) const
+{
+   MFEM_VERIFY(elem_weights.Size() == NElements,
+               "Size of the weights vector must match the number "
+               "of local mesh elements (ParMesh::GetNE()).");
+
+   double local_weight = elem_weights.Sum(), total_weight = 0.0;
+   MPI_Allreduce(&local_weight, &total_weight, 1, MPI_DOUBLE, MPI_SUM, MyComm);
+
+   double first_weight = 0.0;
+   MPI_Scan(&local_weight, &first_weight, 1, MPI_DOUBLE, MPI_SUM, MyComm);
+   first_weight -= local_weight;
+
+   partition.SetSize(NElements);
+   if (total_weight <= 0.0)
+   {
+      // no meaningful weights, fall back to equal element counts
+      long local_elems = NElements, total_elems = 0, first_elem = 0;
+      MPI_Allreduce(&local_elems, &total_elems, 1, MPI_LONG, MPI_SUM, MyComm);
+      MPI_Scan(&local_elems, &first_elem, 1, MPI_LONG, MPI_SUM, MyComm);
+      first_elem -= local_elems;
+      for (int i = 0; i < NElements; i++)
+      {
+         partition[i] = Partition(first_elem + i, total_elems);
+      }
+      return;
+   }
+
+   // assign each element to the rank whose weight interval contains the
+   // midpoint of the element's weight in the global SFC sequence
+   double sum = first_weight;
+   for (int i = 0; i < NElements; i++)
+   {
+      MFEM_VERIFY(elem_weights(i) >= 0.0, "element weights must be "
+                  "non-negative");
+      const double mid = sum + 0.5*elem_weights(i);
+      sum += elem_weights(i);
+      int rank = (int) std::floor(mid * NRanks / total_weight);
+      partition[i] = std::max(0, std::min(rank, NRanks-1));
+   }
+}
+
 void ParNCMesh::RedistributeElements(Array<int> &new_ranks, int target_elements,
                                      bool record_comm)
 {
@@ -101,6 +101,13 @@ public:
        passed. */
    void Rebalance(const Array<int> *custom_partition = NULL);
 
+   /** Compute a partition of the local elements that splits the global
+       space-filling sequence of leaf elements into NRanks contiguous pieces
+       of (approximately) equal total weight. The weight of local element 'i'
+       is @a elem_weights(i). The result can be passed to Rebalance(). */
+   void GetWeightedPartition(const Vector &elem_weights,
+                             Array<int> &partition) const;
+
 
    // interface for ParFiniteElementSpace
 
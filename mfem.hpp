@@ -19,6 +19,7 @@
 #include "general/array.hpp"
 #include "general/sets.hpp"
 #include "general/hash.hpp"
+#include "general/kernel_registry.hpp"
 #include "general/mem_alloc.hpp"
 #include "general/sort_pairs.hpp"
 #include "general/stable3d.hpp"
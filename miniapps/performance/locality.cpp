@@ -0,0 +1,152 @@
+//                 MFEM Locality Benchmark - DOF and Element Renumbering
+//
+// Compile with: make locality
+//
+// Sample runs:  locality
+//               locality -m ../../data/fichera.mesh -o 2 -r 3
+//               locality -m ../../data/star.mesh -o 4 -r 5
+//               locality -m ../../data/beam-tet.mesh -o 3 -r 2
+//
+// Description:  This miniapp measures the effect of the element and DOF
+//               numbering on the memory locality of the two basic sparse
+//               kernels of a finite element code: the gather/scatter between
+//               L-vectors and E-vectors performed by ElementRestriction::Mult
+//               and MultTranspose, and the assembled SparseMatrix::Mult.
+//
+//               The H1 space of the given order is constructed on the refined
+//               mesh in four configurations: (1) mesh and DOFs in their native
+//               order, (2) elements and vertices reordered along a Hilbert
+//               space-filling curve with the native (entity based) DOF
+//               numbering, (3) Hilbert elements with the DOFs numbered in
+//               element order, see DofRenumbering::ELEMENT, and (4) Hilbert
+//               elements with a reverse Cuthill-McKee DOF numbering, see
+//               DofRenumbering::RCM. For each configuration the bandwidth of
+//               the assembled diffusion matrix and the average time of the
+//               three kernels are reported.
+
+#include "mfem.hpp"
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+using namespace mfem;
+
+static int Bandwidth(const SparseMatrix &A)
+{
+   int bw = 0;
+   for (int i = 0; i < A.Height(); i++)
+   {
+      const int *col = A.GetRowColumns(i);
+      for (int j = 0; j < A.RowSize(i); j++)
+      {
+         bw = max(bw, abs(col[j] - i));
+      }
+   }
+   return bw;
+}
+
+static void Benchmark(const char *name, Mesh &mesh, int order,
+                      DofRenumbering::Type renumbering, int iter)
+{
+   H1_FECollection fec(order, mesh.Dimension());
+   FiniteElementSpace fespace(&mesh, &fec);
+   fespace.SetDofRenumbering(renumbering);
+
+   const Operator *R =
+      fespace.GetElementRestriction(ElementDofOrdering::LEXICOGRAPHIC);
+   Vector x(fespace.GetVSize()), y(fespace.GetVSize()), e(R->Height());
+   x.Randomize(1);
+
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fespace);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.Assemble();
+   a.Finalize();
+   const SparseMatrix &A = a.SpMat();
+
+   // Warm up the caches and the lazily constructed data.
+   R->Mult(x, e);
+   R->MultTranspose(e, y);
+   A.Mult(x, y);
+
+   StopWatch sw_mult, sw_mult_t, sw_spmv;
+   for (int i = 0; i < iter; i++)
+   {
+      sw_mult.Start();
+      R->Mult(x, e);
+      sw_mult.Stop();
+
+      sw_mult_t.Start();
+      R->MultTranspose(e, y);
+      sw_mult_t.Stop();
+
+      sw_spmv.Start();
+      A.Mult(x, y);
+      sw_spmv.Stop();
+   }
+
+   cout << setw(22) << left << name << right
+        << setw(12) << Bandwidth(A)
+        << setw(14) << 1e3*sw_mult.RealTime()/iter
+        << setw(14) << 1e3*sw_mult_t.RealTime()/iter
+        << setw(14) << 1e3*sw_spmv.RealTime()/iter << endl;
+}
+
+int main(int argc, char *argv[])
+{
+   // 1. Parse command-line options.
+   const char *mesh_file = "../../data/inline-hex.mesh";
+   int order = 3;
+   int ref_levels = 3;
+   int iter = 20;
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&mesh_file, "-m", "--mesh",
+                  "Mesh file to use.");
+   args.AddOption(&order, "-o", "--order",
+                  "Finite element order (polynomial degree).");
+   args.AddOption(&ref_levels, "-r", "--refine",
+                  "Number of uniform mesh refinements.");
+   args.AddOption(&iter, "-n", "--iterations",
+                  "Number of timed applications of each kernel.");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      return 1;
+   }
+   args.PrintOptions(cout);
+
+   // 2. Read and refine the mesh. Uniform refinement appends the children of
+   //    each element to the element list, which degrades the locality of the
+   //    native ordering.
+   Mesh mesh(mesh_file, 1, 1);
+   for (int l = 0; l < ref_levels; l++)
+   {
+      mesh.UniformRefinement();
+   }
+
+   // 3. Create a copy of the mesh with elements and vertices reordered along a
+   //    Hilbert space-filling curve.
+   Mesh hilbert_mesh(mesh);
+   Array<int> ordering;
+   hilbert_mesh.GetHilbertElementOrdering(ordering);
+   hilbert_mesh.ReorderElements(ordering, true);
+
+   cout << "Number of elements: " << mesh.GetNE() << '\n'
+        << "Order: " << order << "\n\n"
+        << setw(22) << left << "Numbering" << right
+        << setw(12) << "bandwidth"
+        << setw(14) << "E-Mult (ms)"
+        << setw(14) << "E-MultT (ms)"
+        << setw(14) << "SpMV (ms)" << endl;
+
+   // 4. Time the kernels in all configurations.
+   Benchmark("native", mesh, order, DofRenumbering::NATIVE, iter);
+   Benchmark("hilbert", hilbert_mesh, order, DofRenumbering::NATIVE, iter);
+   Benchmark("hilbert + element", hilbert_mesh, order,
+             DofRenumbering::ELEMENT, iter);
+   Benchmark("hilbert + rcm", hilbert_mesh, order, DofRenumbering::RCM, iter);
+
+   return 0;
+}
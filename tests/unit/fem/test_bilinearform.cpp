@@ -65,3 +65,42 @@ TEST_CASE("Test order of boundary integrators",
       delete D;
    }
 }
+
+TEST_CASE("BilinearForm element costs", "[BilinearForm]")
+{
+   Mesh mesh(8, 8, Element::QUADRILATERAL);
+   const int ne = mesh.GetNE();
+
+   H1_FECollection fec(3, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+
+   Vector costs;
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator);
+   a.AddDomainIntegrator(new MassIntegrator);
+   a.SetElementCosts(&costs);
+   a.Assemble();
+
+   REQUIRE(costs.Size() == ne);
+   REQUIRE(costs.Min() >= 0.0);
+   REQUIRE(costs.Sum() > 0.0);
+
+   // Recording stops when the cost vector is unset.
+   a.SetElementCosts(NULL);
+   costs = -1.0;
+   a.Assemble();
+   REQUIRE(costs.Max() == -1.0);
+
+#ifdef MFEM_USE_METIS
+   // The recorded costs give a partitioning that balances them.
+   a.SetElementCosts(&costs);
+   a.Assemble();
+   const int nparts = 4;
+   int *partitioning = mesh.GeneratePartitioning(nparts, costs);
+   std::ostringstream out;
+   const double imbalance =
+      mesh.PrintPartitionBalance(partitioning, nparts, &costs, out);
+   REQUIRE(imbalance < 1.25);
+   delete [] partitioning;
+#endif
+}
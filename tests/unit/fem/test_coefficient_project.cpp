@@ -0,0 +1,255 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+namespace coefficient_project
+{
+
+static double func(const Vector &x)
+{
+   return sin(M_PI*x(0)) + x(x.Size()-1)*x(x.Size()-1) + 2.0;
+}
+
+static void vfunc(const Vector &x, Vector &v)
+{
+   for (int i = 0; i < v.Size(); i++) { v(i) = (i+1)*func(x); }
+}
+
+static void mfunc(const Vector &x, DenseMatrix &m)
+{
+   for (int i = 0; i < m.Height(); i++)
+   {
+      for (int j = 0; j < m.Width(); j++) { m(i,j) = func(x) + i - 2*j; }
+   }
+}
+
+// Compare the batched projection of the coefficient with the pointwise
+// evaluation implemented by the base class.
+static void CheckProject(Coefficient &c, QuadratureSpace &qs)
+{
+   QuadratureFunction qf(&qs), qf0(&qs);
+   c.Project(qf);
+   c.Coefficient::Project(qf0);
+   qf -= qf0;
+   qf.HostRead();
+   REQUIRE(qf.Normlinf() == MFEM_Approx(0.0));
+}
+
+static void CheckProject(VectorCoefficient &c, QuadratureSpace &qs)
+{
+   QuadratureFunction qf(&qs, c.GetVDim()), qf0(&qs, c.GetVDim());
+   c.Project(qf);
+   c.VectorCoefficient::Project(qf0);
+   qf -= qf0;
+   qf.HostRead();
+   REQUIRE(qf.Normlinf() == MFEM_Approx(0.0));
+}
+
+static void CheckProject(MatrixCoefficient &c, QuadratureSpace &qs)
+{
+   const int hw = c.GetHeight()*c.GetWidth();
+   for (int transpose = 0; transpose <= 1; transpose++)
+   {
+      QuadratureFunction qf(&qs, hw), qf0(&qs, hw);
+      c.Project(qf, transpose);
+      c.MatrixCoefficient::Project(qf0, transpose);
+      qf -= qf0;
+      qf.HostRead();
+      REQUIRE(qf.Normlinf() == MFEM_Approx(0.0));
+   }
+}
+
+static void TestProject(Mesh &mesh, int order)
+{
+   const int dim = mesh.Dimension();
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(&mesh, &fec), vfes(&mesh, &fec, dim);
+   L2_FECollection l2_fec(order, dim);
+   FiniteElementSpace l2_fes(&mesh, &l2_fec);
+
+   FunctionCoefficient f_coeff(func);
+   VectorFunctionCoefficient vf_coeff(dim, vfunc);
+   GridFunction x(&fes), vx(&vfes), l2_x(&l2_fes);
+   x.ProjectCoefficient(f_coeff);
+   vx.ProjectCoefficient(vf_coeff);
+   l2_x.ProjectCoefficient(f_coeff);
+
+   const IntegrationRule &ir =
+      IntRules.Get(mesh.GetElementBaseGeometry(0), 2*order + 1);
+   QuadratureSpace qs(&mesh, ir), qs_order(&mesh, 2*order);
+   REQUIRE(qs.GetSize() == mesh.GetNE()*ir.GetNPoints());
+
+   ConstantCoefficient c_coeff(3.0);
+   Vector pw(mesh.attributes.Max());
+   pw.Randomize(1);
+   PWConstCoefficient pw_coeff(pw);
+   GridFunctionCoefficient gf_coeff(&x), l2_coeff(&l2_x);
+   GridFunctionCoefficient gf_comp_coeff(&vx, dim);
+   QuadratureFunction q(&qs);
+   f_coeff.Project(q);
+   QuadratureFunctionCoefficient q_coeff(q);
+   SumCoefficient sum_coeff(gf_coeff, f_coeff, 2.0, -1.0);
+   SumCoefficient sum_c_coeff(1.5, gf_coeff);
+   ProductCoefficient prod_coeff(pw_coeff, f_coeff);
+   ProductCoefficient prod_c_coeff(0.5, gf_coeff);
+   PowerCoefficient pow_coeff(f_coeff, 1.5);
+   FunctionCoefficient td_coeff([](const Vector &x, double t)
+   { return t*x(0); });
+   td_coeff.SetTime(2.0);
+
+   Coefficient *coeffs[] = { &c_coeff, &pw_coeff, &f_coeff, &gf_coeff,
+                             &l2_coeff, &gf_comp_coeff, &sum_coeff,
+                             &sum_c_coeff, &prod_coeff, &prod_c_coeff,
+                             &pow_coeff, &td_coeff
+                           };
+   for (Coefficient *c : coeffs)
+   {
+      CheckProject(*c, qs);
+      CheckProject(*c, qs_order);
+   }
+
+   // The QuadratureFunction coefficients copy the data when the points match.
+   QuadratureFunction qf(&qs);
+   q_coeff.Project(qf);
+   qf -= q;
+   qf.HostRead();
+   REQUIRE(qf.Normlinf() == MFEM_Approx(0.0));
+
+   Vector v(dim);
+   v.Randomize(2);
+   VectorConstantCoefficient vc_coeff(v);
+   VectorFunctionCoefficient vfq_coeff(dim, vfunc, &gf_coeff);
+   VectorGridFunctionCoefficient vgf_coeff(&vx);
+   QuadratureFunction vq(&qs, dim + 1);
+   vq.Randomize(3);
+   VectorQuadratureFunctionCoefficient vq_coeff(vq);
+   vq_coeff.SetComponent(1, dim);
+
+   VectorCoefficient *vcoeffs[] = { &vc_coeff, &vf_coeff, &vfq_coeff,
+                                    &vgf_coeff
+                                  };
+   for (VectorCoefficient *c : vcoeffs)
+   {
+      CheckProject(*c, qs);
+   }
+
+   QuadratureFunction vqf(&qs, dim);
+   vq_coeff.Project(vqf);
+   vqf.HostRead();
+   vq.HostRead();
+   for (int i = 0; i < qs.GetSize(); i++)
+   {
+      for (int j = 0; j < dim; j++)
+      {
+         REQUIRE(vqf(j + i*dim) == vq(j + 1 + i*(dim + 1)));
+      }
+   }
+
+   DenseMatrix m(dim, dim + 1);
+   m.Diag(1.0, dim);
+   m(0, dim) = 2.0;
+   MatrixConstantCoefficient mc_coeff(m);
+   MatrixFunctionCoefficient mf_coeff(dim, mfunc);
+   CheckProject(mc_coeff, qs);
+   CheckProject(mf_coeff, qs);
+
+   // The batched evaluation is exact for the GridFunction: it reproduces the
+   // interpolant at the quadrature points.
+   QuadratureFunction qx(&qs);
+   gf_coeff.Project(qx);
+   qx.HostRead();
+   x.HostRead();
+   Vector values;
+   for (int e = 0; e < mesh.GetNE(); e++)
+   {
+      qx.GetElementValues(e, values);
+      for (int i = 0; i < ir.GetNPoints(); i++)
+      {
+         REQUIRE(values(i) == MFEM_Approx(x.GetValue(e, ir.IntPoint(i))));
+      }
+   }
+}
+
+TEST_CASE("Coefficient Project", "[Coefficient][QuadratureFunction]")
+{
+   SECTION("Segments")
+   {
+      Mesh mesh(5, 1.0);
+      TestProject(mesh, 2);
+   }
+   SECTION("Quadrilaterals")
+   {
+      Mesh mesh(3, 4, Element::QUADRILATERAL, true);
+      mesh.SetAttribute(0, 2);
+      mesh.SetAttributes();
+      TestProject(mesh, 2);
+   }
+   SECTION("Curved triangles")
+   {
+      Mesh mesh(3, 3, Element::TRIANGLE, true);
+      mesh.SetCurvature(2);
+      TestProject(mesh, 3);
+   }
+   SECTION("Hexahedra")
+   {
+      Mesh mesh(2, 2, 3, Element::HEXAHEDRON, true);
+      mesh.SetCurvature(1);
+      TestProject(mesh, 1);
+   }
+}
+
+TEST_CASE("Coefficient Project PA", "[Coefficient][PartialAssembly]")
+{
+   Mesh mesh(4, 4, Element::QUADRILATERAL, true);
+   mesh.SetCurvature(3);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   FunctionCoefficient f_coeff(func);
+   MatrixFunctionCoefficient m_coeff(2, mfunc);
+
+   for (int i = 0; i < 3; i++)
+   {
+      BilinearForm a_fa(&fes), a_pa(&fes);
+      a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      if (i == 0)
+      {
+         a_fa.AddDomainIntegrator(new MassIntegrator(f_coeff));
+         a_pa.AddDomainIntegrator(new MassIntegrator(f_coeff));
+      }
+      else if (i == 1)
+      {
+         a_fa.AddDomainIntegrator(new DiffusionIntegrator(f_coeff));
+         a_pa.AddDomainIntegrator(new DiffusionIntegrator(f_coeff));
+      }
+      else
+      {
+         a_fa.AddDomainIntegrator(new DiffusionIntegrator(m_coeff));
+         a_pa.AddDomainIntegrator(new DiffusionIntegrator(m_coeff));
+      }
+      a_fa.Assemble();
+      a_fa.Finalize();
+      a_pa.Assemble();
+
+      Vector x(fes.GetVSize()), y_fa(fes.GetVSize()), y_pa(fes.GetVSize());
+      x.Randomize(1);
+      a_fa.Mult(x, y_fa);
+      a_pa.Mult(x, y_pa);
+      y_pa -= y_fa;
+      y_pa.HostRead();
+      REQUIRE(y_pa.Normlinf() == MFEM_Approx(0.0));
+   }
+}
+
+} // namespace coefficient_project
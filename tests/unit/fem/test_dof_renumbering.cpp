@@ -0,0 +1,219 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+namespace dof_renumbering
+{
+
+static void func(const Vector &x, Vector &v)
+{
+   for (int i = 0; i < v.Size(); i++)
+   {
+      v(i) = sin(M_PI*(i+1)*x(0)) + x(1)*x(x.Size()-1) + i;
+   }
+}
+
+static int Bandwidth(const SparseMatrix &A)
+{
+   int bw = 0;
+   for (int i = 0; i < A.Height(); i++)
+   {
+      const int *col = A.GetRowColumns(i);
+      for (int j = 0; j < A.RowSize(i); j++)
+      {
+         bw = std::max(bw, std::abs(col[j] - i));
+      }
+   }
+   return bw;
+}
+
+static void AssembleMass(BilinearForm &a)
+{
+   const FiniteElementSpace &fes = *a.FESpace();
+   if (fes.GetFE(0)->GetRangeType() == FiniteElement::VECTOR)
+   {
+      a.AddDomainIntegrator(new VectorFEMassIntegrator);
+   }
+   else if (fes.GetVDim() == 1)
+   {
+      a.AddDomainIntegrator(new MassIntegrator);
+   }
+   else
+   {
+      a.AddDomainIntegrator(new VectorMassIntegrator);
+   }
+   a.Assemble();
+   a.Finalize();
+}
+
+static double Energy(FiniteElementSpace &fes, const GridFunction &x)
+{
+   BilinearForm a(&fes);
+   AssembleMass(a);
+   return a.SpMat().InnerProduct(x, x);
+}
+
+static void TestRenumbering(Mesh &mesh, const FiniteElementCollection &fec,
+                            int vdim)
+{
+   const int dim = mesh.Dimension();
+   FiniteElementSpace fes0(&mesh, &fec, vdim);
+   const bool vector_fe =
+      (fes0.GetFE(0)->GetRangeType() == FiniteElement::VECTOR);
+   VectorFunctionCoefficient coeff(vector_fe ? dim : vdim, func);
+   GridFunction x0(&fes0);
+   x0.ProjectCoefficient(coeff);
+   const double energy0 = Energy(fes0, x0);
+
+   const Operator *R0 =
+      fes0.GetElementRestriction(ElementDofOrdering::NATIVE);
+   Vector e0(R0->Height());
+   R0->Mult(x0, e0);
+
+   for (int t = DofRenumbering::ELEMENT; t <= DofRenumbering::RCM; t++)
+   {
+      FiniteElementSpace fes(&mesh, &fec, vdim);
+      fes.SetDofRenumbering(DofRenumbering::Type(t));
+      REQUIRE(fes.GetDofRenumbering() == t);
+      REQUIRE(fes.GetNDofs() == fes0.GetNDofs());
+      REQUIRE(fes.GetTrueVSize() == fes0.GetTrueVSize());
+
+      // The renumbering is a permutation of the DOFs that preserves the DOF
+      // signs and the element-local DOF order.
+      Array<int> seen(fes.GetNDofs()), dofs, dofs0;
+      seen = 0;
+      for (int i = 0; i < mesh.GetNE(); i++)
+      {
+         fes.GetElementDofs(i, dofs);
+         fes0.GetElementDofs(i, dofs0);
+         REQUIRE(dofs.Size() == dofs0.Size());
+         for (int j = 0; j < dofs.Size(); j++)
+         {
+            REQUIRE((dofs[j] < 0) == (dofs0[j] < 0));
+            seen[dofs[j] < 0 ? -1-dofs[j] : dofs[j]] = 1;
+         }
+      }
+      REQUIRE(seen.Sum() == fes.GetNDofs());
+      if (t == DofRenumbering::ELEMENT)
+      {
+         // The DOFs of the first element come first.
+         fes.GetElementDofs(0, dofs);
+         for (int j = 0; j < dofs.Size(); j++)
+         {
+            REQUIRE((dofs[j] < 0 ? -1-dofs[j] : dofs[j]) < dofs.Size());
+         }
+      }
+      for (int i = 0; i < mesh.GetNBE(); i++)
+      {
+         fes.GetBdrElementDofs(i, dofs);
+         fes0.GetBdrElementDofs(i, dofs0);
+         REQUIRE(dofs.Size() == dofs0.Size());
+      }
+
+      GridFunction x(&fes);
+      x.ProjectCoefficient(coeff);
+      REQUIRE(x.ComputeL2Error(coeff) ==
+              MFEM_Approx(x0.ComputeL2Error(coeff)));
+      REQUIRE(Energy(fes, x) == MFEM_Approx(energy0));
+
+      // E-vectors do not depend on the DOF numbering.
+      const Operator *R = fes.GetElementRestriction(ElementDofOrdering::NATIVE);
+      Vector e(R->Height());
+      R->Mult(x, e);
+      e -= e0;
+      REQUIRE(e.Normlinf() == MFEM_Approx(0.0));
+
+      // The number of essential boundary DOFs is preserved.
+      Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdof, ess_tdof0;
+      ess_bdr = 1;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdof);
+      fes0.GetEssentialTrueDofs(ess_bdr, ess_tdof0);
+      REQUIRE(ess_tdof.Size() == ess_tdof0.Size());
+
+      if (t == DofRenumbering::RCM && dim > 1 && mesh.Conforming())
+      {
+         BilinearForm a(&fes), a0(&fes0);
+         AssembleMass(a);
+         AssembleMass(a0);
+         REQUIRE(Bandwidth(a.SpMat()) < Bandwidth(a0.SpMat()));
+      }
+   }
+}
+
+TEST_CASE("DOF renumbering", "[FiniteElementSpace]")
+{
+   SECTION("Quadrilaterals, H1")
+   {
+      Mesh mesh(6, 5, Element::QUADRILATERAL, true);
+      Array<int> ordering;
+      mesh.GetHilbertElementOrdering(ordering);
+      mesh.ReorderElements(ordering);
+      H1_FECollection fec(3, 2);
+      TestRenumbering(mesh, fec, 1);
+      TestRenumbering(mesh, fec, 2);
+   }
+   SECTION("Tetrahedra, ND")
+   {
+      Mesh mesh(2, 2, 2, Element::TETRAHEDRON, true);
+      mesh.ReorientTetMesh();
+      ND_FECollection fec(2, 3);
+      TestRenumbering(mesh, fec, 1);
+   }
+   SECTION("Hexahedra, H1 and RT")
+   {
+      Mesh mesh(3, 2, 2, Element::HEXAHEDRON, true);
+      H1_FECollection h1_fec(2, 3);
+      TestRenumbering(mesh, h1_fec, 1);
+      RT_FECollection rt_fec(1, 3);
+      TestRenumbering(mesh, rt_fec, 1);
+   }
+   SECTION("Nonconforming quadrilaterals, H1")
+   {
+      Mesh mesh(3, 3, Element::QUADRILATERAL, true);
+      mesh.EnsureNCMesh();
+      Array<int> refs;
+      refs.Append(0);
+      refs.Append(4);
+      mesh.GeneralRefinement(refs);
+      H1_FECollection fec(2, 2);
+      TestRenumbering(mesh, fec, 1);
+   }
+}
+
+TEST_CASE("DOF renumbering update", "[FiniteElementSpace]")
+{
+   Mesh mesh(4, 4, Element::QUADRILATERAL, true);
+   H1_FECollection fec(2, 2);
+   FunctionCoefficient coeff([](const Vector &x) { return x(0)*x(0) + x(1); });
+
+   FiniteElementSpace fes0(&mesh, &fec), fes(&mesh, &fec);
+   fes.SetDofRenumbering(DofRenumbering::RCM);
+   GridFunction x0(&fes0), x(&fes);
+   x0.ProjectCoefficient(coeff);
+   x.ProjectCoefficient(coeff);
+
+   mesh.UniformRefinement();
+   fes0.Update();
+   fes.Update();
+   x0.Update();
+   x.Update();
+
+   REQUIRE(fes.GetDofRenumbering() == DofRenumbering::RCM);
+   REQUIRE(fes.GetNDofs() == fes0.GetNDofs());
+   REQUIRE(x.ComputeL2Error(coeff) == MFEM_Approx(x0.ComputeL2Error(coeff)));
+   REQUIRE(x.ComputeL2Error(coeff) == MFEM_Approx(0.0));
+}
+
+} // namespace dof_renumbering
@@ -0,0 +1,140 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+namespace eltrans_batch
+{
+
+static void surface(const Vector &x, Vector &y)
+{
+   y.SetSize(3);
+   y(0) = x(0);
+   y(1) = x(1);
+   y(2) = 0.3*x(0)*x(1);
+}
+
+static double MaxDiff(const DenseMatrix &A, const DenseMatrix &B)
+{
+   REQUIRE(A.Height() == B.Height());
+   REQUIRE(A.Width() == B.Width());
+   DenseMatrix C(A);
+   C -= B;
+   return C.MaxMaxNorm();
+}
+
+// Compare the data computed by SetIntRule() with the pointwise evaluation.
+static void TestBatch(Mesh &mesh, int order)
+{
+   IsoparametricTransformation T, T0;
+   IntegrationRule ir_copy;
+   for (int e = 0; e < mesh.GetNE(); e++)
+   {
+      const IntegrationRule &ir =
+         IntRules.Get(mesh.GetElementBaseGeometry(e), order);
+      mesh.GetElementTransformation(e, &T);
+      mesh.GetElementTransformation(e, &T0);
+      T.SetIntRule(&ir);
+      for (int i = 0; i < ir.GetNPoints(); i++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(i);
+         T.SetIntPoint(&ip);
+         T0.SetIntPoint(&ip);
+         REQUIRE(T.Weight() == MFEM_Approx(T0.Weight()));
+         REQUIRE(MaxDiff(T.Jacobian(), T0.Jacobian()) == MFEM_Approx(0.0));
+         REQUIRE(MaxDiff(T.AdjugateJacobian(), T0.AdjugateJacobian()) ==
+                 MFEM_Approx(0.0));
+         REQUIRE(MaxDiff(T.InverseJacobian(), T0.InverseJacobian()) ==
+                 MFEM_Approx(0.0));
+      }
+
+      // Points that are not in the rule are evaluated pointwise.
+      ir_copy = ir;
+      ir_copy.IntPoint(0).x *= 0.5;
+      T.SetIntPoint(&ir_copy.IntPoint(0));
+      T0.SetIntPoint(&ir_copy.IntPoint(0));
+      REQUIRE(T.Weight() == MFEM_Approx(T0.Weight()));
+      REQUIRE(MaxDiff(T.Jacobian(), T0.Jacobian()) == MFEM_Approx(0.0));
+   }
+
+   // Moving the transformation to another element discards the data.
+   if (mesh.GetNE() > 1)
+   {
+      const IntegrationRule &ir =
+         IntRules.Get(mesh.GetElementBaseGeometry(0), order);
+      mesh.GetElementTransformation(0, &T);
+      T.SetIntRule(&ir);
+      mesh.GetElementTransformation(1, &T);
+      mesh.GetElementTransformation(1, &T0);
+      T.SetIntPoint(&ir.IntPoint(0));
+      T0.SetIntPoint(&ir.IntPoint(0));
+      REQUIRE(MaxDiff(T.Jacobian(), T0.Jacobian()) == MFEM_Approx(0.0));
+   }
+}
+
+TEST_CASE("ElementTransformation SetIntRule", "[ElementTransformation]")
+{
+   SECTION("Segments")
+   {
+      Mesh mesh(4, 2.0);
+      mesh.SetCurvature(2);
+      TestBatch(mesh, 4);
+   }
+
+   SECTION("Curved quadrilaterals")
+   {
+      Mesh mesh(3, 3, Element::QUADRILATERAL, true);
+      mesh.SetCurvature(3);
+      GridFunction &nodes = *mesh.GetNodes();
+      for (int i = 0; i < nodes.Size(); i++)
+      {
+         nodes(i) += 0.02*sin(7.0*i);
+      }
+      TestBatch(mesh, 5);
+   }
+
+   SECTION("Triangles")
+   {
+      Mesh mesh(3, 2, Element::TRIANGLE, true);
+      TestBatch(mesh, 3);
+   }
+
+   SECTION("Surface")
+   {
+      Mesh mesh(3, 3, Element::QUADRILATERAL, true);
+      mesh.SetCurvature(2, false, 3);
+      mesh.Transform(surface);
+      TestBatch(mesh, 4);
+   }
+
+   SECTION("Curved tetrahedra")
+   {
+      Mesh mesh(2, 2, 2, Element::TETRAHEDRON, true);
+      mesh.SetCurvature(2);
+      GridFunction &nodes = *mesh.GetNodes();
+      for (int i = 0; i < nodes.Size(); i++)
+      {
+         nodes(i) += 0.02*cos(5.0*i);
+      }
+      TestBatch(mesh, 4);
+   }
+
+   SECTION("Hexahedra")
+   {
+      Mesh mesh(2, 2, 2, Element::HEXAHEDRON, true);
+      TestBatch(mesh, 3);
+   }
+}
+
+} // namespace eltrans_batch
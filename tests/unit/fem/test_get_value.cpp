@@ -1049,6 +1049,57 @@ TEST_CASE("2D GetValue in Parallel",
              << npts << " 2D points" << std::endl;
 }
 
+TEST_CASE("2D GetValues on face neighbors in Parallel",
+          "[ParGridFunction]"
+          "[Parallel]")
+{
+   // GetValues() with the transformation of a face neighbor element must use
+   // the face neighbor data of the ParGridFunction.
+   int num_procs;
+   MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+   int n = (int)ceil(sqrt(2*num_procs));
+   int dim = 2;
+   int order = 2;
+
+   Mesh mesh(n, n, Element::QUADRILATERAL, 1, 2.0, 3.0);
+   ParMesh pmesh(MPI_COMM_WORLD, mesh);
+
+   FunctionCoefficient funcCoef(func_2D_lin);
+   H1_FECollection h1_fec(order, dim);
+   DG_FECollection dg_fec(order, dim, BasisType::GaussLegendre);
+   ParFiniteElementSpace h1_fespace(&pmesh, &h1_fec);
+   ParFiniteElementSpace dg_fespace(&pmesh, &dg_fec);
+   ParGridFunction h1_x(&h1_fespace);
+   ParGridFunction dg_x(&dg_fespace);
+   h1_x.ProjectCoefficient(funcCoef);
+   dg_x.ProjectCoefficient(funcCoef);
+   h1_x.ExchangeFaceNbrData();
+   dg_x.ExchangeFaceNbrData();
+
+   ParGridFunction *gfs[] = { &h1_x, &dg_x };
+   Vector vals;
+   for (int sf = 0; sf < pmesh.GetNSharedFaces(); sf++)
+   {
+      FaceElementTransformations *FET =
+         pmesh.GetSharedFaceTransformations(sf);
+      ElementTransformation &T = FET->GetElement2Transformation();
+      REQUIRE(T.ElementNo >= pmesh.GetNE());
+      const IntegrationRule &ir = IntRules.Get(Geometry::SQUARE, 2*order);
+      for (ParGridFunction *gf : gfs)
+      {
+         gf->GetValues(T, ir, vals);
+         REQUIRE(vals.Size() == ir.GetNPoints());
+         for (int j = 0; j < ir.GetNPoints(); j++)
+         {
+            const IntegrationPoint &ip = ir.IntPoint(j);
+            T.SetIntPoint(&ip);
+            REQUIRE(vals(j) == MFEM_Approx(funcCoef.Eval(T, ip)));
+         }
+      }
+   }
+}
+
 #endif // MFEM_USE_MPI
 
 TEST_CASE("3D GetValue",
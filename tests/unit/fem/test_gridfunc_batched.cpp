@@ -0,0 +1,205 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+namespace gridfunc_batched
+{
+
+static double func(const Vector &x)
+{
+   return sin(M_PI*x(0)) + x(x.Size()-1)*x(x.Size()-1) + 2.0;
+}
+
+static void grad_func(const Vector &x, Vector &g)
+{
+   g = 0.0;
+   g(0) = M_PI*cos(M_PI*x(0));
+   g(x.Size()-1) += 2.0*x(x.Size()-1);
+}
+
+static void vfunc(const Vector &x, Vector &v)
+{
+   for (int i = 0; i < v.Size(); i++) { v(i) = (i+1)*func(x) - i*x(0); }
+}
+
+static void transform(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.05*sin(M_PI*x(1));
+   y(1) += 0.05*x(0)*x(0);
+}
+
+static void surface(const Vector &x, Vector &y)
+{
+   y(0) = x(0);
+   y(1) = x(1);
+   y(2) = 0.3*x(0)*x(1);
+}
+
+// Element-by-element projection, as done without the batched path.
+static void HostProject(GridFunction &x, Coefficient *c, VectorCoefficient *vc)
+{
+   const FiniteElementSpace &fes = *x.FESpace();
+   Array<int> vdofs;
+   Vector vals;
+   for (int i = 0; i < fes.GetNE(); i++)
+   {
+      fes.GetElementVDofs(i, vdofs);
+      vals.SetSize(vdofs.Size());
+      ElementTransformation &T = *fes.GetElementTransformation(i);
+      if (c) { fes.GetFE(i)->Project(*c, T, vals); }
+      else { fes.GetFE(i)->Project(*vc, T, vals); }
+      x.SetSubVector(vdofs, vals);
+   }
+}
+
+static double SumOfPowers(const Vector &e, double p)
+{
+   double s = 0.0;
+   for (int i = 0; i < e.Size(); i++) { s += pow(e(i), p); }
+   return pow(s, 1.0/p);
+}
+
+// L2 norm of the gradient error computed with element transformations.
+static double HostGradError(const GridFunction &x, VectorCoefficient &exgrad)
+{
+   const FiniteElementSpace &fes = *x.FESpace();
+   const int sdim = fes.GetMesh()->SpaceDimension();
+   Vector grad, vec(sdim);
+   double error = 0.0;
+   for (int i = 0; i < fes.GetNE(); i++)
+   {
+      const FiniteElement *fe = fes.GetFE(i);
+      const IntegrationRule &ir =
+         IntRules.Get(fe->GetGeomType(), 2*fe->GetOrder() + 3);
+      ElementTransformation &T = *fes.GetElementTransformation(i);
+      for (int j = 0; j < ir.GetNPoints(); j++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(j);
+         T.SetIntPoint(&ip);
+         x.GetGradient(T, grad);
+         exgrad.Eval(vec, T, ip);
+         vec -= grad;
+         error += ip.weight * T.Weight() * (vec * vec);
+      }
+   }
+   return sqrt(error);
+}
+
+static void TestBatched(Mesh &mesh, int order)
+{
+   const int dim = mesh.Dimension();
+   const int sdim = mesh.SpaceDimension();
+   H1_FECollection h1_fec(order, dim);
+   L2_FECollection l2_fec(order, dim);
+   FiniteElementSpace fes(&mesh, &h1_fec), vfes(&mesh, &h1_fec, sdim);
+   FiniteElementSpace l2_fes(&mesh, &l2_fec);
+   FunctionCoefficient c(func);
+   VectorFunctionCoefficient gc(sdim, grad_func), vc(sdim, vfunc);
+   ConstantCoefficient w(0.5);
+   Vector vw_val(sdim);
+   vw_val = 1.5;
+   VectorConstantCoefficient vw(vw_val);
+
+   GridFunction x(&fes), x0(&fes), v(&vfes), v0(&vfes);
+   GridFunction y(&l2_fes), y0(&l2_fes);
+   x.ProjectCoefficient(c);
+   HostProject(x0, &c, NULL);
+   v.ProjectCoefficient(vc);
+   HostProject(v0, NULL, &vc);
+   y.ProjectCoefficient(c);
+   HostProject(y0, &c, NULL);
+   x -= x0;
+   v -= v0;
+   y -= y0;
+   x.HostRead();
+   v.HostRead();
+   y.HostRead();
+   REQUIRE(x.Normlinf() == MFEM_Approx(0.0));
+   REQUIRE(v.Normlinf() == MFEM_Approx(0.0));
+   REQUIRE(y.Normlinf() == MFEM_Approx(0.0));
+   x = x0;
+   v = v0;
+   y = y0;
+
+   Vector e(mesh.GetNE());
+   for (double p = 1.0; p <= 3.0; p += 1.0)
+   {
+      x.ComputeElementLpErrors(p, c, e, &w);
+      REQUIRE(x.ComputeLpError(p, c, &w) == MFEM_Approx(SumOfPowers(e, p)));
+      y.ComputeElementLpErrors(p, c, e);
+      REQUIRE(y.ComputeLpError(p, c) == MFEM_Approx(SumOfPowers(e, p)));
+      v.ComputeElementLpErrors(p, vc, e);
+      REQUIRE(v.ComputeLpError(p, vc) == MFEM_Approx(SumOfPowers(e, p)));
+      v.ComputeElementLpErrors(p, vc, e, &w, &vw);
+      REQUIRE(v.ComputeLpError(p, vc, &w, &vw) ==
+              MFEM_Approx(SumOfPowers(e, p)));
+   }
+   x.ComputeElementMaxErrors(c, e);
+   REQUIRE(x.ComputeMaxError(c) == MFEM_Approx(e.Max()));
+   v.ComputeElementMaxErrors(vc, e);
+   REQUIRE(v.ComputeMaxError(vc) == MFEM_Approx(e.Max()));
+   v.ComputeElementL2Errors(vc, e);
+   REQUIRE(v.ComputeL2Error(vc) == MFEM_Approx(e.Norml2()));
+
+   if (dim == sdim)
+   {
+      REQUIRE(x.ComputeGradError(&gc) == MFEM_Approx(HostGradError(x, gc)));
+      x.ComputeElementL2Errors(c, e);
+      const double h1_err = sqrt(pow(e.Norml2(), 2) +
+                                 pow(HostGradError(x, gc), 2));
+      REQUIRE(x.ComputeH1Error(&c, &gc) == MFEM_Approx(h1_err));
+   }
+}
+
+TEST_CASE("GridFunction batched errors", "[GridFunction]")
+{
+   SECTION("Segments")
+   {
+      Mesh mesh(5, 1.0);
+      TestBatched(mesh, 3);
+   }
+   SECTION("Quadrilaterals")
+   {
+      Mesh mesh(3, 2, Element::QUADRILATERAL, true);
+      TestBatched(mesh, 2);
+   }
+   SECTION("Curved triangles")
+   {
+      Mesh mesh(2, 3, Element::TRIANGLE, true);
+      mesh.SetCurvature(3);
+      mesh.Transform(transform);
+      TestBatched(mesh, 2);
+   }
+   SECTION("Surface quadrilaterals")
+   {
+      Mesh mesh(3, 3, Element::QUADRILATERAL, true);
+      mesh.SetCurvature(2, false, 3);
+      mesh.Transform(surface);
+      TestBatched(mesh, 2);
+   }
+   SECTION("Hexahedra")
+   {
+      Mesh mesh(2, 2, 2, Element::HEXAHEDRON, true);
+      TestBatched(mesh, 2);
+   }
+   SECTION("Mixed geometries")
+   {
+      Mesh mesh("../../data/star-mixed.mesh", 1, 1);
+      TestBatched(mesh, 2);
+   }
+}
+
+} // namespace gridfunc_batched
@@ -0,0 +1,189 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+enum class Space { H1, ND, RT };
+
+// Solve the H1 diffusion, ND curl-curl and RT div-div problems with CG,
+// preconditioned with an accurate solve of the LOR system, and return the
+// number of iterations.
+static int LORIterations(Space space, int dim, int order)
+{
+   Mesh *mesh = (dim == 2) ?
+                new Mesh(4, 4, Element::QUADRILATERAL, true) :
+                new Mesh(2, 2, 2, Element::HEXAHEDRON, true);
+   FiniteElementCollection *fec = NULL;
+   switch (space)
+   {
+      case Space::H1: fec = new H1_FECollection(order, dim); break;
+      case Space::ND: fec = new ND_FECollection(order, dim); break;
+      case Space::RT: fec = new RT_FECollection(order - 1, dim); break;
+   }
+   FiniteElementSpace fes(mesh, fec);
+
+   BilinearForm a(&fes);
+   switch (space)
+   {
+      case Space::H1:
+         a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+         a.AddDomainIntegrator(new DiffusionIntegrator);
+         break;
+      case Space::ND:
+         a.AddDomainIntegrator(new CurlCurlIntegrator);
+         a.AddDomainIntegrator(new VectorFEMassIntegrator);
+         break;
+      case Space::RT:
+         a.AddDomainIntegrator(new DivDivIntegrator);
+         a.AddDomainIntegrator(new VectorFEMassIntegrator);
+         break;
+   }
+   a.Assemble();
+
+   Array<int> ess_bdr(mesh->bdr_attributes.Max()), ess_tdof_list;
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+   OperatorPtr A;
+   a.FormSystemMatrix(ess_tdof_list, A);
+
+   LORSolver lor(a, ess_bdr);
+   REQUIRE(lor.GetFESpace().GetTrueVSize() == fes.GetTrueVSize());
+   if (space == Space::H1)
+   {
+      REQUIRE(lor.GetDofMap().NumNonZeroElems() == fes.GetTrueVSize());
+   }
+
+   CGSolver lor_cg;
+   lor_cg.SetRelTol(1e-12);
+   lor_cg.SetMaxIter(2000);
+   GSSmoother gs(static_cast<const SparseMatrix&>(lor.GetAssembledMatrix()));
+   lor_cg.SetPreconditioner(gs);
+   lor.SetSolver(lor_cg);
+
+   Vector B(fes.GetTrueVSize()), X(fes.GetTrueVSize());
+   B.Randomize(1);
+   for (int i = 0; i < ess_tdof_list.Size(); i++) { B(ess_tdof_list[i]) = 0.0; }
+   X = 0.0;
+
+   CGSolver cg;
+   cg.SetRelTol(1e-8);
+   cg.SetMaxIter(500);
+   cg.SetOperator(*A);
+   cg.SetPreconditioner(lor);
+   cg.Mult(B, X);
+   REQUIRE(cg.GetConverged());
+
+   delete fec;
+   delete mesh;
+   return cg.GetNumIterations();
+}
+
+TEST_CASE("LOR Preconditioner", "[LOR]")
+{
+   auto space = GENERATE(Space::H1, Space::ND, Space::RT);
+   auto dim = GENERATE(2, 3);
+   CAPTURE(int(space), dim);
+
+   // The number of iterations should be bounded independently of the order.
+   REQUIRE(LORIterations(space, dim, 2) < 30);
+   REQUIRE(LORIterations(space, dim, 4) < 30);
+}
+
+#ifdef MFEM_USE_MPI
+
+TEST_CASE("Parallel LOR Preconditioner", "[Parallel], [LOR]")
+{
+   // The LOR mesh refines the ParMesh, the LOR true dofs are those owned by
+   // the same rank as the high-order ones, and the default LOR solver is AMG,
+   // AMS or ADS depending on the space.
+   auto space = GENERATE(Space::H1, Space::ND, Space::RT);
+   CAPTURE(int(space));
+   const int dim = 3, order = 2;
+   Mesh mesh(2, 2, 2, Element::HEXAHEDRON, true);
+   ParMesh pmesh(MPI_COMM_WORLD, mesh);
+   FiniteElementCollection *fec = NULL;
+   switch (space)
+   {
+      case Space::H1: fec = new H1_FECollection(order, dim); break;
+      case Space::ND: fec = new ND_FECollection(order, dim); break;
+      case Space::RT: fec = new RT_FECollection(order - 1, dim); break;
+   }
+   ParFiniteElementSpace fes(&pmesh, fec);
+
+   ParBilinearForm a(&fes);
+   switch (space)
+   {
+      case Space::H1:
+         a.AddDomainIntegrator(new DiffusionIntegrator);
+         break;
+      case Space::ND:
+         a.AddDomainIntegrator(new CurlCurlIntegrator);
+         a.AddDomainIntegrator(new VectorFEMassIntegrator);
+         break;
+      case Space::RT:
+         a.AddDomainIntegrator(new DivDivIntegrator);
+         a.AddDomainIntegrator(new VectorFEMassIntegrator);
+         break;
+   }
+   a.Assemble();
+
+   Array<int> ess_bdr(pmesh.bdr_attributes.Max()), ess_tdof_list;
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+   HypreParMatrix A;
+   a.FormSystemMatrix(ess_tdof_list, A);
+
+   LORSolver lor(a, ess_bdr);
+   ParFiniteElementSpace *fes_lor =
+      dynamic_cast<ParFiniteElementSpace*>(&lor.GetFESpace());
+   REQUIRE(fes_lor != NULL);
+   REQUIRE(fes_lor->GetParMesh()->GetGlobalNE() ==
+           pmesh.GetGlobalNE()*order*order*order);
+   REQUIRE(fes_lor->GetTrueVSize() == fes.GetTrueVSize());
+   REQUIRE(fes_lor->GlobalTrueVSize() == fes.GlobalTrueVSize());
+   REQUIRE(lor.GetDofMap().Height() == fes.GetTrueVSize());
+   if (space == Space::H1)
+   {
+      REQUIRE(lor.GetDofMap().NumNonZeroElems() == fes.GetTrueVSize());
+   }
+   switch (space)
+   {
+      case Space::H1:
+         REQUIRE(dynamic_cast<HypreBoomerAMG*>(&lor.GetSolver()) != NULL);
+         break;
+      case Space::ND:
+         REQUIRE(dynamic_cast<HypreAMS*>(&lor.GetSolver()) != NULL);
+         break;
+      case Space::RT:
+         REQUIRE(dynamic_cast<HypreADS*>(&lor.GetSolver()) != NULL);
+         break;
+   }
+
+   Vector B(fes.GetTrueVSize()), X(fes.GetTrueVSize());
+   B.Randomize(1);
+   for (int i = 0; i < ess_tdof_list.Size(); i++) { B(ess_tdof_list[i]) = 0.0; }
+   X = 0.0;
+
+   CGSolver cg(MPI_COMM_WORLD);
+   cg.SetRelTol(1e-8);
+   cg.SetMaxIter(500);
+   cg.SetOperator(A);
+   cg.SetPreconditioner(lor);
+   cg.Mult(B, X);
+   REQUIRE(cg.GetConverged());
+
+   delete fec;
+}
+
+#endif // MFEM_USE_MPI
@@ -459,4 +459,75 @@ TEST_CASE("PA Convection", "[PartialAssembly]")
 
 } // test case
 
+static void simd_coeff_matrix(const Vector &x, DenseMatrix &K)
+{
+   const int dim = x.Size();
+   K.SetSize(dim);
+   for (int i = 0; i < dim; i++)
+   {
+      for (int j = 0; j < dim; j++)
+      {
+         K(i,j) = (i == j) ? 2.0 + x(i) : 0.1*(i + 1)*x(j);
+      }
+   }
+}
+
+static void simd_velocity(const Vector &x, Vector &v)
+{
+   for (int i = 0; i < x.Size(); i++) { v(i) = 1.0 + (i + 1)*x(i); }
+}
+
+static double simd_coeff(const Vector &x) { return 1.0 + x.Norml2(); }
+
+// Compare the SIMD kernels of class SimdPA with the MFEM_FORALL kernels
+TEST_CASE("PA SIMD Kernels", "[PartialAssembly]")
+{
+   const int dim = GENERATE(2, 3);
+   const int order = GENERATE(1, 2, 3);
+   const int integ = GENERATE(0, 1, 2, 3, 4);
+
+   // The number of elements is not a multiple of the SIMD width.
+   Mesh *mesh_ptr = (dim == 2) ? new Mesh(3, 3, Element::QUADRILATERAL) :
+                    new Mesh(3, 1, 1, Element::HEXAHEDRON);
+   Mesh &mesh = *mesh_ptr;
+   mesh.EnsureNodes();
+   GridFunction *nodes = mesh.GetNodes();
+   for (int i = 0; i < nodes->Size(); i++)
+   {
+      (*nodes)(i) += 0.01*sin(10.0*i);
+   }
+
+   H1_FECollection fec(order, dim);
+   const int vdim = (integ == 2) ? dim : 1;
+   FiniteElementSpace fes(&mesh, &fec, vdim);
+   FunctionCoefficient q(simd_coeff);
+   ConstantCoefficient cq(2.0);
+   MatrixFunctionCoefficient mq(dim, simd_coeff_matrix);
+   VectorFunctionCoefficient vq(dim, simd_velocity);
+
+   BilinearForm a(&fes);
+   a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   switch (integ)
+   {
+      case 0: a.AddDomainIntegrator(new MassIntegrator(q)); break;
+      case 1: a.AddDomainIntegrator(new DiffusionIntegrator(q)); break;
+      case 2: a.AddDomainIntegrator(new VectorMassIntegrator(cq)); break;
+      case 3: a.AddDomainIntegrator(new ConvectionIntegrator(vq)); break;
+      case 4: a.AddDomainIntegrator(new DiffusionIntegrator(mq)); break;
+   }
+   a.Assemble();
+
+   GridFunction x(&fes), y_simd(&fes), y_ref(&fes);
+   x.Randomize(1);
+   SimdPA::Enable(false);
+   a.Mult(x, y_ref);
+   SimdPA::Enable(true);
+   a.Mult(x, y_simd);
+   SimdPA::Enable(SimdPA::Width() > 1);
+
+   y_simd -= y_ref;
+   REQUIRE(y_simd.Normlinf() <= 1e-12*y_ref.Normlinf());
+   delete mesh_ptr;
+}
+
 } // namespace pa_kernels
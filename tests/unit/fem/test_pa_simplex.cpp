@@ -0,0 +1,205 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+namespace pa_simplex
+{
+
+static void perturb(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.1*sin(3.0*x(1));
+   y(1) += 0.1*sin(2.0*x(0));
+}
+
+static double coeff(const Vector &x)
+{
+   return 1.0 + x(0) + 0.5*x(1)*x(1);
+}
+
+// Compare the partially assembled mass and diffusion operators and their
+// diagonals with the full assembly. The explicit rule makes both exact. On
+// meshes with more than one geometry, the default rules are used with a
+// piecewise constant coefficient, which they integrate exactly on the
+// straight-sided elements used below.
+static void TestSimplexPA(Mesh &mesh, int order, int btype, bool diffusion)
+{
+   const int dim = mesh.Dimension();
+   H1_FECollection fec(order, dim, btype);
+   FiniteElementSpace fes(&mesh, &fec);
+   const Geometry::Type geom = mesh.GetElementBaseGeometry(0);
+   const IntegrationRule &ir = IntRules.Get(geom, 2*order + 2);
+   const bool mixed = mesh.GetNumGeometries(dim) > 1;
+   FunctionCoefficient fq(coeff);
+   Vector pw(mesh.attributes.Max());
+   for (int i = 0; i < pw.Size(); i++) { pw(i) = 1.0 + i; }
+   PWConstCoefficient pq(pw);
+   Coefficient &q = mixed ? static_cast<Coefficient&>(pq) : fq;
+
+   BilinearForm a_fa(&fes), a_pa(&fes);
+   a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   for (BilinearForm *a : { &a_fa, &a_pa })
+   {
+      BilinearFormIntegrator *integ;
+      if (diffusion) { integ = new DiffusionIntegrator(q); }
+      else { integ = new MassIntegrator(q); }
+      if (!mixed) { integ->SetIntRule(&ir); }
+      a->AddDomainIntegrator(integ);
+      a->Assemble();
+   }
+   a_fa.Finalize();
+
+   GridFunction x(&fes), y_fa(&fes), y_pa(&fes);
+   x.Randomize(1);
+   a_fa.Mult(x, y_fa);
+   a_pa.Mult(x, y_pa);
+   y_pa -= y_fa;
+   REQUIRE(y_pa.Normlinf() == MFEM_Approx(0.0));
+
+   Vector d_fa(fes.GetTrueVSize()), d_pa(fes.GetTrueVSize());
+   a_fa.SpMat().GetDiag(d_fa);
+   a_pa.AssembleDiagonal(d_pa);
+   d_pa -= d_fa;
+   REQUIRE(d_pa.Normlinf() == MFEM_Approx(0.0));
+}
+
+TEST_CASE("PA Simplex", "[PartialAssembly]")
+{
+   const int btypes[] = { BasisType::GaussLobatto, BasisType::Positive };
+
+   SECTION("Triangles")
+   {
+      Mesh mesh(3, 3, Element::TRIANGLE, true);
+      mesh.Transform(perturb);
+      for (int btype : btypes)
+      {
+         for (int order = 1; order <= 5; order++)
+         {
+            TestSimplexPA(mesh, order, btype, false);
+            TestSimplexPA(mesh, order, btype, true);
+         }
+      }
+   }
+
+   SECTION("Tetrahedra")
+   {
+      Mesh mesh(2, 2, 2, Element::TETRAHEDRON, true);
+      mesh.Transform(perturb);
+      for (int btype : btypes)
+      {
+         for (int order = 1; order <= 4; order++)
+         {
+            TestSimplexPA(mesh, order, btype, false);
+            TestSimplexPA(mesh, order, btype, true);
+         }
+      }
+   }
+
+   SECTION("Prisms")
+   {
+      Mesh mesh(2, 2, 2, Element::WEDGE, true);
+      mesh.Transform(perturb);
+      for (int btype : btypes)
+      {
+         for (int order = 1; order <= 4; order++)
+         {
+            TestSimplexPA(mesh, order, btype, false);
+            TestSimplexPA(mesh, order, btype, true);
+         }
+      }
+   }
+}
+
+TEST_CASE("PA Mixed Meshes", "[PartialAssembly]")
+{
+   // Each geometry of the mesh is a separate batch of the E-vector.
+   const char *mesh_files[] = { "../../data/square-mixed.mesh",
+                                "../../data/fichera-mixed.mesh"
+                              };
+   for (const char *mesh_file : mesh_files)
+   {
+      Mesh mesh(mesh_file);
+      REQUIRE(mesh.GetNumGeometries(mesh.Dimension()) > 1);
+      for (int i = 0; i < mesh.GetNE(); i++) { mesh.SetAttribute(i, 1 + i%3); }
+      mesh.SetAttributes();
+      for (int order = 1; order <= 3; order++)
+      {
+         TestSimplexPA(mesh, order, BasisType::GaussLobatto, false);
+         TestSimplexPA(mesh, order, BasisType::GaussLobatto, true);
+      }
+   }
+}
+
+TEST_CASE("PA Simplex collapsed rule", "[PartialAssembly]")
+{
+   // The collapsed rules integrate polynomials of their order exactly.
+   const Geometry::Type geoms[] =
+   { Geometry::TRIANGLE, Geometry::TETRAHEDRON, Geometry::PRISM };
+   for (Geometry::Type geom : geoms)
+   {
+      // the collapsed directions of the prism are those of the triangle
+      const int dim = geom == Geometry::TETRAHEDRON ? 3 : 2;
+      for (int q1d = dim - 1; q1d <= 6; q1d++)
+      {
+         const IntegrationRule &ir = SimplexPAMaps::GetCollapsedRule(geom, q1d);
+         REQUIRE(&ir == &SimplexPAMaps::GetCollapsedRule(geom, q1d));
+         const int p = ir.GetOrder();
+         double s = 0.0;
+         for (int i = 0; i < ir.GetNPoints(); i++)
+         {
+            const IntegrationPoint &ip = ir.IntPoint(i);
+            s += ip.weight*pow(ip.x, p);
+         }
+         // the integral of x^p over the reference element is p!/(p+dim)!
+         double exact = 1.0;
+         for (int i = 1; i <= dim; i++) { exact /= p + i; }
+         REQUIRE(s == MFEM_Approx(exact));
+      }
+   }
+}
+
+TEST_CASE("ElementRestriction BooleanMask", "[PartialAssembly]")
+{
+   // The mask selects exactly one E-vector entry for each L-vector entry, also
+   // for the signed dofs of ND and RT spaces and on meshes with more than one
+   // geometry.
+   Mesh mesh("../../data/square-mixed.mesh");
+   const int dim = mesh.Dimension();
+   ND_FECollection nd_fec(2, dim);
+   RT_FECollection rt_fec(1, dim);
+   H1_FECollection h1_fec(2, dim);
+   FiniteElementSpace nd_fes(&mesh, &nd_fec);
+   FiniteElementSpace rt_fes(&mesh, &rt_fec);
+   FiniteElementSpace h1_fes(&mesh, &h1_fec, dim, Ordering::byVDIM);
+   FiniteElementSpace *spaces[] = { &nd_fes, &rt_fes, &h1_fes };
+   for (FiniteElementSpace *fes : spaces)
+   {
+      const ElementRestriction *R = dynamic_cast<const ElementRestriction*>(
+                                       fes->GetElementRestriction(
+                                          ElementDofOrdering::NATIVE));
+      REQUIRE(R != NULL);
+      Vector mask(R->Height()), ones(R->Width());
+      R->BooleanMask(mask);
+      for (int i = 0; i < mask.Size(); i++)
+      {
+         REQUIRE((mask(i) == 0.0 || mask(i) == 1.0));
+      }
+      R->MultTransposeUnsigned(mask, ones);
+      ones -= 1.0;
+      REQUIRE(ones.Normlinf() == 0.0);
+   }
+}
+
+} // namespace pa_simplex
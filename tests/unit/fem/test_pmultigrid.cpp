@@ -0,0 +1,71 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+TEST_CASE("PMultigrid", "[PMultigrid]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      const int order = (dim == 2) ? 6 : 4;
+      Mesh *mesh = (dim == 2) ?
+                   new Mesh(6, 6, Element::QUADRILATERAL, true) :
+                   new Mesh(3, 3, 3, Element::HEXAHEDRON, true);
+      H1_FECollection fec(order, dim);
+      FiniteElementSpace fes(mesh, &fec);
+
+      ConstantCoefficient one(1.0);
+      auto setup = [&](BilinearForm &form)
+      {
+         form.AddDomainIntegrator(new DiffusionIntegrator(one));
+      };
+      BilinearForm a(&fes);
+      a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      setup(a);
+      a.Assemble();
+
+      Array<int> ess_bdr(mesh->bdr_attributes.Max());
+      ess_bdr = 1;
+      PMultigrid mg(a, ess_bdr, setup);
+      REQUIRE(mg.NumLevels() == 3);
+      REQUIRE(mg.GetOrderAtLevel(0) == 1);
+      REQUIRE(mg.GetOrderAtLevel(mg.NumLevels() - 1) == order);
+
+      LinearForm b(&fes);
+      b.AddDomainIntegrator(new DomainLFIntegrator(one));
+      b.Assemble();
+      GridFunction x(&fes);
+      x = 0.0;
+
+      OperatorPtr A;
+      Vector B, X;
+      a.FormLinearSystem(mg.GetEssentialTrueDofs(), x, b, A, X, B);
+
+      CGSolver cg;
+      cg.SetRelTol(1e-8);
+      cg.SetMaxIter(500);
+      cg.SetOperator(*A);
+      cg.Mult(B, X);
+      const int unpreconditioned = cg.GetNumIterations();
+
+      X = 0.0;
+      cg.SetPreconditioner(mg);
+      cg.Mult(B, X);
+      REQUIRE(cg.GetConverged());
+      REQUIRE(cg.GetNumIterations() < 20);
+      REQUIRE(cg.GetNumIterations()*4 < unpreconditioned);
+
+      delete mesh;
+   }
+}
@@ -0,0 +1,164 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+namespace pointlocator
+{
+
+static double func(const Vector &x)
+{
+   return sin(M_PI*x(0)) + x(x.Size()-1)*x(x.Size()-1) + 2.0;
+}
+
+static void vfunc(const Vector &x, Vector &v)
+{
+   for (int i = 0; i < v.Size(); i++) { v(i) = (i+1)*func(x) - x(0); }
+}
+
+static void transform(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.05*sin(M_PI*x(x.Size()-1));
+   if (x.Size() > 1) { y(1) += 0.05*x(0)*x(0); }
+}
+
+static void CheckField(PointLocator &finder, const GridFunction &gf,
+                       double default_value)
+{
+   const Array<int> &elem = finder.GetElem();
+   const int npts = elem.Size();
+   Array<IntegrationPoint> ips;
+   finder.GetIntegrationPoints(ips);
+   Vector vals, val;
+   finder.Interpolate(gf, vals);
+   vals.HostRead();
+   REQUIRE(vals.Size() == npts*gf.VectorDim());
+   for (int p = 0; p < npts; p++)
+   {
+      if (elem[p] >= 0) { gf.GetVectorValue(elem[p], ips[p], val); }
+      for (int c = 0; c < gf.VectorDim(); c++)
+      {
+         const double v = (elem[p] >= 0) ? val(c) : default_value;
+         REQUIRE(vals(p + npts*c) == MFEM_Approx(v));
+      }
+   }
+}
+
+static void TestPointLocator(Mesh &mesh, int order)
+{
+   const int dim = mesh.Dimension();
+   const int npts = 50;
+
+   // Random points, some of them outside of the mesh, ordered by nodes.
+   Vector pos(npts*dim);
+   pos.Randomize(1);
+   for (int i = 0; i < pos.Size(); i++) { pos(i) = 1.6*pos(i) - 0.3; }
+   pos.HostReadWrite();
+
+   PointLocator finder(mesh);
+   const int found = finder.FindPoints(pos);
+   const Array<int> &elem = finder.GetElem();
+   elem.HostRead();
+   REQUIRE(elem.Size() == npts);
+   REQUIRE(found > 0);
+   REQUIRE(found < npts);
+
+   DenseMatrix point_mat(dim, npts);
+   for (int p = 0; p < npts; p++)
+   {
+      for (int d = 0; d < dim; d++) { point_mat(d,p) = pos(p + npts*d); }
+   }
+   Array<int> elem0;
+   Array<IntegrationPoint> ips0, ips;
+   mesh.FindPoints(point_mat, elem0, ips0, false);
+   finder.GetIntegrationPoints(ips);
+
+   // The points are mapped back to their physical coordinates.
+   Vector x, pt;
+   int count = 0;
+   for (int p = 0; p < npts; p++)
+   {
+      if (elem0[p] >= 0) { REQUIRE(elem[p] >= 0); }
+      if (elem[p] < 0) { continue; }
+      count++;
+      ElementTransformation &T = *mesh.GetElementTransformation(elem[p]);
+      T.Transform(ips[p], x);
+      point_mat.GetColumnReference(p, pt);
+      x -= pt;
+      REQUIRE(x.Normlinf() == MFEM_Approx(0.0, 1e-9));
+   }
+   REQUIRE(count == found);
+
+   H1_FECollection h1_fec(order, dim);
+   L2_FECollection l2_fec(order, dim);
+   FiniteElementSpace h1_fes(&mesh, &h1_fec), l2_fes(&mesh, &l2_fec);
+   FiniteElementSpace v_fes(&mesh, &h1_fec, dim);
+   FunctionCoefficient c(func);
+   VectorFunctionCoefficient vc(dim, vfunc);
+   GridFunction u(&h1_fes), v(&l2_fes), w(&v_fes);
+   u.ProjectCoefficient(c);
+   v.ProjectCoefficient(c);
+   w.ProjectCoefficient(vc);
+
+   finder.SetDefaultInterpolationValue(-1.0);
+   CheckField(finder, u, -1.0);
+   CheckField(finder, v, -1.0);
+   CheckField(finder, w, -1.0);
+   if (dim > 1)
+   {
+      ND_FECollection nd_fec(order, dim);
+      FiniteElementSpace nd_fes(&mesh, &nd_fec);
+      GridFunction z(&nd_fes);
+      z.ProjectCoefficient(vc);
+      CheckField(finder, z, -1.0);
+   }
+}
+
+TEST_CASE("PointLocator", "[Mesh][GridFunction]")
+{
+   SECTION("Segments")
+   {
+      Mesh mesh(7, 1.0);
+      TestPointLocator(mesh, 3);
+   }
+   SECTION("Quadrilaterals")
+   {
+      Mesh mesh(5, 4, Element::QUADRILATERAL, true);
+      TestPointLocator(mesh, 2);
+   }
+   SECTION("Curved quadrilaterals")
+   {
+      Mesh mesh(4, 4, Element::QUADRILATERAL, true);
+      mesh.SetCurvature(3);
+      mesh.Transform(transform);
+      TestPointLocator(mesh, 2);
+   }
+   SECTION("Triangles")
+   {
+      Mesh mesh(4, 3, Element::TRIANGLE, true);
+      mesh.SetCurvature(2);
+      mesh.Transform(transform);
+      TestPointLocator(mesh, 2);
+   }
+   SECTION("Curved hexahedra")
+   {
+      Mesh mesh(3, 3, 2, Element::HEXAHEDRON, true);
+      mesh.SetCurvature(2);
+      mesh.Transform(transform);
+      TestPointLocator(mesh, 2);
+   }
+}
+
+} // namespace pointlocator
@@ -0,0 +1,146 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+namespace shape_table
+{
+
+// Compare the tabulated values with CalcShape and CalcDShape.
+static void CheckShapeTable(const FiniteElement &fe, int order)
+{
+   const IntegrationRule &ir = IntRules.Get(fe.GetGeomType(), order);
+   const ShapeTable *table = fe.GetShapeTable(ir);
+   REQUIRE(table != NULL);
+   REQUIRE(table->FE == &fe);
+   REQUIRE(table->IntRule.GetNPoints() == ir.GetNPoints());
+
+   const int nd = fe.GetDof(), dim = fe.GetDim();
+   Vector shape(nd), t_shape;
+   DenseMatrix dshape(nd, dim), t_dshape;
+   for (int i = 0; i < ir.GetNPoints(); i++)
+   {
+      fe.CalcShape(ir.IntPoint(i), shape);
+      fe.CalcDShape(ir.IntPoint(i), dshape);
+      table->CalcShape(i, t_shape);
+      table->CalcDShape(i, t_dshape);
+      REQUIRE(t_shape.Size() == nd);
+      REQUIRE(t_dshape.Height() == nd);
+      REQUIRE(t_dshape.Width() == dim);
+      t_shape -= shape;
+      t_dshape -= dshape;
+      REQUIRE(t_shape.Normlinf() == MFEM_Approx(0.0));
+      REQUIRE(t_dshape.MaxMaxNorm() == MFEM_Approx(0.0));
+   }
+
+   // The tables are matched by the points, not by the IntegrationRule object.
+   IntegrationRule ir_copy(ir);
+   REQUIRE(fe.GetShapeTable(ir_copy) == table);
+   {
+      IntegrationRule ir_tmp(ir);
+      ir_tmp.IntPoint(0).x += 0.125;
+      const ShapeTable *t_tmp = fe.GetShapeTable(ir_tmp);
+      REQUIRE(t_tmp != table);
+      REQUIRE(fe.GetShapeTable(ir_tmp) == t_tmp);
+   }
+   REQUIRE(fe.GetShapeTable(ir) == table);
+}
+
+TEST_CASE("ShapeTable", "[FiniteElement]")
+{
+   const int p = 3;
+
+   SECTION("H1 elements")
+   {
+      H1_SegmentElement seg(p);
+      H1_TriangleElement tri(p);
+      H1_QuadrilateralElement quad(p);
+      H1_TetrahedronElement tet(p);
+      H1_HexahedronElement hex(p);
+      H1_WedgeElement wdg(p);
+      const FiniteElement *fes[] = { &seg, &tri, &quad, &tet, &hex, &wdg };
+      for (const FiniteElement *fe : fes) { CheckShapeTable(*fe, 2*p); }
+   }
+
+   SECTION("L2 and positive elements")
+   {
+      L2_TriangleElement tri(p, BasisType::GaussLegendre);
+      tri.SetMapType(FiniteElement::INTEGRAL);
+      L2_HexahedronElement hex(p);
+      H1Pos_QuadrilateralElement pos(p);
+      const FiniteElement *fes[] = { &tri, &hex, &pos };
+      for (const FiniteElement *fe : fes) { CheckShapeTable(*fe, 2*p); }
+   }
+
+   SECTION("Unsupported elements")
+   {
+      const IntegrationRule &ir = IntRules.Get(Geometry::SQUARE, 2);
+      ND_QuadrilateralElement nd(p);
+      NURBS2DFiniteElement nurbs(p);
+      REQUIRE(nd.GetShapeTable(ir) == NULL);
+      REQUIRE(nurbs.GetShapeTable(ir) == NULL);
+   }
+}
+
+TEST_CASE("ShapeTable assembly", "[FiniteElement]")
+{
+   // The tabulated shapes must reproduce the assembly with the pointwise
+   // evaluation, which is exact for the projection of a polynomial.
+   const int p = 3;
+   Mesh mesh(3, 3, Element::TRIANGLE, true);
+   H1_FECollection fec(p, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+
+   FunctionCoefficient f([](const Vector &x) { return x(0)*x(0)*x(1) + 1.0; });
+   GridFunction x(&fes);
+   x.ProjectCoefficient(f);
+
+   BilinearForm m(&fes);
+   m.AddDomainIntegrator(new MassIntegrator);
+   m.Assemble();
+   m.Finalize();
+   LinearForm b(&fes);
+   b.AddDomainIntegrator(new DomainLFIntegrator(f));
+   b.Assemble();
+
+   // (x, 1) computed with the mass matrix and with the linear form
+   GridFunction one(&fes);
+   one = 1.0;
+   Vector mx(fes.GetVSize());
+   m.Mult(x, mx);
+   REQUIRE((mx*one) == MFEM_Approx(b*one));
+
+   // GetValues and GetGradients at the quadrature points
+   const IntegrationRule &ir = IntRules.Get(Geometry::TRIANGLE, 2*p);
+   Vector vals;
+   DenseMatrix grads;
+   for (int e = 0; e < mesh.GetNE(); e++)
+   {
+      x.GetValues(e, ir, vals);
+      ElementTransformation *T = mesh.GetElementTransformation(e);
+      x.GetGradients(*T, ir, grads);
+      for (int i = 0; i < ir.GetNPoints(); i++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(i);
+         REQUIRE(vals(i) == MFEM_Approx(x.GetValue(e, ip)));
+         T->SetIntPoint(&ip);
+         Vector g(grads.GetColumn(i), 2), g0;
+         x.GetGradient(*T, g0);
+         g -= g0;
+         REQUIRE(g.Normlinf() == MFEM_Approx(0.0));
+      }
+   }
+}
+
+} // namespace shape_table
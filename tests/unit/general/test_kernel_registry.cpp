@@ -0,0 +1,103 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+using namespace mfem;
+
+#include "unit_tests.hpp"
+
+template <int T_D1D = 0, int T_Q1D = 0>
+static int TestKernel(int d1d, int q1d)
+{
+   return T_D1D ? 100*T_D1D + T_Q1D : -(100*d1d + q1d);
+}
+
+typedef int (*TestKernelType)(int, int);
+
+TEST_CASE("Kernel Registry", "[General]")
+{
+   KernelRegistry<TestKernelType> kernels("TestKernel");
+   kernels.Add(3, 6, 7, TestKernel<6,7>);
+   kernels.Add(3, 7, 8, TestKernel<7,8>);
+   kernels.AddFallback(3, TestKernel<>);
+
+   REQUIRE(kernels.Size() == 2);
+   REQUIRE(kernels.Has(3, 6, 7));
+   REQUIRE(!kernels.Has(2, 6, 7));
+   REQUIRE(KernelRegistryBase::Find("TestKernel") == &kernels);
+
+   REQUIRE(kernels.Get(3, 6, 7)(6, 7) == 607);
+   REQUIRE(kernels.Get(3, 7, 8)(7, 8) == 708);
+   REQUIRE(kernels.GetNumFallbacks() == 0);
+
+   REQUIRE(kernels.Get(3, 6, 8)(6, 8) == -608);
+   REQUIRE(kernels.Get(3, 6, 8)(6, 8) == -608);
+   REQUIRE(kernels.GetNumFallbacks() == 2);
+
+   kernels.ResetFallbacks();
+   REQUIRE(kernels.GetNumFallbacks() == 0);
+
+   // The vectorized kernel replaces all the kernels of its dimension when it
+   // is requested, without counting fallbacks.
+   kernels.AddVectorized(3, TestKernel<9,9>);
+   REQUIRE(kernels.Get(3, 6, 7, true)(6, 7) == 909);
+   REQUIRE(kernels.Get(3, 6, 8, true)(6, 8) == 909);
+   REQUIRE(kernels.Get(3, 6, 7, false)(6, 7) == 607);
+   REQUIRE(kernels.GetNumFallbacks() == 0);
+   kernels.AddFallback(2, TestKernel<>);
+   REQUIRE(kernels.Get(2, 6, 8, true)(6, 8) == -608);
+   REQUIRE(kernels.GetNumFallbacks() == 1);
+}
+
+TEST_CASE("PA Kernel Registry", "[General][PartialAssembly]")
+{
+   // Order p = 5 with Q1D = 7 has a specialized 3D diffusion kernel, while
+   // p = 5 with Q1D = 9 uses the generic one. The SIMD kernel, when enabled,
+   // is used for both. It is enabled explicitly since its default depends on
+   // the build.
+   const int order = 5;
+   Mesh mesh(2, 2, 2, Element::HEXAHEDRON);
+   H1_FECollection fec(order, 3);
+   FiniteElementSpace fes(&mesh, &fec);
+   GridFunction x(&fes), y(&fes), y_simd(&fes);
+   x.Randomize(1);
+
+   for (int q1d : {order + 2, order + 4})
+   {
+      const IntegrationRule &ir = IntRules.Get(Geometry::CUBE, 2*q1d - 1);
+      BilinearForm a(&fes);
+      a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      DiffusionIntegrator *integ = new DiffusionIntegrator;
+      integ->SetIntRule(&ir);
+      a.AddDomainIntegrator(integ);
+      a.Assemble();
+
+      // The registry is created by the first call of the kernels, and other
+      // tests may have already recorded fallbacks in it.
+      const KernelRegistryBase *r =
+         KernelRegistryBase::Find("PADiffusionApply");
+      const long fallbacks = r ? r->GetNumFallbacks() : 0;
+      SimdPA::Enable(false);
+      a.Mult(x, y);
+
+      r = KernelRegistryBase::Find("PADiffusionApply");
+      REQUIRE(r != NULL);
+      const long expected = (q1d == order + 2) ? 0 : 1;
+      REQUIRE(r->GetNumFallbacks() - fallbacks == expected);
+
+      SimdPA::Enable(true);
+      a.Mult(x, y_simd);
+      SimdPA::Enable(SimdPA::Width() > 1);
+      REQUIRE(r->GetNumFallbacks() - fallbacks == expected);
+      y_simd -= y;
+      REQUIRE(y_simd.Normlinf() <= 1e-12*y.Normlinf());
+   }
+}
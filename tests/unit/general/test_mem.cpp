@@ -111,4 +111,43 @@ TEST_CASE("MemoryManager", "[MemoryManager]")
    }
 }
 
+TEST_CASE("MemoryPool", "[MemoryManager]")
+{
+   const MemoryType mt = MemoryType::HOST_POOL;
+   mm.Init(); // the memory manager may have been destroyed by a Device
+   const MemoryPoolStats s0 = mm.GetPoolStats(mt);
+
+   TestMemoryTypes(mt, false);
+
+   const int N = 1000; // 8000 bytes, size class of 8192 bytes
+   {
+      Vector x(N, mt);
+      x = 1.0;
+      const MemoryPoolStats s1 = mm.GetPoolStats(mt);
+      REQUIRE(s1.bytes_in_use == s0.bytes_in_use + 8192);
+      REQUIRE(s1.high_water_mark >= s1.bytes_in_use);
+      REQUIRE(s1.num_allocs == s0.num_allocs + 2);
+   }
+   const MemoryPoolStats s2 = mm.GetPoolStats(mt);
+   REQUIRE(s2.bytes_in_use == s0.bytes_in_use);
+   REQUIRE(s2.bytes_reserved >= s2.bytes_in_use + 8192);
+
+   // Allocations of the same size class recycle the cached blocks.
+   for (int i = 0; i < 10; i++)
+   {
+      Vector y(N - i, mt);
+      y = 2.0;
+      REQUIRE(y.Sum() == MFEM_Approx(2.0*(N - i)));
+   }
+   const MemoryPoolStats s3 = mm.GetPoolStats(mt);
+   REQUIRE(s3.num_allocs == s2.num_allocs + 10);
+   REQUIRE(s3.num_reuses == s2.num_reuses + 10);
+   REQUIRE(s3.bytes_reserved == s2.bytes_reserved);
+   REQUIRE(s3.high_water_mark == s2.high_water_mark);
+
+   mm.ReleasePoolMemory(mt);
+   const MemoryPoolStats s4 = mm.GetPoolStats(mt);
+   REQUIRE(s4.bytes_reserved == s4.bytes_in_use);
+}
+
 #endif // _WIN32
@@ -63,3 +63,82 @@ TEST_CASE("OperatorChebyshevSmoother", "[Chebyshev symmetry]")
       delete smoother;
    }
 }
+
+TEST_CASE("OperatorChebyshevSmoother kinds", "[Chebyshev]")
+{
+   const int order = 3;
+   Mesh mesh(4, 4, 4, Element::HEXAHEDRON, true);
+   H1_FECollection fec(order, 3);
+   FiniteElementSpace fespace(&mesh, &fec);
+   Array<int> ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   Array<int> ess_tdof_list;
+   fespace.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   BilinearForm aform(&fespace);
+   aform.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   aform.AddDomainIntegrator(new DiffusionIntegrator);
+   aform.Assemble();
+   OperatorPtr opr;
+   opr.SetType(Operator::ANY_TYPE);
+   aform.FormSystemMatrix(ess_tdof_list, opr);
+   Vector diag(fespace.GetTrueVSize());
+   aform.AssembleDiagonal(diag);
+
+   for (auto kind : { OperatorChebyshevSmoother::Kind::FIRST,
+                      OperatorChebyshevSmoother::Kind::FOURTH
+                    })
+   {
+      for (int cheb_order : { 2, 6 })
+      {
+         OperatorChebyshevSmoother smoother(opr.Ptr(), diag, ess_tdof_list,
+                                            cheb_order);
+         smoother.SetKind(kind);
+
+         // The warm started estimate improves on the initial one.
+         OperatorChebyshevSmoother reference(opr.Ptr(), diag, ess_tdof_list,
+                                             cheb_order);
+         reference.EstimateMaxEigenvalue(200, 1e-12);
+         const double max_eig = reference.GetMaxEigenvalueEstimate();
+         const double error = std::abs(smoother.GetMaxEigenvalueEstimate() -
+                                       max_eig);
+         smoother.EstimateMaxEigenvalue(2);
+         REQUIRE(std::abs(smoother.GetMaxEigenvalueEstimate() - max_eig) <
+                 error);
+
+         // The smoother is symmetric.
+         const int n = smoother.Width();
+         Vector left(n), right(n), out(n);
+         left.Randomize(1);
+         right.Randomize(3);
+         smoother.Mult(right, out);
+         const double forward_val = left * out;
+         smoother.Mult(left, out);
+         const double transpose_val = right * out;
+         REQUIRE(std::abs(forward_val - transpose_val) <
+                 1e-13 * std::abs(forward_val));
+
+         // The stationary iteration with the smoother reduces the energy norm
+         // of a random error.
+         Vector b(n), x(n), Ax(n);
+         b = 0.0;
+         x.Randomize(5);
+         for (int i = 0; i < ess_tdof_list.Size(); i++)
+         {
+            x(ess_tdof_list[i]) = 0.0;
+         }
+         opr->Mult(x, Ax);
+         const double energy = x * Ax;
+         SLISolver sli;
+         sli.SetOperator(*opr);
+         sli.SetPreconditioner(smoother);
+         sli.SetMaxIter(5);
+         sli.SetRelTol(0.0);
+         sli.SetAbsTol(0.0);
+         sli.iterative_mode = true;
+         sli.Mult(b, x);
+         opr->Mult(x, Ax);
+         REQUIRE(x * Ax < 0.1 * energy);
+      }
+   }
+}
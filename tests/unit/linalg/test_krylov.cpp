@@ -0,0 +1,348 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+// Finite difference matrix of -Laplacian + c . grad + shift on an n x n grid
+// of the unit square, with homogeneous Dirichlet boundary conditions.
+static SparseMatrix *ConvectionDiffusion(int n, double c, double shift = 0.0)
+{
+   const double h = 1.0/(n + 1);
+   SparseMatrix *A = new SparseMatrix(n*n);
+   for (int j = 0; j < n; j++)
+   {
+      for (int i = 0; i < n; i++)
+      {
+         const int row = i + n*j;
+         A->Add(row, row, 4.0/(h*h) + shift);
+         if (i > 0) { A->Add(row, row-1, -1.0/(h*h) - c/(2*h)); }
+         if (i < n-1) { A->Add(row, row+1, -1.0/(h*h) + c/(2*h)); }
+         if (j > 0) { A->Add(row, row-n, -1.0/(h*h) - c/(2*h)); }
+         if (j < n-1) { A->Add(row, row+n, -1.0/(h*h) + c/(2*h)); }
+      }
+   }
+   A->Finalize();
+   return A;
+}
+
+static double RelativeResidual(const Operator &A, const Vector &b,
+                               const Vector &x)
+{
+   Vector r(b.Size());
+   A.Mult(x, r);
+   r -= b;
+   return r.Norml2()/b.Norml2();
+}
+
+// Return the l2 norm of x, over all ranks of the solver in parallel.
+static double GlobalNorm(const IterativeSolver &solver, const Vector &x)
+{
+#ifdef MFEM_USE_MPI
+   if (solver.GetComm() != MPI_COMM_NULL)
+   {
+      return sqrt(InnerProduct(solver.GetComm(), x, x));
+   }
+#endif
+   return x.Norml2();
+}
+
+// Solve A x = b with the given solver, check the solution and return the
+// number of iterations.
+static int Solve(IterativeSolver &solver, const Operator &A, Solver &prec,
+                 const Vector &b, double tol)
+{
+   Vector x(b.Size()), r(b.Size());
+   x = 0.0;
+   solver.SetRelTol(tol);
+   solver.SetMaxIter(1000);
+   solver.SetOperator(A);
+   solver.SetPreconditioner(prec);
+   solver.Mult(b, x);
+
+   REQUIRE(solver.GetConverged());
+   A.Mult(x, r);
+   r -= b;
+   REQUIRE(GlobalNorm(solver, r) < 1e3*tol*GlobalNorm(solver, b));
+   return solver.GetNumIterations();
+}
+
+// Solver wrapper counting the applications of an operator.
+class CountingSolver : public Solver
+{
+   const Operator &op;
+public:
+   mutable int count;
+   CountingSolver(const Operator &op_) : Solver(op_.Height()), op(op_), count(0)
+   { }
+   virtual void Mult(const Vector &x, Vector &y) const
+   { count++; op.Mult(x, y); }
+   virtual void SetOperator(const Operator &) { }
+};
+
+TEST_CASE("Krylov subspace recycling", "[DeflatedCGSolver][GCRODRSolver]")
+{
+   const int n = 32, num_systems = 4;
+   const double tol = 1e-8;
+
+   SECTION("DeflatedCGSolver")
+   {
+      DeflatedCGSolver dcg;
+      dcg.SetRelTol(tol);
+      dcg.SetMaxIter(500);
+      dcg.SetRecycleDim(16);
+      CGSolver cg;
+      cg.SetRelTol(tol);
+      cg.SetMaxIter(500);
+
+      int first_iter = 0;
+      for (int s = 0; s < num_systems; s++)
+      {
+         SparseMatrix *A = ConvectionDiffusion(n, 0.0, 10.0*s);
+         DSmoother jacobi(*A);
+         Vector b(A->Height()), x(A->Height()), x_cg(A->Height());
+         b.Randomize(s + 1);
+         x = 0.0;
+         x_cg = 0.0;
+
+         dcg.SetOperator(*A);
+         dcg.SetPreconditioner(jacobi);
+         dcg.Mult(b, x);
+         cg.SetOperator(*A);
+         cg.SetPreconditioner(jacobi);
+         cg.Mult(b, x_cg);
+
+         REQUIRE(dcg.GetConverged());
+         REQUIRE(RelativeResidual(*A, b, x) < 10*tol);
+         if (s == 0)
+         {
+            first_iter = dcg.GetNumIterations();
+            REQUIRE(first_iter == cg.GetNumIterations());
+         }
+         else
+         {
+            REQUIRE(dcg.GetRecycleDim() == 16);
+            REQUIRE(dcg.GetNumIterations() < cg.GetNumIterations());
+         }
+         if (s > 1)
+         {
+            REQUIRE(dcg.GetNumIterations() < 0.75*first_iter);
+            REQUIRE(dcg.GetNumIterations() < 0.75*cg.GetNumIterations());
+         }
+         delete A;
+      }
+   }
+
+   SECTION("DeflatedCGSolver with a new preconditioner")
+   {
+      // The deflation space is kept, with its products updated for the new
+      // preconditioner, and still reduces the number of iterations.
+      SparseMatrix *A = ConvectionDiffusion(n, 0.0, 0.0);
+      DSmoother jacobi(*A);
+      GSSmoother sgs(*A);
+      DeflatedCGSolver dcg;
+      dcg.SetRelTol(tol);
+      dcg.SetMaxIter(500);
+      dcg.SetRecycleDim(16);
+      dcg.SetOperator(*A);
+      dcg.SetPreconditioner(jacobi);
+      CGSolver cg;
+      cg.SetRelTol(tol);
+      cg.SetMaxIter(500);
+      cg.SetOperator(*A);
+      cg.SetPreconditioner(sgs);
+      Vector b(A->Height()), x(A->Height());
+      b.Randomize(1);
+      x = 0.0;
+      dcg.Mult(b, x);
+
+      dcg.SetPreconditioner(sgs);
+      b.Randomize(2);
+      x = 0.0;
+      dcg.Mult(b, x);
+      REQUIRE(dcg.GetConverged());
+      REQUIRE(RelativeResidual(*A, b, x) < 10*tol);
+      REQUIRE(dcg.GetRecycleDim() == 16);
+      x = 0.0;
+      cg.Mult(b, x);
+      REQUIRE(dcg.GetNumIterations() < cg.GetNumIterations());
+      delete A;
+   }
+
+   SECTION("DeflatedCGSolver work per solve")
+   {
+      // Updating the deflation space applies neither A nor B: each solve
+      // applies A and B once per iteration and once for the initial residual.
+      SparseMatrix *A = ConvectionDiffusion(n, 0.0, 0.0);
+      DSmoother jacobi(*A);
+      CountingSolver cA(*A), cB(jacobi);
+      DeflatedCGSolver dcg;
+      dcg.SetRelTol(tol);
+      dcg.SetMaxIter(500);
+      dcg.SetRecycleDim(16);
+      dcg.SetOperator(cA);
+      dcg.SetPreconditioner(cB);
+      Vector b(A->Height()), x(A->Height());
+      for (int s = 0; s < num_systems; s++)
+      {
+         b.Randomize(s + 1);
+         x = 0.0;
+         cA.count = cB.count = 0;
+         dcg.Mult(b, x);
+         REQUIRE(dcg.GetConverged());
+         REQUIRE(RelativeResidual(*A, b, x) < 10*tol);
+         REQUIRE(cA.count == dcg.GetNumIterations() + 1);
+         REQUIRE(cB.count == dcg.GetNumIterations() + 1);
+      }
+      REQUIRE(dcg.GetRecycleDim() == 16);
+      delete A;
+   }
+
+   SECTION("GCRODRSolver")
+   {
+      GCRODRSolver gcrodr;
+      gcrodr.SetRelTol(tol);
+      gcrodr.SetMaxIter(2000);
+      gcrodr.SetKDim(20);
+      gcrodr.SetRecycleDim(10);
+      FGMRESSolver fgmres;
+      fgmres.SetRelTol(tol);
+      fgmres.SetMaxIter(2000);
+      fgmres.SetKDim(30);
+
+      for (int s = 0; s < num_systems; s++)
+      {
+         SparseMatrix *A = ConvectionDiffusion(n, 20.0, 10.0*s);
+         DSmoother jacobi(*A);
+         Vector b(A->Height()), x(A->Height()), x_fgmres(A->Height());
+         b.Randomize(s + 1);
+         x = 0.0;
+         x_fgmres = 0.0;
+
+         gcrodr.SetOperator(*A);
+         gcrodr.SetPreconditioner(jacobi);
+         gcrodr.Mult(b, x);
+         fgmres.SetOperator(*A);
+         fgmres.SetPreconditioner(jacobi);
+         fgmres.Mult(b, x_fgmres);
+
+         // Same memory as FGMRES(30), fewer iterations.
+         REQUIRE(gcrodr.GetConverged());
+         REQUIRE(RelativeResidual(*A, b, x) < 10*tol);
+         REQUIRE(gcrodr.GetRecycleDim() == 10);
+         REQUIRE(gcrodr.GetNumIterations() < fgmres.GetNumIterations());
+         delete A;
+      }
+   }
+}
+
+TEST_CASE("GMRES orthogonalization", "[GMRESSolver][FGMRESSolver]")
+{
+   const double tol = 1e-10;
+   SparseMatrix *A = ConvectionDiffusion(24, 40.0);
+   DSmoother jacobi(*A);
+   Vector b(A->Height());
+   b.Randomize(1);
+
+   typedef IterativeSolver::Orthogonalization Orthogonalization;
+   int gmres_iter[2], fgmres_iter[2];
+   for (int i = 0; i < 2; i++)
+   {
+      const Orthogonalization orth =
+         i ? Orthogonalization::CGS2 : Orthogonalization::MGS;
+      GMRESSolver gmres;
+      gmres.SetKDim(30);
+      gmres.SetOrthogonalization(orth);
+      gmres_iter[i] = Solve(gmres, *A, jacobi, b, tol);
+
+      FGMRESSolver fgmres;
+      fgmres.SetKDim(30);
+      fgmres.SetOrthogonalization(orth);
+      fgmres_iter[i] = Solve(fgmres, *A, jacobi, b, tol);
+   }
+   // Both variants build the same basis up to round-off.
+   REQUIRE(std::abs(gmres_iter[1] - gmres_iter[0]) <= 1);
+   REQUIRE(std::abs(fgmres_iter[1] - fgmres_iter[0]) <= 1);
+
+   delete A;
+}
+
+TEST_CASE("CAGMRESSolver", "[CAGMRESSolver]")
+{
+   const double tol = 1e-8;
+   SparseMatrix *A = ConvectionDiffusion(24, 40.0);
+   DSmoother jacobi(*A);
+   Vector b(A->Height());
+   b.Randomize(1);
+
+   GMRESSolver gmres;
+   gmres.SetKDim(32);
+   const int gmres_iter = Solve(gmres, *A, jacobi, b, tol);
+
+   auto step = GENERATE(1, 2, 4, 5);
+   CAGMRESSolver cagmres;
+   cagmres.SetKDim(32);
+   cagmres.SetStepSize(step);
+   const int cagmres_iter = Solve(cagmres, *A, jacobi, b, tol);
+
+   // Same Krylov spaces in exact arithmetic
+   REQUIRE(cagmres_iter <= gmres_iter + 2);
+
+   delete A;
+}
+
+#ifdef MFEM_USE_MPI
+
+TEST_CASE("Parallel CAGMRESSolver", "[Parallel], [CAGMRESSolver]")
+{
+   // The TSQR factorization of each block reduces its R factors over all the
+   // ranks, so CA-GMRES should follow GMRES for any number of ranks.
+   const double tol = 1e-8;
+   Mesh mesh(16, 16, Element::QUADRILATERAL, true);
+   ParMesh pmesh(MPI_COMM_WORLD, mesh);
+   H1_FECollection fec(2, 2);
+   ParFiniteElementSpace fes(&pmesh, &fec);
+   Array<int> ess_bdr(pmesh.bdr_attributes.Max()), ess_tdof_list;
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   Vector velocity(2);
+   velocity(0) = 40.0;
+   velocity(1) = 20.0;
+   VectorConstantCoefficient vel(velocity);
+   ParBilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator);
+   a.AddDomainIntegrator(new ConvectionIntegrator(vel));
+   a.Assemble();
+   HypreParMatrix A;
+   a.FormSystemMatrix(ess_tdof_list, A);
+   HypreSmoother jacobi(A, HypreSmoother::Jacobi);
+
+   Vector b(fes.GetTrueVSize());
+   b.Randomize(1 + pmesh.GetMyRank());
+   for (int i = 0; i < ess_tdof_list.Size(); i++) { b(ess_tdof_list[i]) = 0.0; }
+
+   GMRESSolver gmres(MPI_COMM_WORLD);
+   gmres.SetKDim(32);
+   const int gmres_iter = Solve(gmres, A, jacobi, b, tol);
+
+   auto step = GENERATE(1, 4);
+   CAGMRESSolver cagmres(MPI_COMM_WORLD);
+   cagmres.SetKDim(32);
+   cagmres.SetStepSize(step);
+   const int cagmres_iter = Solve(cagmres, A, jacobi, b, tol);
+
+   REQUIRE(cagmres_iter <= gmres_iter + 2);
+}
+
+#endif // MFEM_USE_MPI
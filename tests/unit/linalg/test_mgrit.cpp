@@ -0,0 +1,77 @@
+// Copyright (c) 2010-2021, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+namespace mfem
+{
+#ifdef MFEM_USE_MPI
+
+// Damped oscillator du/dt = A u with A = [-0.1 1; -1 -0.1].
+class MGRITTestODE : public TimeDependentOperator
+{
+public:
+   MGRITTestODE() : TimeDependentOperator(2, 0.0) { }
+
+   virtual void Mult(const Vector &u, Vector &dudt) const
+   {
+      dudt(0) = -0.1*u(0) + u(1);
+      dudt(1) = -u(0) - 0.1*u(1);
+   }
+};
+
+TEST_CASE("MGRIT", "[Parallel], [ODE1]")
+{
+   int nranks;
+   MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+   const double dt = 0.01, tf = 0.01*128*nranks;
+   MGRITTestODE ode;
+   Vector u0(2);
+   u0(0) = 1.0; u0(1) = 0.0;
+
+   // Sequential fine solution.
+   RK4Solver rk4;
+   rk4.Init(ode);
+   Vector u_ref(u0);
+   double t = 0.0, h = dt;
+   rk4.Run(u_ref, t, h, tf - 1e-12);
+
+   for (int fcf = 0; fcf < 2; fcf++)
+   {
+      RK4Solver fine;
+      RK2Solver coarse;
+      MGRITSolver mgrit(MPI_COMM_WORLD);
+      mgrit.SetOperator(ode);
+      mgrit.SetFineSolver(fine);
+      mgrit.SetCoarseSolver(coarse);
+      mgrit.SetCoarseningFactor(8);
+      mgrit.SetFCFRelaxation(fcf);
+      mgrit.SetTolerance(1e-12);
+      mgrit.SetMaxIter(100);
+
+      Vector u(u0);
+      t = 0.0;
+      mgrit.Run(u, t, dt, tf);
+      REQUIRE(t == tf);
+      u -= u_ref;
+      REQUIRE(u.Normlinf() < 1e-10);
+
+      // Converged well before the 16*nranks (F) or 8*nranks (FCF) iterations
+      // after which the solution is exact.
+      REQUIRE(mgrit.GetNumIterations() <= 6);
+   }
+}
+
+#endif // MFEM_USE_MPI
+
+} // namespace mfem
@@ -230,6 +230,27 @@ TEST_CASE("First order ODE methods",
       REQUIRE(conv_rate + tol > 4.0);
    }
 
+   SECTION("LSRK3Solver")
+   {
+      std::cout <<"\nTesting LSRK3Solver" << std::endl;
+      double conv_rate = check.order(new LSRK3Solver);
+      REQUIRE(conv_rate + tol > 3.0);
+   }
+
+   SECTION("LSRK54Solver")
+   {
+      std::cout <<"\nTesting LSRK54Solver" << std::endl;
+      double conv_rate = check.order(new LSRK54Solver);
+      REQUIRE(conv_rate + tol > 4.0);
+   }
+
+   SECTION("SSPRK104Solver")
+   {
+      std::cout <<"\nTesting SSPRK104Solver" << std::endl;
+      double conv_rate = check.order(new SSPRK104Solver);
+      REQUIRE(conv_rate + tol > 4.0);
+   }
+
    SECTION("ImplicitMidpointSolver")
    {
       std::cout <<"\nTesting ImplicitMidpointSolver" << std::endl;
@@ -412,3 +433,305 @@ TEST_CASE("First order ODE methods",
       REQUIRE(conv_rate + tol > 5.0);
    }
 }
+
+TEST_CASE("Adaptive ODE methods",
+          "[ODE1]")
+{
+   // Harmonic oscillator du/dt = A u with A = [0 1; -1 0], or a stiff problem
+   // du/dt = -lambda (u - cos(t)), counting the calls to Mult and
+   // ImplicitSolve.
+   class ODE : public TimeDependentOperator
+   {
+   public:
+      double lambda;
+      mutable int num_mult;
+      int num_solve;
+
+      ODE(double l) : TimeDependentOperator(l > 0.0 ? 1 : 2, 0.0),
+         lambda(l), num_mult(0), num_solve(0) { }
+
+      virtual void Mult(const Vector &u, Vector &dudt) const
+      {
+         num_mult++;
+         if (lambda > 0.0)
+         {
+            dudt(0) = -lambda*(u(0) - cos(GetTime()));
+            return;
+         }
+         dudt(0) = u(1);
+         dudt(1) = -u(0);
+      }
+
+      virtual void ImplicitSolve(const double dt, const Vector &u,
+                                 Vector &dudt)
+      {
+         num_solve++;
+         if (lambda > 0.0)
+         {
+            dudt(0) = -lambda*(u(0) - cos(GetTime()))/(1.0 + lambda*dt);
+            return;
+         }
+         const double det = 1.0 + dt*dt;
+         dudt(0) = (u(1) - dt*u(0))/det;
+         dudt(1) = (-u(0) - dt*u(1))/det;
+      }
+   };
+
+   auto run = [](EmbeddedRKSolver &solver, ODE &ode, double tol,
+                 double tf, Vector &u)
+   {
+      solver.Init(ode);
+      solver.SetTolerances(tol, tol);
+      double t = 0.0, dt = 1e-3;
+      solver.Run(u, t, dt, tf);
+      REQUIRE(t == tf);
+      return solver.GetNumAccepted();
+   };
+
+   SECTION("Oscillator")
+   {
+      DormandPrince54Solver dp54;
+      BogackiShampine32Solver bs32;
+      ESDIRK32EmbeddedSolver esdirk;
+      EmbeddedRKSolver *solvers[3] = { &dp54, &bs32, &esdirk };
+      for (EmbeddedRKSolver *solver : solvers)
+      {
+         long steps[2];
+         for (int i = 0; i < 2; i++)
+         {
+            const double tol = i ? 1e-8 : 1e-5;
+            ODE ode(0.0);
+            Vector u(2);
+            u(0) = 1.0; u(1) = 0.0;
+            steps[i] = run(*solver, ode, tol, M_PI, u);
+            u(0) += 1.0;
+            REQUIRE(u.Normlinf() < 100*tol);
+
+            // With FSAL, each step costs s-1 evaluations, plus one at t = 0.
+            const long evals = ode.num_mult + ode.num_solve;
+            const long tried = steps[i] + solver->GetNumRejected();
+            const int s = (solver == &dp54) ? 7 : 4;
+            REQUIRE(evals == 1 + (s-1)*tried);
+         }
+         REQUIRE(steps[1] > steps[0]);
+      }
+   }
+
+   SECTION("Stiff")
+   {
+      // The explicit pair is limited by stability, the ESDIRK pair only by
+      // accuracy.
+      long steps[2];
+      for (int i = 0; i < 2; i++)
+      {
+         DormandPrince54Solver dp54;
+         ESDIRK32EmbeddedSolver esdirk;
+         EmbeddedRKSolver &solver = i ? (EmbeddedRKSolver&) esdirk : dp54;
+         ODE ode(1e4);
+         Vector u(1);
+         u = 1.0;
+         steps[i] = run(solver, ode, 1e-4, 2.0, u);
+         const double l = ode.lambda;
+         const double exact = (l*l*cos(2.0) + l*sin(2.0))/(1.0 + l*l);
+         REQUIRE(fabs(u(0) - exact) < 1e-2);
+      }
+      REQUIRE(steps[1]*10 < steps[0]);
+   }
+
+   SECTION("Step to target")
+   {
+      // Step() reaches the target time exactly, taking internal steps.
+      DormandPrince54Solver dp54;
+      ODE ode(0.0);
+      dp54.Init(ode);
+      dp54.SetTolerances(1e-8, 1e-8);
+      Vector u(2);
+      u(0) = 1.0; u(1) = 0.0;
+      double t = 0.0;
+      for (int i = 0; i < 4; i++)
+      {
+         double dt = 0.25*M_PI;
+         dp54.Step(u, t, dt);
+         REQUIRE(t == Approx((i + 1)*0.25*M_PI));
+         REQUIRE(dt <= 0.25*M_PI);
+      }
+      REQUIRE(dp54.GetNumAccepted() > 4);
+      REQUIRE(u(0) == Approx(-1.0).epsilon(1e-6));
+   }
+}
+
+TEST_CASE("IMEX ODE methods",
+          "[ODE1]")
+{
+   // Split problem du/dt = f1 + f2 with f1 = cos(t) u explicit and
+   // f2 = -lambda u implicit, with exact solution u = exp(sin(t) - lambda t).
+   class ODE : public TimeDependentOperator
+   {
+   public:
+      double lambda;
+
+      ODE(double l) : TimeDependentOperator(1, 0.0), lambda(l) { }
+
+      virtual void Mult(const Vector &u, Vector &dudt) const
+      {
+         MFEM_VERIFY(GetEvalMode() != NORMAL, "f is split");
+         dudt(0) = (GetEvalMode() == ADDITIVE_TERM_1) ?
+                   cos(GetTime())*u(0) : -lambda*u(0);
+      }
+
+      virtual void ImplicitSolve(const double dt, const Vector &u,
+                                 Vector &dudt)
+      {
+         MFEM_VERIFY(GetEvalMode() == ADDITIVE_TERM_2, "f2 is implicit");
+         dudt(0) = -lambda*u(0)/(1.0 + lambda*dt);
+      }
+   };
+
+   auto error = [](ODESolver &solver, double lambda, int n)
+   {
+      ODE ode(lambda);
+      solver.Init(ode);
+      Vector u(1);
+      u = 1.0;
+      double t = 0.0, dt = 1.0/n;
+      for (int i = 0; i < n; i++) { solver.Step(u, t, dt); }
+      REQUIRE(ode.GetEvalMode() == TimeDependentOperator::NORMAL);
+      return fabs(u(0) - exp(sin(t) - lambda*t));
+   };
+
+   ARS222Solver ars222;
+   ARS443Solver ars443;
+   ARK3Solver ark3;
+   ARK4Solver ark4;
+   ODESolver *solvers[4] = { &ars222, &ars443, &ark3, &ark4 };
+   const int orders[4] = { 2, 3, 3, 4 };
+
+   SECTION("Convergence")
+   {
+      for (int m = 0; m < 4; m++)
+      {
+         const double e1 = error(*solvers[m], 1.0, 20);
+         const double e2 = error(*solvers[m], 1.0, 40);
+         REQUIRE(log2(e1/e2) > orders[m] - 0.2);
+      }
+   }
+
+   SECTION("Stiff")
+   {
+      // Steps far beyond the explicit stability limit of the stiff term.
+      for (int m = 0; m < 4; m++)
+      {
+         REQUIRE(error(*solvers[m], 1e6, 10) < 1e-3);
+      }
+   }
+}
+
+TEST_CASE("Multirate ODE methods",
+          "[ODE1]")
+{
+   // Chain of n unknowns, one per "element", with du_i/dt = -lambda_i u_i +
+   // u_{i-1} - u_{i+1}: the elements with larger lambda_i need smaller steps.
+   class ODE : public TimeDependentOperator
+   {
+   public:
+      Vector lambda;
+      mutable long num_evals;
+
+      ODE(const Vector &l) : TimeDependentOperator(l.Size(), 0.0),
+         lambda(l), num_evals(0) { }
+
+      void Eval(int i, const Vector &u, Vector &dudt) const
+      {
+         const int n = u.Size();
+         dudt(i) = -lambda(i)*u(i) + (i > 0 ? u(i-1) : 0.0) -
+                   (i < n-1 ? u(i+1) : 0.0) + cos(GetTime());
+         num_evals++;
+      }
+
+      virtual void Mult(const Vector &u, Vector &dudt) const
+      {
+         for (int i = 0; i < u.Size(); i++) { Eval(i, u, dudt); }
+      }
+
+      virtual void MultSubset(const Array<int> &elems, const Vector &u,
+                              Vector &dudt) const
+      {
+         for (int i : elems) { Eval(i, u, dudt); }
+      }
+   };
+
+   const int n = 6;
+   Vector lambda(n), elem_dt(n);
+   Array<int> dofs(n);
+   for (int i = 0; i < n; i++)
+   {
+      lambda(i) = (i < 3) ? 1.0 : (1 << (2*(i - 2)));
+      elem_dt(i) = 0.1/lambda(i);
+      dofs[i] = i;
+   }
+   Table elem_dof(n, dofs.GetData());
+   // the unknowns read by each element: its own and those of its neighbors
+   Table elem_read(n, 3);
+   for (int i = 0; i < n; i++)
+   {
+      for (int j = std::max(i-1, 0); j <= std::min(i+1, n-1); j++)
+      {
+         elem_read.Push(i, j);
+      }
+   }
+   elem_read.Finalize();
+   Array<int> rate;
+   MultirateABSolver::ComputeRates(elem_dt, 0.1, rate);
+   REQUIRE(rate[0] == 0);
+   REQUIRE(rate[3] == 2);
+   REQUIRE(rate[5] == 6);
+
+   auto solve = [&](ODESolver &solver, double dt, long &evals)
+   {
+      ODE ode(lambda);
+      solver.Init(ode);
+      Vector u(n);
+      u = 1.0;
+      double t = 0.0;
+      const int steps = int(1.0/dt + 0.5);
+      for (int i = 0; i < steps; i++) { solver.Step(u, t, dt); }
+      evals = ode.num_evals;
+      return u;
+   };
+
+   long evals, evals_ref;
+   RK4Solver rk4;
+   const Vector u_ref = solve(rk4, 1e-4, evals_ref);
+
+   for (int order = 1; order <= 3; order++)
+   {
+      MultirateABSolver mrab(order), mrab_read(order);
+      mrab.SetRates(rate, elem_dof);
+      mrab_read.SetRates(rate, elem_dof, &elem_read);
+      REQUIRE(mrab.GetMaxRate() == 6);
+
+      double err[2];
+      for (int l = 0; l < 2; l++)
+      {
+         const double dt = 0.1/(1 << l);
+         Vector u = solve(mrab, dt, evals);
+
+         // Extrapolating the slower bins only on the unknowns read by the
+         // evaluated bins gives the same solution.
+         long evals_read;
+         Vector u_read = solve(mrab_read, dt, evals_read);
+         u_read -= u;
+         REQUIRE(u_read.Normlinf() == 0.0);
+         REQUIRE(evals_read == evals);
+
+         u -= u_ref;
+         err[l] = u.Normlinf();
+
+         // Each element is evaluated 2^rate times per step.
+         long per_step = 0;
+         for (int i = 0; i < n; i++) { per_step += 1 << rate[i]; }
+         REQUIRE(evals == per_step*int(1.0/dt + 0.5));
+      }
+      REQUIRE(log2(err[0]/err[1]) > order - 0.3);
+   }
+}
@@ -145,3 +145,111 @@ TEST_CASE("Gecko integration in MFEM", "[Mesh]")
       }
    }
 }
+
+TEST_CASE("Weighted partitioning", "[Mesh]")
+{
+   Mesh mesh(4, 4, Element::QUADRILATERAL);
+   const int ne = mesh.GetNE();
+
+   Array<int> partitioning(ne);
+   for (int i = 0; i < ne; i++) { partitioning[i] = (i < ne/2) ? 0 : 1; }
+
+   Vector weights(ne);
+   weights = 1.0;
+   std::ostringstream out;
+
+   SECTION("Balance report")
+   {
+      REQUIRE(mesh.PrintPartitionBalance(partitioning, 2, NULL, out) ==
+              MFEM_Approx(1.0));
+      REQUIRE(mesh.PrintPartitionBalance(partitioning, 2, &weights, out) ==
+              MFEM_Approx(1.0));
+
+      // make the elements of the first part twice as expensive
+      for (int i = 0; i < ne/2; i++) { weights(i) = 2.0; }
+      REQUIRE(mesh.PrintPartitionBalance(partitioning, 2, &weights, out) ==
+              MFEM_Approx(4.0/3.0));
+   }
+
+#ifdef MFEM_USE_METIS
+   SECTION("METIS vertex weights")
+   {
+      for (int i = 0; i < ne; i++) { weights(i) = (i % 4 == 0) ? 10.0 : 1.0; }
+      int *wpart = mesh.GeneratePartitioning(2, weights);
+      double imbalance = mesh.PrintPartitionBalance(wpart, 2, &weights, out);
+      REQUIRE(imbalance < 1.2);
+      delete [] wpart;
+   }
+#endif
+}
+
+TEST_CASE("Streaming refined output", "[Mesh]")
+{
+   for (int elem_type = 0; elem_type < 5; elem_type++)
+   {
+      Mesh *mesh;
+      switch (elem_type)
+      {
+         case 0: mesh = new Mesh(3, 2, Element::QUADRILATERAL); break;
+         case 1: mesh = new Mesh(3, 2, Element::TRIANGLE); break;
+         case 2: mesh = new Mesh(2, 2, 2, Element::HEXAHEDRON); break;
+         case 3: mesh = new Mesh(2, 2, 2, Element::TETRAHEDRON); break;
+         default: mesh = new Mesh(2, 2, 2, Element::WEDGE); break;
+      }
+
+      for (int ref_levels = 1; ref_levels <= 2; ref_levels++)
+      {
+         std::stringstream refined_str;
+         refined_str.precision(16);
+         mesh->PrintRefined(refined_str, 1 << ref_levels);
+         Mesh refined(refined_str, 1, 1);
+
+         Mesh uniform(*mesh);
+         for (int l = 0; l < ref_levels; l++) { uniform.UniformRefinement(); }
+
+         REQUIRE(refined.GetNE() == uniform.GetNE());
+         REQUIRE(refined.GetNBE() == uniform.GetNBE());
+         REQUIRE(refined.GetNV() == uniform.GetNV());
+         REQUIRE(refined.GetNEdges() == uniform.GetNEdges());
+
+         double volume = 0.0;
+         for (int i = 0; i < refined.GetNE(); i++)
+         {
+            REQUIRE(refined.GetElementVolume(i) > 0.0);
+            volume += refined.GetElementVolume(i);
+         }
+         REQUIRE(volume == MFEM_Approx(1.0));
+      }
+      delete mesh;
+   }
+
+   SECTION("Curved mesh")
+   {
+      Mesh mesh(4, 4, Element::QUADRILATERAL);
+      mesh.SetCurvature(3);
+      mesh.Transform([](const Vector &x, Vector &y)
+      {
+         y = x;
+         y(1) += 0.1*sin(M_PI*x(0));
+      });
+
+      std::stringstream refined_str;
+      refined_str.precision(16);
+      mesh.PrintRefined(refined_str, 3);
+      Mesh refined(refined_str, 1, 1);
+      Mesh lor(&mesh, 3, BasisType::ClosedUniform);
+
+      REQUIRE(refined.GetNE() == lor.GetNE());
+      REQUIRE(refined.GetNV() == lor.GetNV());
+      double max_diff = 0.0;
+      for (int i = 0; i < lor.GetNV(); i++)
+      {
+         for (int d = 0; d < 2; d++)
+         {
+            max_diff = std::max(max_diff, std::abs(refined.GetVertex(i)[d] -
+                                                   lor.GetVertex(i)[d]));
+         }
+      }
+      REQUIRE(max_diff == MFEM_Approx(0.0));
+   }
+}
@@ -118,6 +118,191 @@ TEST_CASE("ParMeshGlobalIndices",  "[Parallel], [ParMesh]")
    }
 }
 
+TEST_CASE("ParMeshWeightedRebalance",  "[Parallel], [ParMesh]")
+{
+   Mesh mesh(8, 8, Element::QUADRILATERAL, 1, 1.0, 1.0);
+   mesh.EnsureNCMesh();
+
+   ParMesh pmesh(MPI_COMM_WORLD, mesh);
+
+   // make the elements in the left half of the domain 3x more expensive
+   auto weights = [&](Vector &w)
+   {
+      w.SetSize(pmesh.GetNE());
+      for (int i = 0; i < pmesh.GetNE(); i++)
+      {
+         Vector center;
+         pmesh.GetElementCenter(i, center);
+         w(i) = (center(0) < 0.5) ? 3.0 : 1.0;
+      }
+   };
+
+   Vector w;
+   weights(w);
+   const long ne_before = pmesh.ReduceInt(pmesh.GetNE());
+
+   pmesh.Rebalance(w);
+   REQUIRE(pmesh.ReduceInt(pmesh.GetNE()) == ne_before);
+
+   // the weighted SFC split balances the total cost within one element
+   weights(w);
+   std::ostringstream out;
+   const double imbalance = pmesh.PrintLoadBalance(&w, out);
+   const double avg_load = (3.0 + 1.0) * 32 / pmesh.GetNRanks();
+   REQUIRE(imbalance <= 1.0 + 3.0 / avg_load + 1e-12);
+}
+
+TEST_CASE("ParMeshLoadDistributed",  "[Parallel], [ParMesh]")
+{
+   int rank;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+   const char *mesh_file = "load_distributed_test.mesh";
+   for (int elem_type = 0; elem_type < 4; elem_type++)
+   {
+      Mesh *mesh;
+      switch (elem_type)
+      {
+         case 0: mesh = new Mesh(6, 5, Element::QUADRILATERAL); break;
+         case 1: mesh = new Mesh(6, 5, Element::TRIANGLE); break;
+         case 2: mesh = new Mesh(4, 3, 3, Element::HEXAHEDRON); break;
+         default: mesh = new Mesh(3, 3, 4, Element::TETRAHEDRON); break;
+      }
+      if (rank == 0)
+      {
+         std::ofstream mesh_ofs(mesh_file);
+         mesh_ofs.precision(16);
+         mesh->Print(mesh_ofs);
+      }
+      MPI_Barrier(MPI_COMM_WORLD);
+
+      ParMesh *pmesh = ParMesh::LoadDistributed(MPI_COMM_WORLD, mesh_file);
+
+      REQUIRE(pmesh->ReduceInt(pmesh->GetNE()) == mesh->GetNE());
+      REQUIRE(pmesh->ReduceInt(pmesh->GetNBE()) == mesh->GetNBE());
+
+      // the shared entities are consistent iff the number of true DOFs of
+      // H1 and ND spaces matches the serial mesh
+      const int dim = mesh->Dimension();
+      H1_FECollection h1_fec(2, dim);
+      ND_FECollection nd_fec(1, dim);
+      FiniteElementSpace h1_fes(mesh, &h1_fec), nd_fes(mesh, &nd_fec);
+      ParFiniteElementSpace h1_pfes(pmesh, &h1_fec), nd_pfes(pmesh, &nd_fec);
+      REQUIRE(h1_pfes.GlobalTrueVSize() == h1_fes.GetTrueVSize());
+      REQUIRE(nd_pfes.GlobalTrueVSize() == nd_fes.GetTrueVSize());
+
+      delete pmesh;
+      delete mesh;
+      MPI_Barrier(MPI_COMM_WORLD);
+   }
+   if (rank == 0) { std::remove(mesh_file); }
+}
+
+TEST_CASE("ParMeshLoadDistributedInternalBoundary",  "[Parallel], [ParMesh]")
+{
+   int rank;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+   // an 8 x 4 quad mesh of [0,2] x [0,1] with an internal boundary (attribute
+   // 2) on the line x = 1, which the partitioning typically makes shared
+   const int nx = 8, ny = 4;
+   Mesh mesh(2, (nx+1)*(ny+1), nx*ny, 2*(nx+ny) + ny);
+   for (int j = 0; j <= ny; j++)
+   {
+      for (int i = 0; i <= nx; i++)
+      {
+         mesh.AddVertex(2.0*i/nx, 1.0*j/ny);
+      }
+   }
+   auto v = [=](int i, int j) { return i + j*(nx+1); };
+   for (int j = 0; j < ny; j++)
+   {
+      for (int i = 0; i < nx; i++)
+      {
+         mesh.AddQuad(v(i,j), v(i+1,j), v(i+1,j+1), v(i,j+1));
+      }
+   }
+   for (int i = 0; i < nx; i++)
+   {
+      mesh.AddBdrSegment(v(i,0), v(i+1,0));
+      mesh.AddBdrSegment(v(i+1,ny), v(i,ny));
+   }
+   for (int j = 0; j < ny; j++)
+   {
+      mesh.AddBdrSegment(v(nx,j), v(nx,j+1));
+      mesh.AddBdrSegment(v(0,j+1), v(0,j));
+      mesh.AddBdrSegment(v(nx/2,j), v(nx/2,j+1), 2);
+   }
+   mesh.FinalizeQuadMesh(1, 1, true);
+
+   const char *mesh_file = "load_distributed_internal_test.mesh";
+   if (rank == 0)
+   {
+      std::ofstream mesh_ofs(mesh_file);
+      mesh_ofs.precision(16);
+      mesh.Print(mesh_ofs);
+   }
+   MPI_Barrier(MPI_COMM_WORLD);
+
+   ParMesh *pmesh = ParMesh::LoadDistributed(MPI_COMM_WORLD, mesh_file);
+
+   // each boundary element, including the internal ones, is loaded once
+   int nbe_internal = 0;
+   for (int i = 0; i < pmesh->GetNBE(); i++)
+   {
+      if (pmesh->GetBdrAttribute(i) == 2) { nbe_internal++; }
+   }
+   REQUIRE(pmesh->ReduceInt(pmesh->GetNBE()) == mesh.GetNBE());
+   REQUIRE(pmesh->ReduceInt(nbe_internal) == ny);
+
+   delete pmesh;
+   MPI_Barrier(MPI_COMM_WORLD);
+   if (rank == 0) { std::remove(mesh_file); }
+}
+
+TEST_CASE("ParMeshStreamingRefinement",  "[Parallel], [ParMesh]")
+{
+   for (int elem_type = 0; elem_type < 4; elem_type++)
+   {
+      Mesh *mesh;
+      switch (elem_type)
+      {
+         case 0: mesh = new Mesh(6, 5, Element::QUADRILATERAL); break;
+         case 1: mesh = new Mesh(6, 5, Element::TRIANGLE); break;
+         case 2: mesh = new Mesh(4, 3, 3, Element::HEXAHEDRON); break;
+         default: mesh = new Mesh(3, 3, 4, Element::TETRAHEDRON); break;
+      }
+      ParMesh pmesh(MPI_COMM_WORLD, *mesh);
+      delete mesh;
+
+      const int ref_levels = 2;
+      std::stringstream refined_str;
+      refined_str.precision(16);
+      pmesh.ParPrintRefined(refined_str, 1 << ref_levels);
+      ParMesh refined(MPI_COMM_WORLD, refined_str);
+
+      ParMesh uniform(pmesh);
+      for (int l = 0; l < ref_levels; l++) { uniform.UniformRefinement(); }
+
+      REQUIRE(refined.ReduceInt(refined.GetNE()) ==
+              uniform.ReduceInt(uniform.GetNE()));
+      REQUIRE(refined.ReduceInt(refined.GetNBE()) ==
+              uniform.ReduceInt(uniform.GetNBE()));
+
+      // the shared entities are consistent iff the number of true DOFs of
+      // H1 and ND spaces matches the uniformly refined mesh
+      const int dim = pmesh.Dimension();
+      H1_FECollection h1_fec(2, dim);
+      ND_FECollection nd_fec(1, dim);
+      ParFiniteElementSpace h1_ref(&refined, &h1_fec);
+      ParFiniteElementSpace nd_ref(&refined, &nd_fec);
+      ParFiniteElementSpace h1_uni(&uniform, &h1_fec);
+      ParFiniteElementSpace nd_uni(&uniform, &nd_fec);
+      REQUIRE(h1_ref.GlobalTrueVSize() == h1_uni.GlobalTrueVSize());
+      REQUIRE(nd_ref.GlobalTrueVSize() == nd_uni.GlobalTrueVSize());
+   }
+}
+
 #endif // MFEM_USE_MPI
 
 } // namespace mfem